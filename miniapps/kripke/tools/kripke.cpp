@@ -197,9 +197,10 @@ void runPoint(int point, int num_tasks, int num_threads, Input_Variables &input_
 
 int main(int argc, char **argv) {
   /*
-   * Initialize MPI
+   * Initialize MPI, with threads for asynchronous in situ analysis
    */
-  MPI_Init(&argc, &argv);
+  int provided = 0;
+  MPI_Init_thread(&argc, &argv, MPI_THREAD_MULTIPLE, &provided);
   int myid;
   MPI_Comm_rank(MPI_COMM_WORLD, &myid);
   int num_tasks;
@@ -573,8 +573,9 @@ int main(int argc, char **argv)
     int nx = 32;
     int ny = 32;
 
-    // Initialize MPI
-    MPI_Init(&argc, &argv);
+    // Initialize MPI, with threads for asynchronous in situ analysis
+    int provided = 0;
+    MPI_Init_thread(&argc, &argv, MPI_THREAD_MULTIPLE, &provided);
     MPI_Comm_rank(MPI_COMM_WORLD, &sim.par_rank);
     MPI_Comm_size(MPI_COMM_WORLD, &sim.par_size);
 
@@ -1,5 +1,6 @@
 #include "DataAdaptor.h"
 #include "MeshMetadata.h"
+#include "VTKUtils.h"
 #include "Error.h"
 
 #include <vtkCellArray.h>
@@ -19,6 +20,8 @@
 
 #include <sdiy/master.hpp>
 
+#include <set>
+
 
 static
 long getBlockNumCells(const sdiy::DiscreteBounds &ext)
@@ -194,7 +197,7 @@ static
 int newParticleArray(const std::vector<Particle> &particles,
   const std::string &arrayName, vtkFloatArray *&fa)
 {
-  enum {PID, VEL, VELMAG};
+  enum {PID, VELMAG};
 
   fa = vtkFloatArray::New();
 
@@ -203,11 +206,6 @@ int newParticleArray(const std::vector<Particle> &particles,
     {
     aid = PID;
     }
-  else if (arrayName == "velocity")
-    {
-    aid = VEL;
-    fa->SetNumberOfComponents(3);
-    }
   else if (arrayName == "velocityMagnitude")
     {
     aid = VELMAG;
@@ -232,11 +230,6 @@ int newParticleArray(const std::vector<Particle> &particles,
       case PID:
         pfa[i] = particles[i].id;
         break;
-      case VEL:
-        pfa[3*i] = particles[i].velocity[0];
-        pfa[3*i+1] = particles[i].velocity[1];
-        pfa[3*i+2] = particles[i].velocity[2];
-        break;
       case VELMAG:
         {
         float vx = particles[i].velocity[0];
@@ -435,15 +428,33 @@ void DataAdaptor::SetParticleData(int gid, const std::vector<Particle> &particle
 int DataAdaptor::GetMesh(const std::string &meshName, bool structureOnly,
     vtkDataObject *&mesh)
 {
-  mesh = nullptr;
+  mesh = this->NewMesh(meshName, structureOnly, nullptr);
+  return mesh ? 0 : -1;
+}
+
+//-----------------------------------------------------------------------------
+int DataAdaptor::GetMesh(const std::string &meshName, bool structureOnly,
+    const std::vector<int> &blockIds, vtkCompositeDataSet *&mesh)
+{
+  mesh = this->NewMesh(meshName, structureOnly, &blockIds);
+  return mesh ? 0 : -1;
+}
 
+//-----------------------------------------------------------------------------
+vtkMultiBlockDataSet *DataAdaptor::NewMesh(const std::string &meshName,
+    bool structureOnly, const std::vector<int> *blockIds)
+{
   if ((meshName != "mesh") && (meshName != "ucdmesh") && (meshName != "particles"))
     {
     SENSEI_ERROR("the miniapp provides meshes named \"mesh\", \"ucdmesh\","
       " and \"particles\". you requested \"" << meshName << "\"")
-    return -1;
+    return nullptr;
     }
 
+  std::set<int> selected;
+  if (blockIds)
+    selected.insert(blockIds->begin(), blockIds->end());
+
   int particleBlocks = meshName == "particles";
   int unstructuredBlocks = particleBlocks ? 0 : meshName == "ucdmesh";
 
@@ -454,6 +465,10 @@ int DataAdaptor::GetMesh(const std::string &meshName, bool structureOnly,
   auto end = this->Internals->BlockExtents.end();
   for (; it != end; ++it)
     {
+    // when a subset is requested the other blocks are left empty
+    if (blockIds && !selected.count(it->first))
+      continue;
+
     if (particleBlocks)
       {
       vtkPolyData *pd =
@@ -481,9 +496,7 @@ int DataAdaptor::GetMesh(const std::string &meshName, bool structureOnly,
       }
     }
 
-  mesh = mb;
-
-  return 0;
+  return mb;
 }
 
 //-----------------------------------------------------------------------------
@@ -519,7 +532,7 @@ int DataAdaptor::AddArray(vtkDataObject* mesh, const std::string &meshName,
       return -1;
       }
     if ((arrayName != "velocity") && (arrayName != "velocityMagnitude") &&
-      (arrayName != "id"))
+      (arrayName != "pid"))
       {
       SENSEI_ERROR("Invalid particle mesh array \"" << arrayName << "\"")
       return -1;
@@ -538,14 +551,12 @@ int DataAdaptor::AddArray(vtkDataObject* mesh, const std::string &meshName,
     // this code is the same for the Cartesian and unstructured blocks
     // because they both have the same number of cells and are in the
     // same order
+    // blocks are empty when the mesh is a subset
     vtkDataObject *blk = mb->GetBlock(it->first);
     if (!blk)
-      {
-      SENSEI_ERROR("encountered empty block at index " << it->first)
-      return -1;
-      }
+      continue;
 
-    vtkFloatArray *fa = nullptr;
+    vtkDataArray *da = nullptr;
     vtkDataSetAttributes *dsa = nullptr;
 
     if (meshId == BLOCK)
@@ -553,25 +564,63 @@ int DataAdaptor::AddArray(vtkDataObject* mesh, const std::string &meshName,
       dsa = blk->GetAttributes(vtkDataObject::CELL);
       vtkIdType nCells = getBlockNumCells(this->Internals->BlockExtents[it->first]);
 
-      // zero coopy the array
-      fa = vtkFloatArray::New();
-      fa->SetName("data");
-      fa->SetArray(it->second, nCells, 1);
+      // zero copy the array
+      int zeroCopy = 0;
+      da = sensei::VTKUtils::NewAOSArray("data", VTK_FLOAT,
+        it->second, nCells, 1, 0, zeroCopy);
       }
     else
       {
       dsa = blk->GetAttributes(vtkDataObject::POINT);
-      newParticleArray(*this->Internals->ParticleData[it->first], arrayName, fa);
+      const std::vector<Particle> &particles =
+        *this->Internals->ParticleData[it->first];
+
+      if (arrayName == "velocity")
+        {
+        // the particles are stored as an array of structures, the
+        // velocities are strided and have to be gathered
+        int zeroCopy = 0;
+        void *pv = particles.empty() ? nullptr :
+          const_cast<float*>(&particles[0].velocity[0]);
+        da = sensei::VTKUtils::NewAOSArray("velocity", VTK_FLOAT,
+          pv, particles.size(), 3, sizeof(Particle), zeroCopy);
+        }
+      else
+        {
+        vtkFloatArray *fa = nullptr;
+        newParticleArray(particles, arrayName, fa);
+        da = fa;
+        }
       }
 
-    dsa->AddArray(fa);
-    fa->Delete();
+    if (!da)
+      {
+      SENSEI_ERROR("Failed to create array \"" << arrayName << "\"")
+      return -1;
+      }
+
+    dsa->AddArray(da);
+    da->Delete();
     }
 
   return 0;
 }
 
 
+//----------------------------------------------------------------------------
+int DataAdaptor::GetArrayZeroCopy(const std::string &meshName,
+  int association, const std::string &arrayName, int &zeroCopy)
+{
+  (void)association;
+  (void)arrayName;
+
+  // the grid data is passed zero-copy. the particle arrays are computed
+  // from an array of structures and are copied
+  zeroCopy = meshName != "particles";
+
+  return 0;
+}
+
 //----------------------------------------------------------------------------
 int DataAdaptor::AddGhostCellsArray(vtkDataObject *mesh, const std::string &meshName)
 {
@@ -596,12 +645,10 @@ int DataAdaptor::AddGhostCellsArray(vtkDataObject *mesh, const std::string &mesh
     // this code is the same for the Cartesian and unstructured blocks
     // because they both have the same number of cells and are in the
     // same order
+    // blocks are empty when the mesh is a subset
     vtkDataObject *blk = mb->GetBlock(it->first);
     if (!blk)
-      {
-      SENSEI_ERROR("encountered empty block at index " << it->first)
-      return -1;
-      }
+      continue;
 
     vtkDataSetAttributes *dsa = blk->GetAttributes(vtkDataObject::CELL);
 
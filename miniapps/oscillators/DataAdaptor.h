@@ -6,6 +6,7 @@
 #include "Particles.h"
 
 class vtkDataArray;
+class vtkMultiBlockDataSet;
 
 namespace oscillators
 {
@@ -47,9 +48,15 @@ public:
   int GetMesh(const std::string &meshName, bool structureOnly,
     vtkDataObject *&mesh) override;
 
+  int GetMesh(const std::string &meshName, bool structureOnly,
+    const std::vector<int> &blockIds, vtkCompositeDataSet *&mesh) override;
+
   int AddArray(vtkDataObject* mesh, const std::string &meshName,
     int association, const std::string &arrayName) override;
 
+  int GetArrayZeroCopy(const std::string &meshName, int association,
+    const std::string &arrayName, int &zeroCopy) override;
+
   int AddGhostCellsArray(vtkDataObject* mesh, const std::string &meshName) override;
 
   int ReleaseData() override;
@@ -62,6 +69,11 @@ protected:
 
   vtkDataObject* GetParticlesBlock(int gid, bool structureOnly);
 
+  /// Generate the local blocks of the named mesh. When blockIds is not
+  /// null only the listed blocks are generated.
+  vtkMultiBlockDataSet *NewMesh(const std::string &meshName,
+    bool structureOnly, const std::vector<int> *blockIds);
+
 private:
   DataAdaptor(const DataAdaptor&); // not implemented.
   void operator=(const DataAdaptor&); // not implemented.
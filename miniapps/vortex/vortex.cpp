@@ -688,8 +688,10 @@ int main(int argc, char **argv)
     std::string config_file("vortex.xml");
     simulation_data sim;
 
-    // Initialize MPI 
-    MPI_Init(&argc, &argv);
+    // Initialize MPI. SENSEI checks the thread level it got and runs
+    // the analyses synchronously without MPI_THREAD_MULTIPLE
+    int provided = 0;
+    MPI_Init_thread(&argc, &argv, MPI_THREAD_MULTIPLE, &provided);
     MPI_Comm_rank(MPI_COMM_WORLD, &sim.par_rank);
     MPI_Comm_size(MPI_COMM_WORLD, &sim.par_size);
 
@@ -80,6 +80,7 @@ bool ADIOS1AnalysisAdaptor::Execute(DataAdaptor* dataAdaptor)
   flags.SetBlockBounds();
   flags.SetBlockExtents();
   flags.SetBlockArrayRange();
+  flags.SetBlockNode();
 
   MeshMetadataMap mdm;
   if (mdm.Initialize(dataAdaptor, flags))
@@ -141,19 +142,19 @@ bool ADIOS1AnalysisAdaptor::Execute(DataAdaptor* dataAdaptor)
       return false;
       }
 
-    // add the required arrays
+    // add the required arrays, a batch per association
     ArrayRequirementsIterator ait =
       this->Requirements.GetArrayRequirementsIterator(mit.MeshName());
+    ait.SetMode(ArrayRequirementsIterator::MODE_ASSOCIATION);
 
     while (ait)
       {
-      if (dataAdaptor->AddArray(dobj, mit.MeshName(),
-         ait.Association(), ait.Array()))
+      if (dataAdaptor->AddArrays(dobj, mit.MeshName(),
+         ait.Association(), ait.Arrays()))
         {
         SENSEI_ERROR("Failed to add "
           << VTKUtils::GetAttributesName(ait.Association())
-          << " data array \"" << ait.Array() << "\" to mesh \""
-          << mit.MeshName() << "\"")
+          << " data arrays to mesh \"" << mit.MeshName() << "\"")
         return false;
         }
 
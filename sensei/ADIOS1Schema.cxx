@@ -2855,6 +2855,15 @@ int DataObjectCollectionSchema::SetReceiverMeshMetadata(unsigned int id,
   sensei::MeshMetadataPtr &md)
 {
   sensei::TimeEvent<128>("senseiADIOS1::DataObjectCollectionSchema::SetReceiverMeshMetadata");
+
+  // blocks are read whole
+  if (md && !md->BlockSource.empty())
+    {
+    SENSEI_ERROR("The ADIOS1 transport does not read blocks split by the"
+      " receiver. Use the ADIOS2 or HDF5 transport")
+    return -1;
+    }
+
   return this->Internals->ReceiverMdMap.SetMeshMetadata(id, md);
 }
 
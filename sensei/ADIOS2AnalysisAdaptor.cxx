@@ -90,6 +90,7 @@ int ADIOS2AnalysisAdaptor::FetchFromProducer(
   flags.SetBlockBounds();
   flags.SetBlockExtents();
   flags.SetBlockArrayRange();
+  flags.SetBlockNode();
 
   MeshMetadataMap mdm;
   if (mdm.Initialize(dataAdaptor, flags))
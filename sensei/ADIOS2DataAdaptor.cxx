@@ -307,6 +307,30 @@ int ADIOS2DataAdaptor::GetMesh(const std::string &meshName,
   return 0;
 }
 
+//----------------------------------------------------------------------------
+int ADIOS2DataAdaptor::GetMesh(const std::string &meshName,
+   bool structureOnly, const std::vector<int> &blockIds,
+   vtkCompositeDataSet *&mesh)
+{
+  TimeEvent<128> mark("ADIOS2DataAdaptor::GetMesh");
+
+  mesh = nullptr;
+
+  // read only the requested blocks at the current time step. the schema
+  // always creates a composite dataset
+  vtkDataObject *dobj = nullptr;
+  if (this->Internals->Schema.ReadObject(this->GetCommunicator(),
+    this->Internals->Stream, meshName, blockIds, dobj, structureOnly))
+    {
+    SENSEI_ERROR("Failed to read mesh \"" << meshName << "\"")
+    return -1;
+    }
+
+  mesh = static_cast<vtkCompositeDataSet*>(dobj);
+
+  return 0;
+}
+
 //----------------------------------------------------------------------------
 int ADIOS2DataAdaptor::AddGhostNodesArray(vtkDataObject *mesh,
   const std::string &meshName)
@@ -348,6 +372,33 @@ int ADIOS2DataAdaptor::AddArray(vtkDataObject* mesh,
   return 0;
 }
 
+//----------------------------------------------------------------------------
+int ADIOS2DataAdaptor::AddArrays(vtkDataObject* mesh,
+  const std::string &meshName, int association,
+  const std::vector<std::string> &arrayNames)
+{
+  TimeEvent<128> mark("ADIOS2DataAdaptor::AddArrays");
+
+  // the mesh should never be null. there must have been an error
+  // upstream.
+  if (!mesh)
+    {
+    SENSEI_ERROR("Invalid mesh object")
+    return -1;
+    }
+
+  // the reads are deferred and performed together
+  if (this->Internals->Schema.ReadArrays(this->GetCommunicator(),
+    this->Internals->Stream, meshName, association, arrayNames, mesh))
+    {
+    SENSEI_ERROR("Failed to read " << VTKUtils::GetAttributesName(association)
+      << " data arrays from mesh \"" << meshName << "\"")
+    return -1;
+    }
+
+  return 0;
+}
+
 //----------------------------------------------------------------------------
 int ADIOS2DataAdaptor::ReleaseData()
 {
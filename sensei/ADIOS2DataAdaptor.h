@@ -57,12 +57,18 @@ public:
   int GetMesh(const std::string &meshName, bool structure_only,
     vtkDataObject *&mesh) override;
 
+  int GetMesh(const std::string &meshName, bool structure_only,
+    const std::vector<int> &blockIds, vtkCompositeDataSet *&mesh) override;
+
   int AddGhostNodesArray(vtkDataObject* mesh, const std::string &meshName) override;
   int AddGhostCellsArray(vtkDataObject* mesh, const std::string &meshName) override;
 
   int AddArray(vtkDataObject* mesh, const std::string &meshName,
     int association, const std::string &arrayName) override;
 
+  int AddArrays(vtkDataObject* mesh, const std::string &meshName,
+    int association, const std::vector<std::string> &arrayNames) override;
+
   int ReleaseData() override;
 
 protected:
@@ -2,6 +2,7 @@
 #include "MeshMetadataMap.h"
 #include "BinaryStream.h"
 #include "Partitioner.h"
+#include "SubBlockPartitioner.h"
 #include "VTKUtils.h"
 #include "MPIUtils.h"
 #include "Error.h"
@@ -48,6 +49,8 @@
 #include <adios2_c.h>
 
 #include <vector>
+#include <array>
+#include <algorithm>
 #include <map>
 #include <set>
 #include <string>
@@ -919,7 +922,7 @@ struct ArraySchema
     adios2_variable *putVar);
 
   int Read(MPI_Comm comm, AdiosHandle handles, const std::string &ons,
-    const std::string &array_name, int centering,
+    const std::vector<std::string> &array_names, int centering,
     const sensei::MeshMetadataPtr &md, vtkCompositeDataSet *dobj);
 
   int Read(MPI_Comm comm, AdiosHandle handles , const std::string &ons,
@@ -927,7 +930,7 @@ struct ArraySchema
     unsigned long long num_components, int array_cen, unsigned int num_blocks,
     const std::vector<long> &block_num_points,
     const std::vector<long> &block_num_cells, const std::vector<int> &block_owner,
-    vtkCompositeDataSet *dobj);
+    vtkCompositeDataSet *dobj, adios2_mode mode);
 
   std::map<std::string,std::vector<size_t>> PutVarsStart;
   std::map<std::string,std::vector<size_t>> PutVarsCount;
@@ -1195,7 +1198,7 @@ int ArraySchema::Read(MPI_Comm comm, AdiosHandle handles, const std::string &ons
   unsigned long long num_components, int array_cen, unsigned int num_blocks,
   const std::vector<long> &block_num_points,
   const std::vector<long> &block_num_cells, const std::vector<int> &block_owner,
-  vtkCompositeDataSet *dobj)
+  vtkCompositeDataSet *dobj, adios2_mode mode)
 {
   sensei::Profiler::StartEvent("senseiADIOS2::ArraySchema::Read");
   long long numBytes = 0ll;
@@ -1221,8 +1224,9 @@ int ArraySchema::Read(MPI_Comm comm, AdiosHandle handles, const std::string &ons
     unsigned long long num_elem_local = (array_cen == vtkDataObject::POINT ?
       block_num_points[j] : block_num_cells[j])*num_components;
 
-    // define the variable for a local block
-    if (block_owner[j] ==  rank)
+    // define the variable for a local block. blocks are empty when the
+    // mesh is a subset
+    if ((block_owner[j] ==  rank) && it->GetCurrentDataObject())
       {
       adios2_variable *vinfo = adios2_inquire_variable(handles.io, path.c_str());
       if (!vinfo)
@@ -1246,9 +1250,10 @@ int ArraySchema::Read(MPI_Comm comm, AdiosHandle handles, const std::string &ons
       array->SetNumberOfTuples(num_elem_local);
       array->SetName(array_name.c_str());
 
-      // /data_object_<id>/data_array_<id>/data
-      if (adios2_get(handles.engine, vinfo, array->GetVoidPointer(0),
-        adios2_mode_sync))
+      // /data_object_<id>/data_array_<id>/data. when the get is deferred
+      // the array must be kept alive until the gets are performed, this
+      // is taken care of by the reference held by the mesh
+      if (adios2_get(handles.engine, vinfo, array->GetVoidPointer(0), mode))
         {
         SENSEI_ERROR("adios2_get \"" << array_name
           << "\" block " << j << " array " << i << " failed")
@@ -1288,8 +1293,8 @@ int ArraySchema::Read(MPI_Comm comm, AdiosHandle handles, const std::string &ons
 
 // --------------------------------------------------------------------------
 int ArraySchema::Read(MPI_Comm comm, AdiosHandle handles, const std::string &ons,
-  const std::string &name, int centering, const sensei::MeshMetadataPtr &md,
-  vtkCompositeDataSet *dobj)
+  const std::vector<std::string> &names, int centering,
+  const sensei::MeshMetadataPtr &md, vtkCompositeDataSet *dobj)
 {
   sensei::TimeEvent<128> mark("senseiADIOS2::ArraySchema::Read");
 
@@ -1298,30 +1303,50 @@ int ArraySchema::Read(MPI_Comm comm, AdiosHandle handles, const std::string &ons
 
   bool have_ghost_cells = md->NumGhostCells || sensei::VTKUtils::AMR(md);
 
-  // read ghost arrays
-  if (name == "vtkGhostType")
+  // the gets for all of the requested arrays are deferred and then
+  // performed together in a single transport step
+  unsigned int num_names = names.size();
+  for (unsigned int k = 0; k < num_names; ++k)
     {
-    unsigned int i = (centering == vtkDataObject::CELL ?
-      num_arrays : num_arrays + (have_ghost_cells ? 1 : 0));
+    const std::string &name = names[k];
 
-    return this->Read(comm, handles, ons, i, "vtkGhostType",
-      VTK_UNSIGNED_CHAR, 1, centering, num_blocks, md->BlockNumPoints,
-      md->BlockNumCells, md->BlockOwner, dobj);
-    }
+    // read ghost arrays
+    if (name == "vtkGhostType")
+      {
+      unsigned int i = (centering == vtkDataObject::CELL ?
+        num_arrays : num_arrays + (have_ghost_cells ? 1 : 0));
 
-  // read data arrays
-  for (unsigned int i = 0; i < num_arrays; ++i)
-    {
-    const std::string &array_name = md->ArrayName[i];
-    int array_cen = md->ArrayCentering[i];
+      if (this->Read(comm, handles, ons, i, "vtkGhostType",
+        VTK_UNSIGNED_CHAR, 1, centering, num_blocks, md->BlockNumPoints,
+        md->BlockNumCells, md->BlockOwner, dobj, adios2_mode_deferred))
+        return -1;
 
-    // skip all but the requested array
-    if ((centering != array_cen) || (name != array_name))
       continue;
+      }
+
+    // read data arrays
+    for (unsigned int i = 0; i < num_arrays; ++i)
+      {
+      const std::string &array_name = md->ArrayName[i];
+      int array_cen = md->ArrayCentering[i];
+
+      // skip all but the requested array
+      if ((centering != array_cen) || (name != array_name))
+        continue;
+
+      if (this->Read(comm, handles, ons, i, array_name, md->ArrayType[i],
+        md->ArrayComponents[i], array_cen, num_blocks, md->BlockNumPoints,
+        md->BlockNumCells, md->BlockOwner, dobj, adios2_mode_deferred))
+        return -1;
 
-    return this->Read(comm, handles, ons, i, array_name, md->ArrayType[i],
-      md->ArrayComponents[i], array_cen, num_blocks, md->BlockNumPoints,
-      md->BlockNumCells, md->BlockOwner, dobj);
+      break;
+      }
+    }
+
+  if (adios2_perform_gets(handles.engine))
+    {
+    SENSEI_ERROR("adios2_perform_gets failed")
+    return -1;
     }
 
   return 0;
@@ -3330,6 +3355,368 @@ int StretchedCartesianSchema::Read(MPI_Comm comm, AdiosHandle handles,
 
 
 
+// --------------------------------------------------------------------------
+// get the selection start, count of a 1D variable into data
+int getSelection(AdiosHandle handles, const std::string &path, size_t start,
+  size_t count, void *data, adios2_mode mode)
+{
+  adios2_variable *vinfo = adios2_inquire_variable(handles.io, path.c_str());
+  if (!vinfo)
+    {
+    SENSEI_ERROR("ADIOS2 stream is missing \"" << path << "\"")
+    return -1;
+    }
+
+  if (adios2_set_selection(vinfo, 1, &start, &count))
+    {
+    SENSEI_ERROR("adios2_set_selection \"" << path << "\" start=" << start
+      << " count=" << count << " failed")
+    return -1;
+    }
+
+  if (adios2_get(handles.engine, vinfo, data, mode))
+    {
+    SENSEI_ERROR("adios2_get \"" << path << "\" failed")
+    return -1;
+    }
+
+  return 0;
+}
+
+
+
+/// reads blocks that the receiver split into pieces along their slowest
+/// varying axis, see SubBlockPartitioner. the sender writes whole blocks,
+/// the position of each piece in the sender's data is found from the
+/// sender metadata (smd) and the piece's sub-extent in the receiver
+/// metadata (md). each piece is read with a single selection per variable.
+struct SubBlockSchema
+{
+  int ReadMesh(MPI_Comm comm, AdiosHandle handles, const std::string &ons,
+    const sensei::MeshMetadataPtr &md, const sensei::MeshMetadataPtr &smd,
+    vtkCompositeDataSet *dobj, bool structure_only);
+
+  int ReadArrays(MPI_Comm comm, AdiosHandle handles, const std::string &ons,
+    const std::vector<std::string> &names, int centering,
+    const sensei::MeshMetadataPtr &md, const sensei::MeshMetadataPtr &smd,
+    vtkCompositeDataSet *dobj);
+
+  int ReadArray(MPI_Comm comm, AdiosHandle handles, const std::string &ons,
+    unsigned int i, const std::string &array_name, int array_type,
+    unsigned long long num_components, int array_cen,
+    const sensei::MeshMetadataPtr &md, const sensei::MeshMetadataPtr &smd,
+    vtkCompositeDataSet *dobj);
+};
+
+// --------------------------------------------------------------------------
+int SubBlockSchema::ReadMesh(MPI_Comm comm, AdiosHandle handles,
+  const std::string &ons, const sensei::MeshMetadataPtr &md,
+  const sensei::MeshMetadataPtr &smd, vtkCompositeDataSet *dobj,
+  bool structure_only)
+{
+  if (!sensei::VTKUtils::LogicallyCartesian(md))
+    {
+    SENSEI_ERROR("Only logically Cartesian blocks can be split")
+    return -1;
+    }
+
+  sensei::Profiler::StartEvent("senseiADIOS2::SubBlockSchema::ReadMesh");
+  long long numBytes = 0ll;
+
+  int rank = 0;
+  MPI_Comm_rank(comm, &rank);
+
+  // the offset of each sender block in the flattened points and coordinates
+  unsigned int num_src = smd->NumBlocks;
+  std::vector<size_t> pt_offset(num_src + 1, 0);
+  std::vector<std::array<size_t,3>> xc_offset(num_src + 1, {{0, 0, 0}});
+  for (unsigned int p = 0; p < num_src; ++p)
+    {
+    const int *pext = smd->BlockExtents[p].data();
+
+    pt_offset[p + 1] = pt_offset[p] +
+      (sensei::VTKUtils::Structured(smd) ? smd->BlockNumPoints[p] : 0);
+
+    for (int d = 0; d < 3; ++d)
+      xc_offset[p + 1][d] = xc_offset[p][d] + pext[2*d+1] - pext[2*d] + 2;
+    }
+
+  long long cts = size(md->CoordinateType);
+
+  vtkCompositeDataIterator *it = dobj->NewIterator();
+  it->SetSkipEmptyNodes(0);
+  it->InitTraversal();
+
+  unsigned int num_blocks = md->NumBlocks;
+  for (unsigned int j = 0; j < num_blocks; ++j)
+    {
+    vtkDataObject *bobj = it->GetCurrentDataObject();
+    if ((md->BlockOwner[j] == rank) && bobj)
+      {
+      int p = md->BlockSource[j];
+      const int *pext = smd->BlockExtents[p].data();
+      int *ext = md->BlockExtents[j].data();
+
+      switch (md->BlockType)
+        {
+        case VTK_IMAGE_DATA:
+        case VTK_UNIFORM_GRID:
+          {
+          // pieces share the origin and spacing of the block
+          double x0[3] = {0.0};
+          double dx[3] = {0.0};
+          if (getSelection(handles, ons + "origin", 3*p, 3, x0, adios2_mode_sync) ||
+            getSelection(handles, ons + "spacing", 3*p, 3, dx, adios2_mode_sync))
+            {
+            SENSEI_ERROR("Failed to read piece " << j << " of block " << p)
+            return -1;
+            }
+
+          vtkImageData *ds = dynamic_cast<vtkImageData*>(bobj);
+          ds->SetExtent(ext);
+          ds->SetOrigin(x0);
+          ds->SetSpacing(dx);
+
+          numBytes += 6*sizeof(double);
+          }
+          break;
+
+        case VTK_RECTILINEAR_GRID:
+          {
+          // the piece's range of each of the block's coordinate arrays
+          const char *names[3] = {"x_coords", "y_coords", "z_coords"};
+          vtkDataArray *coords[3] = {nullptr};
+          for (int d = 0; d < 3; ++d)
+            {
+            size_t start = xc_offset[p][d] + ext[2*d] - pext[2*d];
+            size_t count = ext[2*d+1] - ext[2*d] + 1;
+
+            coords[d] = vtkDataArray::CreateDataArray(md->CoordinateType);
+            coords[d]->SetNumberOfTuples(count);
+            coords[d]->SetName(names[d]);
+
+            if (getSelection(handles, ons + names[d], start, count,
+              coords[d]->GetVoidPointer(0), adios2_mode_sync))
+              {
+              SENSEI_ERROR("Failed to read piece " << j << " of block " << p)
+              return -1;
+              }
+
+            numBytes += count*cts;
+            }
+
+          vtkRectilinearGrid *ds = dynamic_cast<vtkRectilinearGrid*>(bobj);
+          ds->SetExtent(ext);
+          ds->SetXCoordinates(coords[0]);
+          ds->SetYCoordinates(coords[1]);
+          ds->SetZCoordinates(coords[2]);
+
+          for (int d = 0; d < 3; ++d)
+            coords[d]->Delete();
+          }
+          break;
+
+        case VTK_STRUCTURED_GRID:
+          {
+          vtkStructuredGrid *ds = dynamic_cast<vtkStructuredGrid*>(bobj);
+          ds->SetExtent(ext);
+
+          if (structure_only)
+            break;
+
+          // the piece's slab of the block's points
+          size_t start = 0;
+          size_t count = 0;
+          if (sensei::SubBlockPartitioner::GetSelection(pext, ext, false,
+            start, count))
+            {
+            SENSEI_ERROR("Piece " << j << " of block " << p
+              << " is not a contiguous slab")
+            return -1;
+            }
+
+          vtkDataArray *points = vtkDataArray::CreateDataArray(md->CoordinateType);
+          points->SetNumberOfComponents(3);
+          points->SetNumberOfTuples(count);
+          points->SetName("points");
+
+          if (getSelection(handles, ons + "points", 3*(pt_offset[p] + start),
+            3*count, points->GetVoidPointer(0), adios2_mode_sync))
+            {
+            SENSEI_ERROR("Failed to read piece " << j << " of block " << p)
+            return -1;
+            }
+
+          vtkPoints *pts = vtkPoints::New();
+          pts->SetData(points);
+          points->Delete();
+
+          ds->SetPoints(pts);
+          pts->Delete();
+
+          numBytes += 3*count*cts;
+          }
+          break;
+        }
+      }
+
+    // next block
+    it->GoToNextItem();
+    }
+
+  it->Delete();
+
+  sensei::Profiler::EndEvent("senseiADIOS2::SubBlockSchema::ReadMesh", numBytes);
+  return 0;
+}
+
+// --------------------------------------------------------------------------
+int SubBlockSchema::ReadArray(MPI_Comm comm, AdiosHandle handles,
+  const std::string &ons, unsigned int i, const std::string &array_name,
+  int array_type, unsigned long long num_components, int array_cen,
+  const sensei::MeshMetadataPtr &md, const sensei::MeshMetadataPtr &smd,
+  vtkCompositeDataSet *dobj)
+{
+  sensei::Profiler::StartEvent("senseiADIOS2::SubBlockSchema::ReadArray");
+  long long numBytes = 0ll;
+
+  int rank = 0;
+  MPI_Comm_rank(comm, &rank);
+
+  // /data_object_<id>/data_array_<id>/data
+  std::ostringstream ans;
+  ans << ons << "data_array_" << i << "/data";
+  std::string path = ans.str();
+
+  // the offset of each sender block in the flattened array
+  bool cells = array_cen != vtkDataObject::POINT;
+  const std::vector<long> &block_num_elem = cells ?
+    smd->BlockNumCells : smd->BlockNumPoints;
+
+  unsigned int num_src = smd->NumBlocks;
+  std::vector<unsigned long long> block_offset(num_src + 1, 0);
+  for (unsigned int p = 0; p < num_src; ++p)
+    block_offset[p + 1] = block_offset[p] + block_num_elem[p]*num_components;
+
+  vtkCompositeDataIterator *it = dobj->NewIterator();
+  it->SetSkipEmptyNodes(0);
+  it->InitTraversal();
+
+  unsigned int num_blocks = md->NumBlocks;
+  for (unsigned int j = 0; j < num_blocks; ++j)
+    {
+    vtkDataSet *ds = dynamic_cast<vtkDataSet*>(it->GetCurrentDataObject());
+    if ((md->BlockOwner[j] == rank) && ds)
+      {
+      int p = md->BlockSource[j];
+
+      // the piece's slab of the block's data
+      size_t start = 0;
+      size_t count = 0;
+      if (sensei::SubBlockPartitioner::GetSelection(smd->BlockExtents[p].data(),
+        md->BlockExtents[j].data(), cells, start, count))
+        {
+        SENSEI_ERROR("Piece " << j << " of block " << p
+          << " is not a contiguous slab")
+        return -1;
+        }
+
+      vtkDataArray *array = vtkDataArray::CreateDataArray(array_type);
+      array->SetNumberOfComponents(num_components);
+      array->SetNumberOfTuples(count);
+      array->SetName(array_name.c_str());
+
+      // the get is deferred, the array is kept alive by the mesh until
+      // the gets are performed
+      if (getSelection(handles, path, block_offset[p] + start*num_components,
+        count*num_components, array->GetVoidPointer(0), adios2_mode_deferred))
+        {
+        SENSEI_ERROR("Failed to read \"" << array_name << "\" piece " << j
+          << " of block " << p)
+        return -1;
+        }
+
+      vtkDataSetAttributes *dsa = cells ?
+        dynamic_cast<vtkDataSetAttributes*>(ds->GetCellData()) :
+        dynamic_cast<vtkDataSetAttributes*>(ds->GetPointData());
+
+      dsa->AddArray(array);
+      array->Delete();
+
+      numBytes += count*num_components*size(array_type);
+      }
+
+    // next block
+    it->GoToNextItem();
+    }
+
+  it->Delete();
+
+  sensei::Profiler::EndEvent("senseiADIOS2::SubBlockSchema::ReadArray", numBytes);
+  return 0;
+}
+
+// --------------------------------------------------------------------------
+int SubBlockSchema::ReadArrays(MPI_Comm comm, AdiosHandle handles,
+  const std::string &ons, const std::vector<std::string> &names,
+  int centering, const sensei::MeshMetadataPtr &md,
+  const sensei::MeshMetadataPtr &smd, vtkCompositeDataSet *dobj)
+{
+  sensei::TimeEvent<128> mark("senseiADIOS2::SubBlockSchema::ReadArrays");
+
+  unsigned int num_arrays = md->NumArrays;
+
+  bool have_ghost_cells = md->NumGhostCells || sensei::VTKUtils::AMR(md);
+
+  // the gets for all of the requested arrays are deferred and then
+  // performed together in a single transport step
+  unsigned int num_names = names.size();
+  for (unsigned int k = 0; k < num_names; ++k)
+    {
+    const std::string &name = names[k];
+
+    // read ghost arrays
+    if (name == "vtkGhostType")
+      {
+      unsigned int i = (centering == vtkDataObject::CELL ?
+        num_arrays : num_arrays + (have_ghost_cells ? 1 : 0));
+
+      if (this->ReadArray(comm, handles, ons, i, "vtkGhostType",
+        VTK_UNSIGNED_CHAR, 1, centering, md, smd, dobj))
+        return -1;
+
+      continue;
+      }
+
+    // read data arrays
+    for (unsigned int i = 0; i < num_arrays; ++i)
+      {
+      const std::string &array_name = md->ArrayName[i];
+      int array_cen = md->ArrayCentering[i];
+
+      // skip all but the requested array
+      if ((centering != array_cen) || (name != array_name))
+        continue;
+
+      if (this->ReadArray(comm, handles, ons, i, array_name, md->ArrayType[i],
+        md->ArrayComponents[i], array_cen, md, smd, dobj))
+        return -1;
+
+      break;
+      }
+    }
+
+  if (adios2_perform_gets(handles.engine))
+    {
+    SENSEI_ERROR("adios2_perform_gets failed")
+    return -1;
+    }
+
+  return 0;
+}
+
+
+
 struct DataObjectSchema
 {
   int DefineVariables(MPI_Comm comm, AdiosHandle handles,
@@ -3338,13 +3725,17 @@ struct DataObjectSchema
   int Write(MPI_Comm comm, AdiosHandle handles, unsigned int doid,
     const sensei::MeshMetadataPtr &md, vtkCompositeDataSet *dobj);
 
+  // read the mesh as laid out by the receiver metadata md. smd is the
+  // sender metadata, used when the receiver split the sender's blocks
   int ReadMesh(MPI_Comm comm, AdiosHandle handles,
     unsigned int doid, const sensei::MeshMetadataPtr &md,
-    vtkCompositeDataSet *&dobj, bool structure_only);
+    const sensei::MeshMetadataPtr &smd, vtkCompositeDataSet *&dobj,
+    bool structure_only);
 
-  int ReadArray(MPI_Comm comm, AdiosHandle handles,
-    unsigned int doid, const std::string &name, int association,
-    const sensei::MeshMetadataPtr &md, vtkCompositeDataSet *dobj);
+  int ReadArrays(MPI_Comm comm, AdiosHandle handles,
+    unsigned int doid, const std::vector<std::string> &names, int association,
+    const sensei::MeshMetadataPtr &md, const sensei::MeshMetadataPtr &smd,
+    vtkCompositeDataSet *dobj);
 
   int InitializeDataObject(MPI_Comm comm,
     const sensei::MeshMetadataPtr &md, vtkCompositeDataSet *&dobj);
@@ -3356,6 +3747,7 @@ struct DataObjectSchema
   UniformCartesianSchema UniformCartesian;
   StretchedCartesianSchema StretchedCartesian;
   LogicallyCartesianSchema LogicallyCartesian;
+  SubBlockSchema SubBlocks;
 };
 
 // --------------------------------------------------------------------------
@@ -3410,7 +3802,8 @@ int DataObjectSchema::Write(MPI_Comm comm, AdiosHandle handles, unsigned int doi
 // --------------------------------------------------------------------------
 int DataObjectSchema::ReadMesh(MPI_Comm comm, AdiosHandle handles,
   unsigned int doid, const sensei::MeshMetadataPtr &md,
-  vtkCompositeDataSet *&dobj, bool structure_only)
+  const sensei::MeshMetadataPtr &smd, vtkCompositeDataSet *&dobj,
+  bool structure_only)
 {
   sensei::TimeEvent<128> mark(
     "senseiADIOS2::DataObjectSchema::ReadMesh");
@@ -3426,6 +3819,19 @@ int DataObjectSchema::ReadMesh(MPI_Comm comm, AdiosHandle handles,
   std::ostringstream ons;
   ons << "data_object_" << doid << "/";
 
+  // blocks split by the receiver are read piece by piece
+  if (!md->BlockSource.empty())
+    {
+    if (this->SubBlocks.ReadMesh(comm, handles, ons.str(), md, smd,
+      dobj, structure_only))
+      {
+      SENSEI_ERROR("Failed to read the pieces of object "
+        << doid << " \"" << md->MeshName << "\"")
+      return -1;
+      }
+    return 0;
+    }
+
   if ((!structure_only &&
     (this->Points.Read(comm, handles, ons.str(), md, dobj) ||
     this->UnstructuredCells.Read(comm, handles, ons.str(), md, dobj) ||
@@ -3443,17 +3849,24 @@ int DataObjectSchema::ReadMesh(MPI_Comm comm, AdiosHandle handles,
 }
 
 // --------------------------------------------------------------------------
-int DataObjectSchema::ReadArray(MPI_Comm comm, AdiosHandle handles,
-  unsigned int doid, const std::string &name, int association,
-  const sensei::MeshMetadataPtr &md, vtkCompositeDataSet *dobj)
+int DataObjectSchema::ReadArrays(MPI_Comm comm, AdiosHandle handles,
+  unsigned int doid, const std::vector<std::string> &names, int association,
+  const sensei::MeshMetadataPtr &md, const sensei::MeshMetadataPtr &smd,
+  vtkCompositeDataSet *dobj)
 {
   sensei::TimeEvent<128> mark(
-    "senseiADIOS2::DataObjectSchema::ReadArray");
+    "senseiADIOS2::DataObjectSchema::ReadArrays");
 
   std::ostringstream ons;
   ons << "data_object_" << doid << "/";
 
-  if (this->DataArrays.Read(comm, handles, ons.str(), name, association, md, dobj))
+  // blocks split by the receiver are read piece by piece
+  int ierr = md->BlockSource.empty() ?
+    this->DataArrays.Read(comm, handles, ons.str(), names, association, md, dobj) :
+    this->SubBlocks.ReadArrays(comm, handles, ons.str(), names, association,
+      md, smd, dobj);
+
+  if (ierr)
     {
     SENSEI_ERROR("Failed to define variables for object "
       << doid << " \"" << md->MeshName << "\"")
@@ -3814,9 +4227,75 @@ int DataObjectCollectionSchema::ReadObject(MPI_Comm comm,
     return -1;
     }
 
+  // the sender metadata locates the pieces of blocks split by the receiver
+  sensei::MeshMetadataPtr smd;
+  if (this->Internals->SenderMdMap.GetMeshMetadata(doid, smd))
+    {
+    SENSEI_ERROR("Failed to get sender metadata for  \"" << object_name << "\"")
+    return -1;
+    }
+
   vtkCompositeDataSet *cd = dynamic_cast<vtkCompositeDataSet*>(dobj);
   if (this->Internals->DataObject.ReadMesh(comm,
-    iStream.Handles, doid, md, cd, structure_only))
+    iStream.Handles, doid, md, smd, cd, structure_only))
+    {
+    SENSEI_ERROR("Failed to read object " << doid << " \""
+      << object_name << "\"")
+    return -1;
+    }
+  dobj = cd;
+
+  return 0;
+}
+
+// --------------------------------------------------------------------------
+int DataObjectCollectionSchema::ReadObject(MPI_Comm comm,
+  InputStream &iStream, const std::string &object_name,
+  const std::vector<int> &block_ids, vtkDataObject *&dobj,
+  bool structure_only)
+{
+  sensei::TimeEvent<128> mark(
+    "senseiADIOS2::DataObjectCollectionSchema::ReadObject");
+
+  dobj = nullptr;
+
+  unsigned int doid = 0;
+  if (this->GetObjectId(comm, object_name, doid))
+    {
+    SENSEI_ERROR("Failed to get object id for \"" << object_name << "\"")
+    return -1;
+    }
+
+  sensei::MeshMetadataPtr md;
+  if (this->Internals->ReceiverMdMap.GetMeshMetadata(doid, md))
+    {
+    SENSEI_ERROR("Failed to get metadata for  \"" << object_name << "\"")
+    return -1;
+    }
+
+  // blocks are only created and read on the rank that owns them. reading
+  // with a copy of the metadata in which the blocks that were not
+  // requested have no owner leaves them empty
+  std::set<int> selected(block_ids.begin(), block_ids.end());
+
+  sensei::MeshMetadataPtr smd = md->NewCopy();
+  unsigned int num_blocks = smd->NumBlocks;
+  for (unsigned int j = 0; j < num_blocks; ++j)
+    {
+    if (!selected.count(smd->BlockIds[j]))
+      smd->BlockOwner[j] = -1;
+    }
+
+  sensei::MeshMetadataPtr sender_md;
+  if (this->Internals->SenderMdMap.GetMeshMetadata(doid, sender_md))
+    {
+    SENSEI_ERROR("Failed to get sender metadata for  \"" << object_name << "\"")
+    return -1;
+    }
+
+  vtkCompositeDataSet *cd = nullptr;
+  if (this->Internals->DataObject.ReadMesh(comm,
+    iStream.Handles, doid, smd, sender_md, cd, structure_only))
     {
     SENSEI_ERROR("Failed to read object " << doid << " \""
       << object_name << "\"")
@@ -3831,9 +4310,18 @@ int DataObjectCollectionSchema::ReadObject(MPI_Comm comm,
 int DataObjectCollectionSchema::ReadArray(MPI_Comm comm,
   InputStream &iStream, const std::string &object_name, int association,
   const std::string &array_name, vtkDataObject *dobj)
+{
+  return this->ReadArrays(comm, iStream, object_name, association,
+    std::vector<std::string>(1, array_name), dobj);
+}
+
+// --------------------------------------------------------------------------
+int DataObjectCollectionSchema::ReadArrays(MPI_Comm comm,
+  InputStream &iStream, const std::string &object_name, int association,
+  const std::vector<std::string> &array_names, vtkDataObject *dobj)
 {
   sensei::TimeEvent<128> mark(
-    "senseiADIOS2::DataObjectCollectionSchema::ReadArray");
+    "senseiADIOS2::DataObjectCollectionSchema::ReadArrays");
 
   // convert the mesh name into its id
   unsigned int doid = 0;
@@ -3861,39 +4349,60 @@ int DataObjectCollectionSchema::ReadArray(MPI_Comm comm,
     return -1;
     }
 
-  // handle a special case to let us visualize block owner for debugging
-  if (array_name.rfind("BlockOwner") != std::string::npos)
+  std::vector<std::string> read_names;
+  read_names.reserve(array_names.size());
+
+  unsigned int num_names = array_names.size();
+  for (unsigned int i = 0; i < num_names; ++i)
     {
-    // if not generating owner for the receiver, get the sender metadata
-    sensei::MeshMetadataPtr omd = md;
-    if (array_name.find("Sender") == 0)
+    const std::string &array_name = array_names[i];
+
+    // handle a special case to let us visualize block owner for debugging
+    if (array_name.rfind("BlockOwner") != std::string::npos)
       {
-      if (this->Internals->SenderMdMap.GetMeshMetadata(doid, omd))
+      // if not generating owner for the receiver, get the sender metadata
+      sensei::MeshMetadataPtr omd = md;
+      if (array_name.find("Sender") == 0)
+        {
+        if (this->Internals->SenderMdMap.GetMeshMetadata(doid, omd))
+          {
+          SENSEI_ERROR("Failed to get sender metadata for  \"" << object_name << "\"")
+          return -1;
+          }
+        }
+
+      // add an array filled with BlockOwner, from either sender or receiver
+      // metadata
+      if (this->AddBlockOwnerArray(comm, array_name, association, omd, cds))
         {
-        SENSEI_ERROR("Failed to get sender metadata for  \"" << object_name << "\"")
+        SENSEI_ERROR("Failed to add \"" << array_name << "\"")
         return -1;
         }
-      }
 
-    // add an array filled with BlockOwner, from either sender or receiver
-    // metadata
-    if (this->AddBlockOwnerArray(comm, array_name, association, omd, cds))
-      {
-      SENSEI_ERROR("Failed to add \"" << array_name << "\"")
-      return -1;
+      continue;
       }
 
+    read_names.push_back(array_name);
+    }
+
+  if (read_names.empty())
     return 0;
+
+  // the sender metadata locates the pieces of blocks split by the receiver
+  sensei::MeshMetadataPtr smd;
+  if (this->Internals->SenderMdMap.GetMeshMetadata(doid, smd))
+    {
+    SENSEI_ERROR("Failed to get sender metadata for  \"" << object_name << "\"")
+    return -1;
     }
 
-  // read the array from the stream. this will pull data across the wire
-  if (this->Internals->DataObject.ReadArray(comm,
-    iStream.Handles, doid, array_name, association, md, cds))
+  // read the arrays from the stream. this will pull data across the wire
+  if (this->Internals->DataObject.ReadArrays(comm,
+    iStream.Handles, doid, read_names, association, md, smd, cds))
     {
     SENSEI_ERROR("Failed to read "
       << sensei::VTKUtils::GetAttributesName(association)
-      << " data array \"" << array_name << "\" from object \"" << object_name
-      << "\"")
+      << " data arrays from object \"" << object_name << "\"")
     return -1;
     }
 
@@ -78,11 +78,23 @@ public:
   int ReadObject(MPI_Comm comm, InputStream &iStream, const std::string &name,
     vtkDataObject *&object, bool structure_only);
 
+  // creates the mesh as above but only the listed blocks are created and
+  // read. the others are left empty
+  int ReadObject(MPI_Comm comm, InputStream &iStream, const std::string &name,
+    const std::vector<int> &block_ids, vtkDataObject *&object,
+    bool structure_only);
+
   // read a single array from disk(or stream), store it into the mesh
   int ReadArray(MPI_Comm comm, InputStream &iStream,
     const std::string &object_name, int association,
     const std::string &array_name, vtkDataObject *dobj);
 
+  // read a set of arrays from disk(or stream) in a single transport step,
+  // store them into the mesh
+  int ReadArrays(MPI_Comm comm, InputStream &iStream,
+    const std::string &object_name, int association,
+    const std::vector<std::string> &array_names, vtkDataObject *dobj);
+
   // returns the current time and time step
   int ReadTimeStep(MPI_Comm comm, InputStream &iStream,
     unsigned long &time_step, double &time);
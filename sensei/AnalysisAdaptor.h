@@ -39,6 +39,15 @@ public:
   /// iteration.
   virtual bool Execute(DataAdaptor* data) = 0;
 
+  /// @brief Report if Execute may run concurrently with other analyses.
+  ///
+  /// Analyses that return non-zero may be executed on a thread pool at
+  /// the same time as other analyses, using their own communicator and
+  /// sharing read only access to the simulation data. The default is 0,
+  /// analyses that wrap libraries with global state, or that are not
+  /// otherwise thread safe, are run serially.
+  virtual int GetThreadSafe() { return 0; }
+
   /// @breif Finalize the analyis routine
   ///
   /// This method is called when the run is finsihed clean up
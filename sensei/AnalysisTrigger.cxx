@@ -0,0 +1,88 @@
+#include "AnalysisTrigger.h"
+#include "Error.h"
+
+#include <pugixml.hpp>
+
+#include <algorithm>
+
+namespace sensei
+{
+namespace
+{
+// --------------------------------------------------------------------------
+// reduce value, operation pairs. the operation travels with the value so
+// that one reduction serves all of the triggers
+void reduceValues(void *in, void *inout, int *len, MPI_Datatype *)
+{
+  const double *a = static_cast<double*>(in);
+  double *b = static_cast<double*>(inout);
+
+  int n = *len;
+  for (int i = 0; i < n; ++i, a += 2, b += 2)
+    {
+    switch (int(b[1]))
+      {
+      case TriggerReduction::SUM:
+        b[0] += a[0];
+        break;
+      case TriggerReduction::MIN:
+        b[0] = std::min(a[0], b[0]);
+        break;
+      case TriggerReduction::MAX:
+        b[0] = std::max(a[0], b[0]);
+        break;
+      }
+    }
+}
+}
+
+// --------------------------------------------------------------------------
+unsigned int TriggerReduction::Add(double value, int op)
+{
+  this->Values.push_back(value);
+  this->Values.push_back(op);
+  return this->Values.size()/2 - 1;
+}
+
+// --------------------------------------------------------------------------
+int TriggerReduction::Allreduce(MPI_Comm comm)
+{
+  int n = this->Size();
+  if (n == 0)
+    return 0;
+
+  MPI_Datatype pairType;
+  MPI_Type_contiguous(2, MPI_DOUBLE, &pairType);
+  MPI_Type_commit(&pairType);
+
+  MPI_Op op;
+  MPI_Op_create(reduceValues, 1, &op);
+
+  int ierr = MPI_Allreduce(MPI_IN_PLACE, this->Values.data(), n,
+    pairType, op, comm);
+
+  MPI_Op_free(&op);
+  MPI_Type_free(&pairType);
+
+  if (ierr != MPI_SUCCESS)
+    {
+    SENSEI_ERROR("Failed to reduce the trigger values")
+    return -1;
+    }
+
+  return 0;
+}
+
+//----------------------------------------------------------------------------
+int AnalysisTrigger::Initialize(pugi::xml_node)
+{
+  return 0;
+}
+
+//----------------------------------------------------------------------------
+void AnalysisTrigger::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+}
+
+}
@@ -0,0 +1,85 @@
+#ifndef sensei_AnalysisTrigger_h
+#define sensei_AnalysisTrigger_h
+
+#include "senseiConfig.h"
+#include <vtkObjectBase.h>
+#include <mpi.h>
+#include <vector>
+
+namespace pugi { class xml_node; }
+
+namespace sensei
+{
+class DataAdaptor;
+
+/// @class TriggerReduction
+/// @brief The values contributed by each rank to the evaluation of a set of
+/// triggers.
+///
+/// Each value is reduced with its own operation, and all of the values are
+/// reduced together in a single MPI_Allreduce.
+class TriggerReduction
+{
+public:
+  enum {SUM=0, MIN=1, MAX=2};
+
+  /// @brief Add a value to reduce with the given operation. Returns its
+  /// index, used to get the reduced value.
+  unsigned int Add(double value, int op);
+
+  /// @brief Get the i'th value
+  double Get(unsigned int i) const { return this->Values[2*i]; }
+
+  /// @brief Get the number of values
+  unsigned int Size() const { return this->Values.size()/2; }
+
+  void Clear() { this->Values.clear(); }
+
+  /// @brief Reduce the values in place. This is collective on comm, and
+  /// every rank must have added the same values in the same order.
+  int Allreduce(MPI_Comm comm);
+
+private:
+  std::vector<double> Values; // value, operation pairs
+};
+
+/// @class AnalysisTrigger
+/// @brief AnalysisTrigger is an abstract base class for cheap data driven
+/// conditions that gate the execution of an analysis.
+///
+/// A trigger is evaluated in two phases. In AddLocalValues each rank adds
+/// the values it contributes, for instance the range of an array over its
+/// blocks, to a TriggerReduction shared by all of the triggers. After the
+/// values have been reduced Evaluate decides if the trigger fires from
+/// the global values. Evaluate sees the same values on every rank and
+/// must make the same decision everywhere.
+class AnalysisTrigger : public vtkObjectBase
+{
+public:
+  senseiBaseTypeMacro(AnalysisTrigger, vtkObjectBase);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /// @brief Configure the trigger from its XML element. The default does
+  /// nothing.
+  virtual int Initialize(pugi::xml_node node);
+
+  /// @brief Add the values contributed by this rank. Called on all ranks
+  /// each step.
+  virtual int AddLocalValues(DataAdaptor *data, TriggerReduction &values) = 0;
+
+  /// @brief Decide if the trigger fires from the reduced values.
+  virtual int Evaluate(const TriggerReduction &values, bool &fire) = 0;
+
+  /// @brief Clean up at the end of the run. The default does nothing.
+  virtual int Finalize() { return 0; }
+
+protected:
+  AnalysisTrigger() {}
+  ~AnalysisTrigger() {}
+
+  AnalysisTrigger(const AnalysisTrigger&) = delete;
+  void operator=(const AnalysisTrigger&) = delete;
+};
+
+}
+#endif
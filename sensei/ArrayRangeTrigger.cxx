@@ -0,0 +1,245 @@
+#include "ArrayRangeTrigger.h"
+#include "DataAdaptor.h"
+#include "MeshMetadata.h"
+#include "MeshMetadataMap.h"
+#include "VTKUtils.h"
+#include "XMLUtils.h"
+#include "Error.h"
+
+#include <vtkCompositeDataIterator.h>
+#include <vtkCompositeDataSet.h>
+#include <vtkDataArray.h>
+#include <vtkDataSet.h>
+#include <vtkFieldData.h>
+#include <vtkObjectFactory.h>
+#include <vtkSmartPointer.h>
+
+#include <pugixml.hpp>
+
+#include <algorithm>
+#include <limits>
+
+namespace sensei
+{
+
+//----------------------------------------------------------------------------
+senseiNewMacro(ArrayRangeTrigger);
+
+//----------------------------------------------------------------------------
+ArrayRangeTrigger::ArrayRangeTrigger() : Association(vtkDataObject::POINT),
+  HaveAbove(false), HaveBelow(false), Above(0.0), Below(0.0), Level(0),
+  Active(false), Index(0), Range{0.0, 0.0}
+{
+}
+
+//----------------------------------------------------------------------------
+void ArrayRangeTrigger::SetArray(const std::string &meshName,
+  int association, const std::string &arrayName)
+{
+  this->MeshName = meshName;
+  this->Association = association;
+  this->ArrayName = arrayName;
+}
+
+//----------------------------------------------------------------------------
+void ArrayRangeTrigger::SetAbove(double val)
+{
+  this->HaveAbove = true;
+  this->Above = val;
+}
+
+//----------------------------------------------------------------------------
+void ArrayRangeTrigger::SetBelow(double val)
+{
+  this->HaveBelow = true;
+  this->Below = val;
+}
+
+//----------------------------------------------------------------------------
+void ArrayRangeTrigger::SetLevel(int val)
+{
+  this->Level = val;
+}
+
+//----------------------------------------------------------------------------
+void ArrayRangeTrigger::GetRange(double range[2]) const
+{
+  range[0] = this->Range[0];
+  range[1] = this->Range[1];
+}
+
+//----------------------------------------------------------------------------
+int ArrayRangeTrigger::Initialize(pugi::xml_node node)
+{
+  if (XMLUtils::RequireAttribute(node, "mesh") ||
+    XMLUtils::RequireAttribute(node, "array"))
+    {
+    SENSEI_ERROR("Failed to initialize ArrayRangeTrigger")
+    return -1;
+    }
+
+  int association = 0;
+  std::string assocStr = node.attribute("association").as_string("point");
+  if (VTKUtils::GetAssociation(assocStr, association))
+    {
+    SENSEI_ERROR("Failed to initialize ArrayRangeTrigger")
+    return -1;
+    }
+
+  this->SetArray(node.attribute("mesh").value(), association,
+    node.attribute("array").value());
+
+  if (node.attribute("above"))
+    this->SetAbove(node.attribute("above").as_double());
+
+  if (node.attribute("below"))
+    this->SetBelow(node.attribute("below").as_double());
+
+  if (!this->HaveAbove && !this->HaveBelow)
+    {
+    SENSEI_ERROR("ArrayRangeTrigger needs an above and/or below threshold")
+    return -1;
+    }
+
+  std::string mode = node.attribute("mode").as_string("crossing");
+  if ((mode != "crossing") && (mode != "level"))
+    {
+    SENSEI_ERROR("Invalid mode \"" << mode << "\". The mode is crossing or level")
+    return -1;
+    }
+
+  this->SetLevel(mode == "level");
+
+  return 0;
+}
+
+//----------------------------------------------------------------------------
+int ArrayRangeTrigger::GetLocalRange(DataAdaptor *data, double range[2])
+{
+  range[0] = std::numeric_limits<double>::max();
+  range[1] = std::numeric_limits<double>::lowest();
+
+  MeshMetadataFlags flags;
+  flags.SetBlockDecomp();
+  flags.SetBlockArrayRange();
+
+  MeshMetadataMap mdm;
+  MeshMetadataPtr md;
+  if (mdm.Initialize(data, flags) || mdm.GetMeshMetadata(this->MeshName, md))
+    {
+    SENSEI_ERROR("Failed to get metadata for mesh \"" << this->MeshName << "\"")
+    return -1;
+    }
+
+  int ai = -1;
+  for (int i = 0; (ai < 0) && (i < md->NumArrays); ++i)
+    {
+    if ((md->ArrayName[i] == this->ArrayName) &&
+      (md->ArrayCentering[i] == this->Association))
+      ai = i;
+    }
+
+  if (ai < 0)
+    {
+    SENSEI_ERROR("Mesh \"" << this->MeshName << "\" has no "
+      << VTKUtils::GetAttributesName(this->Association) << " data array \""
+      << this->ArrayName << "\"")
+    return -1;
+    }
+
+  // use the ranges in the metadata when the adaptor provides them
+  unsigned int nBlocks = md->BlockOwner.size();
+  bool haveRanges = md->BlockArrayRange.size() == nBlocks;
+  for (unsigned int i = 0; haveRanges && (i < nBlocks); ++i)
+    haveRanges = int(md->BlockArrayRange[i].size()) > ai;
+
+  if (haveRanges)
+    {
+    int rank = 0;
+    MPI_Comm_rank(data->GetCommunicator(), &rank);
+
+    for (unsigned int i = 0; i < nBlocks; ++i)
+      {
+      if (md->BlockOwner[i] != rank)
+        continue;
+
+      const std::array<double,2> &rng = md->BlockArrayRange[i][ai];
+      range[0] = std::min(range[0], rng[0]);
+      range[1] = std::max(range[1], rng[1]);
+      }
+
+    return 0;
+    }
+
+  // otherwise compute them
+  vtkCompositeDataSet *cd = nullptr;
+  if (data->GetMesh(this->MeshName, true, cd))
+    {
+    SENSEI_ERROR("Failed to get mesh \"" << this->MeshName << "\"")
+    return -1;
+    }
+
+  vtkSmartPointer<vtkCompositeDataSet> mesh;
+  mesh.TakeReference(cd);
+
+  if (data->AddArray(cd, this->MeshName, this->Association, this->ArrayName))
+    {
+    SENSEI_ERROR("Failed to add " << VTKUtils::GetAttributesName(this->Association)
+      << " data array \"" << this->ArrayName << "\" to mesh \""
+      << this->MeshName << "\"")
+    return -1;
+    }
+
+  vtkSmartPointer<vtkCompositeDataIterator> it;
+  it.TakeReference(cd->NewIterator());
+  for (it->InitTraversal(); !it->IsDoneWithTraversal(); it->GoToNextItem())
+    {
+    vtkDataSet *ds = dynamic_cast<vtkDataSet*>(it->GetCurrentDataObject());
+    vtkFieldData *atts = ds ? VTKUtils::GetAttributes(ds, this->Association) : nullptr;
+    vtkDataArray *da = atts ? atts->GetArray(this->ArrayName.c_str()) : nullptr;
+    if (!da || (da->GetNumberOfTuples() == 0))
+      continue;
+
+    double rng[2];
+    da->GetRange(rng, 0);
+
+    range[0] = std::min(range[0], rng[0]);
+    range[1] = std::max(range[1], rng[1]);
+    }
+
+  return 0;
+}
+
+//----------------------------------------------------------------------------
+int ArrayRangeTrigger::AddLocalValues(DataAdaptor *data,
+  TriggerReduction &values)
+{
+  double range[2];
+  if (this->GetLocalRange(data, range))
+    return -1;
+
+  this->Index = values.Add(range[0], TriggerReduction::MIN);
+  values.Add(range[1], TriggerReduction::MAX);
+
+  return 0;
+}
+
+//----------------------------------------------------------------------------
+int ArrayRangeTrigger::Evaluate(const TriggerReduction &values, bool &fire)
+{
+  this->Range[0] = values.Get(this->Index);
+  this->Range[1] = values.Get(this->Index + 1);
+
+  // an empty range never satisfies the condition
+  bool active = this->Range[0] <= this->Range[1] &&
+    ((this->HaveAbove && (this->Range[1] > this->Above)) ||
+    (this->HaveBelow && (this->Range[0] < this->Below)));
+
+  fire = active && (this->Level || !this->Active);
+
+  this->Active = active;
+
+  return 0;
+}
+
+}
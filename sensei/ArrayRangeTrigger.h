@@ -0,0 +1,79 @@
+#ifndef sensei_ArrayRangeTrigger_h
+#define sensei_ArrayRangeTrigger_h
+
+#include "AnalysisTrigger.h"
+
+#include <string>
+
+namespace sensei
+{
+
+/// @class ArrayRangeTrigger
+/// @brief Fires when the global range of an array crosses a threshold.
+///
+/// The trigger fires when the global maximum of the array is above a
+/// threshold and/or its global minimum is below another. By default it
+/// fires only on the step where the condition becomes true, set the mode
+/// to level to fire on every step where it holds.
+///
+/// The range of the local blocks is taken from the mesh metadata
+/// (MeshMetadataFlags::SetBlockArrayRange), which VTK based adaptors
+/// compute from the first component of the array. When the data adaptor
+/// does not provide it the array is fetched and its range computed. The
+/// XML is of the form:
+///
+///   <trigger type="range" mesh="mesh" array="data" association="cell"
+///     above="0.9" below="-0.9" mode="crossing"/>
+class ArrayRangeTrigger : public AnalysisTrigger
+{
+public:
+  static ArrayRangeTrigger *New();
+  senseiTypeMacro(ArrayRangeTrigger, AnalysisTrigger);
+
+  /// @brief Set the array whose range is tested
+  void SetArray(const std::string &meshName, int association,
+    const std::string &arrayName);
+
+  /// @brief Fire when the global maximum is greater than the value
+  void SetAbove(double val);
+
+  /// @brief Fire when the global minimum is less than the value
+  void SetBelow(double val);
+
+  /// @brief When set, fire on every step the condition holds rather than
+  /// only on the step it becomes true.
+  void SetLevel(int val);
+
+  /// @brief Get the global range reduced during the last evaluation
+  void GetRange(double range[2]) const;
+
+  int Initialize(pugi::xml_node node) override;
+  int AddLocalValues(DataAdaptor *data, TriggerReduction &values) override;
+  int Evaluate(const TriggerReduction &values, bool &fire) override;
+
+protected:
+  ArrayRangeTrigger();
+  ~ArrayRangeTrigger() {}
+
+  ArrayRangeTrigger(const ArrayRangeTrigger&) = delete;
+  void operator=(const ArrayRangeTrigger&) = delete;
+
+  // compute the range of the local blocks
+  int GetLocalRange(DataAdaptor *data, double range[2]);
+
+private:
+  std::string MeshName;
+  std::string ArrayName;
+  int Association;
+  bool HaveAbove;
+  bool HaveBelow;
+  double Above;
+  double Below;
+  int Level;
+  bool Active;
+  unsigned int Index;
+  double Range[2];
+};
+
+}
+#endif
@@ -5,29 +5,37 @@
 #include "MeshMetadataMap.h"
 #include "VTKUtils.h"
 #include "Profiler.h"
+#include "TopK.h"
 #include "Error.h"
 
 // VTK includes
 #include <vtkCompositeDataIterator.h>
-#include <vtkCellData.h>
+#include <vtkDataSetAttributes.h>
 #include <vtkFieldData.h>
-#include <vtkFloatArray.h>
 #include <vtkImageData.h>
 #include <vtkMultiBlockDataSet.h>
 #include <vtkObjectFactory.h>
 #include <vtkSmartPointer.h>
 #include <vtkStructuredData.h>
 #include <vtkUnsignedCharArray.h>
+#ifdef ENABLE_VTK_GENERIC_ARRAYS
+#include <vtkAOSDataArrayTemplate.h>
+#include <vtkArrayDispatch.h>
+#else
+#include <vtkDataArrayDispatcher.h>
+#endif
 
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <errno.h>
+#include <iostream>
 #include <memory>
 #include <vector>
 
 #include <sdiy/master.hpp>
-#include <sdiy/reduce.hpp>
-#include <sdiy/partners/merge.hpp>
-#include <sdiy/io/numpy.hpp>
-#include <sdiy/grid.hpp>
-#include <sdiy/vertices.hpp>
+#include <sdiy/point.hpp>
 
 
 // http://stackoverflow.com/a/12580468
@@ -37,94 +45,208 @@ std::unique_ptr<T> make_unique(Args&& ...args)
   return std::unique_ptr<T>(new T(std::forward<Args>(args)...));
 }
 
-template<class T>
-struct add_vectors
+namespace sensei
+{
+
+using Vertex  = sdiy::Point<int,3>;
+
+namespace
+{
+// conversions between float and IEEE half precision, rounding to nearest
+// even. half precision has 11 significant bits and a max of 65504, larger
+// values become inf.
+inline uint32_t asBits(float f)
+{
+  uint32_t u;
+  memcpy(&u, &f, sizeof(u));
+  return u;
+}
+
+inline float asFloat(uint32_t u)
+{
+  float f;
+  memcpy(&f, &u, sizeof(f));
+  return f;
+}
+
+inline uint16_t floatToHalf(float ff)
 {
-    using Vector = std::vector<T>;
-    Vector  operator()(const Vector& lhs, const Vector& rhs) const
+  const uint32_t f32infty = 255u << 23;
+  const uint32_t f16max = (127u + 16u) << 23;
+  const float denormMagic = asFloat(((127u - 15u) + (23u - 10u) + 1u) << 23);
+
+  uint32_t f = asBits(ff);
+  uint32_t sign = f & 0x80000000u;
+  f ^= sign;
+
+  uint16_t o = 0;
+  if (f >= f16max)
     {
-      Vector res(lhs.size(), 0);
-      for (size_t i = 0; i < lhs.size(); ++i)
-        res[i] = lhs[i] + rhs[i];
-      return res;
+    // inf or nan
+    o = (f > f32infty) ? 0x7e00 : 0x7c00;
+    }
+  else if (f < (113u << 23))
+    {
+    // denormal, the addition does the rounding
+    o = asBits(asFloat(f) + denormMagic) - asBits(denormMagic);
+    }
+  else
+    {
+    uint32_t mantOdd = (f >> 13) & 1u;
+    f += (uint32_t(15 - 127) << 23) + 0xfffu;
+    f += mantOdd;
+    o = f >> 13;
     }
-};
 
-namespace sdiy { namespace mpi { namespace detail {
-template<class U> struct mpi_op<add_vectors<U>>
-{
-  static MPI_Op get()
-  { return MPI_SUM; }
-};
-}}}
+  return o | (sign >> 16);
+}
 
-namespace sensei
+inline float halfToFloat(uint16_t h)
 {
+  const uint32_t shiftedExp = 0x7c00u << 13;
+  const float magic = asFloat(113u << 23);
 
-using GridRef = sdiy::GridRef<float,3>;
-using Vertex  = GridRef::Vertex;
-using Vertex4D = Vertex::UPoint;
+  uint32_t o = uint32_t(h & 0x7fffu) << 13;
+  uint32_t exp = shiftedExp & o;
+  o += (127u - 15u) << 23;
 
+  if (exp == shiftedExp)
+    {
+    // inf or nan
+    o += (128u - 16u) << 23;
+    }
+  else if (exp == 0)
+    {
+    // zero or denormal
+    o += 1u << 23;
+    o = asBits(asFloat(o) - magic);
+    }
+
+  return asFloat(o | (uint32_t(h & 0x8000u) << 16));
+}
+}
+
+// The correlation state of one block. The history of the last window
+// values and the correlation sums are stored shift major, each shift is a
+// contiguous array over the block's values, so that a step's update is a
+// sequence of unit stride multiply adds. The history may be stored in half
+// precision, and the block may be sampled every stride'th value in each
+// direction, to reduce the memory footprint.
 struct AutocorrelationImpl
 {
-  using Grid = sdiy::Grid<float,4>;
-  AutocorrelationImpl(size_t window_, int gid_, Vertex from_, Vertex to_):
+  AutocorrelationImpl(size_t window_, int gid_, Vertex from_, Vertex to_,
+    int stride_, bool half_):
     window(window_),
     gid(gid_),
     from(from_), to(to_),
-    shape(to - from + Vertex::one()),
-    // init grid with (to - from + 1) in 3D, and window in the 4-th dimension
-    values(shape.lift(3, window)),
-    corr(shape.lift(3, window))
-  { corr = 0; }
+    extent(to - from + Vertex::one()),
+    stride(stride_),
+    half(half_)
+    {
+    size = 1;
+    for (int i = 0; i < 3; ++i)
+      {
+      shape[i] = (extent[i] + stride - 1)/stride;
+      size *= shape[i];
+      }
+
+    if (half)
+      halfValues.resize(window*size);
+    else
+      values.resize(window*size);
+
+    corr.assign(window*size, 0.0f);
+    current.resize(size);
+    }
 
   static void* create()            { return new AutocorrelationImpl; }
   static void destroy(void* b)    { delete static_cast<AutocorrelationImpl*>(b); }
-  void process(float* data, unsigned char *ghostArray)
+
+  // the number of values in the block's data
+  size_t dataSize() const
+    { return size_t(extent[0])*extent[1]*extent[2]; }
+
+  // the grid location of the i'th sampled value
+  Vertex location(size_t i) const
     {
-    GridRef g(data, shape);
+    size_t nxy = size_t(shape[0])*shape[1];
+    Vertex v { int(i % shape[0]), int((i / shape[0]) % shape[1]), int(i / nxy) };
+    v *= stride;
+    v += from;
+    return v;
+    }
 
-    if (ghostArray)
+  // copy the sampled values into current, ghosts are zeroed
+  template <typename T>
+  void gather(const T *data, const unsigned char *ghosts)
+    {
+    size_t nx = extent[0];
+    size_t nxy = nx*extent[1];
+    float *cur = current.data();
+    for (int k = 0; k < shape[2]; ++k)
       {
-      sdiy::GridRef<unsigned char, 3> ghost(ghostArray, shape);
-      // record the values
-      sdiy::for_each(g.shape(), [&](const Vertex& v)
+      for (int j = 0; j < shape[1]; ++j)
         {
-        auto gv = (ghost(v) == 0) ? g(v) : 0;
-
-        for (size_t i = 1; i <= window; ++i)
-        {
-        if (i > count) continue;    // during the initial fill, we don't get contributions to some shifts
-
-        auto uc = v.lift(3, i-1);
-        auto uv = v.lift(3, (offset + window - i) % window);
-        corr(uc) += values(uv)*gv;
+        size_t src = k*stride*nxy + j*stride*nx;
+        if (ghosts)
+          {
+          for (int i = 0; i < shape[0]; ++i, src += stride)
+            *cur++ = ghosts[src] ? 0.0f : static_cast<float>(data[src]);
+          }
+        else
+          {
+          for (int i = 0; i < shape[0]; ++i, src += stride)
+            *cur++ = static_cast<float>(data[src]);
+          }
         }
-
-        auto u = v.lift(3, offset);
-        values(u) = gv;
-        });
       }
-    else
+    }
+
+  // correlate current with the history and record it. the values are
+  // processed in chunks that stay in cache across the shifts
+  void process()
+    {
+    const size_t chunk = 4096;
+    size_t nShifts = std::min(count, window);
+    const float *x = current.data();
+
+    for (size_t i0 = 0; i0 < size; i0 += chunk)
       {
-      // record the values
-      sdiy::for_each(g.shape(), [&](const Vertex& v)
-        {
-        auto gv = g(v);
+      size_t n = std::min(chunk, size - i0);
+      const float *xc = x + i0;
 
-        for (size_t i = 1; i <= window; ++i)
+      // during the initial fill, we don't get contributions to some shifts
+      for (size_t s = 1; s <= nShifts; ++s)
         {
-        if (i > count) continue;    // during the initial fill, we don't get contributions to some shifts
-
-        auto uc = v.lift(3, i-1);
-        auto uv = v.lift(3, (offset + window - i) % window);
-        corr(uc) += values(uv)*gv;
+        size_t slot = (offset + window - s) % window;
+        float *c = corr.data() + (s - 1)*size + i0;
+        if (half)
+          {
+          const uint16_t *v = halfValues.data() + slot*size + i0;
+          for (size_t i = 0; i < n; ++i)
+            c[i] += halfToFloat(v[i])*xc[i];
+          }
+        else
+          {
+          const float *v = values.data() + slot*size + i0;
+          for (size_t i = 0; i < n; ++i)
+            c[i] += v[i]*xc[i];
+          }
         }
+      }
 
-        auto u = v.lift(3, offset);
-        values(u) = gv;
-        });
+    // record the values
+    if (half)
+      {
+      uint16_t *v = halfValues.data() + offset*size;
+      for (size_t i = 0; i < size; ++i)
+        v[i] = floatToHalf(x[i]);
+      }
+    else
+      {
+      std::copy(x, x + size, values.data() + offset*size);
       }
+
     offset += 1;
     offset %= window;
 
@@ -133,9 +255,17 @@ struct AutocorrelationImpl
 
   size_t          window;
   int             gid;
-  Vertex          from, to, shape;
-  Grid            values;     // circular buffer of last `window` values
-  Grid            corr;       // autocorrelations for different time shifts
+  Vertex          from, to;
+  Vertex          extent;     // the size of the block's data
+  Vertex          shape;      // the size of the sampled grid
+  int             stride = 1;
+  bool            half = false;
+  size_t          size = 0;   // the number of sampled values
+
+  std::vector<float>    values;      // circular buffer of last `window` values
+  std::vector<uint16_t> halfValues;  // the same, in half precision
+  std::vector<float>    corr;        // autocorrelations for different time shifts
+  std::vector<float>    current;     // the sampled values of this step
 
   size_t          offset = 0;
   size_t          count  = 0;
@@ -144,6 +274,43 @@ private:
   AutocorrelationImpl() {}        // here just for create; to let Master manage the blocks (+ if we choose to add OOC later)
 };
 
+namespace
+{
+// Samples a scalar array into a block's current values. To be used with
+// vtkArrayDispatch or vtkDataArrayDispatcher.
+struct GatherWorker
+{
+  AutocorrelationImpl *Block;
+  const unsigned char *Ghosts;
+
+#ifdef ENABLE_VTK_GENERIC_ARRAYS
+  template <typename T>
+  void operator()(vtkAOSDataArrayTemplate<T> *array)
+  {
+    this->Block->gather(array->GetPointer(0), this->Ghosts);
+  }
+
+  // arrays with other memory layouts are copied first
+  template <typename ArrayT>
+  void operator()(ArrayT *array)
+  {
+    using T = typename ArrayT::ValueType;
+    vtkIdType n = array->GetNumberOfTuples();
+    std::vector<T> tmp(n);
+    for (vtkIdType i = 0; i < n; ++i)
+      tmp[i] = array->GetTypedComponent(i, 0);
+    this->Block->gather(tmp.data(), this->Ghosts);
+  }
+#else
+  template <typename T>
+  void operator()(const vtkDataArrayDispatcherPointer<T>& array)
+  {
+    this->Block->gather(array.RawPointer, this->Ghosts);
+  }
+#endif
+};
+}
+
 //-----------------------------------------------------------------------------
 class Autocorrelation::AInternals
 {
@@ -154,19 +321,33 @@ public:
   int Association;
   std::string ArrayName;
   size_t Window;
+  unsigned int NumThreads;
+  int Stride;
+  bool HalfPrecision;
   bool BlocksInitialized;
   size_t NumberOfBlocks;
+  std::string OutputFileName;
+  int Interval;
+  long StepCount;
+  long LastStep;
+  double LastTime;
+  bool ResultsCurrent;
+  int StepFailed;
 
   AInternals() : KMax(3), Association(vtkDataObject::POINT),
-    Window(10), BlocksInitialized(false), NumberOfBlocks(0) {}
-
-  void InitializeBlocks(vtkDataObject* dobj)
+    Window(10), NumThreads(1), Stride(1), HalfPrecision(false),
+    BlocksInitialized(false), NumberOfBlocks(0), Interval(0),
+    StepCount(0), LastStep(0), LastTime(0.0), ResultsCurrent(false),
+    StepFailed(0) {}
+
+  // add the block for a dataset. image data is treated as a grid with
+  // the dataset's extent, other datasets as a 1D grid of their points or
+  // cells
+  void AddBlock(int bid, vtkDataSet *ds)
     {
-    if (this->BlocksInitialized)
-      {
-      return;
-      }
-    if (vtkImageData* img = vtkImageData::SafeDownCast(dobj))
+    Vertex from;
+    Vertex to;
+    if (vtkImageData* img = vtkImageData::SafeDownCast(ds))
       {
       int ext[6];
       img->GetExtent(ext);
@@ -178,44 +359,41 @@ public:
         vtkStructuredData::GetCellExtentFromPointExtent(ext, ext);
 #endif
         }
-      Vertex from { ext[0], ext[2], ext[4] };
-      Vertex to   { ext[1], ext[3], ext[5] };
-      int bid = this->Master->communicator().rank();
-      AutocorrelationImpl* b = new AutocorrelationImpl(this->Window, bid, from, to);
-      this->Master->add(bid, b, new sdiy::Link);
-      this->NumberOfBlocks = this->Master->communicator().size();
+      from = Vertex { ext[0], ext[2], ext[4] };
+      to = Vertex { ext[1], ext[3], ext[5] };
       }
-    else if (vtkCompositeDataSet* cd = vtkCompositeDataSet::SafeDownCast(dobj))
+    else
       {
-      // add blocks
-      vtkSmartPointer<vtkCompositeDataIterator> iter;
-      iter.TakeReference(cd->NewIterator());
-      iter->SkipEmptyNodesOff();
+      vtkIdType n = this->Association == vtkDataObject::CELL ?
+        ds->GetNumberOfCells() : ds->GetNumberOfPoints();
+      to = Vertex { int(n) - 1, 0, 0 };
+      }
 
-      int bid = 0;
-      for (iter->InitTraversal(); !iter->IsDoneWithTraversal(); iter->GoToNextItem(), ++bid)
-        {
-        if (vtkImageData* id = vtkImageData::SafeDownCast(iter->GetCurrentDataObject()))
-          {
-          int ext[6];
-          id->GetExtent(ext);
-          if (this->Association == vtkDataObject::CELL)
-            {
-#if VTK_MAJOR_VERSION == 6 && VTK_MINOR_VERSION == 1
-            vtkStructuredData::GetCellExtentFromNodeExtent(ext, ext);
-#else
-            vtkStructuredData::GetCellExtentFromPointExtent(ext, ext);
-#endif
-            }
-          Vertex from { ext[0], ext[2], ext[4] };
-          Vertex to   { ext[1], ext[3], ext[5] };
+    AutocorrelationImpl* b = new AutocorrelationImpl(this->Window, bid,
+      from, to, this->Stride, this->HalfPrecision);
 
-          AutocorrelationImpl* b = new AutocorrelationImpl(this->Window, bid, from, to);
-          this->Master->add(bid, b, new sdiy::Link);
-          }
-        }
-      this->NumberOfBlocks = bid;
+    this->Master->add(bid, b, new sdiy::Link);
+    }
+
+  void InitializeBlocks(vtkCompositeDataSet* cd, size_t nBlocks)
+    {
+    if (this->BlocksInitialized)
+      {
+      return;
       }
+
+    // a lone dataset is the rank'th block, block ids match ParallelApply's
+    // flat indices
+    vtkSmartPointer<vtkCompositeDataIterator> iter;
+    iter.TakeReference(cd->NewIterator());
+
+    for (iter->InitTraversal(); !iter->IsDoneWithTraversal(); iter->GoToNextItem())
+      {
+      if (vtkDataSet* ds = vtkDataSet::SafeDownCast(iter->GetCurrentDataObject()))
+        this->AddBlock(iter->GetCurrentFlatIndex() - 1, ds);
+      }
+
+    this->NumberOfBlocks = nBlocks;
     this->BlocksInitialized = true;
     }
 };
@@ -237,20 +415,27 @@ Autocorrelation::~Autocorrelation()
 
 //-----------------------------------------------------------------------------
 void Autocorrelation::Initialize(size_t window, const std::string &meshName,
-  int association, const std::string &arrayname, size_t kmax, int numThreads)
+  int association, const std::string &arrayname, size_t kmax, int numThreads,
+  int stride, bool halfPrecision)
 {
   TimeEvent<128> mark("Autocorrelation::Initialize");
 
   AInternals& internals = (*this->Internals);
 
+  internals.NumThreads = numThreads > 0 ? numThreads :
+    VTKUtils::GetNumberOfThreads();
+
   internals.Master = make_unique<sdiy::Master>(this->GetCommunicator(),
-    numThreads, -1, &AutocorrelationImpl::create, &AutocorrelationImpl::destroy);
+    internals.NumThreads, -1, &AutocorrelationImpl::create,
+    &AutocorrelationImpl::destroy);
 
   internals.MeshName = meshName;
   internals.Association = association;
   internals.ArrayName = arrayname;
-  internals.Window = window;
+  internals.Window = std::max(window, size_t(1));
   internals.KMax = kmax;
+  internals.Stride = std::max(stride, 1);
+  internals.HalfPrecision = halfPrecision;
 }
 
 //-----------------------------------------------------------------------------
@@ -260,11 +445,31 @@ bool Autocorrelation::Execute(DataAdaptor* dataAdaptor)
 
   AInternals& internals = (*this->Internals);
 
+  // all ranks count the step and take part in the reductions at the
+  // interval, including those that failed, otherwise the others would
+  // wait for them in the reductions forever. the failure is passed on
+  // through the reductions
+  auto endStep = [&](int failed) -> int
+    {
+    internals.LastStep = dataAdaptor->GetDataTimeStep();
+    internals.LastTime = dataAdaptor->GetDataTime();
+    internals.StepCount += 1;
+    internals.ResultsCurrent = false;
+    internals.StepFailed |= failed;
+
+    if ((internals.Interval > 0) &&
+      ((internals.StepCount % internals.Interval) == 0))
+      return this->WriteResults(internals.LastStep, internals.LastTime);
+
+    return failed ? -1 : 0;
+    };
+
   // see what the simulation is providing
   MeshMetadataMap mdMap;
   if (mdMap.Initialize(dataAdaptor))
     {
     SENSEI_ERROR("Failed to get metadata")
+    endStep(1);
     return false;
     }
 
@@ -273,6 +478,7 @@ bool Autocorrelation::Execute(DataAdaptor* dataAdaptor)
   if (mdMap.GetMeshMetadata(internals.MeshName, mmd))
     {
     SENSEI_ERROR("Failed to get metadata for mesh \"" << internals.MeshName << "\"")
+    endStep(1);
     return false;
     }
 
@@ -281,6 +487,7 @@ bool Autocorrelation::Execute(DataAdaptor* dataAdaptor)
   if (dataAdaptor->GetMesh(internals.MeshName, false, mesh))
     {
     SENSEI_ERROR("Failed to get mesh \"" << internals.MeshName << "\"")
+    endStep(1);
     return false;
     }
 
@@ -290,6 +497,8 @@ bool Autocorrelation::Execute(DataAdaptor* dataAdaptor)
     {
     SENSEI_ERROR("Failed to add array \"" << internals.ArrayName
       << "\" on mesh \"" << internals.MeshName << "\"")
+    mesh->Delete();
+    endStep(1);
     return false;
     }
 
@@ -298,6 +507,8 @@ bool Autocorrelation::Execute(DataAdaptor* dataAdaptor)
     dataAdaptor->AddGhostCellsArray(mesh, internals.MeshName))
     {
     SENSEI_ERROR(<< dataAdaptor->GetClassName() << " failed to add ghost cells.")
+    mesh->Delete();
+    endStep(1);
     return false;
     }
 
@@ -305,175 +516,240 @@ bool Autocorrelation::Execute(DataAdaptor* dataAdaptor)
     dataAdaptor->AddGhostNodesArray(mesh, internals.MeshName))
     {
     SENSEI_ERROR(<< dataAdaptor->GetClassName() << " failed to add ghost nodes.")
+    mesh->Delete();
+    endStep(1);
     return false;
     }
 
   const int association = internals.Association;
-  internals.InitializeBlocks(mesh);
 
-  if (vtkCompositeDataSet* cd = vtkCompositeDataSet::SafeDownCast(mesh))
-    {
-    vtkSmartPointer<vtkCompositeDataIterator> iter;
-    iter.TakeReference(cd->NewIterator());
-    iter->SkipEmptyNodesOff();
+  // a lone dataset is the rank'th block
+  vtkCompositeDataSetPtr cd =
+    VTKUtils::AsCompositeData(this->GetCommunicator(), mesh, true);
+
+  internals.InitializeBlocks(cd.GetPointer(), mmd->NumBlocks);
 
-    int bid = 0;
-    for (iter->InitTraversal(); !iter->IsDoneWithTraversal(); iter->GoToNextItem(), ++bid)
+  // each block has its own correlation state so the blocks are processed
+  // in parallel
+  VTKUtils::ThreadDatasetFunction process = [&](unsigned int,
+    unsigned int flatIndex, vtkDataSet *dataObj) -> int
+    {
+    int bid = flatIndex - 1;
+    int lid = internals.Master->lid(bid);
+    if (lid < 0)
       {
-      if (vtkDataSet* dataObj = vtkDataSet::SafeDownCast(iter->GetCurrentDataObject()))
-        {
-        int lid = internals.Master->lid(static_cast<int>(bid));
-        AutocorrelationImpl* corr = internals.Master->block<AutocorrelationImpl>(lid);
-        vtkFloatArray* fa = vtkFloatArray::SafeDownCast(
-          dataObj->GetAttributesAsFieldData(association)->GetArray(internals.ArrayName.c_str()));
-        vtkUnsignedCharArray *gc = vtkUnsignedCharArray::SafeDownCast(
-          dataObj->GetCellData()->GetArray("vtkGhostType"));
-        if (fa)
-          {
-          corr->process(fa->GetPointer(0), gc ? gc->GetPointer(0) : nullptr);
-          }
-        else
-          {
-          SENSEI_ERROR("Current implementation only supports float arrays")
-          abort();
-          }
-        }
+      SENSEI_ERROR("Block " << bid << " was not present in the first step")
+      return -1;
       }
-    }
-  else if (vtkDataSet* ds = vtkDataSet::SafeDownCast(mesh))
-    {
-    int bid = internals.Master->communicator().rank();
-    int lid = internals.Master->lid(static_cast<int>(bid));
+
     AutocorrelationImpl* corr = internals.Master->block<AutocorrelationImpl>(lid);
-    vtkFloatArray* fa = vtkFloatArray::SafeDownCast(
-      ds->GetAttributesAsFieldData(association)->GetArray(internals.ArrayName.c_str()));
-    vtkUnsignedCharArray *gc = vtkUnsignedCharArray::SafeDownCast(
-      ds->GetCellData()->GetArray("vtkGhostType"));
-    if (fa)
+
+    vtkFieldData *fd = dataObj->GetAttributesAsFieldData(association);
+    vtkDataArray* da = fd->GetArray(internals.ArrayName.c_str());
+    if (!da)
       {
-      corr->process(fa->GetPointer(0), gc ? gc->GetPointer(0) : nullptr);
+      SENSEI_ERROR("Block " << bid << " has no array \""
+        << internals.ArrayName << "\"")
+      return -1;
       }
-    else
+
+    if ((da->GetNumberOfComponents() != 1) ||
+      (size_t(da->GetNumberOfTuples()) != corr->dataSize()))
       {
-      SENSEI_ERROR("Current implementation only supports float arrays")
-      abort();
+      SENSEI_ERROR("Array \"" << internals.ArrayName << "\" on block " << bid
+        << " must be a scalar with " << corr->dataSize() << " values")
+      return -1;
       }
+
+#if VTK_MAJOR_VERSION == 6 && VTK_MINOR_VERSION == 1
+    const char *ghostName = "vtkGhostType";
+#else
+    const char *ghostName = vtkDataSetAttributes::GhostArrayName();
+#endif
+    vtkUnsignedCharArray *gc = vtkUnsignedCharArray::SafeDownCast(
+      fd->GetArray(ghostName));
+
+    GatherWorker worker;
+    worker.Block = corr;
+    worker.Ghosts = gc ? gc->GetPointer(0) : nullptr;
+
+#ifdef ENABLE_VTK_GENERIC_ARRAYS
+    vtkArrayDispatch::Dispatch::Execute(da, worker);
+#else
+    vtkDataArrayDispatcher<GatherWorker> dispatcher(worker);
+    dispatcher.Go(da);
+#endif
+
+    corr->process();
+
+    return 0;
+    };
+
+  int failed = 0;
+  if (VTKUtils::ParallelApply(internals.NumThreads, cd, process))
+    {
+    SENSEI_ERROR("Failed to process mesh \"" << internals.MeshName << "\"")
+    failed = 1;
     }
 
-  mesh->Delete();
+  return !endStep(failed);
+}
 
-  return true;
+//-----------------------------------------------------------------------------
+void Autocorrelation::SetOutputFileName(const std::string &fileName)
+{
+  this->Internals->OutputFileName = fileName;
 }
 
 //-----------------------------------------------------------------------------
-void Autocorrelation::PrintResults(size_t k_max)
+void Autocorrelation::SetInterval(int interval)
 {
-  TimeEvent<128> mark("Autocorrelation::PrintResults");
+  this->Internals->Interval = std::max(interval, 0);
+}
+
+//-----------------------------------------------------------------------------
+int Autocorrelation::WriteResults(long step, double time)
+{
+  TimeEvent<128> mark("Autocorrelation::WriteResults");
 
   AInternals& internals = (*this->Internals);
-  size_t nblocks = internals.NumberOfBlocks;
-
-    // add up the autocorrellations
-  internals.Master->foreach([](AutocorrelationImpl* b, const sdiy::Master::ProxyWithLink& cp)
-                                     {
-                                        std::vector<float> sums(b->window, 0);
-                                        sdiy::for_each(b->corr.shape(), [&](const Vertex4D& v)
-                                        {
-                                            size_t w = v[3];
-                                            sums[w] += b->corr(v);
-                                        });
-
-                                        cp.all_reduce(sums, add_vectors<float>());
-                                     });
-  internals.Master->exchange();
-  if (internals.Master->communicator().rank() == 0)
+
+  MPI_Comm comm = this->GetCommunicator();
+
+  int rank = 0;
+  MPI_Comm_rank(comm, &rank);
+
+  // when a rank failed to process a step since the last report the
+  // results are incomplete. all ranks learn of it here and none report
+  int failed = internals.StepFailed;
+  MPI_Allreduce(MPI_IN_PLACE, &failed, 1, MPI_INT, MPI_MAX, comm);
+
+  internals.StepFailed = 0;
+  internals.ResultsCurrent = true;
+
+  if (failed)
+    {
+    if (rank == 0)
+      SENSEI_ERROR("Results at step " << step << " are incomplete, a rank"
+        " failed to process a step")
+    return -1;
+    }
+
+  size_t window = internals.Window;
+  unsigned int nBlocks = internals.Master->size();
+
+  // add up the autocorrelations and select the k strongest for each shift.
+  // the blocks are processed in parallel, each thread with its own results
+  unsigned int nThreads = std::min(internals.NumThreads,
+    VTKUtils::GetNumberOfThreads());
+
+  std::vector<std::vector<double>> sums(nThreads, std::vector<double>(window, 0.0));
+  std::vector<TopK> maxs(nThreads, TopK(internals.KMax, window));
+
+  VTKUtils::ThreadLoopFunction select = [&](unsigned int thread,
+    unsigned int lid) -> int
+    {
+    AutocorrelationImpl* b = internals.Master->block<AutocorrelationImpl>(lid);
+    TopK &max = maxs[thread];
+    for (size_t w = 0; w < window; ++w)
+      {
+      const float *c = b->corr.data() + w*b->size;
+      double sum = 0.0;
+      for (size_t i = 0; i < b->size; ++i)
+        {
+        sum += c[i];
+        if (c[i] >= max.GetThreshold(w))
+          {
+          Vertex v = b->location(i);
+          max.Insert(w, c[i], b->gid, v[0], v[1], v[2]);
+          }
+        }
+      sums[thread][w] += sum;
+      }
+    return 0;
+    };
+
+  if (VTKUtils::ParallelFor(nThreads, nBlocks, select))
+    {
+    SENSEI_ERROR("Failed to select the strongest autocorrelations")
+    return -1;
+    }
+
+  for (unsigned int i = 1; i < nThreads; ++i)
+    {
+    maxs[0].Merge(maxs[i]);
+    for (size_t w = 0; w < window; ++w)
+      sums[0][w] += sums[i][w];
+    }
+
+  // all ranks take part in the reductions, including those without blocks
+  MPI_Reduce(rank == 0 ? MPI_IN_PLACE : sums[0].data(), sums[0].data(),
+    window, MPI_DOUBLE, MPI_SUM, 0, comm);
+
+  if (maxs[0].Reduce(comm, 0))
+    {
+    SENSEI_ERROR("Failed to reduce the strongest autocorrelations")
+    return -1;
+    }
+
+  if (rank != 0)
+    return 0;
+
+  std::vector<TopK::Candidate> cands;
+
+  if (internals.OutputFileName.empty())
     {
     // print out the autocorrelations
-    auto result = internals.Master->proxy(0).get<std::vector<float>>();
     std::cerr << "Autocorrelations:";
-    for (size_t i = 0; i < result.size(); ++i)
-      std::cerr << ' ' << result[i];
+    for (size_t i = 0; i < window; ++i)
+      std::cerr << ' ' << sums[0][i];
     std::cerr << std::endl;
+
+    for (size_t i = 0; i < window; ++i)
+      {
+      maxs[0].GetCandidates(i, cands);
+      std::cerr << "Max autocorrelations for " << i << ":";
+      for (auto& x : cands)
+        std::cerr << " (" << x.Value << " at " << x.Location[0] << ' '
+          << x.Location[1] << ' ' << x.Location[2] << ")";
+      std::cerr << std::endl;
+      }
+
+    return 0;
+    }
+
+  // one row per candidate, indexed from the strongest of the shift. the
+  // sum of all autocorrelations for the shift is repeated on each row
+  char fname[1024] = {'\0'};
+  snprintf(fname, 1024, "%s_%s_%ld.csv", internals.OutputFileName.c_str(),
+    internals.ArrayName.c_str(), step);
+
+  FILE *file = fopen(fname, "w");
+  if (!file)
+    {
+    char *estr = strerror(errno);
+    SENSEI_ERROR("Failed to open \"" << fname << "\""
+      << std::endl << estr)
+    return -1;
     }
 
-  internals.Master->foreach(
-    [](AutocorrelationImpl*, const sdiy::Master::ProxyWithLink& cp)
+  fprintf(file, "# step %ld time %0.9g\n", step, time);
+  fprintf(file, "shift,sum,index,value,block,i,j,k\n");
+  for (size_t i = 0; i < window; ++i)
     {
-    cp.collectives()->clear();
-    });
-
-
-  // select k strongest autocorrelations for each shift
-  sdiy::ContiguousAssigner     assigner(internals.Master->communicator().size(), nblocks);     // NB: this is coupled to main(...) in oscillator.cpp
-  sdiy::RegularDecomposer<sdiy::DiscreteBounds> decomposer(1, sdiy::interval(0, nblocks-1), nblocks);
-  sdiy::RegularMergePartners   partners(decomposer, 2);
-  //sdiy::RegularMergePartners   partners(3, nblocks, 2, true);
-  sdiy::reduce(*internals.Master, assigner, partners,
-              [k_max](void* b_, const sdiy::ReduceProxy& rp, const sdiy::RegularMergePartners&)
-              {
-                  AutocorrelationImpl* b = static_cast<AutocorrelationImpl*>(b_);
-                  //unsigned round = rp.round(); // current round number
-
-                  using MaxHeapVector = std::vector<std::vector<std::tuple<float,Vertex>>>;
-                  using Compare       = std::greater<std::tuple<float,Vertex>>;
-                  MaxHeapVector maxs(b->window);
-                  if (rp.in_link().size() == 0)
-                  {
-                      sdiy::for_each(b->corr.shape(), [&](const Vertex4D& v)
-                      {
-                          size_t offset = v[3];
-                          float val = b->corr(v);
-                          auto& max = maxs[offset];
-                          if (max.size() < k_max)
-                          {
-                              max.emplace_back(val, v.drop(3) + b->from);
-                              std::push_heap(max.begin(), max.end(), Compare());
-                          } else if (val > std::get<0>(max[0]))
-                          {
-                              std::pop_heap(max.begin(), max.end(), Compare());
-                              maxs[offset].back() = std::make_tuple(val, v.drop(3) + b->from);
-                              std::push_heap(max.begin(), max.end(), Compare());
-                          }
-                      });
-                  } else
-                  {
-                      for (long i = 0; i < rp.in_link().size(); ++i)
-                      {
-                          MaxHeapVector in_heaps;
-                          rp.dequeue(rp.in_link().target(i).gid, in_heaps);
-                          for (size_t j = 0; j < in_heaps.size(); ++j)
-                          {
-                              for (auto& x : in_heaps[j])
-                                  maxs[j].push_back(x);
-                          }
-                      }
-                      for (size_t j = 0; j < maxs.size(); ++j)
-                      {
-                          auto& max = maxs[j];
-                          std::make_heap(max.begin(), max.end(), Compare());
-                          while(max.size() > k_max)
-                          {
-                              std::pop_heap(max.begin(), max.end(), Compare());
-                              max.pop_back();
-                          }
-                      }
-                  }
-
-                  if (rp.out_link().size() > 0)
-                      rp.enqueue(rp.out_link().target(0), maxs);
-                  else
-                  {
-                      // print out the answer
-                      for (size_t i = 0; i < maxs.size(); ++i)
-                      {
-                          std::sort(maxs[i].begin(), maxs[i].end(), Compare());
-                          std::cerr << "Max autocorrelations for " << i << ":";
-                          for (auto& x : maxs[i])
-                              std::cerr << " (" << std::get<0>(x) << " at " << std::get<1>(x) << ")";
-                          std::cerr << std::endl;
-                      }
-                  }
-              });
+    maxs[0].GetCandidates(i, cands);
+    size_t nc = cands.size();
+    for (size_t j = 0; j < nc; ++j)
+      {
+      const TopK::Candidate &x = cands[j];
+      fprintf(file, "%zu,%0.9g,%zu,%0.9g,%d,%ld,%ld,%ld\n", i + 1, sums[0][i],
+        j, x.Value, x.Block, x.Location[0], x.Location[1], x.Location[2]);
+      }
+    }
+
+  fclose(file);
+
+  return 0;
 }
 
 //-----------------------------------------------------------------------------
@@ -481,12 +757,16 @@ int Autocorrelation::Finalize()
 {
   TimeEvent<128> mark("Autocorrelation::Finalize");
 
-  this->PrintResults(this->Internals->KMax);
+  // report the final state, unless that was done in the last step
+  int ierr = 0;
+  if (!this->Internals->ResultsCurrent)
+    ierr = this->WriteResults(this->Internals->LastStep,
+      this->Internals->LastTime);
 
   delete this->Internals;
   this->Internals = nullptr;
 
-  return 0;
+  return ierr;
 }
 
 }
@@ -11,7 +11,9 @@ namespace sensei
 /// @brief AnalysisAdaptor subclass for autocorrelation.
 ///
 /// Autocorrelation is an analysis adaptor that performs
-/// autocorrelation on the dataset.
+/// autocorrelation on the dataset. Any scalar array type is supported. The
+/// memory used per value is 8 bytes times the window, or 6 bytes when the
+/// past values are kept in half precision.
 class Autocorrelation : public AnalysisAdaptor
 {
 public:
@@ -30,12 +32,32 @@ public:
   /// @param arrayname together with \c association, identifies the array to
   ///         compute autocorrelation for.
   /// @param kMax number of strongest autocorrelations to report
-  /// @param numThreads number of threads in sdiy's thread pool
+  /// @param numThreads number of threads processing the blocks, 0 uses
+  ///         VTKUtils::GetNumberOfThreads
+  /// @param stride track every stride'th value in each direction,
+  ///         reducing memory by stride cubed on 3D image data
+  /// @param halfPrecision store the window of past values in half
+  ///         precision, values must be less than 65504 in magnitude
   void Initialize(size_t window, const std::string &meshName,
     int association, const std::string &arrayname, size_t kMax,
-    int numThreads = 1);
+    int numThreads = 0, int stride = 1, bool halfPrecision = false);
+
+  /// @brief Write the results to files instead of stderr.
+  ///
+  /// Each report is written on rank 0 to a CSV file named
+  /// <fileName>_<arrayname>_<step>.csv, with a row for each of the
+  /// strongest autocorrelations of each shift.
+  void SetOutputFileName(const std::string &fileName);
+
+  /// @brief Report the results every interval steps.
+  ///
+  /// The default of 0 reports them only in Finalize. When any rank fails to
+  /// process a step, no rank reports the results at the next interval and
+  /// all ranks return an error there.
+  void SetInterval(int interval);
 
   bool Execute(DataAdaptor* data) override;
+  int GetThreadSafe() override { return 1; }
 
   int Finalize() override;
 
@@ -43,7 +65,9 @@ protected:
   Autocorrelation();
   ~Autocorrelation();
 
-  void PrintResults(size_t k_max);
+  // reduce and report the sums and the strongest autocorrelations of
+  // each shift
+  int WriteResults(long step, double time);
 private:
   Autocorrelation(const Autocorrelation&); // not implemented.
   void operator=(const Autocorrelation&);
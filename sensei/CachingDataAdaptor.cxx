@@ -0,0 +1,818 @@
+#include "CachingDataAdaptor.h"
+#include "VTKUtils.h"
+#include "Error.h"
+
+#include <vtkDataObject.h>
+#include <vtkCompositeDataSet.h>
+#include <vtkCompositeDataIterator.h>
+#include <vtkDataSetAttributes.h>
+#include <vtkFieldData.h>
+#include <vtkAbstractArray.h>
+#include <vtkObjectFactory.h>
+#include <vtkSmartPointer.h>
+
+#include <algorithm>
+#include <map>
+#include <set>
+#include <vector>
+#include <string>
+#include <utility>
+#include <mutex>
+
+using vtkDataObjectPtr = vtkSmartPointer<vtkDataObject>;
+using vtkCompositeDataSetPtr = vtkSmartPointer<vtkCompositeDataSet>;
+using vtkCompositeDataIteratorPtr = vtkSmartPointer<vtkCompositeDataIterator>;
+
+namespace sensei
+{
+
+// a cached mesh. the object as returned by the wrapped adaptor, and
+// when requested a composite view of it, along with the arrays that
+// have been added to it. in thread safe mode callers are given private
+// views that share the cached mesh's arrays.
+struct MeshCacheEntry
+{
+  MeshCacheEntry() : GhostCells(false), GhostNodes(false) {}
+
+  vtkDataObjectPtr Mesh;
+  vtkCompositeDataSetPtr CompositeMesh;
+  std::vector<vtkDataObjectPtr> Views;
+  std::set<std::pair<int, std::string>> Arrays;
+  bool GhostCells;
+  bool GhostNodes;
+};
+
+// mesh name, structure only
+using MeshCacheKey = std::pair<std::string, bool>;
+using MeshCacheType = std::map<MeshCacheKey, MeshCacheEntry>;
+
+// identifies the cache entry of an object handed to a caller. when the
+// caller was given a private view, the view with the same structure as
+// the cached mesh is stored so that arrays added later can be shared
+struct MeshCacheObject
+{
+  MeshCacheObject() : Key(), View(nullptr) {}
+  MeshCacheObject(const MeshCacheKey &key, vtkDataObject *view)
+    : Key(key), View(view) {}
+
+  MeshCacheKey Key;
+  vtkDataObject *View;
+};
+
+// --------------------------------------------------------------------------
+static vtkDataObject *newView(vtkDataObject *dobj)
+{
+  // new containers with the same structure referencing the same arrays
+  if (vtkCompositeDataSet *cd = dynamic_cast<vtkCompositeDataSet*>(dobj))
+    {
+    vtkCompositeDataSet *view = cd->NewInstance();
+    view->CopyStructure(cd);
+
+    vtkCompositeDataIteratorPtr it;
+    it.TakeReference(cd->NewIterator());
+    for (it->InitTraversal(); !it->IsDoneWithTraversal(); it->GoToNextItem())
+      {
+      vtkDataObject *block = it->GetCurrentDataObject();
+      vtkDataObject *viewBlock = block->NewInstance();
+      viewBlock->ShallowCopy(block);
+      view->SetDataSet(it, viewBlock);
+      viewBlock->Delete();
+      }
+
+    return view;
+    }
+
+  vtkDataObject *view = dobj->NewInstance();
+  view->ShallowCopy(dobj);
+  return view;
+}
+
+// --------------------------------------------------------------------------
+static void shareArray(vtkDataObject *src, vtkDataObject *dest,
+  int association, const std::string &arrayName)
+{
+  if (vtkCompositeDataSet *cd = dynamic_cast<vtkCompositeDataSet*>(src))
+    {
+    vtkCompositeDataSet *destCd = static_cast<vtkCompositeDataSet*>(dest);
+
+    vtkCompositeDataIteratorPtr it;
+    it.TakeReference(cd->NewIterator());
+    for (it->InitTraversal(); !it->IsDoneWithTraversal(); it->GoToNextItem())
+      {
+      vtkDataObject *destBlock = destCd->GetDataSet(it);
+      if (destBlock)
+        shareArray(it->GetCurrentDataObject(), destBlock, association, arrayName);
+      }
+
+    return;
+    }
+
+  vtkFieldData *srcAtts = src->GetAttributesAsFieldData(association);
+  vtkFieldData *destAtts = dest->GetAttributesAsFieldData(association);
+  if (!srcAtts || !destAtts)
+    return;
+
+  vtkAbstractArray *array = srcAtts->GetAbstractArray(arrayName.c_str());
+  if (array && (destAtts->GetAbstractArray(arrayName.c_str()) != array))
+    destAtts->AddArray(array);
+}
+
+// cached metadata. the flags it was generated with and when
+struct MetadataCacheEntry
+{
+  MeshMetadataPtr Metadata;
+  long long Flags;
+  long Step;
+  unsigned long Epoch;
+};
+
+// mesh id to the metadata generated for it
+using MetadataCacheType = std::map<unsigned int, std::vector<MetadataCacheEntry>>;
+
+struct CachingDataAdaptor::InternalsType
+{
+  InternalsType() : ThreadSafe(0), Hits(0), Misses(0), MetadataHits(0),
+    MetadataMisses(0), Epoch(0) {}
+
+  // locate the cache entry from the object handed to the caller. if the
+  // caller was given a private view it is returned in view.
+  MeshCacheEntry *Find(vtkDataObject *mesh, vtkDataObject *&view);
+
+  // get the cache entry, asking the wrapped adaptor for the mesh when
+  // it is not cached
+  MeshCacheEntry *GetEntry(const MeshCacheKey &key);
+
+  // drop cached meshes
+  void ClearMeshes();
+
+  // drop metadata that describes a mesh that may change
+  void ClearMetadata();
+
+  // cache metadata, replacing any entries it supersedes
+  void AddMetadata(unsigned int id, const MeshMetadataPtr &md,
+    long long flags, long step);
+
+  int ThreadSafe;
+  std::recursive_mutex Mutex;
+
+  vtkSmartPointer<DataAdaptor> Adaptor;
+  MeshCacheType Meshes;
+  std::map<vtkDataObject*, MeshCacheObject> Objects;
+  long Hits;
+  long Misses;
+
+  MetadataCacheType Metadata;
+  long MetadataHits;
+  long MetadataMisses;
+  unsigned long Epoch;
+};
+
+// --------------------------------------------------------------------------
+MeshCacheEntry *CachingDataAdaptor::InternalsType::Find(vtkDataObject *mesh,
+  vtkDataObject *&view)
+{
+  view = nullptr;
+
+  std::map<vtkDataObject*, MeshCacheObject>::iterator it = this->Objects.find(mesh);
+  if (it == this->Objects.end())
+    return nullptr;
+
+  view = it->second.View;
+
+  return &this->Meshes[it->second.Key];
+}
+
+// --------------------------------------------------------------------------
+MeshCacheEntry *CachingDataAdaptor::InternalsType::GetEntry(
+  const MeshCacheKey &key)
+{
+  MeshCacheType::iterator it = this->Meshes.find(key);
+  if (it != this->Meshes.end())
+    {
+    this->Hits += 1;
+    return &it->second;
+    }
+
+  this->Misses += 1;
+
+  vtkDataObject *dobj = nullptr;
+  if (this->Adaptor->GetMesh(key.first, key.second, dobj))
+    {
+    SENSEI_ERROR("Failed to get mesh \"" << key.first << "\"")
+    return nullptr;
+    }
+
+  MeshCacheEntry &entry = this->Meshes[key];
+  entry.Mesh.TakeReference(dobj);
+
+  if (dobj)
+    this->Objects[dobj] = MeshCacheObject(key, nullptr);
+
+  return &entry;
+}
+
+// --------------------------------------------------------------------------
+void CachingDataAdaptor::InternalsType::ClearMeshes()
+{
+  this->Meshes.clear();
+  this->Objects.clear();
+}
+
+// --------------------------------------------------------------------------
+void CachingDataAdaptor::InternalsType::ClearMetadata()
+{
+  // metadata generated from here on is for a new step
+  this->Epoch += 1;
+
+  // the metadata of static meshes is kept
+  MetadataCacheType::iterator it = this->Metadata.begin();
+  MetadataCacheType::iterator end = this->Metadata.end();
+  for (; it != end; ++it)
+    {
+    std::vector<MetadataCacheEntry> &entries = it->second;
+    entries.erase(std::remove_if(entries.begin(), entries.end(),
+      [](const MetadataCacheEntry &e) -> bool { return !e.Metadata->StaticMesh; }),
+      entries.end());
+    }
+}
+
+// --------------------------------------------------------------------------
+void CachingDataAdaptor::InternalsType::AddMetadata(unsigned int id,
+  const MeshMetadataPtr &md, long long flags, long step)
+{
+  std::vector<MetadataCacheEntry> &entries = this->Metadata[id];
+
+  entries.erase(std::remove_if(entries.begin(), entries.end(),
+    [flags](const MetadataCacheEntry &e) -> bool
+    { return (flags & e.Flags) == e.Flags; }), entries.end());
+
+  MetadataCacheEntry entry;
+  entry.Metadata = md->NewCopy();
+  entry.Flags = flags;
+  entry.Step = step;
+  entry.Epoch = this->Epoch;
+
+  entries.push_back(entry);
+}
+
+
+//----------------------------------------------------------------------------
+senseiNewMacro(CachingDataAdaptor);
+
+//----------------------------------------------------------------------------
+CachingDataAdaptor::CachingDataAdaptor()
+{
+  this->Internals = new InternalsType;
+}
+
+//----------------------------------------------------------------------------
+CachingDataAdaptor::~CachingDataAdaptor()
+{
+  delete this->Internals;
+}
+
+//----------------------------------------------------------------------------
+void CachingDataAdaptor::SetThreadSafe(int val)
+{
+  this->Internals->ThreadSafe = val;
+}
+
+//----------------------------------------------------------------------------
+int CachingDataAdaptor::GetThreadSafe()
+{
+  return this->Internals->ThreadSafe;
+}
+
+//----------------------------------------------------------------------------
+void CachingDataAdaptor::SetDataAdaptor(DataAdaptor *da)
+{
+  std::lock_guard<std::recursive_mutex> lock(this->Internals->Mutex);
+
+  this->ClearCache();
+
+  this->Internals->Adaptor = da;
+}
+
+//----------------------------------------------------------------------------
+DataAdaptor *CachingDataAdaptor::GetDataAdaptor()
+{
+  return this->Internals->Adaptor.GetPointer();
+}
+
+//----------------------------------------------------------------------------
+void CachingDataAdaptor::ClearCache()
+{
+  std::lock_guard<std::recursive_mutex> lock(this->Internals->Mutex);
+
+  this->Internals->ClearMeshes();
+  this->Internals->ClearMetadata();
+}
+
+//----------------------------------------------------------------------------
+void CachingDataAdaptor::ClearMetadataCache()
+{
+  std::lock_guard<std::recursive_mutex> lock(this->Internals->Mutex);
+
+  this->Internals->Metadata.clear();
+}
+
+//----------------------------------------------------------------------------
+void CachingDataAdaptor::GetCacheStatistics(long &hits, long &misses) const
+{
+  hits = this->Internals->Hits;
+  misses = this->Internals->Misses;
+}
+
+//----------------------------------------------------------------------------
+void CachingDataAdaptor::GetMetadataCacheStatistics(long &hits,
+  long &misses) const
+{
+  hits = this->Internals->MetadataHits;
+  misses = this->Internals->MetadataMisses;
+}
+
+//----------------------------------------------------------------------------
+void CachingDataAdaptor::ResetCacheStatistics()
+{
+  this->Internals->Hits = 0;
+  this->Internals->Misses = 0;
+  this->Internals->MetadataHits = 0;
+  this->Internals->MetadataMisses = 0;
+}
+
+//----------------------------------------------------------------------------
+int CachingDataAdaptor::GetNumberOfMeshes(unsigned int &numMeshes)
+{
+  numMeshes = 0;
+
+  std::lock_guard<std::recursive_mutex> lock(this->Internals->Mutex);
+
+  if (!this->Internals->Adaptor)
+    {
+    SENSEI_ERROR("No data adaptor was set")
+    return -1;
+    }
+
+  return this->Internals->Adaptor->GetNumberOfMeshes(numMeshes);
+}
+
+//----------------------------------------------------------------------------
+int CachingDataAdaptor::GetMeshMetadata(unsigned int id,
+  MeshMetadataPtr &metadata)
+{
+  std::lock_guard<std::recursive_mutex> lock(this->Internals->Mutex);
+
+  if (!this->Internals->Adaptor)
+    {
+    SENSEI_ERROR("No data adaptor was set")
+    return -1;
+    }
+
+  long long flags = metadata->Flags.GetFlags();
+  long step = this->Internals->Adaptor->GetDataTimeStep();
+
+  MeshMetadataFlags rangeFlag;
+  rangeFlag.SetBlockArrayRange();
+  long long range = rangeFlag.GetFlags();
+
+  std::vector<MetadataCacheEntry> &entries = this->Internals->Metadata[id];
+
+  // metadata generated during this step with at least the requested fields
+  unsigned int nEntries = entries.size();
+  for (unsigned int i = 0; i < nEntries; ++i)
+    {
+    const MetadataCacheEntry &entry = entries[i];
+    if ((entry.Epoch == this->Internals->Epoch) && (entry.Step == step) &&
+      ((entry.Flags & flags) == flags))
+      {
+      this->Internals->MetadataHits += 1;
+      *metadata = *entry.Metadata;
+      metadata->Flags = flags;
+      return 0;
+      }
+    }
+
+  // metadata of a static mesh generated during a previous step. the
+  // decomposition, sizes, extents, and bounds are reused and only the
+  // array ranges need to be refreshed.
+  for (unsigned int i = 0; i < nEntries; ++i)
+    {
+    const MetadataCacheEntry &entry = entries[i];
+    if (entry.Metadata->StaticMesh &&
+      ((entry.Flags & flags & ~range) == (flags & ~range)))
+      {
+      this->Internals->MetadataHits += 1;
+
+      MeshMetadataPtr md = entry.Metadata->NewCopy();
+      long long mdFlags = entry.Flags & ~range;
+
+      if (flags & range)
+        {
+        MeshMetadataPtr arrays = MeshMetadata::New(rangeFlag);
+        if (this->Internals->Adaptor->GetMeshMetadata(id, arrays))
+          {
+          SENSEI_ERROR("Failed to get array metadata for mesh " << id)
+          return -1;
+          }
+
+        md->NumArrays = arrays->NumArrays;
+        md->ArrayName = arrays->ArrayName;
+        md->ArrayCentering = arrays->ArrayCentering;
+        md->ArrayComponents = arrays->ArrayComponents;
+        md->ArrayType = arrays->ArrayType;
+        md->ArrayRange = arrays->ArrayRange;
+        md->BlockArrayRange = arrays->BlockArrayRange;
+
+        mdFlags |= range;
+        }
+
+      md->Flags = mdFlags;
+      this->Internals->AddMetadata(id, md, mdFlags, step);
+
+      *metadata = *md;
+      metadata->Flags = flags;
+      return 0;
+      }
+    }
+
+  // generate it
+  this->Internals->MetadataMisses += 1;
+
+  if (this->Internals->Adaptor->GetMeshMetadata(id, metadata))
+    return -1;
+
+  this->Internals->AddMetadata(id, metadata, flags, step);
+
+  return 0;
+}
+
+//----------------------------------------------------------------------------
+int CachingDataAdaptor::GetMesh(const std::string &meshName,
+  bool structureOnly, vtkDataObject *&mesh)
+{
+  mesh = nullptr;
+
+  std::lock_guard<std::recursive_mutex> lock(this->Internals->Mutex);
+
+  if (!this->Internals->Adaptor)
+    {
+    SENSEI_ERROR("No data adaptor was set")
+    return -1;
+    }
+
+  MeshCacheKey key(meshName, structureOnly);
+
+  MeshCacheEntry *entry = this->Internals->GetEntry(key);
+  if (!entry)
+    return -1;
+
+  if (!entry->Mesh)
+    return 0;
+
+  if (this->Internals->ThreadSafe)
+    {
+    // a private view so that callers on other threads are not affected
+    // when arrays are added
+    vtkDataObject *view = newView(entry->Mesh);
+    entry->Views.push_back(vtkDataObjectPtr::Take(view));
+    this->Internals->Objects[view] = MeshCacheObject(key, view);
+    mesh = view;
+    }
+  else
+    {
+    mesh = entry->Mesh.GetPointer();
+    }
+
+  // the cache holds one reference and the caller the other
+  mesh->Register(nullptr);
+
+  return 0;
+}
+
+//----------------------------------------------------------------------------
+int CachingDataAdaptor::GetMesh(const std::string &meshName,
+  bool structureOnly, vtkCompositeDataSet *&mesh)
+{
+  mesh = nullptr;
+
+  std::lock_guard<std::recursive_mutex> lock(this->Internals->Mutex);
+
+  // make sure the mesh is cached
+  vtkDataObject *dobj = nullptr;
+  if (this->GetMesh(meshName, structureOnly, dobj))
+    return -1;
+
+  MeshCacheKey key(meshName, structureOnly);
+  MeshCacheEntry &entry = this->Internals->Meshes[key];
+
+  if (this->Internals->ThreadSafe)
+    {
+    // a composite view of this caller's private view
+    if ((mesh = dynamic_cast<vtkCompositeDataSet*>(dobj)))
+      return 0;
+
+    vtkCompositeDataSetPtr cd = VTKUtils::AsCompositeData(
+      this->GetCommunicator(), dobj, false);
+
+    entry.Views.push_back(cd.GetPointer());
+    this->Internals->Objects[cd.GetPointer()] = MeshCacheObject(key, dobj);
+
+    if (dobj)
+      dobj->Delete();
+
+    mesh = cd.GetPointer();
+    mesh->Register(nullptr);
+
+    return 0;
+    }
+
+  // the composite view shares the blocks of the cached mesh
+  if (!entry.CompositeMesh)
+    {
+    entry.CompositeMesh = VTKUtils::AsCompositeData(
+      this->GetCommunicator(), dobj, false);
+
+    this->Internals->Objects[entry.CompositeMesh.GetPointer()] =
+      MeshCacheObject(key, nullptr);
+    }
+
+  if (dobj)
+    dobj->Delete();
+
+  mesh = entry.CompositeMesh.GetPointer();
+  mesh->Register(nullptr);
+
+  return 0;
+}
+
+//----------------------------------------------------------------------------
+int CachingDataAdaptor::GetMesh(const std::string &meshName,
+  bool structureOnly, const std::vector<int> &blockIds,
+  vtkCompositeDataSet *&mesh)
+{
+  std::lock_guard<std::recursive_mutex> lock(this->Internals->Mutex);
+
+  if (!this->Internals->Adaptor)
+    {
+    SENSEI_ERROR("No data adaptor was set")
+    return -1;
+    }
+
+  // subsets are not cached. the arrays added to them are passed through
+  // to the wrapped adaptor
+  return this->Internals->Adaptor->GetMesh(meshName, structureOnly,
+    blockIds, mesh);
+}
+
+//----------------------------------------------------------------------------
+int CachingDataAdaptor::AddGhostNodesArray(vtkDataObject* mesh,
+  const std::string &meshName)
+{
+  std::lock_guard<std::recursive_mutex> lock(this->Internals->Mutex);
+
+  if (!this->Internals->Adaptor)
+    {
+    SENSEI_ERROR("No data adaptor was set")
+    return -1;
+    }
+
+  vtkDataObject *view = nullptr;
+  MeshCacheEntry *entry = this->Internals->Find(mesh, view);
+  if (!entry)
+    return this->Internals->Adaptor->AddGhostNodesArray(mesh, meshName);
+
+  if (entry->GhostNodes)
+    {
+    this->Internals->Hits += 1;
+    }
+  else
+    {
+    this->Internals->Misses += 1;
+
+    if (this->Internals->Adaptor->AddGhostNodesArray(entry->Mesh, meshName))
+      return -1;
+
+    entry->GhostNodes = true;
+    }
+
+  if (view)
+    shareArray(entry->Mesh, view, vtkDataObject::POINT,
+      vtkDataSetAttributes::GhostArrayName());
+
+  return 0;
+}
+
+//----------------------------------------------------------------------------
+int CachingDataAdaptor::AddGhostCellsArray(vtkDataObject* mesh,
+  const std::string &meshName)
+{
+  std::lock_guard<std::recursive_mutex> lock(this->Internals->Mutex);
+
+  if (!this->Internals->Adaptor)
+    {
+    SENSEI_ERROR("No data adaptor was set")
+    return -1;
+    }
+
+  vtkDataObject *view = nullptr;
+  MeshCacheEntry *entry = this->Internals->Find(mesh, view);
+  if (!entry)
+    return this->Internals->Adaptor->AddGhostCellsArray(mesh, meshName);
+
+  if (entry->GhostCells)
+    {
+    this->Internals->Hits += 1;
+    }
+  else
+    {
+    this->Internals->Misses += 1;
+
+    if (this->Internals->Adaptor->AddGhostCellsArray(entry->Mesh, meshName))
+      return -1;
+
+    entry->GhostCells = true;
+    }
+
+  if (view)
+    shareArray(entry->Mesh, view, vtkDataObject::CELL,
+      vtkDataSetAttributes::GhostArrayName());
+
+  return 0;
+}
+
+//----------------------------------------------------------------------------
+int CachingDataAdaptor::AddArray(vtkDataObject* mesh,
+  const std::string &meshName, int association, const std::string &arrayName)
+{
+  std::lock_guard<std::recursive_mutex> lock(this->Internals->Mutex);
+
+  if (!this->Internals->Adaptor)
+    {
+    SENSEI_ERROR("No data adaptor was set")
+    return -1;
+    }
+
+  // not one of ours, pass it through
+  vtkDataObject *view = nullptr;
+  MeshCacheEntry *entry = this->Internals->Find(mesh, view);
+  if (!entry)
+    return this->Internals->Adaptor->AddArray(mesh, meshName,
+      association, arrayName);
+
+  std::pair<int, std::string> arrayKey(association, arrayName);
+  if (entry->Arrays.count(arrayKey))
+    {
+    this->Internals->Hits += 1;
+    }
+  else
+    {
+    this->Internals->Misses += 1;
+
+    // the wrapped adaptor is always handed the object it created
+    if (this->Internals->Adaptor->AddArray(entry->Mesh, meshName,
+      association, arrayName))
+      return -1;
+
+    entry->Arrays.insert(arrayKey);
+    }
+
+  if (view)
+    shareArray(entry->Mesh, view, association, arrayName);
+
+  return 0;
+}
+
+//----------------------------------------------------------------------------
+int CachingDataAdaptor::AddArrays(vtkDataObject* mesh,
+  const std::string &meshName, int association,
+  const std::vector<std::string> &arrayNames)
+{
+  std::lock_guard<std::recursive_mutex> lock(this->Internals->Mutex);
+
+  if (!this->Internals->Adaptor)
+    {
+    SENSEI_ERROR("No data adaptor was set")
+    return -1;
+    }
+
+  // not one of ours, pass it through
+  vtkDataObject *view = nullptr;
+  MeshCacheEntry *entry = this->Internals->Find(mesh, view);
+  if (!entry)
+    return this->Internals->Adaptor->AddArrays(mesh, meshName,
+      association, arrayNames);
+
+  // the arrays not yet in the cache are fetched in a single batch
+  std::vector<std::string> missing;
+  unsigned int nArrays = arrayNames.size();
+  for (unsigned int i = 0; i < nArrays; ++i)
+    {
+    std::pair<int, std::string> arrayKey(association, arrayNames[i]);
+    if (entry->Arrays.count(arrayKey))
+      this->Internals->Hits += 1;
+    else
+      missing.push_back(arrayNames[i]);
+    }
+
+  if (!missing.empty())
+    {
+    this->Internals->Misses += missing.size();
+
+    // the wrapped adaptor is always handed the object it created
+    if (this->Internals->Adaptor->AddArrays(entry->Mesh, meshName,
+      association, missing))
+      return -1;
+
+    unsigned int nMissing = missing.size();
+    for (unsigned int i = 0; i < nMissing; ++i)
+      entry->Arrays.insert(std::make_pair(association, missing[i]));
+    }
+
+  if (view)
+    {
+    for (unsigned int i = 0; i < nArrays; ++i)
+      shareArray(entry->Mesh, view, association, arrayNames[i]);
+    }
+
+  return 0;
+}
+
+//----------------------------------------------------------------------------
+int CachingDataAdaptor::GetArrayZeroCopy(const std::string &meshName,
+  int association, const std::string &arrayName, int &zeroCopy)
+{
+  std::lock_guard<std::recursive_mutex> lock(this->Internals->Mutex);
+
+  if (!this->Internals->Adaptor)
+    {
+    SENSEI_ERROR("No data adaptor was set")
+    return -1;
+    }
+
+  // cached arrays are shared not copied
+  return this->Internals->Adaptor->GetArrayZeroCopy(meshName,
+    association, arrayName, zeroCopy);
+}
+
+//----------------------------------------------------------------------------
+int CachingDataAdaptor::ReleaseData()
+{
+  std::lock_guard<std::recursive_mutex> lock(this->Internals->Mutex);
+
+  // other threads may still be using the data, it is released when the
+  // step ends
+  if (this->Internals->ThreadSafe)
+    return 0;
+
+  this->Internals->ClearMeshes();
+
+  if (this->Internals->Adaptor)
+    return this->Internals->Adaptor->ReleaseData();
+
+  return 0;
+}
+
+//----------------------------------------------------------------------------
+double CachingDataAdaptor::GetDataTime()
+{
+  return this->Internals->Adaptor ?
+    this->Internals->Adaptor->GetDataTime() : this->Superclass::GetDataTime();
+}
+
+//----------------------------------------------------------------------------
+void CachingDataAdaptor::SetDataTime(double time)
+{
+  if (this->Internals->Adaptor)
+    this->Internals->Adaptor->SetDataTime(time);
+  else
+    this->Superclass::SetDataTime(time);
+}
+
+//----------------------------------------------------------------------------
+long CachingDataAdaptor::GetDataTimeStep()
+{
+  return this->Internals->Adaptor ?
+    this->Internals->Adaptor->GetDataTimeStep() :
+    this->Superclass::GetDataTimeStep();
+}
+
+//----------------------------------------------------------------------------
+void CachingDataAdaptor::SetDataTimeStep(long index)
+{
+  if (this->Internals->Adaptor)
+    this->Internals->Adaptor->SetDataTimeStep(index);
+  else
+    this->Superclass::SetDataTimeStep(index);
+}
+
+//----------------------------------------------------------------------------
+void CachingDataAdaptor::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "Hits: " << this->Internals->Hits << endl
+    << indent << "Misses: " << this->Internals->Misses << endl
+    << indent << "MetadataHits: " << this->Internals->MetadataHits << endl
+    << indent << "MetadataMisses: " << this->Internals->MetadataMisses << endl;
+}
+
+}
@@ -0,0 +1,118 @@
+#ifndef sensei_CachingDataAdaptor_h
+#define sensei_CachingDataAdaptor_h
+
+#include "DataAdaptor.h"
+
+namespace sensei
+{
+
+/// @brief A DataAdaptor that shares meshes and arrays between analyses.
+///
+/// CachingDataAdaptor wraps another data adaptor and memoizes the meshes
+/// it returns for the current step. Meshes are cached per mesh name and
+/// structureOnly flag, and the arrays and ghost arrays added to a cached
+/// mesh are tracked per association and array name, so that when several
+/// analyses ask for the same data the wrapped adaptor only builds it once.
+/// Callers receive a shared reference to the cached mesh, and as usual
+/// call Delete when they are finished with it. Because the mesh is shared,
+/// callers must not modify it beyond adding arrays through this adaptor.
+///
+/// The cache is invalidated by ReleaseData, which also releases the data
+/// of the wrapped adaptor, and by ClearCache, which does not. Hits and
+/// misses are counted to help judge the effectiveness of the cache.
+///
+/// Metadata is cached per mesh, time step, and MeshMetadataFlags. A request
+/// is served from metadata generated earlier in the step with the same or
+/// more flags set, so that the metadata collectives are issued about once
+/// per mesh per step rather than once per analysis. When the wrapped
+/// adaptor flags a mesh as static (MeshMetadata::StaticMesh) its block
+/// decomposition, sizes, extents, and bounds are kept across steps and
+/// only the array ranges are refreshed when requested.
+class CachingDataAdaptor : public DataAdaptor
+{
+public:
+  static CachingDataAdaptor *New();
+  senseiTypeMacro(CachingDataAdaptor, DataAdaptor);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /// @brief Set the adaptor to cache data from. This clears the cache.
+  /// The communicator is not changed, it should be set to one that is
+  /// congruent with the wrapped adaptor's communicator.
+  void SetDataAdaptor(DataAdaptor *da);
+  DataAdaptor *GetDataAdaptor();
+
+  /// @brief Enable use from multiple threads. Calls are serialized, each
+  /// call to GetMesh returns a private view of the cached mesh that shares
+  /// its arrays, so that arrays added by one caller do not modify the
+  /// objects in use by another, and ReleaseData is deferred until the
+  /// step ends.
+  void SetThreadSafe(int val);
+  int GetThreadSafe();
+
+  /// @brief Ends the step. Drops all cached meshes and the metadata of
+  /// meshes that are not static without releasing the wrapped adaptor's
+  /// data.
+  void ClearCache();
+
+  /// @brief Drops all cached metadata including that of static meshes.
+  /// Use this when the wrapped adaptor's meshes change.
+  void ClearMetadataCache();
+
+  /// @brief Get the number of requests served from the cache and the
+  /// number forwarded to the wrapped adaptor.
+  void GetCacheStatistics(long &hits, long &misses) const;
+  void GetMetadataCacheStatistics(long &hits, long &misses) const;
+  void ResetCacheStatistics();
+
+  // DataAdaptor API, see DataAdaptor for details
+  int GetNumberOfMeshes(unsigned int &numMeshes) override;
+
+  int GetMeshMetadata(unsigned int id, MeshMetadataPtr &metadata) override;
+
+  int GetMesh(const std::string &meshName, bool structureOnly,
+    vtkDataObject *&mesh) override;
+
+  int GetMesh(const std::string &meshName, bool structureOnly,
+    vtkCompositeDataSet *&mesh) override;
+
+  int GetMesh(const std::string &meshName, bool structureOnly,
+    const std::vector<int> &blockIds, vtkCompositeDataSet *&mesh) override;
+
+  int AddGhostNodesArray(vtkDataObject* mesh,
+    const std::string &meshName) override;
+
+  int AddGhostCellsArray(vtkDataObject* mesh,
+    const std::string &meshName) override;
+
+  int AddArray(vtkDataObject* mesh, const std::string &meshName,
+    int association, const std::string &arrayName) override;
+
+  int AddArrays(vtkDataObject* mesh, const std::string &meshName,
+    int association, const std::vector<std::string> &arrayNames) override;
+
+  int GetArrayZeroCopy(const std::string &meshName, int association,
+    const std::string &arrayName, int &zeroCopy) override;
+
+  int ReleaseData() override;
+
+  double GetDataTime() override;
+  void SetDataTime(double time) override;
+
+  long GetDataTimeStep() override;
+  void SetDataTimeStep(long index) override;
+
+protected:
+  CachingDataAdaptor();
+  ~CachingDataAdaptor();
+
+  CachingDataAdaptor(const CachingDataAdaptor&) = delete;
+  void operator=(const CachingDataAdaptor&) = delete;
+
+private:
+  struct InternalsType;
+  InternalsType *Internals;
+};
+
+}
+
+#endif
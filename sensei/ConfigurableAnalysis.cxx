@@ -2,11 +2,18 @@
 #include <vtkSmartPointer.h>
 #include <vtkNew.h>
 #include <vtkDataObject.h>
+#include <vtkCompositeDataSet.h>
 
 #include <vector>
+#include <deque>
+#include <algorithm>
 #include <fstream>
 #include <sstream>
 #include <cstdio>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 #include <errno.h>
 
 #include "ConfigurableAnalysis.h"
@@ -17,9 +24,26 @@
 #include "XMLUtils.h"
 #include "STLUtils.h"
 #include "DataRequirements.h"
+#include "DataAdaptor.h"
+#include "VTKDataAdaptor.h"
+#include "InTransitDataAdaptor.h"
+#include "MeshMetadataMap.h"
+#include "TimeBudgetScheduler.h"
+#include "TriggerSet.h"
+#include "ArrayRangeTrigger.h"
+#include "EntropyTrigger.h"
+#include "PredicateTrigger.h"
+#include "CachingDataAdaptor.h"
+#include "ThreadPool.h"
+#include "MeshMetadata.h"
 
 #include "Autocorrelation.h"
 #include "Histogram.h"
+#include "JointHistogram.h"
+#include "Quantiles.h"
+#include "SubsampleAnalysis.h"
+#include "SubsampleDataAdaptor.h"
+#include "TemporalStatistics.h"
 #ifdef ENABLE_VTK_IO
 #include "VTKPosthocIO.h"
 #ifdef ENABLE_VTK_MPI
@@ -64,6 +88,8 @@
 
 using AnalysisAdaptorPtr = vtkSmartPointer<sensei::AnalysisAdaptor>;
 using AnalysisAdaptorVector = std::vector<AnalysisAdaptorPtr>;
+using VTKDataAdaptorPtr = vtkSmartPointer<sensei::VTKDataAdaptor>;
+using CachingDataAdaptorPtr = vtkSmartPointer<sensei::CachingDataAdaptor>;
 
 namespace sensei
 {
@@ -73,7 +99,10 @@ using namespace STLUtils; // for operator<< overloads
 struct ConfigurableAnalysis::InternalsType
 {
   InternalsType()
-    : Comm(MPI_COMM_NULL)
+    : Comm(MPI_COMM_NULL), Async(0), AsyncDeepCopy(1), AsyncQueueDepth(1),
+      AsyncSnapshotAll(false), AsyncComm(MPI_COMM_NULL), AsyncDone(false),
+      AsyncSteps(0), AsyncExecTime(0.0), AsyncWaitTime(0.0),
+      AsyncSnapshotTime(0.0), EnableCache(1)
   {
   }
 
@@ -90,6 +119,8 @@ struct ConfigurableAnalysis::InternalsType
   // a status message indicating success/failure is printed
   // by rank 0
   int AddHistogram(pugi::xml_node node);
+  int AddJointHistogram(pugi::xml_node node);
+  int AddQuantiles(pugi::xml_node node);
   int AddVTKmContour(pugi::xml_node node);
   int AddVTKmVolumeReduction(pugi::xml_node node);
   int AddVTKmCDF(pugi::xml_node node);
@@ -100,10 +131,57 @@ struct ConfigurableAnalysis::InternalsType
   int AddCatalyst(pugi::xml_node node);
   int AddLibsim(pugi::xml_node node);
   int AddAutoCorrelation(pugi::xml_node node);
+  int AddTemporalStatistics(pugi::xml_node node);
   int AddPosthocIO(pugi::xml_node node);
   int AddVTKAmrWriter(pugi::xml_node node);
   int AddPythonAnalysis(pugi::xml_node node);
   int AddSliceExtract(pugi::xml_node node);
+  int AddSubsample(pugi::xml_node node);
+
+  // calls the above Add method matching the analysis type. returns
+  // 0 if the analysis was added
+  int AddAnalysis(const std::string &type, pugi::xml_node node);
+
+  // creates and initializes the triggers given by the trigger elements
+  // of the node and attaches them to the analyses added since the n'th
+  int AddTriggers(pugi::xml_node node, const std::string &type,
+    unsigned int n);
+
+  // creates a trigger that calls the Trigger function of a python script
+  int AddPythonTrigger(pugi::xml_node node, PredicateTrigger *trigger);
+
+  // calls Execute on each of the analyses. when an analysis fails
+  // MPI_Abort is called.
+  void ExecuteAnalyses(MPI_Comm comm, DataAdaptor *data);
+
+  // calls Execute on the ai'th analysis, recording the time taken
+  void ExecuteAnalysis(MPI_Comm comm, unsigned int ai, DataAdaptor *data);
+
+  // merges the data an analysis needs into the set of data that is
+  // snapshotted in asynchronous mode. the data is identified by
+  // the mesh, array, and association attributes and/or mesh elements.
+  // if nothing is found all of the data will be snapshotted.
+  void AddAsyncRequirements(pugi::xml_node node);
+
+  // copy the data needed by the analyses into the snapshot
+  int Snapshot(DataAdaptor *data, VTKDataAdaptor *snap);
+
+  // start and stop the background thread used in asynchronous mode.
+  // stopping blocks until all queued steps have been processed.
+  int StartAsync(MPI_Comm comm);
+  int StopAsync();
+
+  // snapshot the data and queue it for processing. blocks if the queue
+  // is full.
+  int ExecuteAsync(MPI_Comm comm, DataAdaptor *data);
+
+  // the body of the background thread
+  void AsyncLoop();
+
+  // register the analyses added since the n'th with the scheduler. the
+  // priority and min_cadence attributes are read from the node.
+  void AddToScheduler(pugi::xml_node node, const std::string &type,
+    unsigned int n);
 
 public:
   // list of all analyses. api calls are forwareded to each
@@ -128,8 +206,84 @@ public:
   MPI_Comm Comm;
 
   std::vector<std::string> LogEventNames;
+
+  // asynchronous execution. snapshots of the simulation data are passed
+  // to a background thread through a bounded queue. the snapshot adaptors
+  // are recycled, there are AsyncQueueDepth of them
+  int Async;
+  int AsyncDeepCopy;
+  unsigned int AsyncQueueDepth;
+  bool AsyncSnapshotAll;
+  DataRequirements AsyncRequirements;
+  MPI_Comm AsyncComm;
+  std::vector<VTKDataAdaptorPtr> AsyncFree;
+  std::deque<VTKDataAdaptorPtr> AsyncQueue;
+  std::thread AsyncThread;
+  std::mutex AsyncMutex;
+  std::condition_variable AsyncCond;
+  bool AsyncDone;
+
+  // statistics used to report how much of the analysis time was hidden
+  long AsyncSteps;
+  double AsyncExecTime;
+  double AsyncWaitTime;
+  double AsyncSnapshotTime;
+
+  // decides which analyses run on each step when a time budget is given.
+  // there is one entry in the scheduler for each analysis
+  TimeBudgetScheduler Scheduler;
+
+  // decides which analyses run on each step from the triggers attached
+  // to them
+  TriggerSet Triggers;
+
+  // meshes and arrays are shared by the analyses during a step
+  int EnableCache;
+  CachingDataAdaptorPtr Cache;
+
+  // runs thread safe analyses concurrently
+  ThreadPool Pool;
 };
 
+// --------------------------------------------------------------------------
+static double getSystemTime()
+{
+  using namespace std::chrono;
+  return duration_cast<duration<double>>(
+    steady_clock::now().time_since_epoch()).count();
+}
+
+// --------------------------------------------------------------------------
+// split a comma or space separated list
+static std::vector<std::string> splitList(std::string str)
+{
+  std::replace(str.begin(), str.end(), ',', ' ');
+
+  std::vector<std::string> items;
+  std::istringstream iss(str);
+  std::string item;
+  while (iss >> item)
+    items.push_back(item);
+
+  return items;
+}
+
+// --------------------------------------------------------------------------
+// strip a component selection, name:N or name:mag, from an array name
+static std::string getArrayName(const std::string &var)
+{
+  size_t pos = var.rfind(':');
+  if (pos == std::string::npos)
+    return var;
+
+  std::string sel = var.substr(pos + 1);
+  if ((sel == "mag") || (sel == "magnitude") || (!sel.empty() &&
+    (sel.find_first_not_of("0123456789") == std::string::npos)))
+    return var.substr(0, pos);
+
+  return var;
+}
+
 // --------------------------------------------------------------------------
 int ConfigurableAnalysis::InternalsType::TimeInitialization(
   AnalysisAdaptorPtr adaptor, std::function<int()> initializer)
@@ -182,25 +336,194 @@ int ConfigurableAnalysis::InternalsType::AddHistogram(pugi::xml_node node)
   int bins = node.attribute("bins").as_int(10);
   std::string fileName = node.attribute("file").value();
 
+  // a comma or space separated list of arrays, each is histogramed in the
+  // same pass over the data
+  std::vector<std::string> arrays = splitList(array);
+
   auto histogram = vtkSmartPointer<Histogram>::New();
 
   if (this->Comm != MPI_COMM_NULL)
     histogram->SetCommunicator(this->Comm);
 
+  // overlap the reductions with computation, and optionally skip the
+  // range reduction using a given range or that of the previous step
+  histogram->SetPipelined(node.attribute("pipelined").as_int(0));
+
+  // format="series" appends all steps to a single binary file
+  histogram->SetTimeSeries(
+    std::string(node.attribute("format").as_string("text")) == "series");
+
+  std::string range = node.attribute("range").as_string("");
+  if (range == "previous")
+    {
+    histogram->SetUsePreviousRange(1);
+    }
+  else if (!range.empty())
+    {
+    std::replace(range.begin(), range.end(), ',', ' ');
+    std::istringstream riss(range);
+    double rmin = 0.0, rmax = 0.0;
+    if (!(riss >> rmin >> rmax) || (rmin >= rmax))
+      {
+      SENSEI_ERROR("Invalid histogram range \""
+        << node.attribute("range").value() << "\"")
+      return -1;
+      }
+    histogram->SetRange(rmin, rmax);
+    }
+
   this->TimeInitialization(histogram, [&]() {
-      histogram->Initialize(bins, mesh, association, array, fileName);
+      histogram->Initialize(bins, mesh, association, arrays, fileName);
       return 0;
     });
   this->Analyses.push_back(histogram.GetPointer());
 
   SENSEI_STATUS("Configured histogram with " << bins
-    << " bins on " << assocStr << " data array \"" << array
-    << "\" on mesh \"" << mesh << "\" writing output to "
+    << " bins on " << assocStr << " data array" << (arrays.size() > 1 ? "s" : "")
+    << " \"" << array << "\" on mesh \"" << mesh << "\" writing output to "
     << (fileName.empty() ? "cout" : "file"))
 
   return 0;
 }
 
+// --------------------------------------------------------------------------
+int ConfigurableAnalysis::InternalsType::AddJointHistogram(pugi::xml_node node)
+{
+  if (XMLUtils::RequireAttribute(node, "mesh") || XMLUtils::RequireAttribute(node, "array"))
+    {
+    SENSEI_ERROR("Failed to initialize JointHistogram");
+    return -1;
+    }
+
+  int association = 0;
+  std::string assocStr = node.attribute("association").as_string("point");
+  if (VTKUtils::GetAssociation(assocStr, association))
+    {
+    SENSEI_ERROR("Failed to initialize JointHistogram");
+    return -1;
+    }
+
+  std::string mesh = node.attribute("mesh").value();
+  std::string array = node.attribute("array").value();
+  std::string fileName = node.attribute("file").value();
+
+  // comma or space separated lists of the arrays, the number of bins of
+  // each or one for all, and optionally a min and max for each
+  std::vector<std::string> arrays = splitList(array);
+
+  std::string tmp = node.attribute("bins").as_string("10");
+  std::replace(tmp.begin(), tmp.end(), ',', ' ');
+  std::vector<int> bins;
+  std::istringstream biss(tmp);
+  int nBins = 0;
+  while (biss >> nBins)
+    bins.push_back(nBins);
+
+  tmp = node.attribute("range").as_string("");
+  std::replace(tmp.begin(), tmp.end(), ',', ' ');
+  std::vector<double> ranges;
+  std::istringstream riss(tmp);
+  double val = 0.0;
+  while (riss >> val)
+    ranges.push_back(val);
+
+  if ((arrays.size() < 2) || ((bins.size() != 1) && (bins.size() != arrays.size()))
+    || (!ranges.empty() && (ranges.size() != 2*arrays.size())))
+    {
+    SENSEI_ERROR("A joint histogram needs two or more arrays, one number of"
+      " bins or one for each array, and optionally a min and max for each")
+    return -1;
+    }
+
+  auto histogram = vtkSmartPointer<JointHistogram>::New();
+
+  if (this->Comm != MPI_COMM_NULL)
+    histogram->SetCommunicator(this->Comm);
+
+  histogram->SetRanges(ranges);
+
+  if (node.attribute("dense_limit"))
+    histogram->SetDenseLimit(node.attribute("dense_limit").as_uint());
+
+  this->TimeInitialization(histogram, [&]() {
+      histogram->Initialize(mesh, association, arrays, bins, fileName);
+      return 0;
+    });
+  this->Analyses.push_back(histogram.GetPointer());
+
+  SENSEI_STATUS("Configured joint histogram of " << assocStr
+    << " data arrays \"" << array << "\" on mesh \"" << mesh
+    << "\" writing output to " << (fileName.empty() ? "nowhere" : "file"))
+
+  return 0;
+}
+
+// --------------------------------------------------------------------------
+int ConfigurableAnalysis::InternalsType::AddQuantiles(pugi::xml_node node)
+{
+  if (XMLUtils::RequireAttribute(node, "mesh") || XMLUtils::RequireAttribute(node, "array"))
+    {
+    SENSEI_ERROR("Failed to initialize Quantiles");
+    return -1;
+    }
+
+  int association = 0;
+  std::string assocStr = node.attribute("association").as_string("point");
+  if (VTKUtils::GetAssociation(assocStr, association))
+    {
+    SENSEI_ERROR("Failed to initialize Quantiles");
+    return -1;
+    }
+
+  std::string mesh = node.attribute("mesh").value();
+  std::string array = node.attribute("array").value();
+  int k = node.attribute("k").as_int(200);
+  std::string fileName = node.attribute("file").value();
+
+  // either a comma or space separated list of quantiles, or a number of
+  // evenly spaced quantiles describing the CDF
+  std::vector<double> quantiles;
+  std::string qstr = node.attribute("quantiles").as_string("");
+  std::replace(qstr.begin(), qstr.end(), ',', ' ');
+  std::istringstream iss(qstr);
+  double q = 0.0;
+  while (iss >> q)
+    {
+    if ((q < 0.0) || (q > 1.0))
+      {
+      SENSEI_ERROR("Invalid quantile " << q << " not in [0, 1]")
+      return -1;
+      }
+    quantiles.push_back(q);
+    }
+
+  int nQuantiles = node.attribute("num_quantiles").as_int(10);
+
+  auto analysis = vtkSmartPointer<Quantiles>::New();
+
+  if (this->Comm != MPI_COMM_NULL)
+    analysis->SetCommunicator(this->Comm);
+
+  // format="series" appends all steps to a single binary file
+  analysis->SetTimeSeries(
+    std::string(node.attribute("format").as_string("text")) == "series");
+
+  this->TimeInitialization(analysis, [&]() {
+      if (quantiles.empty())
+        analysis->Initialize(mesh, association, array, nQuantiles, k, fileName);
+      else
+        analysis->Initialize(mesh, association, array, quantiles, k, fileName);
+      return 0;
+    });
+  this->Analyses.push_back(analysis.GetPointer());
+
+  SENSEI_STATUS("Configured quantiles of " << assocStr << " data array \""
+    << array << "\" on mesh \"" << mesh << "\" with k " << k
+    << " writing output to " << (fileName.empty() ? "cout" : "file"))
+
+  return 0;
+}
+
 // --------------------------------------------------------------------------
 int ConfigurableAnalysis::InternalsType::AddVTKmContour(pugi::xml_node node)
 {
@@ -306,6 +629,10 @@ int ConfigurableAnalysis::InternalsType::AddVTKmCDF(pugi::xml_node node)
     analysis->Initialize(mesh, field, assoc, workDir, quantiles, exchangeSize, this->Comm);
     return 0;
   });
+
+  // append all steps to a single file instead of a Cinema database
+  analysis->SetTimeSeriesFile(node.attribute("time-series-file").as_string(""));
+
   this->Analyses.push_back(analysis.GetPointer());
 
   SENSEI_STATUS("Configured VTKmCDFAnalysis " << mesh << "/" << field)
@@ -816,15 +1143,23 @@ int ConfigurableAnalysis::InternalsType::AddAutoCorrelation(pugi::xml_node node)
 
   int window = node.attribute("window").as_int(10);
   int kMax = node.attribute("k-max").as_int(3);
-  int numThreads = node.attribute("n-threads").as_int(1);
+  int numThreads = node.attribute("n-threads").as_int(0);
+  int stride = node.attribute("stride").as_int(1);
+  bool halfPrecision = node.attribute("half-precision").as_int(0);
+  int interval = node.attribute("interval").as_int(0);
+  std::string fileName = node.attribute("file").value();
 
   auto adaptor = vtkSmartPointer<Autocorrelation>::New();
 
   if (this->Comm != MPI_COMM_NULL)
     adaptor->SetCommunicator(this->Comm);
 
+  adaptor->SetOutputFileName(fileName);
+  adaptor->SetInterval(interval);
+
   this->TimeInitialization(adaptor, [&]() {
-    adaptor->Initialize(window, meshName, assoc, arrayName, kMax);
+    adaptor->Initialize(window, meshName, assoc, arrayName, kMax,
+      numThreads, stride, halfPrecision);
     return 0;
   });
 
@@ -833,7 +1168,148 @@ int ConfigurableAnalysis::InternalsType::AddAutoCorrelation(pugi::xml_node node)
   SENSEI_STATUS("Configured Autocorrelation " << assocStr
     << " data array \"" << arrayName << "\" on mesh \"" << meshName
     << "\" window " << window << " k-max " << kMax
-    << " n-threads " << numThreads)
+    << " n-threads " << numThreads << " stride " << stride
+    << (halfPrecision ? " half precision" : "") << " interval " << interval
+    << " writing output to " << (fileName.empty() ? "stderr" : "file"))
+
+  return 0;
+}
+
+// --------------------------------------------------------------------------
+int ConfigurableAnalysis::InternalsType::AddTemporalStatistics(pugi::xml_node node)
+{
+  if (XMLUtils::RequireAttribute(node, "mesh") || XMLUtils::RequireAttribute(node, "array"))
+    {
+    SENSEI_ERROR("Failed to initialize TemporalStatistics");
+    return -1;
+    }
+
+  std::string meshName = node.attribute("mesh").value();
+
+  std::string assocStr = node.attribute("association").as_string("point");
+  int assoc = 0;
+  if (VTKUtils::GetAssociation(assocStr, assoc))
+    {
+    SENSEI_ERROR("Failed to initialize TemporalStatistics");
+    return -1;
+    }
+
+  // a comma or space separated list of arrays
+  std::string arrayStr = node.attribute("array").value();
+  std::vector<std::string> arrayNames = splitList(arrayStr);
+
+  double alpha = node.attribute("ema").as_double(0.0);
+  int interval = node.attribute("interval").as_int(0);
+
+  // the writer is configured by a nested element in the same way as the
+  // analysis of the same type. it is taken back off the list of analyses
+  // so that it only sees the statistics.
+  AnalysisAdaptorPtr writer;
+  if (pugi::xml_node writerNode = node.child("writer"))
+    {
+    std::string type = writerNode.attribute("type").value();
+    unsigned int nAnalyses = this->Analyses.size();
+    if (!(((type == "PosthocIO") && !this->AddPosthocIO(writerNode))
+      || ((type == "VTKAmrWriter") && !this->AddVTKAmrWriter(writerNode))
+      || ((type == "adios2") && !this->AddAdios2(writerNode))
+      || ((type == "hdf5") && !this->AddHDF5(writerNode)))
+      || (this->Analyses.size() != nAnalyses + 1))
+      {
+      SENSEI_ERROR("Failed to add the \"" << type
+        << "\" writer of TemporalStatistics")
+      return -1;
+      }
+    writer = this->Analyses.back();
+    this->Analyses.pop_back();
+    }
+
+  auto adaptor = vtkSmartPointer<TemporalStatistics>::New();
+
+  if (this->Comm != MPI_COMM_NULL)
+    adaptor->SetCommunicator(this->Comm);
+
+  adaptor->SetWriter(writer);
+
+  this->TimeInitialization(adaptor, [&]() {
+    adaptor->Initialize(meshName, assoc, arrayNames, alpha, interval);
+    return 0;
+  });
+
+  this->Analyses.push_back(adaptor.GetPointer());
+
+  SENSEI_STATUS("Configured TemporalStatistics " << assocStr
+    << " data arrays \"" << arrayStr << "\" on mesh \"" << meshName
+    << "\" ema " << alpha << " interval " << interval << " writer "
+    << (writer ? writer->GetClassName() : "none"))
+
+  return 0;
+}
+
+// --------------------------------------------------------------------------
+int ConfigurableAnalysis::InternalsType::AddSubsample(pugi::xml_node node)
+{
+  auto adaptor = vtkSmartPointer<SubsampleAnalysis>::New();
+
+  if (this->Comm != MPI_COMM_NULL)
+    adaptor->SetCommunicator(this->Comm);
+
+  SubsampleDataAdaptor *subsampler = adaptor->GetSubsampler();
+  if (subsampler->Initialize(node))
+    {
+    SENSEI_ERROR("Failed to initialize the subsampling")
+    return -1;
+    }
+
+  // the analyses run on the subsampled data are configured by nested
+  // elements in the same way as the analyses of the same type. they are
+  // taken back off the list of analyses so that they only see the
+  // subsampled data.
+  for (pugi::xml_node child = node.child("analysis");
+    child; child = child.next_sibling("analysis"))
+    {
+    if (!child.attribute("enabled").as_int(1))
+      continue;
+
+    if (this->Async)
+      this->AddAsyncRequirements(child);
+
+    std::string type = child.attribute("type").value();
+    unsigned int nAnalyses = this->Analyses.size();
+    if (this->AddAnalysis(type, child) ||
+      (this->Analyses.size() != nAnalyses + 1))
+      {
+      SENSEI_ERROR("Failed to add the \"" << type
+        << "\" analysis of the subsampling")
+      return -1;
+      }
+
+    adaptor->AddAnalysis(this->Analyses.back());
+    this->Analyses.pop_back();
+    }
+
+  // importance sampling needs the weights in the snapshot
+  if (this->Async)
+    {
+    for (pugi::xml_node meshNode = node.child("mesh");
+      meshNode; meshNode = meshNode.next_sibling("mesh"))
+      {
+      if (std::string(meshNode.attribute("method").value()) != "importance")
+        continue;
+
+      int association = 0;
+      std::string assocStr = meshNode.attribute("association").as_string("point");
+      VTKUtils::GetAssociation(assocStr, association);
+
+      this->AsyncRequirements.AddRequirement(meshNode.attribute("name").value(),
+        association, std::string(meshNode.attribute("array").value()));
+      }
+    }
+
+  this->TimeInitialization(adaptor);
+  this->Analyses.push_back(adaptor.GetPointer());
+
+  SENSEI_STATUS("Configured SubsampleAnalysis with "
+    << adaptor->GetNumberOfAnalyses() << " analyses")
 
   return 0;
 }
@@ -1109,66 +1585,713 @@ int ConfigurableAnalysis::InternalsType::AddSliceExtract(pugi::xml_node node)
 }
 
 
-
-
-//----------------------------------------------------------------------------
-senseiNewMacro(ConfigurableAnalysis);
-
-//----------------------------------------------------------------------------
-ConfigurableAnalysis::ConfigurableAnalysis()
-  : Internals(new ConfigurableAnalysis::InternalsType())
+// --------------------------------------------------------------------------
+void ConfigurableAnalysis::InternalsType::ExecuteAnalyses(MPI_Comm comm,
+  DataAdaptor *data)
 {
-}
+  // in transit adaptors are passed to the analyses as is. an analysis may
+  // set a partitioner on one, which changes the data it serves, and
+  // so must be able to find it. such adaptors are neither cached nor
+  // shared between threads
+  bool inTransit = dynamic_cast<InTransitDataAdaptor*>(data);
+
+  // share meshes and arrays between the analyses. when the analyses run
+  // concurrently the cache is what makes access to the data thread safe
+  bool concurrent = !inTransit && (this->Pool.GetNumberOfThreads() > 0);
+
+  DataAdaptor *da = data;
+  if (!inTransit && (this->EnableCache || concurrent))
+    {
+    if (!this->Cache)
+      {
+      this->Cache = CachingDataAdaptorPtr::New();
+      this->Cache->SetCommunicator(comm);
+      this->Cache->SetThreadSafe(concurrent);
+      }
+    this->Cache->SetDataAdaptor(data);
+    da = this->Cache;
+    }
 
-//----------------------------------------------------------------------------
-ConfigurableAnalysis::~ConfigurableAnalysis()
-{
-  delete this->Internals;
-}
+  // decide which analyses run this step. the triggers go first, through
+  // the cache so that the data they touch is shared with the analyses,
+  // and the scheduler considers only the analyses they let through
+  std::vector<int> run;
+  if (!this->Triggers.Empty() &&
+    this->Triggers.Evaluate(comm, da, this->Analyses.size(), run))
+    {
+    SENSEI_ERROR("Failed to evaluate the triggers")
+    MPI_Abort(comm, -1);
+    }
 
-//----------------------------------------------------------------------------
-int ConfigurableAnalysis::SetCommunicator(MPI_Comm comm)
-{
-  this->AnalysisAdaptor::SetCommunicator(comm);
+  if (this->Scheduler.Enabled() && this->Scheduler.Schedule(comm, run))
+    {
+    SENSEI_ERROR("Failed to schedule the analyses")
+    MPI_Abort(comm, -1);
+    }
 
-  // save the communicator for use with adaptors created
-  // during XML parsing
-  this->Internals->Comm = comm;
+  if (concurrent)
+    {
+    // generate the metadata up front. metadata requests may involve
+    // collectives on the data adaptor's communicator which must be
+    // issued in the same order on all ranks. after this, requests made
+    // from the analyses' threads are served from the cache
+    unsigned int nMeshes = 0;
+    if (da->GetNumberOfMeshes(nMeshes))
+      {
+      SENSEI_ERROR("Failed to get the number of meshes")
+      MPI_Abort(comm, -1);
+      }
 
-  // set the communicator on existing adaptors, if there are any
-  AnalysisAdaptorVector::iterator iter = this->Internals->Analyses.begin();
-  AnalysisAdaptorVector::iterator end = this->Internals->Analyses.end();
+    for (unsigned int i = 0; i < nMeshes; ++i)
+      {
+      MeshMetadataFlags flags;
+      flags.SetAll();
 
-  for (; iter != end; ++iter)
-    (*iter)->SetCommunicator(comm);
+      MeshMetadataPtr md = MeshMetadata::New(flags);
+      if (da->GetMeshMetadata(i, md))
+        {
+        SENSEI_ERROR("Failed to get metadata for mesh " << i)
+        MPI_Abort(comm, -1);
+        }
+      }
 
-  return 0;
-}
+    // thread safe analyses run on the pool, the rest run here one at
+    // a time while the pool works
+    std::vector<unsigned int> serial;
 
+    unsigned int nAnalyses = this->Analyses.size();
+    for (unsigned int ai = 0; ai < nAnalyses; ++ai)
+      {
+      if (!run.empty() && !run[ai])
+        continue;
 
-//----------------------------------------------------------------------------
-int ConfigurableAnalysis::Initialize(const std::string& filename)
-{
-  TimeEvent<128> event("ConfigurableAnalysis::Initialize");
+      if (this->Analyses[ai]->GetThreadSafe())
+        this->Pool.Push([this,comm,ai,da]() { this->ExecuteAnalysis(comm, ai, da); });
+      else
+        serial.push_back(ai);
+      }
 
-  pugi::xml_document doc;
-  if (XMLUtils::Parse(this->GetCommunicator(), filename, doc))
-    {
-    SENSEI_ERROR("Failed to load, parse, and share XML configuration")
-    MPI_Abort(this->GetCommunicator(), -1);
-    return -1;
+    unsigned int nSerial = serial.size();
+    for (unsigned int i = 0; i < nSerial; ++i)
+      this->ExecuteAnalysis(comm, serial[i], da);
+
+    // join
+    this->Pool.Wait();
     }
+  else
+    {
+    unsigned int nAnalyses = this->Analyses.size();
+    for (unsigned int ai = 0; ai < nAnalyses; ++ai)
+      {
+      if (!run.empty() && !run[ai])
+        continue;
 
-  pugi::xml_node root = doc.child("sensei");
+      this->ExecuteAnalysis(comm, ai, da);
+      }
+    }
 
-  return Initialize(root);
+  // the cached data is only valid during this step
+  if (this->Cache)
+    this->Cache->SetDataAdaptor(nullptr);
 }
 
-//----------------------------------------------------------------------------
+// --------------------------------------------------------------------------
+void ConfigurableAnalysis::InternalsType::ExecuteAnalysis(MPI_Comm comm,
+  unsigned int ai, DataAdaptor *data)
+{
+  AnalysisAdaptorPtr &analysis = this->Analyses[ai];
+
+  const char* analysisName = nullptr;
+  bool logEnabled = Profiler::Enabled();
+  if (logEnabled)
+    {
+    analysisName = this->LogEventNames[3 * ai + 1].c_str();
+    Profiler::StartEvent(analysisName);
+    }
+
+  double t0 = getSystemTime();
+
+  if (!analysis->Execute(data))
+    {
+    SENSEI_ERROR("Failed to execute " << analysis->GetClassName())
+    MPI_Abort(comm, -1);
+    }
+
+  this->Scheduler.SetExecuteTime(ai, getSystemTime() - t0);
+
+  if (logEnabled)
+    Profiler::EndEvent(analysisName);
+}
+
+// --------------------------------------------------------------------------
+int ConfigurableAnalysis::InternalsType::AddAnalysis(const std::string &type,
+  pugi::xml_node node)
+{
+  if (!(((type == "histogram") && !this->AddHistogram(node))
+    || ((type == "joint_histogram") && !this->AddJointHistogram(node))
+    || ((type == "quantiles") && !this->AddQuantiles(node))
+    || ((type == "autocorrelation") && !this->AddAutoCorrelation(node))
+    || ((type == "temporal_statistics") && !this->AddTemporalStatistics(node))
+    || ((type == "adios1") && !this->AddAdios1(node))
+    || ((type == "adios2") && !this->AddAdios2(node))
+    || ((type == "ascent") && !this->AddAscent(node))
+    || ((type == "catalyst") && !this->AddCatalyst(node))
+    || ((type == "hdf5") && !this->AddHDF5(node))
+    || ((type == "libsim") && !this->AddLibsim(node))
+    || ((type == "PosthocIO") && !this->AddPosthocIO(node))
+    || ((type == "VTKAmrWriter") && !this->AddVTKAmrWriter(node))
+    || ((type == "vtkmcontour") && !this->AddVTKmContour(node))
+    || ((type == "vtkmhaar") && !this->AddVTKmVolumeReduction(node))
+    || ((type == "cdf") && !this->AddVTKmCDF(node))
+    || ((type == "python") && !this->AddPythonAnalysis(node))
+    || ((type == "SliceExtract") && !this->AddSliceExtract(node))
+    || ((type == "subsample") && !this->AddSubsample(node))))
+    return -1;
+
+  return 0;
+}
+
+// --------------------------------------------------------------------------
+int ConfigurableAnalysis::InternalsType::AddPythonTrigger(pugi::xml_node node,
+  PredicateTrigger *trigger)
+{
+#if !defined(ENABLE_PYTHON)
+  (void)node;
+  (void)trigger;
+  SENSEI_ERROR("A python trigger was requested but python is disabled in this build")
+  return -1;
+#else
+  if (!node.attribute("script_file") && !node.attribute("script_module"))
+    {
+    SENSEI_ERROR("Failed to initialize the python trigger. Missing "
+      "a required attribute: script_file or script_module");
+    return -1;
+    }
+
+  std::string initSource;
+  pugi::xml_node inode = node.child("initialize_source");
+  if (inode)
+    initSource = inode.text().as_string();
+
+  vtkSmartPointer<PythonAnalysis> pyAnalysis =
+    vtkSmartPointer<PythonAnalysis>::New();
+
+  if (this->Comm != MPI_COMM_NULL)
+    pyAnalysis->SetCommunicator(this->Comm);
+
+  pyAnalysis->SetScriptFile(node.attribute("script_file").value());
+  pyAnalysis->SetScriptModule(node.attribute("script_module").value());
+  pyAnalysis->SetInitializeSource(initSource);
+
+  if (pyAnalysis->Initialize())
+    {
+    SENSEI_ERROR("Failed to initialize the python trigger")
+    return -1;
+    }
+
+  trigger->SetPredicate([pyAnalysis](DataAdaptor *data, int &vote) -> int
+    { return pyAnalysis->EvaluateTrigger(data, vote); });
+
+  trigger->SetFinalize([pyAnalysis]() -> int
+    { return pyAnalysis->Finalize(); });
+
+  return 0;
+#endif
+}
+
+// --------------------------------------------------------------------------
+int ConfigurableAnalysis::InternalsType::AddTriggers(pugi::xml_node node,
+  const std::string &type, unsigned int n)
+{
+  unsigned int nAnalyses = this->Analyses.size();
+
+  for (pugi::xml_node tnode = node.child("trigger");
+    tnode; tnode = tnode.next_sibling("trigger"))
+    {
+    std::string triggerType = tnode.attribute("type").value();
+
+    vtkSmartPointer<AnalysisTrigger> trigger;
+    if (triggerType == "range")
+      {
+      trigger.TakeReference(ArrayRangeTrigger::New());
+      }
+    else if (triggerType == "entropy")
+      {
+      trigger.TakeReference(EntropyTrigger::New());
+      }
+    else if (triggerType == "python")
+      {
+      PredicateTrigger *pred = PredicateTrigger::New();
+      trigger.TakeReference(pred);
+      if (this->AddPythonTrigger(tnode, pred))
+        return -1;
+      }
+    else
+      {
+      SENSEI_ERROR("Invalid trigger type \"" << triggerType << "\". The "
+        "trigger type is one of range, entropy, or python")
+      return -1;
+      }
+
+    if (trigger->Initialize(tnode))
+      {
+      SENSEI_ERROR("Failed to initialize the \"" << triggerType
+        << "\" trigger of \"" << type << "\"")
+      return -1;
+      }
+
+    // the data the trigger looks at must be in the snapshot
+    if (this->Async)
+      this->AddAsyncRequirements(tnode);
+
+    this->Triggers.AddTrigger(n, nAnalyses, type, trigger);
+
+    SENSEI_STATUS("Configured \"" << triggerType << "\" trigger for \""
+      << type << "\"")
+    }
+
+  return 0;
+}
+
+// --------------------------------------------------------------------------
+void ConfigurableAnalysis::InternalsType::AddToScheduler(pugi::xml_node node,
+  const std::string &type, unsigned int n)
+{
+  int priority = node.attribute("priority").as_int(0);
+  unsigned int minCadence = node.attribute("min_cadence").as_uint(0);
+
+  unsigned int nAnalyses = this->Analyses.size();
+  for (unsigned int i = n; i < nAnalyses; ++i)
+    this->Scheduler.AddAnalysis(type, priority, minCadence);
+}
+
+// --------------------------------------------------------------------------
+void ConfigurableAnalysis::InternalsType::AddAsyncRequirements(
+  pugi::xml_node node)
+{
+  DataRequirements req;
+
+  // analyses that describe their needs with mesh elements
+  req.Initialize(node);
+
+  // analyses that describe their needs with attributes. the array
+  // attribute may be a list of arrays with component selections, as for
+  // the histogram, joint histogram, and temporal statistics
+  pugi::xml_attribute arrayAtt = node.attribute("array");
+  if (!arrayAtt)
+    arrayAtt = node.attribute("field");
+
+  if (node.attribute("mesh") && arrayAtt)
+    {
+    int association = 0;
+    std::string assocStr = node.attribute("association").as_string("point");
+    VTKUtils::GetAssociation(assocStr, association);
+
+    std::vector<std::string> arrays = splitList(arrayAtt.value());
+
+    unsigned int nArrays = arrays.size();
+    for (unsigned int i = 0; i < nArrays; ++i)
+      {
+      req.AddRequirement(node.attribute("mesh").value(),
+        association, getArrayName(arrays[i]));
+      }
+    }
+
+  // SliceExtract's iso-surface values
+  pugi::xml_node valsNode = node.child("iso_values");
+  if (valsNode && valsNode.attribute("mesh_name") &&
+    valsNode.attribute("array_name"))
+    {
+    int association = 0;
+    std::string assocStr = valsNode.attribute("array_centering").as_string("point");
+    VTKUtils::GetAssociation(assocStr, association);
+
+    req.AddRequirement(valsNode.attribute("mesh_name").value(),
+      association, std::string(valsNode.attribute("array_name").value()));
+    }
+
+  // when we can't tell what the analysis needs send it everything
+  if (req.Empty())
+    this->AsyncSnapshotAll = true;
+  else
+    this->AsyncRequirements.AddRequirements(req);
+}
+
+// --------------------------------------------------------------------------
+int ConfigurableAnalysis::InternalsType::Snapshot(DataAdaptor *data,
+  VTKDataAdaptor *snap)
+{
+  TimeEvent<128> mark("ConfigurableAnalysis::Snapshot");
+
+  DataRequirements allReq;
+  const DataRequirements *req = &this->AsyncRequirements;
+  if (this->AsyncSnapshotAll)
+    {
+    if (allReq.Initialize(data, false))
+      {
+      SENSEI_ERROR("Failed to initialize the data description")
+      return -1;
+      }
+    req = &allReq;
+    }
+
+  MeshMetadataMap mdMap;
+  if (mdMap.Initialize(data))
+    {
+    SENSEI_ERROR("Failed to get metadata")
+    return -1;
+    }
+
+  MeshRequirementsIterator mit = req->GetMeshRequirementsIterator();
+  for (; mit; ++mit)
+    {
+    const std::string &meshName = mit.MeshName();
+
+    MeshMetadataPtr mmd;
+    if (mdMap.GetMeshMetadata(meshName, mmd))
+      {
+      SENSEI_ERROR("Failed to get metadata for mesh \"" << meshName << "\"")
+      return -1;
+      }
+
+    // always work with a composite dataset, this way every rank has an
+    // object even if it has no local blocks
+    vtkCompositeDataSet *mesh = nullptr;
+    if (data->GetMesh(meshName, mit.StructureOnly(), mesh))
+      {
+      SENSEI_ERROR("Failed to get mesh \"" << meshName << "\"")
+      return -1;
+      }
+
+    if ((mmd->NumGhostCells || VTKUtils::AMR(mmd)) &&
+      data->AddGhostCellsArray(mesh, meshName))
+      {
+      SENSEI_ERROR("Failed to get ghost cells for mesh \"" << meshName << "\"")
+      mesh->Delete();
+      return -1;
+      }
+
+    if (mmd->NumGhostNodes && data->AddGhostNodesArray(mesh, meshName))
+      {
+      SENSEI_ERROR("Failed to get ghost nodes for mesh \"" << meshName << "\"")
+      mesh->Delete();
+      return -1;
+      }
+
+    int zeroCopy = 0;
+    ArrayRequirementsIterator ait = req->GetArrayRequirementsIterator(meshName);
+    ait.SetMode(ArrayRequirementsIterator::MODE_ASSOCIATION);
+    for (; ait; ++ait)
+      {
+      if (data->AddArrays(mesh, meshName, ait.Association(), ait.Arrays()))
+        {
+        SENSEI_ERROR("Failed to add " << VTKUtils::GetAttributesName(ait.Association())
+          << " data arrays to mesh \"" << meshName << "\"")
+        mesh->Delete();
+        return -1;
+        }
+
+      const std::vector<std::string> &arrays = ait.Arrays();
+      unsigned int nArrays = arrays.size();
+      for (unsigned int i = 0; (i < nArrays) && !zeroCopy; ++i)
+        {
+        if (data->GetArrayZeroCopy(meshName, ait.Association(),
+          arrays[i], zeroCopy))
+          {
+          SENSEI_ERROR("Failed to query array \"" << arrays[i]
+            << "\" on mesh \"" << meshName << "\"")
+          mesh->Delete();
+          return -1;
+          }
+        }
+      }
+
+    // deep copy decouples the snapshot from the simulation's memory.
+    // shallow copy hands the arrays to the background thread, the
+    // reference counts keep them alive until the snapshot is released.
+    // arrays that reference simulation memory are not valid after
+    // ReleaseData and are always deep copied
+    vtkCompositeDataSet *copy = mesh->NewInstance();
+    if (this->AsyncDeepCopy || zeroCopy)
+      copy->DeepCopy(mesh);
+    else
+      copy->ShallowCopy(mesh);
+
+    snap->SetDataObject(meshName, copy);
+
+    copy->Delete();
+    mesh->Delete();
+    }
+
+  snap->SetDataTime(data->GetDataTime());
+  snap->SetDataTimeStep(data->GetDataTimeStep());
+
+  return 0;
+}
+
+// --------------------------------------------------------------------------
+int ConfigurableAnalysis::InternalsType::StartAsync(MPI_Comm comm)
+{
+  int threadLevel = MPI_THREAD_SINGLE;
+  MPI_Query_thread(&threadLevel);
+  if (threadLevel < MPI_THREAD_MULTIPLE)
+    {
+    SENSEI_WARNING("Asynchronous execution requires MPI_THREAD_MULTIPLE."
+      " The analyses will be executed synchronously.")
+    this->Async = 0;
+    return 0;
+    }
+
+  if (this->AsyncQueueDepth < 1)
+    this->AsyncQueueDepth = 1;
+
+  // the snapshots live in their own communication space so that the
+  // background thread never shares a communicator with the simulation
+  MPI_Comm_dup(comm, &this->AsyncComm);
+
+  for (unsigned int i = 0; i < this->AsyncQueueDepth; ++i)
+    {
+    VTKDataAdaptorPtr snap = VTKDataAdaptorPtr::New();
+    snap->SetCommunicator(this->AsyncComm);
+    this->AsyncFree.push_back(snap);
+    }
+
+  this->AsyncDone = false;
+  this->AsyncThread = std::thread(&InternalsType::AsyncLoop, this);
+
+  return 0;
+}
+
+// --------------------------------------------------------------------------
+void ConfigurableAnalysis::InternalsType::AsyncLoop()
+{
+  while (true)
+    {
+    // wait for work
+    VTKDataAdaptorPtr snap;
+      {
+      std::unique_lock<std::mutex> lock(this->AsyncMutex);
+      this->AsyncCond.wait(lock, [this]() {
+        return !this->AsyncQueue.empty() || this->AsyncDone; });
+
+      if (this->AsyncQueue.empty())
+        return;
+
+      snap = this->AsyncQueue.front();
+      }
+
+    // process the step
+    double t0 = getSystemTime();
+
+    Profiler::StartEvent("ConfigurableAnalysis::AsyncExecute");
+    this->ExecuteAnalyses(this->AsyncComm, snap);
+    Profiler::EndEvent("ConfigurableAnalysis::AsyncExecute");
+
+    snap->ReleaseData();
+
+    double t1 = getSystemTime();
+
+    // return the snapshot for reuse
+      {
+      std::lock_guard<std::mutex> lock(this->AsyncMutex);
+      this->AsyncQueue.pop_front();
+      this->AsyncFree.push_back(snap);
+      this->AsyncExecTime += t1 - t0;
+      this->AsyncSteps += 1;
+      }
+    this->AsyncCond.notify_all();
+    }
+}
+
+// --------------------------------------------------------------------------
+int ConfigurableAnalysis::InternalsType::ExecuteAsync(MPI_Comm comm,
+  DataAdaptor *data)
+{
+  // get a free snapshot, blocking if the queue is full. the time spent
+  // here is analysis time that could not be hidden
+  double t0 = getSystemTime();
+
+  VTKDataAdaptorPtr snap;
+    {
+    Profiler::StartEvent("ConfigurableAnalysis::AsyncWait");
+    std::unique_lock<std::mutex> lock(this->AsyncMutex);
+    this->AsyncCond.wait(lock, [this]() { return !this->AsyncFree.empty(); });
+    snap = this->AsyncFree.back();
+    this->AsyncFree.pop_back();
+    Profiler::EndEvent("ConfigurableAnalysis::AsyncWait");
+    }
+
+  double t1 = getSystemTime();
+
+  // copy the data
+  if (this->Snapshot(data, snap))
+    {
+    SENSEI_ERROR("Failed to snapshot step " << data->GetDataTimeStep())
+    MPI_Abort(comm, -1);
+    return -1;
+    }
+
+  double t2 = getSystemTime();
+
+  // hand it to the background thread
+    {
+    std::lock_guard<std::mutex> lock(this->AsyncMutex);
+    this->AsyncQueue.push_back(snap);
+    this->AsyncWaitTime += t1 - t0;
+    this->AsyncSnapshotTime += t2 - t1;
+    }
+  this->AsyncCond.notify_all();
+
+  return 0;
+}
+
+// --------------------------------------------------------------------------
+int ConfigurableAnalysis::InternalsType::StopAsync()
+{
+  if (!this->AsyncThread.joinable())
+    return 0;
+
+  // drain the queue
+  double t0 = getSystemTime();
+
+  Profiler::StartEvent("ConfigurableAnalysis::AsyncDrain");
+    {
+    std::lock_guard<std::mutex> lock(this->AsyncMutex);
+    this->AsyncDone = true;
+    }
+  this->AsyncCond.notify_all();
+  this->AsyncThread.join();
+  Profiler::EndEvent("ConfigurableAnalysis::AsyncDrain");
+
+  this->AsyncWaitTime += getSystemTime() - t0;
+
+  // report how much of the analysis time was hidden from the simulation
+  double hidden = std::max(0.0, this->AsyncExecTime
+    - this->AsyncWaitTime - this->AsyncSnapshotTime);
+
+  double pctHidden = this->AsyncExecTime > 0.0 ?
+    100.0*hidden/this->AsyncExecTime : 0.0;
+
+  SENSEI_STATUS("Asynchronous execution of " << this->AsyncSteps
+    << " steps. analysis " << this->AsyncExecTime << " s, snapshot "
+    << this->AsyncSnapshotTime << " s, blocked " << this->AsyncWaitTime
+    << " s, hidden " << hidden << " s (" << pctHidden << "%)")
+
+  this->AsyncFree.clear();
+  this->AsyncQueue.clear();
+
+  MPI_Comm_free(&this->AsyncComm);
+
+  return 0;
+}
+
+
+//----------------------------------------------------------------------------
+senseiNewMacro(ConfigurableAnalysis);
+
+//----------------------------------------------------------------------------
+ConfigurableAnalysis::ConfigurableAnalysis()
+  : Internals(new ConfigurableAnalysis::InternalsType())
+{
+}
+
+//----------------------------------------------------------------------------
+ConfigurableAnalysis::~ConfigurableAnalysis()
+{
+  delete this->Internals;
+}
+
+//----------------------------------------------------------------------------
+int ConfigurableAnalysis::SetCommunicator(MPI_Comm comm)
+{
+  this->AnalysisAdaptor::SetCommunicator(comm);
+
+  // save the communicator for use with adaptors created
+  // during XML parsing
+  this->Internals->Comm = comm;
+
+  // set the communicator on existing adaptors, if there are any
+  AnalysisAdaptorVector::iterator iter = this->Internals->Analyses.begin();
+  AnalysisAdaptorVector::iterator end = this->Internals->Analyses.end();
+
+  for (; iter != end; ++iter)
+    (*iter)->SetCommunicator(comm);
+
+  return 0;
+}
+
+
+//----------------------------------------------------------------------------
+int ConfigurableAnalysis::Initialize(const std::string& filename)
+{
+  TimeEvent<128> event("ConfigurableAnalysis::Initialize");
+
+  pugi::xml_document doc;
+  if (XMLUtils::Parse(this->GetCommunicator(), filename, doc))
+    {
+    SENSEI_ERROR("Failed to load, parse, and share XML configuration")
+    MPI_Abort(this->GetCommunicator(), -1);
+    return -1;
+    }
+
+  pugi::xml_node root = doc.child("sensei");
+
+  return Initialize(root);
+}
+
+//----------------------------------------------------------------------------
 int ConfigurableAnalysis::Initialize(const pugi::xml_node &root)
 {
   TimeEvent<128> event("ConfigurableAnalysis::Initialize");
 
+  // time budget scheduling
+  pugi::xml_node schedNode = root.child("scheduler");
+  if (schedNode && schedNode.attribute("enabled").as_int(1)
+    && this->Internals->Scheduler.Initialize(schedNode))
+    {
+    SENSEI_ERROR("Failed to configure the scheduler")
+    MPI_Abort(this->GetCommunicator(), -1);
+    }
+
+  // share meshes and arrays between the analyses
+  this->Internals->EnableCache = root.attribute("cache").as_int(1);
+
+  // concurrent execution
+  unsigned int nThreads = root.attribute("threads").as_uint(0);
+  if (nThreads > 1)
+    {
+    int threadLevel = MPI_THREAD_SINGLE;
+    MPI_Query_thread(&threadLevel);
+    if (threadLevel < MPI_THREAD_MULTIPLE)
+      {
+      SENSEI_WARNING("Concurrent execution requires MPI_THREAD_MULTIPLE."
+        " The analyses will be executed one at a time.")
+      }
+    else
+      {
+      this->Internals->Pool.Initialize(nThreads);
+
+      SENSEI_STATUS("Configured concurrent execution with "
+        << nThreads << " threads")
+      }
+    }
+
+  // threads used for per-block work inside the analyses
+  unsigned int nBlockThreads = root.attribute("block_threads").as_uint(1);
+  if (nBlockThreads > 1)
+    {
+    VTKUtils::SetNumberOfThreads(nBlockThreads);
+
+    SENSEI_STATUS("Configured per-block processing with "
+      << nBlockThreads << " threads")
+    }
+
+  // asynchronous execution
+  this->Internals->Async = root.attribute("async").as_int(0);
+  this->Internals->AsyncQueueDepth = root.attribute("async_queue_depth").as_uint(1);
+  this->Internals->AsyncDeepCopy =
+    std::string(root.attribute("async_copy").as_string("deep")) != "shallow";
+
   // create and configure analysis adaptors
   for (pugi::xml_node node = root.child("analysis");
     node; node = node.next_sibling("analysis"))
@@ -1176,26 +2299,25 @@ int ConfigurableAnalysis::Initialize(const pugi::xml_node &root)
     if (!node.attribute("enabled").as_int(0))
       continue;
 
+    if (this->Internals->Async)
+      this->Internals->AddAsyncRequirements(node);
+
+    unsigned int nAnalyses = this->Internals->Analyses.size();
+
     std::string type = node.attribute("type").value();
-    if (!(((type == "histogram") && !this->Internals->AddHistogram(node))
-      || ((type == "autocorrelation") && !this->Internals->AddAutoCorrelation(node))
-      || ((type == "adios1") && !this->Internals->AddAdios1(node))
-      || ((type == "adios2") && !this->Internals->AddAdios2(node))
-      || ((type == "ascent") && !this->Internals->AddAscent(node))
-      || ((type == "catalyst") && !this->Internals->AddCatalyst(node))
-      || ((type == "hdf5") && !this->Internals->AddHDF5(node))
-      || ((type == "libsim") && !this->Internals->AddLibsim(node))
-      || ((type == "PosthocIO") && !this->Internals->AddPosthocIO(node))
-      || ((type == "VTKAmrWriter") && !this->Internals->AddVTKAmrWriter(node))
-      || ((type == "vtkmcontour") && !this->Internals->AddVTKmContour(node))
-      || ((type == "vtkmhaar") && !this->Internals->AddVTKmVolumeReduction(node))
-      || ((type == "cdf") && !this->Internals->AddVTKmCDF(node))
-      || ((type == "python") && !this->Internals->AddPythonAnalysis(node))
-      || ((type == "SliceExtract") && !this->Internals->AddSliceExtract(node))))
+    if (this->Internals->AddAnalysis(type, node))
       {
       SENSEI_ERROR("Failed to add \"" << type << "\" analysis")
       MPI_Abort(this->GetCommunicator(), -1);
       }
+
+    if (this->Internals->AddTriggers(node, type, nAnalyses))
+      {
+      SENSEI_ERROR("Failed to add the triggers of \"" << type << "\" analysis")
+      MPI_Abort(this->GetCommunicator(), -1);
+      }
+
+    this->Internals->AddToScheduler(node, type, nAnalyses);
     }
 
   // create and configure transport analysis adaptors
@@ -1205,6 +2327,11 @@ int ConfigurableAnalysis::Initialize(const pugi::xml_node &root)
     if (!node.attribute("enabled").as_int(0))
       continue;
 
+    if (this->Internals->Async)
+      this->Internals->AddAsyncRequirements(node);
+
+    unsigned int nAnalyses = this->Internals->Analyses.size();
+
     std::string type = node.attribute("type").value();
     if (!(((type == "adios1") && !this->Internals->AddAdios1(node))
       || ((type == "adios2") && !this->Internals->AddAdios2(node))
@@ -1213,6 +2340,23 @@ int ConfigurableAnalysis::Initialize(const pugi::xml_node &root)
       SENSEI_ERROR("Failed to add \"" << type << "\" transport")
       MPI_Abort(this->GetCommunicator(), -1);
       }
+
+    if (this->Internals->AddTriggers(node, type, nAnalyses))
+      {
+      SENSEI_ERROR("Failed to add the triggers of \"" << type << "\" transport")
+      MPI_Abort(this->GetCommunicator(), -1);
+      }
+
+    this->Internals->AddToScheduler(node, type, nAnalyses);
+    }
+
+  if (this->Internals->Async)
+    {
+    this->Internals->StartAsync(this->GetCommunicator());
+
+    SENSEI_STATUS("Configured asynchronous execution with queue depth "
+      << this->Internals->AsyncQueueDepth << " and "
+      << (this->Internals->AsyncDeepCopy ? "deep" : "shallow") << " copy")
     }
 
   return 0;
@@ -1223,29 +2367,14 @@ bool ConfigurableAnalysis::Execute(DataAdaptor* data)
 {
   TimeEvent<128> event("ConfigurableAnalysis::Execute");
 
-  int ai = 0;
-  AnalysisAdaptorVector::iterator iter = this->Internals->Analyses.begin();
-  AnalysisAdaptorVector::iterator end = this->Internals->Analyses.end();
-  for (; iter != end; ++iter, ++ai)
+  if (this->Internals->Async)
     {
-    const char* analysisName = nullptr;
-    bool logEnabled = Profiler::Enabled();
-    if (logEnabled)
-      {
-      analysisName = this->Internals->LogEventNames[3 * ai + 1].c_str();
-      Profiler::StartEvent(analysisName);
-      }
-
-    if (!(*iter)->Execute(data))
-      {
-      SENSEI_ERROR("Failed to execute " << (*iter)->GetClassName())
-      MPI_Abort(this->GetCommunicator(), -1);
-      }
-
-    if (logEnabled)
-      Profiler::EndEvent(analysisName);
+    this->Internals->ExecuteAsync(this->GetCommunicator(), data);
+    return true;
     }
 
+  this->Internals->ExecuteAnalyses(this->GetCommunicator(), data);
+
   return true;
 }
 
@@ -1254,6 +2383,28 @@ int ConfigurableAnalysis::Finalize()
 {
   TimeEvent<128> event("ConfigurableAnalysis::Finalize");
 
+  // wait for in flight steps to complete
+  if (this->Internals->Async)
+    this->Internals->StopAsync();
+
+  this->Internals->Pool.Finalize();
+  VTKUtils::SetNumberOfThreads(1);
+
+  this->Internals->Scheduler.PrintSummary(this->GetCommunicator());
+  this->Internals->Triggers.PrintSummary(this->GetCommunicator());
+
+  if (this->Internals->Cache)
+    {
+    long hits = 0;
+    long misses = 0;
+    long mdHits = 0;
+    long mdMisses = 0;
+    this->Internals->Cache->GetCacheStatistics(hits, misses);
+    this->Internals->Cache->GetMetadataCacheStatistics(mdHits, mdMisses);
+    SENSEI_STATUS("Data cache hits " << hits << " misses " << misses
+      << ", metadata cache hits " << mdHits << " misses " << mdMisses)
+    }
+
   int ai = 0;
   AnalysisAdaptorVector::iterator iter = this->Internals->Analyses.begin();
   AnalysisAdaptorVector::iterator end = this->Internals->Analyses.end();
@@ -1277,6 +2428,12 @@ int ConfigurableAnalysis::Finalize()
       Profiler::EndEvent(analysisName);
     }
 
+  if (this->Internals->Triggers.Finalize())
+    {
+    SENSEI_ERROR("Failed to finalize the triggers")
+    MPI_Abort(this->GetCommunicator(), -1);
+    }
+
   return 0;
 }
 
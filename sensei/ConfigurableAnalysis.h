@@ -13,6 +13,61 @@ namespace sensei
 
 /// @brief ConfigurableAnalysis is all-in-one analysis adaptor that
 /// can execute all available analysis adaptors.
+///
+/// By default the analyses run synchronously inside the call to Execute.
+/// Setting the attribute async="1" on the root sensei element enables an
+/// asynchronous mode in which the data needed by the configured analyses
+/// is snapshotted and the analyses are run on a background thread while
+/// the simulation continues. The following attributes control the mode:
+///
+///   async             : 1 to enable asynchronous execution (default 0)
+///   async_queue_depth : the number of snapshots that may be in flight
+///                       before Execute blocks (default 1)
+///   async_copy        : "deep" copies the data (default), "shallow" hands
+///                       ownership of the VTK arrays to the background
+///                       thread. In shallow mode meshes with arrays that
+///                       the data adaptor reports as zero-copy (see
+///                       DataAdaptor::GetArrayZeroCopy) are still deep
+///                       copied.
+///
+/// The data to snapshot is determined from the mesh and array attributes
+/// and the mesh elements of each analysis. If an analysis does not declare
+/// what it needs, all data is snapshotted. Asynchronous mode requires
+/// MPI_THREAD_MULTIPLE, when it is not available the analyses run
+/// synchronously. The simulation must request it from MPI_Init_thread,
+/// as MPIManager does. Finalize blocks until all in flight steps complete.
+///
+/// During a step the analyses share the meshes and arrays they request
+/// through a CachingDataAdaptor, so that data needed by several analyses
+/// is only fetched from the simulation once. The shared meshes and arrays
+/// are read only, an analysis that needs to change them must work on a
+/// copy. Setting the attribute cache="0" on the root sensei element
+/// disables the sharing. In transit data adaptors are never wrapped, the
+/// analyses receive them directly so that they can set a partitioner.
+///
+/// Setting the attribute threads="N" on the root sensei element with N > 1
+/// enables concurrent execution. Analyses that declare themselves thread
+/// safe (see AnalysisAdaptor::GetThreadSafe) are run on a pool of N threads,
+/// each using its own communicator, while the others run one at a time on
+/// the calling thread. Execute returns when all have completed. Concurrent
+/// execution requires MPI_THREAD_MULTIPLE and a data adaptor whose GetMesh
+/// and AddArray are not collective. Metadata is generated up front, in the
+/// same order on all ranks. With an in transit data adaptor the analyses
+/// run one at a time.
+///
+/// Setting the attribute block_threads="N" on the root sensei element with
+/// N > 1 lets analyses that process their blocks with
+/// VTKUtils::ParallelApply use N threads per call. This helps ranks that
+/// hold many small blocks.
+///
+/// A scheduler element on the root sensei element caps the time spent in
+/// the analyses to a fraction of the wall time, see TimeBudgetScheduler.
+/// Each analysis and transport element then accepts the attributes:
+///
+///   priority    : analyses with a larger priority are run first when
+///                 the budget is limited (default 0)
+///   min_cadence : the analysis runs at least once every min_cadence
+///                 steps regardless of the budget (default 0, no guarantee)
 class ConfigurableAnalysis : public AnalysisAdaptor
 {
 public:
@@ -343,6 +343,21 @@ int ConfigurableInTransitDataAdaptor::GetMesh(const std::string &meshName,
   return this->Internals->Adaptor->GetMesh(meshName, structureOnly, mesh);
 }
 
+// -------------------------------------------------------------------------------
+int ConfigurableInTransitDataAdaptor::GetMesh(const std::string &meshName,
+  bool structureOnly, const std::vector<int> &blockIds,
+  vtkCompositeDataSet *&mesh)
+{
+  if (!this->Internals->Adaptor)
+    {
+    SENSEI_ERROR("No InTransitDataAdaptor instance")
+    return -1;
+    }
+
+  return this->Internals->Adaptor->GetMesh(meshName, structureOnly,
+    blockIds, mesh);
+}
+
 // -------------------------------------------------------------------------------
 int ConfigurableInTransitDataAdaptor::AddGhostNodesArray(vtkDataObject* mesh,
   const std::string &meshName)
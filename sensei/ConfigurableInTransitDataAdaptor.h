@@ -82,6 +82,9 @@ public:
   int GetMesh(const std::string &meshName,
     bool structureOnly, vtkCompositeDataSet *&mesh) override;
 
+  int GetMesh(const std::string &meshName, bool structureOnly,
+    const std::vector<int> &blockIds, vtkCompositeDataSet *&mesh) override;
+
   int AddGhostNodesArray(vtkDataObject* mesh,
     const std::string &meshName) override;
 
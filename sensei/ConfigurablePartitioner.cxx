@@ -4,6 +4,11 @@
 #include "MappedPartitioner.h"
 #include "PlanarPartitioner.h"
 #include "PlanarSlicePartitioner.h"
+#include "WeightedPartitioner.h"
+#include "SpaceFillingCurvePartitioner.h"
+#include "NodeAwarePartitioner.h"
+#include "IncrementalPartitioner.h"
+#include "SubBlockPartitioner.h"
 #include "XMLUtils.h"
 #include "Profiler.h"
 
@@ -80,6 +85,26 @@ int ConfigurablePartitioner::Initialize(pugi::xml_node &partNode)
     {
     tmp = PlanarSlicePartitioner::New();
     }
+  else if (partType == "weighted")
+    {
+    tmp = WeightedPartitioner::New();
+    }
+  else if (partType == "sfc")
+    {
+    tmp = SpaceFillingCurvePartitioner::New();
+    }
+  else if (partType == "node")
+    {
+    tmp = NodeAwarePartitioner::New();
+    }
+  else if (partType == "incremental")
+    {
+    tmp = IncrementalPartitioner::New();
+    }
+  else if (partType == "split")
+    {
+    tmp = SubBlockPartitioner::New();
+    }
   else
     {
     SENSEI_ERROR("Failed to construct a partitioner. \""
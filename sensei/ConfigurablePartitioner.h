@@ -27,15 +27,16 @@ public:
     sensei::MeshMetadataPtr &out) override;
 
   // initialize the partitioner from the XML node.  recognizes the following
-  // Partitioner's: block, cyclic, planar, and mapped. The XML schema is as
-  // follows:
+  // Partitioner's: block, cyclic, planar, mapped, weighted, sfc, node,
+  // incremental, and split. The XML schema is as follows:
   //
   // <partitioner type="..." ... >
   //   ...
   // </partitioner>
   //
-  // where type is one of block, cyclic, planar, or mapped. See Parititioner
-  // sub-classes for documentation on the specific XML recognized by each.
+  // where type is one of block, cyclic, planar, mapped, weighted, sfc, node,
+  // incremental, or split. See Parititioner sub-classes for documentation on
+  // the specific XML recognized by each.
   virtual int Initialize(pugi::xml_node &) override;
 
 protected:
@@ -1,13 +1,17 @@
 #include "DataAdaptor.h"
 #include "MeshMetadata.h"
+#include "MeshMetadataMap.h"
 #include "VTKUtils.h"
 #include "Error.h"
 
 #include <vtkDataObject.h>
 #include <vtkCompositeDataSet.h>
+#include <vtkCompositeDataIterator.h>
 #include <vtkObjectFactory.h>
 
 #include <map>
+#include <set>
+#include <algorithm>
 #include <vector>
 #include <string>
 #include <utility>
@@ -95,6 +99,87 @@ int DataAdaptor::GetMesh(const std::string &meshName, bool structureOnly,
   return 0;
 }
 
+//----------------------------------------------------------------------------
+int DataAdaptor::GetMesh(const std::string &meshName, bool structureOnly,
+    const std::vector<int> &blockIds, vtkCompositeDataSet *&mesh)
+{
+  mesh = nullptr;
+
+  // get the full mesh
+  vtkCompositeDataSet *full = nullptr;
+  if (this->GetMesh(meshName, structureOnly, full))
+    {
+    SENSEI_ERROR("Failed to get mesh \"" << meshName << "\"")
+    return -1;
+    }
+
+  // pass the requested blocks
+  std::set<int> selected(blockIds.begin(), blockIds.end());
+
+  vtkCompositeDataSet *subset = full->NewInstance();
+  subset->CopyStructure(full);
+
+  vtkCompositeDataIterator *it = full->NewIterator();
+  for (it->InitTraversal(); !it->IsDoneWithTraversal(); it->GoToNextItem())
+    {
+    // the block id is the flat index of the leaf, see VTKUtils::GetMetadata
+    int bid = std::max(0, int(it->GetCurrentFlatIndex() - 1));
+    if (selected.count(bid))
+      subset->SetDataSet(it, it->GetCurrentDataObject());
+    }
+
+  it->Delete();
+  full->Delete();
+
+  mesh = subset;
+
+  return 0;
+}
+
+//----------------------------------------------------------------------------
+int DataAdaptor::GetMesh(const std::string &meshName, bool structureOnly,
+    const std::array<double,6> &bounds, vtkCompositeDataSet *&mesh)
+{
+  mesh = nullptr;
+
+  // get the block bounds
+  MeshMetadataFlags flags;
+  flags.SetBlockDecomp();
+  flags.SetBlockBounds();
+
+  MeshMetadataMap mdMap;
+  MeshMetadataPtr md;
+  if (mdMap.Initialize(this, flags) || mdMap.GetMeshMetadata(meshName, md))
+    {
+    SENSEI_ERROR("Failed to get metadata for mesh \"" << meshName << "\"")
+    return -1;
+    }
+
+  // without the block bounds return all of the local blocks
+  if (md->BlockBounds.size() != md->BlockIds.size())
+    return this->GetMesh(meshName, structureOnly, mesh);
+
+  int rank = 0;
+  MPI_Comm_rank(this->GetCommunicator(), &rank);
+
+  // select the local blocks that intersect the box
+  std::vector<int> blockIds;
+  unsigned int nBlocks = md->BlockIds.size();
+  for (unsigned int i = 0; i < nBlocks; ++i)
+    {
+    if (md->BlockOwner[i] != rank)
+      continue;
+
+    const std::array<double,6> &bbds = md->BlockBounds[i];
+    if ((bbds[0] <= bounds[1]) && (bbds[1] >= bounds[0]) &&
+      (bbds[2] <= bounds[3]) && (bbds[3] >= bounds[2]) &&
+      (bbds[4] <= bounds[5]) && (bbds[5] >= bounds[4]))
+      blockIds.push_back(md->BlockIds[i]);
+    }
+
+  return this->GetMesh(meshName, structureOnly, blockIds, mesh);
+}
+
 //----------------------------------------------------------------------------
 int DataAdaptor::AddArrays(vtkDataObject* mesh, const std::string &meshName,
     int association, const std::vector<std::string> &arrayNames)
@@ -113,6 +198,16 @@ int DataAdaptor::AddArrays(vtkDataObject* mesh, const std::string &meshName,
   return 0;
 }
 
+//----------------------------------------------------------------------------
+int DataAdaptor::GetArrayZeroCopy(const std::string &, int,
+  const std::string &, int &zeroCopy)
+{
+  // without knowledge of the implementation assume the array references
+  // simulation memory
+  zeroCopy = 1;
+  return 0;
+}
+
 //----------------------------------------------------------------------------
 int DataAdaptor::AddGhostNodesArray(vtkDataObject*, const std::string &)
 {
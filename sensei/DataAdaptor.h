@@ -7,6 +7,7 @@
 #include <vtkObjectBase.h>
 
 #include <vector>
+#include <array>
 #include <string>
 #include <mpi.h>
 #include <memory>
@@ -88,6 +89,45 @@ public:
   virtual int GetMesh(const std::string &meshName, bool structureOnly,
     vtkCompositeDataSet *&mesh);
 
+  /// @brief Return a subset of the blocks of the mesh
+  ///
+  /// Like GetMesh but only the local blocks whose global ids (see
+  /// MeshMetadata::BlockIds) are listed are materialized. The returned
+  /// composite dataset has the same structure as the full mesh, the blocks
+  /// not requested are empty, and the arrays and ghost arrays added to it
+  /// are only added to the blocks present. The default implementation gets
+  /// the full mesh and drops the blocks that were not requested, derived
+  /// classes override it to avoid generating them in the first place.
+  ///
+  /// @param[in] meshName the name of the mesh to access (see GetMeshMetadata)
+  /// @param[in] structureOnly When set to true the returned mesh may not
+  ///            have any geometry or topology information.
+  /// @param[in] blockIds the global ids of the blocks to return
+  /// @param[out] mesh a reference to a pointer where a new VTK object is stored
+  /// @returns zero if successful, non zero if an error occurred
+  virtual int GetMesh(const std::string &meshName, bool structureOnly,
+    const std::vector<int> &blockIds, vtkCompositeDataSet *&mesh);
+
+  /// @brief Return the blocks of the mesh that intersect a box
+  ///
+  /// The block bounds reported in the mesh's metadata
+  /// (MeshMetadata::BlockBounds) are used to select the local blocks that
+  /// intersect the axis aligned box, and these are returned by the block
+  /// subset variant of GetMesh. Blocks that do not intersect the box are
+  /// never generated by adaptors that implement that variant. If the
+  /// adaptor does not provide block bounds all local blocks are returned.
+  /// Fetching the metadata may be collective, thus this must be called on
+  /// all ranks.
+  ///
+  /// @param[in] meshName the name of the mesh to access (see GetMeshMetadata)
+  /// @param[in] structureOnly When set to true the returned mesh may not
+  ///            have any geometry or topology information.
+  /// @param[in] bounds the box [x0,x1, y0,y1, z0,z1]
+  /// @param[out] mesh a reference to a pointer where a new VTK object is stored
+  /// @returns zero if successful, non zero if an error occurred
+  virtual int GetMesh(const std::string &meshName, bool structureOnly,
+    const std::array<double,6> &bounds, vtkCompositeDataSet *&mesh);
+
   /// @brief Adds ghost nodes on the specified mesh. The array name must be set
   ///        to "vtkGhostType".
   ///
@@ -110,6 +150,13 @@ public:
   /// array was already added to the mesh, this will not add it again. The mesh
   /// should not be expected to have geometry or topology information.
   ///
+  /// The array may reference memory owned by the simulation (zero-copy). Such
+  /// memory is only guaranteed to be valid until ReleaseData is called, a
+  /// consumer that needs the data longer must deep copy it. Use
+  /// GetArrayZeroCopy to find out if an array is passed this way. The
+  /// VTKUtils::NewAOSArray and VTKUtils::NewSOAArray functions help
+  /// implementations wrap simulation memory.
+  ///
   /// @param[in] mesh the VTK object returned from GetMesh
   /// @param[in] meshName the name of the mesh on which the array is stored
   /// @param[in] association field association; one of
@@ -134,10 +181,27 @@ public:
   virtual int AddArrays(vtkDataObject* mesh, const std::string &meshName,
     int association, const std::vector<std::string> &arrayName);
 
+  /// @brief Reports if AddArray passes an array zero-copy.
+  ///
+  /// Sets zeroCopy to 1 when the array added by AddArray references memory
+  /// owned by the simulation, and to 0 when the array owns its data and may
+  /// be kept after ReleaseData. The default implementation can not know and
+  /// reports 1, adaptors that copy their data should override it.
+  ///
+  /// @param[in] meshName the name of the mesh on which the array is stored
+  /// @param[in] association field association; one of
+  ///            vtkDataObject::FieldAssociations or vtkDataObject::AttributeTypes.
+  /// @param[in] arrayName name of the array
+  /// @param[out] zeroCopy set to 1 if the array is zero-copy
+  /// @returns zero if successful, non zero if an error occurred
+  virtual int GetArrayZeroCopy(const std::string &meshName, int association,
+    const std::string &arrayName, int &zeroCopy);
+
   /// @brief Release data allocated for the current timestep.
   ///
   /// Releases the data allocated for the current timestep. This is expected to
-  /// be called after each time iteration.
+  /// be called after each time iteration. Zero-copy arrays handed out during
+  /// the timestep may not be accessed after this call.
   ///
   /// @returns zero if successful, non zero if an error occurred
   virtual int ReleaseData() = 0;
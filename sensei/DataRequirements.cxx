@@ -6,6 +6,7 @@
 
 #include <vtkDataObject.h>
 #include <sstream>
+#include <algorithm>
 
 namespace sensei
 {
@@ -178,6 +179,44 @@ int DataRequirements::AddRequirement(const std::string &meshName,
   return 0;
 }
 
+// --------------------------------------------------------------------------
+int DataRequirements::AddRequirements(const DataRequirements &other)
+{
+  MeshNamesType::const_iterator mit = other.MeshNames.begin();
+  MeshNamesType::const_iterator mend = other.MeshNames.end();
+  for (; mit != mend; ++mit)
+    {
+    // keep the geometry if either needs it
+    std::pair<MeshNamesType::iterator, bool> ins =
+      this->MeshNames.insert(*mit);
+
+    if (!ins.second)
+      ins.first->second = ins.first->second && mit->second;
+    }
+
+  MeshArrayMapType::const_iterator ait = other.MeshArrayMap.begin();
+  MeshArrayMapType::const_iterator aend = other.MeshArrayMap.end();
+  for (; ait != aend; ++ait)
+    {
+    AssocArrayMapType::const_iterator it = ait->second.begin();
+    AssocArrayMapType::const_iterator end = ait->second.end();
+    for (; it != end; ++it)
+      {
+      std::vector<std::string> &arrays = this->MeshArrayMap[ait->first][it->first];
+
+      unsigned int nArrays = it->second.size();
+      for (unsigned int i = 0; i < nArrays; ++i)
+        {
+        const std::string &array = it->second[i];
+        if (std::find(arrays.begin(), arrays.end(), array) == arrays.end())
+          arrays.push_back(array);
+        }
+      }
+    }
+
+  return 0;
+}
+
 // --------------------------------------------------------------------------
 int DataRequirements::GetRequiredMesh(unsigned int id, std::string &mesh) const
 {
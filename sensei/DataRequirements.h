@@ -81,6 +81,13 @@ public:
   int AddRequirement(const std::string &meshName, int association,
     const std::string &array);
 
+  /// Merges the requirements of another instance into this one. Where the
+  /// two disagree on a mesh's structure only flag the mesh geometry is
+  /// kept. Arrays already present are not duplicated.
+  /// @param[in] other the requirements to merge
+  /// @returns zero if successful
+  int AddRequirements(const DataRequirements &other);
+
   /// Get the list of meshes
   /// @param[out] meshes a vector where mesh names will be stored
   /// @returns zero if successful
@@ -0,0 +1,280 @@
+#include "EntropyTrigger.h"
+#include "DataAdaptor.h"
+#include "MeshMetadata.h"
+#include "MeshMetadataMap.h"
+#include "VTKHistogram.h"
+#include "VTKUtils.h"
+#include "XMLUtils.h"
+#include "Error.h"
+
+#include <vtkCompositeDataIterator.h>
+#include <vtkCompositeDataSet.h>
+#include <vtkDataArray.h>
+#include <vtkDataSet.h>
+#include <vtkDataSetAttributes.h>
+#include <vtkFieldData.h>
+#include <vtkObjectFactory.h>
+#include <vtkSmartPointer.h>
+#include <vtkUnsignedCharArray.h>
+
+#include <pugixml.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace sensei
+{
+
+//----------------------------------------------------------------------------
+senseiNewMacro(EntropyTrigger);
+
+//----------------------------------------------------------------------------
+EntropyTrigger::EntropyTrigger() : Association(vtkDataObject::POINT),
+  NumberOfBins(32), Change(0.0), FixedRange(false), HaveRange(false),
+  Range{0.0, 0.0}, Reference(-1.0), Entropy(-1.0), Index(0)
+{
+}
+
+//----------------------------------------------------------------------------
+void EntropyTrigger::SetArray(const std::string &meshName,
+  int association, const std::string &arrayName)
+{
+  this->MeshName = meshName;
+  this->Association = association;
+  this->ArrayName = arrayName;
+}
+
+//----------------------------------------------------------------------------
+void EntropyTrigger::SetNumberOfBins(int nBins)
+{
+  this->NumberOfBins = std::max(nBins, 1);
+}
+
+//----------------------------------------------------------------------------
+void EntropyTrigger::SetChange(double change)
+{
+  this->Change = change;
+}
+
+//----------------------------------------------------------------------------
+void EntropyTrigger::SetRange(double min, double max)
+{
+  this->FixedRange = true;
+  this->HaveRange = true;
+  this->Range[0] = min;
+  this->Range[1] = max;
+}
+
+//----------------------------------------------------------------------------
+int EntropyTrigger::Initialize(pugi::xml_node node)
+{
+  if (XMLUtils::RequireAttribute(node, "mesh") ||
+    XMLUtils::RequireAttribute(node, "array") ||
+    XMLUtils::RequireAttribute(node, "change"))
+    {
+    SENSEI_ERROR("Failed to initialize EntropyTrigger")
+    return -1;
+    }
+
+  int association = 0;
+  std::string assocStr = node.attribute("association").as_string("point");
+  if (VTKUtils::GetAssociation(assocStr, association))
+    {
+    SENSEI_ERROR("Failed to initialize EntropyTrigger")
+    return -1;
+    }
+
+  this->SetArray(node.attribute("mesh").value(), association,
+    node.attribute("array").value());
+
+  this->SetNumberOfBins(node.attribute("bins").as_int(32));
+  this->SetChange(node.attribute("change").as_double());
+
+  if (node.attribute("min") || node.attribute("max"))
+    {
+    if (!node.attribute("min") || !node.attribute("max"))
+      {
+      SENSEI_ERROR("EntropyTrigger needs both min and max to fix the range")
+      return -1;
+      }
+
+    this->SetRange(node.attribute("min").as_double(),
+      node.attribute("max").as_double());
+    }
+
+  return 0;
+}
+
+//----------------------------------------------------------------------------
+int EntropyTrigger::GetLocalHistogram(DataAdaptor *data,
+  std::vector<double> &counts, double range[2])
+{
+  counts.assign(this->NumberOfBins, 0.0);
+  range[0] = VTK_DOUBLE_MAX;
+  range[1] = VTK_DOUBLE_MIN;
+
+  MeshMetadataMap mdm;
+  MeshMetadataPtr md;
+  if (mdm.Initialize(data) || mdm.GetMeshMetadata(this->MeshName, md))
+    {
+    SENSEI_ERROR("Failed to get metadata for mesh \"" << this->MeshName << "\"")
+    return -1;
+    }
+
+  vtkCompositeDataSet *cd = nullptr;
+  if (data->GetMesh(this->MeshName, true, cd))
+    {
+    SENSEI_ERROR("Failed to get mesh \"" << this->MeshName << "\"")
+    return -1;
+    }
+
+  vtkSmartPointer<vtkCompositeDataSet> mesh;
+  mesh.TakeReference(cd);
+
+  if (data->AddArray(cd, this->MeshName, this->Association, this->ArrayName))
+    {
+    SENSEI_ERROR("Failed to add " << VTKUtils::GetAttributesName(this->Association)
+      << " data array \"" << this->ArrayName << "\" to mesh \""
+      << this->MeshName << "\"")
+    return -1;
+    }
+
+  // ghost zones are not counted
+  if ((this->Association == vtkDataObject::CELL) &&
+    (md->NumGhostCells || VTKUtils::AMR(md)) &&
+    data->AddGhostCellsArray(cd, this->MeshName))
+    {
+    SENSEI_ERROR("Failed to add ghost cells to mesh \"" << this->MeshName << "\"")
+    return -1;
+    }
+
+  if ((this->Association == vtkDataObject::POINT) && md->NumGhostNodes &&
+    data->AddGhostNodesArray(cd, this->MeshName))
+    {
+    SENSEI_ERROR("Failed to add ghost nodes to mesh \"" << this->MeshName << "\"")
+    return -1;
+    }
+
+  std::vector<vtkDataArray*> arrays;
+  std::vector<vtkUnsignedCharArray*> ghosts;
+
+  vtkSmartPointer<vtkCompositeDataIterator> it;
+  it.TakeReference(cd->NewIterator());
+  for (it->InitTraversal(); !it->IsDoneWithTraversal(); it->GoToNextItem())
+    {
+    vtkDataSet *ds = dynamic_cast<vtkDataSet*>(it->GetCurrentDataObject());
+    vtkFieldData *atts = ds ? VTKUtils::GetAttributes(ds, this->Association) : nullptr;
+    vtkDataArray *da = atts ? atts->GetArray(this->ArrayName.c_str()) : nullptr;
+    if (!da)
+      continue;
+
+    arrays.push_back(da);
+    ghosts.push_back(dynamic_cast<vtkUnsignedCharArray*>(
+      atts->GetArray(vtkDataSetAttributes::GhostArrayName())));
+    }
+
+  // multi-component arrays are binned by magnitude
+  VTKHistogram hist;
+  unsigned int nArrays = arrays.size();
+
+  if (!this->FixedRange)
+    {
+    for (unsigned int i = 0; i < nArrays; ++i)
+      hist.AddRange(arrays[i], ghosts[i], 0, 0, -1, 0,
+        arrays[i]->GetNumberOfComponents() == 1 ? 0 : VTKHistogram::MAGNITUDE);
+
+    std::vector<double> localRange;
+    hist.GetLocalRange(localRange);
+
+    range[0] = localRange[0];
+    range[1] = localRange[1];
+    }
+
+  // no range is known during the first step
+  if (!this->HaveRange)
+    return 0;
+
+  hist.PreCompute(this->NumberOfBins, {this->Range[0], this->Range[1]});
+
+  for (unsigned int i = 0; i < nArrays; ++i)
+    hist.Compute(arrays[i], ghosts[i], 0, 0, -1, 0,
+      arrays[i]->GetNumberOfComponents() == 1 ? 0 : VTKHistogram::MAGNITUDE);
+
+  std::vector<unsigned int> localHist;
+  hist.GetLocalHistogram(localHist);
+
+  counts.assign(localHist.begin(), localHist.end());
+
+  return 0;
+}
+
+//----------------------------------------------------------------------------
+int EntropyTrigger::AddLocalValues(DataAdaptor *data,
+  TriggerReduction &values)
+{
+  std::vector<double> counts;
+  double range[2];
+  if (this->GetLocalHistogram(data, counts, range))
+    return -1;
+
+  this->Index = values.Size();
+
+  for (int i = 0; i < this->NumberOfBins; ++i)
+    values.Add(counts[i], TriggerReduction::SUM);
+
+  if (!this->FixedRange)
+    {
+    values.Add(range[0], TriggerReduction::MIN);
+    values.Add(range[1], TriggerReduction::MAX);
+    }
+
+  return 0;
+}
+
+//----------------------------------------------------------------------------
+int EntropyTrigger::Evaluate(const TriggerReduction &values, bool &fire)
+{
+  fire = false;
+  this->Entropy = -1.0;
+
+  int nBins = this->NumberOfBins;
+
+  double total = 0.0;
+  for (int i = 0; i < nBins; ++i)
+    total += values.Get(this->Index + i);
+
+  if (this->HaveRange && (total > 0.0))
+    {
+    double entropy = 0.0;
+    for (int i = 0; i < nBins; ++i)
+      {
+      double p = values.Get(this->Index + i)/total;
+      if (p > 0.0)
+        entropy -= p*log2(p);
+      }
+
+    this->Entropy = entropy;
+
+    if (this->Reference < 0.0)
+      {
+      this->Reference = entropy;
+      }
+    else if (fabs(entropy - this->Reference) >= this->Change)
+      {
+      this->Reference = entropy;
+      fire = true;
+      }
+    }
+
+  // the range used to bin the next step
+  if (!this->FixedRange)
+    {
+    this->Range[0] = values.Get(this->Index + nBins);
+    this->Range[1] = values.Get(this->Index + nBins + 1);
+    this->HaveRange = this->Range[0] <= this->Range[1];
+    }
+
+  return 0;
+}
+
+}
@@ -0,0 +1,83 @@
+#ifndef sensei_EntropyTrigger_h
+#define sensei_EntropyTrigger_h
+
+#include "AnalysisTrigger.h"
+
+#include <string>
+#include <vector>
+
+namespace sensei
+{
+
+/// @class EntropyTrigger
+/// @brief Fires when the entropy of the histogram of an array changes.
+///
+/// Each step the local values of the array, ghost zones excluded, are
+/// binned and the counts summed across ranks. The Shannon entropy, in
+/// bits, of the global histogram is compared to its value the last time
+/// the trigger fired, and the trigger fires when the two differ by at least
+/// the given change. The first histogram sets the reference without firing.
+///
+/// The histogram's range is either given or, so that the evaluation needs
+/// a single reduction, the global range of the array during the previous
+/// step. In the later case the first step only establishes the range and
+/// values outside of it are counted in the first and last bins. The XML
+/// is of the form:
+///
+///   <trigger type="entropy" mesh="mesh" array="data" association="cell"
+///     bins="32" change="0.25" min="0" max="1"/>
+class EntropyTrigger : public AnalysisTrigger
+{
+public:
+  static EntropyTrigger *New();
+  senseiTypeMacro(EntropyTrigger, AnalysisTrigger);
+
+  /// @brief Set the array whose histogram is computed
+  void SetArray(const std::string &meshName, int association,
+    const std::string &arrayName);
+
+  /// @brief Set the number of bins
+  void SetNumberOfBins(int nBins);
+
+  /// @brief Fire when the entropy has changed by at least this many bits
+  void SetChange(double change);
+
+  /// @brief Set a fixed range for the histogram. By default the range of
+  /// the previous step is used.
+  void SetRange(double min, double max);
+
+  /// @brief Get the entropy computed during the last evaluation, -1 when
+  /// there was no histogram.
+  double GetEntropy() const { return this->Entropy; }
+
+  int Initialize(pugi::xml_node node) override;
+  int AddLocalValues(DataAdaptor *data, TriggerReduction &values) override;
+  int Evaluate(const TriggerReduction &values, bool &fire) override;
+
+protected:
+  EntropyTrigger();
+  ~EntropyTrigger() {}
+
+  EntropyTrigger(const EntropyTrigger&) = delete;
+  void operator=(const EntropyTrigger&) = delete;
+
+  // bin the local values and compute their range
+  int GetLocalHistogram(DataAdaptor *data, std::vector<double> &counts,
+    double range[2]);
+
+private:
+  std::string MeshName;
+  std::string ArrayName;
+  int Association;
+  int NumberOfBins;
+  double Change;
+  bool FixedRange;
+  bool HaveRange;
+  double Range[2];
+  double Reference;
+  double Entropy;
+  unsigned int Index;
+};
+
+}
+#endif
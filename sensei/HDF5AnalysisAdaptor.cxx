@@ -75,10 +75,12 @@ bool HDF5AnalysisAdaptor::Execute(DataAdaptor* dataAdaptor)
 {
   TimeEvent<128> mark("HDF5AnalysisAdaptor::Execute");
 
-  // figure out what the simulation can provide
+  // figure out what the simulation can provide. the node labels let the
+  // end-point partitioners keep data on the node
   MeshMetadataFlags flags;
   flags.SetBlockDecomp();
   flags.SetBlockSize();
+  flags.SetBlockNode();
 
   MeshMetadataMap mdm;
   if (mdm.Initialize(dataAdaptor, flags))
@@ -89,16 +91,17 @@ bool HDF5AnalysisAdaptor::Execute(DataAdaptor* dataAdaptor)
 
   //
   // (usage is from beambeam3d)
-  // we set block extent if images
+  // we set block extent if logically Cartesian, the end point needs them
+  // to split blocks into slabs
   // cannt set it with SetBlockDecomp() etc
-  // error is thrown for non image meshes
+  // error is thrown for other meshes
   //
   for (unsigned int i = 0; i < mdm.Size(); ++i)
     {
       MeshMetadataPtr older;
       mdm.GetMeshMetadata(i, older);
 
-      if (older->BlockType == VTK_IMAGE_DATA) 
+      if (VTKUtils::LogicallyCartesian(older))
       {
 	MeshMetadataPtr curr = sensei::MeshMetadata::New();;
 	flags.SetBlockExtents();
@@ -115,6 +118,13 @@ bool HDF5AnalysisAdaptor::Execute(DataAdaptor* dataAdaptor)
 	  SENSEI_ERROR("The requested metadata was not provided for data object " << i)
 	    return -1;
 	}
+
+	if (curr->LabelBlockNodes(dataAdaptor->GetCommunicator()))
+	{
+	  SENSEI_ERROR("Failed to label the blocks of data object " << i
+	    << " with their compute node")
+	    return -1;
+	}
 	mdm.SetMeshMetadata(i, curr);
       }
     }
@@ -188,18 +198,19 @@ bool HDF5AnalysisAdaptor::Execute(DataAdaptor* dataAdaptor)
           return false;
         }
 
-      // add the required arrays
+      // add the required arrays, a batch per association
       ArrayRequirementsIterator ait =
         this->Requirements.GetArrayRequirementsIterator(mit.MeshName());
+      ait.SetMode(ArrayRequirementsIterator::MODE_ASSOCIATION);
 
       while (ait)
         {
-          if (dataAdaptor->AddArray(
-                dobj, mit.MeshName(), ait.Association(), ait.Array()))
+          if (dataAdaptor->AddArrays(
+                dobj, mit.MeshName(), ait.Association(), ait.Arrays()))
             {
               SENSEI_ERROR("Failed to add "
                            << VTKUtils::GetAttributesName(ait.Association())
-                           << " data array \"" << ait.Array() << "\" to mesh \""
+                           << " data arrays to mesh \""
                            << mit.MeshName() << "\"");
               return false;
             }
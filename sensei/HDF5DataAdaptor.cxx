@@ -276,6 +276,35 @@ int HDF5DataAdaptor::GetMesh(const std::string& meshName,
   return 0;
 }
 
+//----------------------------------------------------------------------------
+int HDF5DataAdaptor::GetMesh(const std::string& meshName,
+                             bool structureOnly,
+                             const std::vector<int>& blockIds,
+                             vtkCompositeDataSet*& mesh)
+{
+  TimeEvent<128> mark("HDF5DataAdaptor::GetMesh");
+
+  mesh = nullptr;
+
+  // only the selected blocks are read, the others are left empty
+  vtkDataObject* dobj = nullptr;
+  if (!this->m_HDF5Reader->ReadMesh(meshName, blockIds, dobj, structureOnly))
+    {
+      SENSEI_ERROR("Failed to read blocks of mesh \"" << meshName << "\"");
+      return -1;
+    }
+
+  mesh = dynamic_cast<vtkCompositeDataSet*>(dobj);
+  if (!mesh && dobj)
+    {
+      SENSEI_ERROR("Mesh \"" << meshName << "\" is not a composite dataset");
+      dobj->Delete();
+      return -1;
+    }
+
+  return 0;
+}
+
 //----------------------------------------------------------------------------
 int HDF5DataAdaptor::AddGhostNodesArray(vtkDataObject* mesh,
                                         const std::string& meshName)
@@ -322,6 +351,34 @@ int HDF5DataAdaptor::AddArray(vtkDataObject* mesh,
   return 0;
 }
 
+//----------------------------------------------------------------------------
+int HDF5DataAdaptor::AddArrays(vtkDataObject* mesh,
+                               const std::string& meshName,
+                               int association,
+                               const std::vector<std::string>& arrayNames)
+{
+  TimeEvent<128> mark("HDF5DataAdaptor::AddArrays");
+
+  // the mesh should never be null. there must have been an error
+  // upstream.
+  if (!mesh)
+    {
+      SENSEI_ERROR("Invalid mesh object");
+      return -1;
+    }
+
+  // the arrays are read in a single pass over the blocks
+  if (!this->m_HDF5Reader->ReadInArrays(meshName, association, arrayNames, mesh))
+    {
+      SENSEI_ERROR("Failed to read " << VTKUtils::GetAttributesName(association)
+                                     << " data arrays from mesh \""
+                                     << meshName << "\"");
+      return -1;
+    }
+
+  return 0;
+}
+
 //----------------------------------------------------------------------------
 int HDF5DataAdaptor::ReleaseData()
 {
@@ -39,6 +39,10 @@ public:
   int GetMesh(const std::string &meshName, bool structure_only,
               vtkDataObject *&mesh) override;
 
+  int GetMesh(const std::string &meshName, bool structure_only,
+              const std::vector<int> &blockIds,
+              vtkCompositeDataSet *&mesh) override;
+
   int AddGhostNodesArray(vtkDataObject *mesh,
                          const std::string &meshName) override;
   int AddGhostCellsArray(vtkDataObject *mesh,
@@ -47,6 +51,10 @@ public:
   int AddArray(vtkDataObject *mesh, const std::string &meshName,
                int association, const std::string &arrayName) override;
 
+  int AddArrays(vtkDataObject *mesh, const std::string &meshName,
+                int association,
+                const std::vector<std::string> &arrayNames) override;
+
   int ReleaseData() override;
 
   // intransit:
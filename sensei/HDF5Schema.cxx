@@ -49,6 +49,7 @@
 #include <unistd.h>
 
 #include "BlockPartitioner.h"
+#include "SubBlockPartitioner.h"
 
 namespace senseiHDF5
 {
@@ -854,6 +855,30 @@ bool ReadStream::ReadReceiverMeshMetaData(unsigned int i, sensei::MeshMetadataPt
 }
 
 
+bool ReadStream::ReadMesh(std::string name,
+                          const std::vector<int> &block_ids,
+                          vtkDataObject *&dobj,
+                          bool structure_only)
+{
+  unsigned int meshId;
+  if(m_AllMeshInfo.GetMeshId(name, meshId) < 0)
+    return false;
+
+  vtkCompositeDataSet *cd = dynamic_cast<vtkCompositeDataSet *>(dobj);
+
+  MeshFlow m(cd, meshId);
+  m.SetBlockSelection(block_ids);
+  if(!m.ReadFrom(this, structure_only))
+    {
+      SENSEI_ERROR("Failed to read object " << meshId << name << "\"");
+      return false;
+    }
+
+  dobj = m.m_VtkPtr;
+
+  return true;
+}
+
 bool ReadStream::ReadMesh(std::string name,
                           vtkDataObject *&dobj,
                           bool structure_only)
@@ -884,6 +909,15 @@ bool ReadStream::ReadInArray(const std::string &meshName,
                              int association,
                              const std::string &array_name,
                              vtkDataObject *dobj)
+{
+  return ReadInArrays(meshName, association,
+                      std::vector<std::string>(1, array_name), dobj);
+}
+
+bool ReadStream::ReadInArrays(const std::string &meshName,
+                              int association,
+                              const std::vector<std::string> &array_names,
+                              vtkDataObject *dobj)
 {
   unsigned int meshId;
   if(m_AllMeshInfo.GetMeshId(meshName, meshId) < 0)
@@ -891,12 +925,11 @@ bool ReadStream::ReadInArray(const std::string &meshName,
 
   MeshFlow m(dynamic_cast<vtkCompositeDataSet *>(dobj), meshId);
 
-  if(!m.ReadArray(this, array_name, association))
+  if(!m.ReadArrays(this, array_names, association))
     {
       SENSEI_ERROR("Failed to read "
                    << sensei::VTKUtils::GetAttributesName(association)
-                   << " data array \"" << array_name << "\" from object \""
-                   << meshName << "\"");
+                   << " data arrays from object \"" << meshName << "\"");
       return false;
     }
   return true;
@@ -908,7 +941,22 @@ bool ReadStream::ReadInArray(const std::string &meshName,
 MeshFlow::MeshFlow(vtkCompositeDataSet *cd, unsigned int meshID)
   : m_VtkPtr(cd)
   , m_MeshID(meshID)
+  , m_HaveSelection(false)
+{
+}
+
+void MeshFlow::SetBlockSelection(const std::vector<int> &block_ids)
+{
+  m_Selection.clear();
+  m_Selection.insert(block_ids.begin(), block_ids.end());
+  m_HaveSelection = true;
+}
+
+bool MeshFlow::IsLocal(const sensei::MeshMetadataPtr &md,
+                       unsigned int block_id, int rank)
 {
+  return (md->BlockOwner[block_id] == rank) &&
+    (!m_HaveSelection || m_Selection.count(md->BlockIds[block_id]));
 }
 
 MeshFlow::~MeshFlow() {}
@@ -992,32 +1040,59 @@ bool MeshFlow::ReadArray(ReadStream *reader,
                          const std::string &array_name,
                          int association)
 {
-  if(ReadBlockOwnerArray(reader, array_name, association))
-    return true;
+  return ReadArrays(reader, std::vector<std::string>(1, array_name),
+                    association);
+}
 
+bool MeshFlow::ReadArrays(ReadStream *reader,
+                          const std::vector<std::string> &array_names,
+                          int association)
+{
   sensei::MeshMetadataPtr md;
   reader->ReadReceiverMeshMetaData(m_MeshID, md);
 
-  //unsigned int num_blocks = md->NumBlocks;
   unsigned int num_arrays = md->NumArrays;
 
-  if (array_name == TAG_VTK_GHOST) {
-    ArrayFlow arrayFlow(m_MeshID, association, md);
-    Load(&arrayFlow, md, reader);
-    return true;
-  }
+  std::vector<std::unique_ptr<ArrayFlow>> flows;
+
+  unsigned int num_names = array_names.size();
+  for (unsigned int k = 0; k < num_names; ++k) {
+    const std::string &array_name = array_names[k];
 
-  // read data arrays
-  for (unsigned int i = 0; i < num_arrays; ++i) {
-    // skip all but the requested array
-    if ((association != md->ArrayCentering[i]) ||
-        (array_name != md->ArrayName[i]))
+    if(ReadBlockOwnerArray(reader, array_name, association))
       continue;
 
-    ArrayFlow arrayFlow(md, m_MeshID, i);
-    Load(&arrayFlow, md, reader);
+    if (array_name == TAG_VTK_GHOST) {
+      flows.emplace_back(new ArrayFlow(m_MeshID, association, md));
+      continue;
+    }
+
+    // read data arrays
+    for (unsigned int i = 0; i < num_arrays; ++i) {
+      // skip all but the requested array
+      if ((association != md->ArrayCentering[i]) ||
+          (array_name != md->ArrayName[i]))
+        continue;
+
+      flows.emplace_back(new ArrayFlow(md, m_MeshID, i));
+      break;
+    }
+  }
+
+  // blocks split by the receiver are read piece by piece
+  if (!md->BlockSource.empty() && !flows.empty()) {
+    sensei::MeshMetadataPtr smd;
+    reader->ReadSenderMeshMetaData(m_MeshID, smd);
+
+    unsigned int num_flows = flows.size();
+    for (unsigned int k = 0; k < num_flows; ++k)
+      flows[k]->SetSource(smd);
   }
 
+  // all of the arrays are loaded in a single pass over the blocks
+  if (!flows.empty())
+    Load(flows, md, reader);
+
   return true;
 }
 
@@ -1030,7 +1105,9 @@ void MeshFlow::Load(ArrayFlow *arrayFlowPtr, const sensei::MeshMetadataPtr &md,
   it->InitTraversal();
 
   for (unsigned int j = 0; j < num_blocks; ++j) {
-    if (md->BlockOwner[j] == reader->m_Rank) {
+    // blocks are empty when the mesh is a subset
+    if ((md->BlockOwner[j] == reader->m_Rank) &&
+        it->GetCurrentDataObject()) {
       arrayFlowPtr->load(j, it, reader);
     }
     arrayFlowPtr->update(j);
@@ -1040,6 +1117,31 @@ void MeshFlow::Load(ArrayFlow *arrayFlowPtr, const sensei::MeshMetadataPtr &md,
   it->Delete();
 }
 
+void MeshFlow::Load(const std::vector<std::unique_ptr<ArrayFlow>> &arrayFlows,
+                    const sensei::MeshMetadataPtr &md, ReadStream *reader) {
+  unsigned int num_blocks = md->NumBlocks;
+  unsigned int num_flows = arrayFlows.size();
+
+  vtkCompositeDataIterator *it = m_VtkPtr->NewIterator();
+  it->SetSkipEmptyNodes(0);
+  it->InitTraversal();
+
+  for (unsigned int j = 0; j < num_blocks; ++j) {
+    // blocks are empty when the mesh is a subset
+    bool local = (md->BlockOwner[j] == reader->m_Rank) &&
+      it->GetCurrentDataObject();
+    for (unsigned int k = 0; k < num_flows; ++k) {
+      if (local) {
+        arrayFlows[k]->load(j, it, reader);
+      }
+      arrayFlows[k]->update(j);
+    }
+    it->GoToNextItem();
+  }
+
+  it->Delete();
+}
+
 
 bool MeshFlow::Initialize(const sensei::MeshMetadataPtr &md, ReadStream *input)
 {
@@ -1055,7 +1157,7 @@ bool MeshFlow::Initialize(const sensei::MeshMetadataPtr &md, ReadStream *input)
 
   for(int i = 0; i < num_blocks; ++i)
     {
-      if(rank == md->BlockOwner[i])
+      if(IsLocal(md, i, rank))
         {
           vtkDataObject *ds = sensei::VTKUtils::NewDataObject(md->BlockType);
           mbds->SetBlock(md->BlockIds[i], ds);
@@ -1085,6 +1187,31 @@ bool MeshFlow::ReadFrom(ReadStream *input, bool structure_only)
   if(structure_only)
     return true;
 
+  // blocks split by the receiver are read piece by piece
+  if(!md->BlockSource.empty())
+    {
+      sensei::MeshMetadataPtr smd;
+      input->ReadSenderMeshMetaData(m_MeshID, smd);
+
+      SubBlockFlow pieces(md, smd, m_MeshID);
+
+      vtkCompositeDataIterator *it = m_VtkPtr->NewIterator();
+      it->SetSkipEmptyNodes(0);
+      it->InitTraversal();
+
+      bool ok = true;
+      for(unsigned int j = 0; ok && (j < num_blocks); ++j)
+        {
+          if(IsLocal(md, j, input->m_Rank))
+            ok = pieces.load(j, it, input);
+          it->GoToNextItem();
+        }
+
+      it->Delete();
+
+      return ok;
+    }
+
   {
     vtkCompositeDataIterator *it = m_VtkPtr->NewIterator();
     it->SetSkipEmptyNodes(0);
@@ -1093,7 +1220,7 @@ bool MeshFlow::ReadFrom(ReadStream *input, bool structure_only)
     WorkerCollection workerPool(md, m_MeshID);
     for(unsigned int j = 0; j < num_blocks; ++j)
       {
-        if(input->m_Rank == md->BlockOwner[j])
+        if(IsLocal(md, j, input->m_Rank))
           {
             workerPool.load(j, it, input);
           }
@@ -1321,23 +1448,62 @@ const std::string &ArrayFlow::GetArrayName() {
 }
 
 
+void ArrayFlow::SetSource(const sensei::MeshMetadataPtr &smd)
+{
+  m_Source = smd;
+
+  // the offset of each sender block
+  const std::vector<long> &num_elem = (m_ArrayCenter == vtkDataObject::POINT
+                                       ? smd->BlockNumPoints
+                                       : smd->BlockNumCells);
+
+  unsigned int num_src = smd->NumBlocks;
+  m_SourceOffset.assign(num_src + 1, 0);
+  for(unsigned int p = 0; p < num_src; ++p)
+    {
+      m_SourceOffset[p + 1] =
+        m_SourceOffset[p] + num_elem[p] * m_NumArrayComponent;
+    }
+}
+
 bool ArrayFlow::load(unsigned int block_id,
                      vtkCompositeDataIterator *it,
                      ReadStream *reader)
 {
-  unsigned long long num_elem_local =
-    m_NumArrayComponent * (m_ArrayCenter == vtkDataObject::POINT
-                           ? m_Metadata->BlockNumPoints[block_id]
-                           : m_Metadata->BlockNumCells[block_id]);
+  unsigned long long num_tuples_local =
+    (m_ArrayCenter == vtkDataObject::POINT
+     ? m_Metadata->BlockNumPoints[block_id]
+     : m_Metadata->BlockNumCells[block_id]);
 
   uint64_t start = m_BlockOffset;
-  uint64_t count = num_elem_local;
-  ;
+  uint64_t count = m_NumArrayComponent * num_tuples_local;
+
+  // a piece of a sender block is a slab of the block's data
+  if(m_Source)
+    {
+      int p = m_Metadata->BlockSource[block_id];
+
+      size_t slab_start = 0;
+      size_t slab_count = 0;
+      if(sensei::SubBlockPartitioner::GetSelection(
+           m_Source->BlockExtents[p].data(),
+           m_Metadata->BlockExtents[block_id].data(),
+           m_ArrayCenter != vtkDataObject::POINT, slab_start, slab_count))
+        {
+          SENSEI_ERROR("Piece " << block_id << " of block " << p
+                       << " is not a contiguous slab");
+          return false;
+        }
+
+      num_tuples_local = slab_count;
+      start = m_SourceOffset[p] + m_NumArrayComponent * slab_start;
+      count = m_NumArrayComponent * slab_count;
+    }
 
   vtkDataArray *array = vtkDataArray::CreateDataArray(GetArrayType());
   array->SetNumberOfComponents(m_NumArrayComponent);
   array->SetName(GetArrayName().c_str());
-  array->SetNumberOfTuples(num_elem_local);
+  array->SetNumberOfTuples(num_tuples_local);
 
   if(!reader->ReadVar1D(m_ArrayPath, start, count, array->GetVoidPointer(0)))
     return false;
@@ -2274,6 +2440,170 @@ bool StretchedCartesianFlow::update(unsigned int block_id)
   return true;
 }
 
+//
+//
+//
+SubBlockFlow::SubBlockFlow(const sensei::MeshMetadataPtr &md,
+                           const sensei::MeshMetadataPtr &smd,
+                           unsigned int meshID)
+  : VTKObjectFlow(md, meshID)
+  , m_Source(smd)
+{
+  gGetNameStr(m_OriginPath, m_MeshID, "origin");
+  gGetNameStr(m_SpacingPath, m_MeshID, "spacing");
+  gGetNameStr(m_PointVarName, m_MeshID, "points");
+  gGetNameStr(m_CoordPath[0], m_MeshID, "x_coords");
+  gGetNameStr(m_CoordPath[1], m_MeshID, "y_coords");
+  gGetNameStr(m_CoordPath[2], m_MeshID, "z_coords");
+
+  // the offset of each sender block in the points and coordinates
+  unsigned int num_src = smd->NumBlocks;
+  bool structured = sensei::VTKUtils::Structured(smd);
+
+  m_PointOffset.assign(num_src + 1, 0);
+  for(int d = 0; d < 3; ++d)
+    m_CoordOffset[d].assign(num_src + 1, 0);
+
+  for(unsigned int p = 0; p < num_src; ++p)
+    {
+      const int *pext = smd->BlockExtents[p].data();
+
+      m_PointOffset[p + 1] =
+        m_PointOffset[p] + (structured ? smd->BlockNumPoints[p] : 0);
+
+      for(int d = 0; d < 3; ++d)
+        {
+          m_CoordOffset[d][p + 1] =
+            m_CoordOffset[d][p] + pext[2 * d + 1] - pext[2 * d] + 2;
+        }
+    }
+}
+
+bool SubBlockFlow::load(unsigned int block_id,
+                        vtkCompositeDataIterator *it,
+                        ReadStream *reader)
+{
+  int p = m_Metadata->BlockSource[block_id];
+  const int *pext = m_Source->BlockExtents[p].data();
+  int *ext = m_Metadata->BlockExtents[block_id].data();
+
+  vtkDataObject *dobj = it->GetCurrentDataObject();
+  if(!dobj)
+    {
+      SENSEI_ERROR("Failed to get block " << block_id);
+      return false;
+    }
+
+  switch(m_Metadata->BlockType)
+    {
+    case VTK_IMAGE_DATA:
+    case VTK_UNIFORM_GRID:
+      {
+        // pieces share the origin and spacing of the block
+        double x0[3] = { 0.0 };
+        double dx[3] = { 0.0 };
+        if(!reader->ReadVar1D(m_OriginPath, 3 * p, 3, x0) ||
+            !reader->ReadVar1D(m_SpacingPath, 3 * p, 3, dx))
+          return false;
+
+        vtkImageData *ds = dynamic_cast<vtkImageData *>(dobj);
+        ds->SetExtent(ext);
+        ds->SetOrigin(x0);
+        ds->SetSpacing(dx);
+      }
+      break;
+
+    case VTK_RECTILINEAR_GRID:
+      {
+        // the piece's range of each of the block's coordinate arrays
+        vtkRectilinearGrid *ds = dynamic_cast<vtkRectilinearGrid *>(dobj);
+        ds->SetExtent(ext);
+
+        for(int d = 0; d < 3; ++d)
+          {
+            uint64_t start = m_CoordOffset[d][p] + ext[2 * d] - pext[2 * d];
+            uint64_t count = ext[2 * d + 1] - ext[2 * d] + 1;
+
+            vtkDataArray *coords =
+              vtkDataArray::CreateDataArray(m_Metadata->CoordinateType);
+            coords->SetNumberOfTuples(count);
+
+            if(!reader->ReadVar1D(
+                  m_CoordPath[d], start, count, coords->GetVoidPointer(0)))
+              {
+                coords->Delete();
+                return false;
+              }
+
+            if(d == 0)
+              ds->SetXCoordinates(coords);
+            else if(d == 1)
+              ds->SetYCoordinates(coords);
+            else
+              ds->SetZCoordinates(coords);
+
+            coords->Delete();
+          }
+      }
+      break;
+
+    case VTK_STRUCTURED_GRID:
+      {
+        vtkStructuredGrid *ds = dynamic_cast<vtkStructuredGrid *>(dobj);
+        ds->SetExtent(ext);
+
+        // the piece's slab of the block's points
+        size_t start = 0;
+        size_t count = 0;
+        if(sensei::SubBlockPartitioner::GetSelection(
+             pext, ext, false, start, count))
+          {
+            SENSEI_ERROR("Piece " << block_id << " of block " << p
+                         << " is not a contiguous slab");
+            return false;
+          }
+
+        vtkDataArray *points =
+          vtkDataArray::CreateDataArray(m_Metadata->CoordinateType);
+        points->SetNumberOfComponents(3);
+        points->SetNumberOfTuples(count);
+        points->SetName("points");
+
+        if(!reader->ReadVar1D(m_PointVarName,
+                               3 * (m_PointOffset[p] + start),
+                               3 * count,
+                               points->GetVoidPointer(0)))
+          {
+            points->Delete();
+            return false;
+          }
+
+        vtkPoints *pts = vtkPoints::New();
+        pts->SetData(points);
+        points->Delete();
+
+        ds->SetPoints(pts);
+        pts->Delete();
+      }
+      break;
+
+    default:
+      SENSEI_ERROR("Only logically Cartesian blocks can be split");
+      return false;
+    }
+
+  return true;
+}
+
+bool SubBlockFlow::unload(unsigned int block_id,
+                          vtkCompositeDataIterator *,
+                          WriteStream *)
+{
+  // senders write whole blocks
+  SENSEI_ERROR("Pieces of block " << block_id << " cannot be written");
+  return false;
+}
+
 //
 //
 //
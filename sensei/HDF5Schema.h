@@ -10,6 +10,7 @@ typedef struct _ADIOS_FILE ADIOS_FILE;
 #include "hdf5.h"
 //#include <adios_read.h>
 #include <cstdint>
+#include <memory>
 #include <mpi.h>
 #include <set>
 #include <string>
@@ -260,12 +261,19 @@ public:
   bool ReadReceiverMeshMetaData(unsigned int i, sensei::MeshMetadataPtr &ptr);
 
   bool ReadMesh(std::string name, vtkDataObject *&dobj, bool structure_only);
+  bool ReadMesh(std::string name, const std::vector<int> &block_ids,
+                vtkDataObject *&dobj, bool structure_only);
 
   bool ReadInArray(const std::string &meshName,
                    int association,
                    const std::string &array_name,
                    vtkDataObject *dobj);
 
+  bool ReadInArrays(const std::string &meshName,
+                    int association,
+                    const std::vector<std::string> &array_names,
+                    vtkDataObject *dobj);
+
   bool ReadNativeAttr(const std::string &name,
                       void *val,
                       hid_t h5Type,
@@ -295,7 +303,13 @@ public:
   bool ReadArray(ReadStream *input,
                  const std::string &array_name,
                  int association);
+  bool ReadArrays(ReadStream *input,
+                  const std::vector<std::string> &array_names,
+                  int association);
   bool ReadFrom(ReadStream *StreamPtr, bool structureOnly);
+
+  // when set only the listed blocks are created and read
+  void SetBlockSelection(const std::vector<int> &block_ids);
   bool Initialize(const sensei::MeshMetadataPtr &md, ReadStream *input);
 
   bool WriteTo(WriteStream *StreamPtr, const sensei::MeshMetadataPtr &md);
@@ -305,15 +319,23 @@ public:
 private:
   bool ValidateMetaData(const sensei::MeshMetadataPtr &md);
 
+  bool IsLocal(const sensei::MeshMetadataPtr &md,
+               unsigned int block_id, int rank);
+
   void Unload(ArrayFlow *arrayFlowPtr, 
 	      const sensei::MeshMetadataPtr &md,
               WriteStream *output);
   void Load(ArrayFlow *arrayFlowPtr, 
 	    const sensei::MeshMetadataPtr &md,
             ReadStream *reader);
+  void Load(const std::vector<std::unique_ptr<ArrayFlow>> &arrayFlows,
+            const sensei::MeshMetadataPtr &md,
+            ReadStream *reader);
 
 
   unsigned int m_MeshID;
+  std::set<int> m_Selection;
+  bool m_HaveSelection;
 };
 
 class VTKObjectFlow
@@ -388,11 +410,17 @@ public:
   int GetArrayType();
   const std::string &GetArrayName();
 
+  // read the pieces of blocks split by the receiver, see
+  // sensei::SubBlockPartitioner. smd is the sender metadata
+  void SetSource(const sensei::MeshMetadataPtr &smd);
+
 protected:
   unsigned long long getLocalElement(unsigned int block_id);
 
 private:
   unsigned long long m_BlockOffset;
+  sensei::MeshMetadataPtr m_Source;
+  std::vector<unsigned long long> m_SourceOffset;
   std::string m_ArrayPath; // name in H5
   hid_t m_ArrayVarID;
 
@@ -516,6 +544,36 @@ private:
   unsigned long long m_CellArrayBlockOffset = 0;
 };
 
+//
+// the pieces of logically Cartesian blocks split by the receiver, see
+// sensei::SubBlockPartitioner. each piece is read with a single slice per
+// variable from the data of the sender block it was cut from.
+//
+class SubBlockFlow : public VTKObjectFlow
+{
+public:
+  SubBlockFlow(const sensei::MeshMetadataPtr &md,
+               const sensei::MeshMetadataPtr &smd,
+               unsigned int meshID);
+  ~SubBlockFlow() {}
+
+  bool load(unsigned int block_id, vtkCompositeDataIterator *it, ReadStream *);
+  bool unload(unsigned int block_id,
+              vtkCompositeDataIterator *it,
+              WriteStream *output);
+  bool update(unsigned int) { return true; }
+
+private:
+  sensei::MeshMetadataPtr m_Source;
+
+  std::string m_OriginPath;
+  std::string m_SpacingPath;
+  std::string m_CoordPath[3];
+
+  std::vector<unsigned long long> m_PointOffset;
+  std::vector<unsigned long long> m_CoordOffset[3];
+};
+
 //
 // blocks  of a mesh have the <same> type
 //
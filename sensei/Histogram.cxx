@@ -3,13 +3,14 @@
 #include "MeshMetadata.h"
 #include "MeshMetadataMap.h"
 #include "Profiler.h"
+#include "TimeSeriesStore.h"
 #include "VTKHistogram.h"
 #include "VTKUtils.h"
 #include "Error.h"
 
-#include <vtkCompositeDataIterator.h>
 #include <vtkCompositeDataSet.h>
 #include <vtkDataObject.h>
+#include <vtkDataSet.h>
 #include <vtkDataSetAttributes.h>
 #include <vtkObjectFactory.h>
 #include <vtkSmartPointer.h>
@@ -26,7 +27,8 @@ senseiNewMacro(Histogram);
 
 //-----------------------------------------------------------------------------
 Histogram::Histogram() : Bins(0),
-  Association(vtkDataObject::FIELD_ASSOCIATION_POINTS), Internals(nullptr)
+  Association(vtkDataObject::FIELD_ASSOCIATION_POINTS), Pipelined(0),
+  UsePreviousRange(0), TimeSeries(0), Internals(nullptr), Store(nullptr)
 {
 }
 
@@ -34,17 +36,68 @@ Histogram::Histogram() : Bins(0),
 Histogram::~Histogram()
 {
   delete this->Internals;
+  delete this->Store;
 }
 
+// a component that is resolved to 0 for scalars and the magnitude for
+// vectors once the array is seen
+static constexpr int COMPONENT_DEFAULT = -2;
+
 //-----------------------------------------------------------------------------
 void Histogram::Initialize(int bins, const std::string &meshName,
   int association, const std::string& arrayName, const std::string &fileName)
+{
+  this->Initialize(bins, meshName, association,
+    std::vector<std::string>(1, arrayName), fileName);
+}
+
+//-----------------------------------------------------------------------------
+void Histogram::Initialize(int bins, const std::string &meshName,
+  int association, const std::vector<std::string> &arrayNames,
+  const std::string &fileName)
 {
   this->Bins = bins;
   this->MeshName = meshName;
-  this->ArrayName = arrayName;
   this->Association = association;
   this->FileName = fileName;
+
+  // split off the component selection, name:N or name:mag
+  this->Variables = arrayNames;
+  this->ArrayNames.clear();
+  this->Components.clear();
+
+  unsigned int nVars = arrayNames.size();
+  for (unsigned int i = 0; i < nVars; ++i)
+    {
+    const std::string &var = arrayNames[i];
+    int comp = COMPONENT_DEFAULT;
+
+    size_t pos = var.rfind(':');
+    if (pos != std::string::npos)
+      {
+      std::string sel = var.substr(pos + 1);
+      if ((sel == "mag") || (sel == "magnitude"))
+        {
+        comp = VTKHistogram::MAGNITUDE;
+        }
+      else
+        {
+        try
+          {
+          comp = std::stoi(sel);
+          }
+        catch (...)
+          {
+          SENSEI_WARNING("Invalid component \"" << sel << "\" in \""
+            << var << "\" the whole name is used as the array name")
+          pos = std::string::npos;
+          }
+        }
+      }
+
+    this->ArrayNames.push_back(var.substr(0, pos));
+    this->Components.push_back(comp);
+    }
 }
 
 //-----------------------------------------------------------------------------
@@ -57,6 +110,37 @@ const char *Histogram::GetGhostArrayName()
 #endif
 }
 
+//-----------------------------------------------------------------------------
+void Histogram::SetRange(double min, double max)
+{
+  this->Range = {min, max};
+}
+
+//-----------------------------------------------------------------------------
+int Histogram::OpenStore()
+{
+  int rank = 0;
+  MPI_Comm_rank(this->GetCommunicator(), &rank);
+
+  if (!this->TimeSeries || this->FileName.empty() || (rank != 0))
+    return 0;
+
+  if (!this->Store)
+    this->Store = new TimeSeriesStore;
+
+  if (this->Store->IsOpen())
+    return 0;
+
+  std::string vars;
+  for (const std::string &var : this->Variables)
+    vars += (vars.empty() ? "" : ",") + var;
+
+  std::string fileName = this->FileName + "_" + this->MeshName + ".sts";
+
+  return this->Store->Open(fileName, "histogram", {{"mesh", this->MeshName},
+    {"variables", vars}, {"bins", std::to_string(this->Bins)}});
+}
+
 //-----------------------------------------------------------------------------
 bool Histogram::Execute(DataAdaptor* data)
 {
@@ -70,13 +154,137 @@ bool Histogram::Execute(DataAdaptor* data)
     return false;
     }
 
-  delete this->Internals;
-  this->Internals = new VTKHistogram;
+  MPI_Comm comm = this->GetCommunicator();
+
+  // the blocks, and pieces of large blocks, are processed in parallel,
+  // each thread accumulating into its own range and histogram
+  unsigned int nThreads = VTKUtils::GetNumberOfThreads();
+  unsigned int nVars = this->Variables.size();
+
+  if (this->Internals)
+    {
+    // complete the reductions started during the previous step
+    this->Internals->FinishPostCompute();
+
+    if (this->UsePreviousRange)
+      this->Internals->FinishRange(this->PreviousRange);
+
+    delete this->Internals;
+    }
+
+  this->Internals = new VTKHistogram(nVars, nThreads);
+
+  if (this->OpenStore())
+    {
+    SENSEI_ERROR("Failed to open the histogram time series")
+    MPI_Abort(comm, -1);
+    }
+
+  if (this->Store && this->Store->IsOpen())
+    this->Internals->SetStore(this->Store);
 
   // get the current time and step
   int step = data->GetDataTimeStep();
   double time = data->GetDataTime();
 
+  // split the arrays into pieces so that both many small blocks and a few
+  // large ones spread over the threads
+  struct Piece
+  {
+    unsigned int Var;
+    int Component;
+    vtkDataArray *Array;
+    vtkUnsignedCharArray *Ghosts;
+    vtkIdType Start;
+    vtkIdType End;
+  };
+
+  const vtkIdType pieceSize = 65536;
+  std::vector<Piece> pieces;
+
+  // compute local histogram ranges
+  VTKUtils::ThreadLoopFunction addRange = [&](unsigned int thread,
+    unsigned int i) -> int
+    {
+    const Piece &p = pieces[i];
+    this->Internals->AddRange(p.Array, p.Ghosts, thread,
+      p.Start, p.End, p.Var, p.Component);
+    return 0;
+    };
+
+  // compute local histograms
+  VTKUtils::ThreadLoopFunction compute = [&](unsigned int thread,
+    unsigned int i) -> int
+    {
+    const Piece &p = pieces[i];
+    this->Internals->Compute(p.Array, p.Ghosts, thread,
+      p.Start, p.End, p.Var, p.Component);
+    return 0;
+    };
+
+  // compute the histograms of the pieces. the collectives are made on all
+  // ranks, including those with nothing to process, and are the same on
+  // all ranks since blocking and non-blocking collectives do not match
+  auto computeHistograms = [&]() -> int
+    {
+    bool fixedRange = this->Range.size() == 2;
+
+    bool previousRange = this->UsePreviousRange &&
+      (this->PreviousRange.size() == 2*nVars);
+
+    bool provisional = this->Pipelined && !fixedRange && !previousRange;
+
+    // compute local histogram ranges, with a fixed range this is not needed
+    int ierr = 0;
+    if (!fixedRange)
+      ierr = VTKUtils::ParallelFor(nThreads, pieces.size(), addRange);
+
+    if (fixedRange)
+      {
+      std::vector<double> range(2*nVars);
+      for (unsigned int j = 0; j < nVars; ++j)
+        std::copy(this->Range.begin(), this->Range.end(), &range[2*j]);
+
+      this->Internals->PreCompute(this->Bins, range);
+      }
+    else if (previousRange)
+      {
+      // this step's range is reduced in the background for the next step
+      this->Internals->StartRange(comm);
+      this->Internals->PreCompute(this->Bins, this->PreviousRange);
+      }
+    else if (provisional)
+      {
+      this->Internals->StartRange(comm);
+      this->Internals->PreComputeProvisional(this->Bins);
+      }
+    else
+      {
+      // compute global histogram ranges
+      this->Internals->PreCompute(comm, this->Bins);
+      }
+
+    if (!ierr)
+      ierr = VTKUtils::ParallelFor(nThreads, pieces.size(), compute);
+
+    if (provisional)
+      {
+      std::vector<double> range;
+      this->Internals->FinishRange(range);
+      this->Internals->Rebin(range);
+      }
+
+    // compute the global histograms
+    if (this->Pipelined)
+      this->Internals->StartPostCompute(comm, step, time,
+        this->MeshName, this->Variables, this->FileName);
+    else
+      this->Internals->PostCompute(comm, step, time,
+        this->MeshName, this->Variables, this->FileName);
+
+    return ierr;
+    };
+
   // get the mesh metadata object
   MeshMetadataPtr mmd;
   if (mdMap.GetMeshMetadata(this->MeshName, mmd))
@@ -97,28 +305,26 @@ bool Histogram::Execute(DataAdaptor* data)
     {
     // it is not an necessarilly an error if all ranks do not have
     // a dataset to process
-    this->Internals->PreCompute(this->GetCommunicator(), this->Bins);
-
-    this->Internals->PostCompute(this->GetCommunicator(), this->Bins,
-      step, time, this->MeshName, this->ArrayName, this->FileName);
-
+    computeHistograms();
     return true;
     }
 
-  // add the array
-  if (data->AddArray(mesh, this->MeshName, this->Association, this->ArrayName))
+  // add the arrays, each only once even if several components are used
+  std::vector<std::string> arrays(this->ArrayNames);
+  std::sort(arrays.begin(), arrays.end());
+  arrays.erase(std::unique(arrays.begin(), arrays.end()), arrays.end());
+
+  if (data->AddArrays(mesh, this->MeshName, this->Association, arrays))
     {
     // it is an error if we try to compute a histogram over a non
     // existant array
     SENSEI_ERROR(<< data->GetClassName() << " failed to add "
       << (this->Association == vtkDataObject::POINT ? "point" : "cell")
-      << " data array \""  << this->ArrayName << "\"")
+      << " data arrays to mesh \""  << this->MeshName << "\"")
 
-    this->Internals->PreCompute(this->GetCommunicator(), this->Bins);
-
-    this->Internals->PostCompute(this->GetCommunicator(), this->Bins,
-      step, time, this->MeshName, this->ArrayName, this->FileName);
+    computeHistograms();
 
+    mesh->Delete();
     return false;
     }
 
@@ -136,89 +342,62 @@ bool Histogram::Execute(DataAdaptor* data)
     return false;
     }
 
-  if (vtkCompositeDataSet* cd = dynamic_cast<vtkCompositeDataSet*>(mesh))
+  int rank = 0;
+  MPI_Comm_rank(comm, &rank);
+
+  bool composite = dynamic_cast<vtkCompositeDataSet*>(mesh);
+
+  VTKUtils::ThreadDatasetFunction getPieces = [&](unsigned int,
+    unsigned int flatIndex, vtkDataSet *ds) -> int
     {
-    vtkSmartPointer<vtkCompositeDataIterator> iter;
-    iter.TakeReference(cd->NewIterator());
+    // get the ghost cell array
+    vtkUnsignedCharArray *ghostArray = dynamic_cast<vtkUnsignedCharArray*>(
+      this->GetArray(ds, this->GetGhostArrayName()));
 
-    for (iter->InitTraversal(); !iter->IsDoneWithTraversal(); iter->GoToNextItem())
+    for (unsigned int j = 0; j < nVars; ++j)
       {
-      // get the local mesh
-      vtkDataObject *curObj = iter->GetCurrentDataObject();
-
       // get the array to compute histogram for
-      vtkDataArray* array = this->GetArray(curObj, this->ArrayName);
+      const std::string &arrayName = this->ArrayNames[j];
+      vtkDataArray* array = this->GetArray(ds, arrayName);
       if (!array)
         {
-        SENSEI_WARNING("Dataset " << iter->GetCurrentFlatIndex()
-          << " has no array named \"" << this->ArrayName << "\"")
+        SENSEI_WARNING("Dataset " << (composite ? flatIndex : rank)
+          << " has no array named \"" << arrayName << "\"")
         continue;
         }
 
-      // and get the ghost cell array
-      vtkUnsignedCharArray *ghostArray = dynamic_cast<vtkUnsignedCharArray*>(
-        this->GetArray(curObj, this->GetGhostArrayName()));
-
-      // compute local histogram range
-      this->Internals->AddRange(array, ghostArray);
-      }
+      int nComps = array->GetNumberOfComponents();
+      int comp = this->Components[j];
+      if (comp == COMPONENT_DEFAULT)
+        comp = nComps == 1 ? 0 : VTKHistogram::MAGNITUDE;
 
-    // compute global histogram range
-    this->Internals->PreCompute(this->GetCommunicator(), this->Bins);
-
-    for (iter->InitTraversal(); !iter->IsDoneWithTraversal(); iter->GoToNextItem())
-      {
-      // get the local mesh
-      vtkDataObject *curObj = iter->GetCurrentDataObject();
-      // get the array to compute histogram for
-      vtkDataArray* array = this->GetArray(curObj, this->ArrayName);
-      if (!array)
+      if (comp >= nComps)
         {
-        SENSEI_WARNING("Dataset " << iter->GetCurrentFlatIndex()
-          << " has no array named \"" << this->ArrayName << "\"")
+        SENSEI_WARNING("Array \"" << arrayName << "\" on dataset "
+          << (composite ? flatIndex : rank) << " has no component " << comp)
         continue;
         }
 
-      // and get the ghost cell array
-      vtkUnsignedCharArray *ghostArray = dynamic_cast<vtkUnsignedCharArray*>(
-        this->GetArray(curObj, this->GetGhostArrayName()));
-
-      // compute local histogram
-      this->Internals->Compute(array, ghostArray);
+      vtkIdType nVals = array->GetNumberOfTuples();
+      for (vtkIdType i = 0; i < nVals; i += pieceSize)
+        pieces.push_back({j, comp, array, ghostArray,
+          i, std::min(i + pieceSize, nVals)});
       }
 
-    // compute the global histogram
-    this->Internals->PostCompute(this->GetCommunicator(), this->Bins,
-      step, time, this->MeshName, this->ArrayName, this->FileName);
-    }
-  else
-    {
-    vtkDataArray* array = this->GetArray(mesh, this->ArrayName);
-    if (!array)
-      {
-      int rank = 0;
-      MPI_Comm_rank(this->GetCommunicator(), &rank);
-
-      SENSEI_WARNING("Dataset " << rank << " has no array named \""
-        << this->ArrayName << "\"")
-
-      this->Internals->PreCompute(this->GetCommunicator(), this->Bins);
+    return 0;
+    };
 
-      this->Internals->PostCompute(this->GetCommunicator(), this->Bins,
-        step, time, this->MeshName, this->ArrayName, this->FileName);
-      }
-    else
-      {
-      vtkUnsignedCharArray *ghostArray = dynamic_cast<vtkUnsignedCharArray*>(
-        this->GetArray(mesh, this->GetGhostArrayName()));
+  int ierr = VTKUtils::ParallelApply(1, mesh, getPieces);
 
-      this->Internals->AddRange(array, ghostArray);
-      this->Internals->PreCompute(this->GetCommunicator(), this->Bins);
-      this->Internals->Compute(array, ghostArray);
+  if (computeHistograms())
+    ierr = -1;
 
-      this->Internals->PostCompute(this->GetCommunicator(), this->Bins,
-        step, time, this->MeshName, this->ArrayName, this->FileName);
-      }
+  if (ierr)
+    {
+    SENSEI_ERROR("Failed to compute the histograms on mesh \""
+      << this->MeshName << "\"")
+    mesh->Delete();
+    return false;
     }
 
   mesh->Delete();
@@ -238,18 +417,34 @@ vtkDataArray* Histogram::GetArray(vtkDataObject* dobj, const std::string& arrayn
 //-----------------------------------------------------------------------------
 int Histogram::GetHistogram(double &min, double &max,
   std::vector<unsigned int> &bins)
+{
+  return this->GetHistogram(0, min, max, bins);
+}
+
+//-----------------------------------------------------------------------------
+int Histogram::GetHistogram(unsigned int i, double &min, double &max,
+  std::vector<unsigned int> &bins)
 {
   if (!this->Internals)
     return -1;
 
-  return this->Internals->GetHistogram(this->GetCommunicator(), min, max, bins);
+  return this->Internals->GetHistogram(this->GetCommunicator(), i,
+    min, max, bins);
 }
 
 //-----------------------------------------------------------------------------
 int Histogram::Finalize()
 {
+  // complete the reduction started during the last step
+  if (this->Internals)
+    this->Internals->FinishPostCompute();
+
   delete this->Internals;
   this->Internals = nullptr;
+
+  if (this->Store && this->Store->Close())
+    return -1;
+
   return 0;
 }
 
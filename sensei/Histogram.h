@@ -3,6 +3,7 @@
 
 #include "AnalysisAdaptor.h"
 #include <mpi.h>
+#include <string>
 #include <vector>
 
 class vtkDataObject;
@@ -12,9 +13,25 @@ namespace sensei
 {
 
 class VTKHistogram;
+class TimeSeriesStore;
 
 /// @class Histogram
-/// @brief Computes a parallel histogram
+/// @brief Computes parallel histograms of one or more arrays
+///
+/// The arrays are taken from the same mesh in a single pass, and their
+/// ranges and bins are reduced with one collective each regardless of
+/// the number of arrays. Each array name may select a component with
+/// name:N, or the magnitude with name:mag. A plain name bins the values
+/// of a scalar array and the magnitude of a vector array.
+///
+/// By default the global range is reduced before the data is binned, and
+/// the bins are reduced before Execute returns. In pipelined mode the
+/// range reduction overlaps with binning into a provisional histogram that
+/// is re-binned when the range arrives, and the bin reduction completes at
+/// the next step or in Finalize, which is when the results are written.
+/// The range reduction is skipped when the range is given up front, and
+/// is taken off of the critical path when the previous step's range is
+/// used.
 class Histogram : public AnalysisAdaptor
 {
 public:
@@ -25,14 +42,47 @@ public:
     int association, const std::string& arrayName,
     const std::string &fileName);
 
+  void Initialize(int bins, const std::string &meshName,
+    int association, const std::vector<std::string> &arrayNames,
+    const std::string &fileName);
+
+  // overlap the reductions with computation, see above
+  void SetPipelined(int val) { this->Pipelined = val; }
+  int GetPipelined() const { return this->Pipelined; }
+
+  // bin all of the arrays over [min, max] rather than the range of the
+  // data. values outside of the range are counted in the end bins.
+  void SetRange(double min, double max);
+
+  // bin over the global range of the data at the previous step, values
+  // outside of it are counted in the end bins. the first step uses the
+  // range of its own data.
+  void SetUsePreviousRange(int val) { this->UsePreviousRange = val; }
+  int GetUsePreviousRange() const { return this->UsePreviousRange; }
+
+  // append the results of every step to a single binary file named
+  // <fileName>_<mesh>.sts rather than writing a text file per step. see
+  // TimeSeriesStore.
+  void SetTimeSeries(int val) { this->TimeSeries = val; }
+  int GetTimeSeries() const { return this->TimeSeries; }
+
   bool Execute(DataAdaptor* data) override;
+  int GetThreadSafe() override { return 1; }
 
   int Finalize() override;
 
-  // return the last computed histogram
+  // return the last computed histogram of the first array
   int GetHistogram(double &min, double &max,
     std::vector<unsigned int> &bins);
 
+  // return the last computed histogram of the i'th array
+  int GetHistogram(unsigned int i, double &min, double &max,
+    std::vector<unsigned int> &bins);
+
+  // the number of arrays histogrammed
+  unsigned int GetNumberOfHistograms() const
+  { return this->Variables.size(); }
+
 protected:
   Histogram();
   ~Histogram();
@@ -43,13 +93,24 @@ protected:
   static const char *GetGhostArrayName();
   vtkDataArray* GetArray(vtkDataObject* dobj, const std::string& arrayname);
 
+  // open the time series file on rank 0, if that is where the results go
+  int OpenStore();
+
   int Bins;
   std::string MeshName;
-  std::string ArrayName;
+  std::vector<std::string> Variables;
+  std::vector<std::string> ArrayNames;
+  std::vector<int> Components;
   int Association;
   std::string FileName;
+  int Pipelined;
+  int UsePreviousRange;
+  std::vector<double> Range;
+  std::vector<double> PreviousRange;
+  int TimeSeries;
 
   VTKHistogram *Internals;
+  TimeSeriesStore *Store;
 
 };
 
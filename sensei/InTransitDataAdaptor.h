@@ -55,9 +55,14 @@ public:
   // words given M ranks and P blocks on the sender/simulation side, a partitioning
   // with N ranks and P blocks on the receiver/analysis side is supported.
   // A transport may support more sophistocated partitioning, but it's not
-  // required. An analysis need not use this API, in that case the default
-  // is handled by the transport layer. See comments in InTransitDataAdaptor::Initialize
-  // for the universal partioning options as well as comments in the specific
+  // required. The ADIOS2 and HDF5 transports also read logically Cartesian
+  // blocks split into slabs by the receiver, so that N may exceed P. Each
+  // piece names the sender block it was cut from in
+  // MeshMetadata::BlockSource and its sub-extent in
+  // MeshMetadata::BlockExtents, see SubBlockPartitioner. An analysis need
+  // not use this API, in that case the default is handled by the transport
+  // layer. See comments in InTransitDataAdaptor::Initialize for the
+  // universal partioning options as well as comments in the specific
   // transport's implementation.
   //
   // The default implementation manages the metadata objects, derived classes
@@ -0,0 +1,262 @@
+#include "IncrementalPartitioner.h"
+#include "ConfigurablePartitioner.h"
+#include "Profiler.h"
+
+#include <pugixml.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <set>
+#include <utility>
+
+namespace sensei
+{
+
+// --------------------------------------------------------------------------
+void IncrementalPartitioner::SetOwners(const MeshMetadataPtr &md, int nRanks)
+{
+  int nBlocks = md->NumBlocks;
+  bool haveIds = int(md->BlockIds.size()) == nBlocks;
+
+  OwnerMap &om = this->Owners[md->MeshName];
+  om.NumRanks = nRanks;
+  om.Owner.clear();
+
+  for (int i = 0; i < nBlocks; ++i)
+    om.Owner[haveIds ? md->BlockIds[i] : i] = md->BlockOwner[i];
+}
+
+// --------------------------------------------------------------------------
+int IncrementalPartitioner::GetPartition(MPI_Comm comm,
+  const MeshMetadataPtr &mdIn, MeshMetadataPtr &mdOut)
+{
+  TimeEvent<128> mark("IncrementalPartitioner::GetPartition");
+
+  int nRanks = 1;
+  MPI_Comm_size(comm, &nRanks);
+
+  // the first partition of the mesh, or the number of ranks changed
+  std::map<std::string, OwnerMap>::iterator it =
+    this->Owners.find(mdIn->MeshName);
+
+  if ((it == this->Owners.end()) || (it->second.NumRanks != nRanks))
+    {
+    if (this->InitialPartitioner ?
+      this->InitialPartitioner->GetPartition(comm, mdIn, mdOut) :
+      this->WeightedPartitioner::GetPartition(comm, mdIn, mdOut))
+      return -1;
+
+    this->MovedFraction = 1.0;
+    this->SetOwners(mdOut, nRanks);
+
+    return 0;
+    }
+
+  mdOut = mdIn->NewCopy();
+
+  int nBlocks = mdOut->NumBlocks;
+  bool haveIds = int(mdOut->BlockIds.size()) == nBlocks;
+
+  // blocks seen before stay with their owner
+  const std::map<int, int> &prevOwner = it->second.Owner;
+
+  std::vector<int> owner(nBlocks, -1);
+  std::vector<int> newBlocks;
+  for (int i = 0; i < nBlocks; ++i)
+    {
+    std::map<int, int>::const_iterator pit =
+      prevOwner.find(haveIds ? mdOut->BlockIds[i] : i);
+
+    if (pit == prevOwner.end())
+      newBlocks.push_back(i);
+    else
+      owner[i] = pit->second;
+    }
+
+  // the partition of a static mesh is reused
+  if (mdOut->StaticMesh && newBlocks.empty())
+    {
+    mdOut->BlockOwner = owner;
+    this->MovedFraction = 0.0;
+    return 0;
+    }
+
+  // every rank computes the same partition from the same metadata
+  std::vector<double> costs;
+  std::vector<double> bytes;
+  if (this->GetBlockCosts(mdOut, costs) || this->GetBlockBytes(mdOut, bytes))
+    return -1;
+
+  std::vector<double> load(nRanks, 0.0);
+  for (int i = 0; i < nBlocks; ++i)
+    {
+    if (owner[i] >= 0)
+      load[owner[i]] += costs[i];
+    }
+
+  // the ranks ordered by load, ties go to the lower rank
+  std::set<std::pair<double, int>> ranks;
+  for (int j = 0; j < nRanks; ++j)
+    ranks.insert(std::make_pair(load[j], j));
+
+  // blocks not seen before, largest first, go to the least loaded rank
+  std::vector<int> keptOwner = owner;
+
+  std::stable_sort(newBlocks.begin(), newBlocks.end(),
+    [&costs](int a, int b) -> bool { return costs[a] > costs[b]; });
+
+  int nNew = newBlocks.size();
+  for (int i = 0; i < nNew; ++i)
+    {
+    int bid = newBlocks[i];
+    int dest = ranks.begin()->second;
+
+    ranks.erase(ranks.begin());
+    load[dest] += costs[bid];
+    ranks.insert(std::make_pair(load[dest], dest));
+
+    owner[bid] = dest;
+    }
+
+  // migrate blocks from the most to the least loaded rank until the
+  // imbalance is below the threshold. every move lowers the sum of the
+  // squared loads, the number of moves is bounded as a safe guard
+  double total = 0.0;
+  for (int j = 0; j < nRanks; ++j)
+    total += load[j];
+
+  double target = this->Threshold*total/nRanks;
+
+  for (int n = 0; n < 4*nBlocks; ++n)
+    {
+    int src = ranks.rbegin()->second;
+    int dest = ranks.begin()->second;
+
+    if ((src == dest) || (load[src] <= target))
+      break;
+
+    double gap = load[src] - load[dest];
+
+    // blocks of at most half the gap are preferred since moving them does
+    // not make the destination the most loaded rank. amongst those the
+    // block with the most cost per byte moves. otherwise the smallest
+    // block that narrows the gap moves
+    int best = -1;
+    double bestRatio = 0.0;
+    int fallback = -1;
+    for (int i = 0; i < nBlocks; ++i)
+      {
+      double cost = costs[i];
+      if ((owner[i] != src) || (cost <= 0.0))
+        continue;
+
+      if (cost <= 0.5*gap)
+        {
+        double ratio = cost/std::max(bytes[i], 1.0);
+        if ((best < 0) || (ratio > bestRatio) ||
+          ((ratio == bestRatio) && (cost > costs[best])))
+          {
+          best = i;
+          bestRatio = ratio;
+          }
+        }
+      else if ((cost < gap) && ((fallback < 0) || (cost < costs[fallback])))
+        {
+        fallback = i;
+        }
+      }
+
+    if (best < 0)
+      best = fallback;
+
+    if (best < 0)
+      break;
+
+    ranks.erase(std::make_pair(load[src], src));
+    ranks.erase(std::make_pair(load[dest], dest));
+
+    load[src] -= costs[best];
+    load[dest] += costs[best];
+
+    ranks.insert(std::make_pair(load[src], src));
+    ranks.insert(std::make_pair(load[dest], dest));
+
+    owner[best] = dest;
+    }
+
+  // the bytes that changed owner, including the blocks not seen before
+  int nMoved = 0;
+  double moved = 0.0;
+  double totalBytes = 0.0;
+  for (int i = 0; i < nBlocks; ++i)
+    {
+    totalBytes += bytes[i];
+    if (owner[i] != keptOwner[i])
+      {
+      moved += bytes[i];
+      nMoved += keptOwner[i] >= 0 ? 1 : 0;
+      }
+    }
+
+  this->MovedFraction = totalBytes > 0.0 ? moved/totalBytes : 0.0;
+
+  mdOut->BlockOwner = owner;
+  this->SetOwners(mdOut, nRanks);
+
+  char eventName[128];
+  snprintf(eventName, 128, "IncrementalPartitioner::GetPartition moved=%.4f",
+    this->MovedFraction);
+  Profiler::StartEvent(eventName);
+  Profiler::EndEvent(eventName);
+
+  if (this->GetVerbose())
+    {
+    SENSEI_STATUS("Migrated " << nMoved << " and placed " << nNew
+      << " new of " << nBlocks << " blocks of mesh \"" << mdOut->MeshName
+      << "\", " << 100.0*this->MovedFraction << "% of the bytes moved")
+    }
+
+  this->ReportImbalance(mdOut, load);
+
+  return 0;
+}
+
+// --------------------------------------------------------------------------
+int IncrementalPartitioner::Initialize(pugi::xml_node &node)
+{
+  TimeEvent<128> mark("IncrementalPartitioner::Initialize");
+
+  if (this->InitializeCost(node) || this->InitializeMethod(node))
+    return -1;
+
+  double threshold = node.attribute("threshold").as_double(1.1);
+  if (threshold < 1.0)
+    {
+    SENSEI_ERROR("Invalid threshold " << threshold << ". The threshold "
+      "must be at least 1")
+    return -1;
+    }
+  this->SetThreshold(threshold);
+
+  // the partitioner used on the first step
+  pugi::xml_node partNode = node.child("partitioner");
+  if (partNode)
+    {
+    ConfigurablePartitionerPtr part = ConfigurablePartitioner::New();
+    if (part->Initialize(partNode))
+      {
+      SENSEI_ERROR("Failed to initialize the initial partitioner")
+      return -1;
+      }
+    this->SetInitialPartitioner(part);
+    }
+
+  SENSEI_STATUS("Configured IncrementalPartitioner threshold=" << threshold
+    << " cost=" << node.attribute("cost").as_string("cells")
+    << (this->Cost == COST_EXPRESSION ? " expression=" + this->Expression : "")
+    << " initial=" << (partNode ? partNode.attribute("type").value() : "weighted"))
+
+  return 0;
+}
+
+}
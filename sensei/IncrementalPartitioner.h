@@ -0,0 +1,96 @@
+#ifndef sensei_IncrementalPartitioner_h
+#define sensei_IncrementalPartitioner_h
+
+#include "WeightedPartitioner.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace sensei
+{
+
+class IncrementalPartitioner;
+using IncrementalPartitionerPtr = std::shared_ptr<sensei::IncrementalPartitioner>;
+
+/// @class IncrementalPartitioner
+/// The incremental partitioner keeps the assignment of blocks to ranks
+/// from one time step to the next, so that small changes in the size of
+/// the blocks do not reshuffle ownership and move most of the data. The
+/// first partition of each mesh is made by a nested partitioner, or when
+/// none is given, as for the WeightedPartitioner. On later steps the
+/// blocks stay with their previous owner, blocks not seen before go to the
+/// least loaded rank, and only when the imbalance, the largest load over
+/// the average, exceeds the threshold are blocks migrated. Blocks then
+/// move from the most to the least loaded rank, choosing at each move the
+/// block with the most cost per byte that narrows the gap, until the
+/// imbalance is below the threshold or no move helps. The partition of
+/// meshes flagged as static (MeshMetadata.StaticMesh) is computed once and
+/// reused. Blocks are matched across steps by MeshMetadata.BlockIds, or by
+/// index when the sender does not provide ids. The fraction of the bytes
+/// moved and the imbalance are logged as Profiler events. The XML is of
+/// the form:
+///
+///   <partitioner type="incremental" threshold="1.1" cost="bytes">
+///     <partitioner type="sfc"/>
+///   </partitioner>
+class IncrementalPartitioner : public sensei::WeightedPartitioner
+{
+public:
+  static sensei::IncrementalPartitionerPtr New()
+  { return IncrementalPartitionerPtr(new IncrementalPartitioner); }
+
+  const char *GetClassName() override { return "IncrementalPartitioner"; }
+
+  // set the imbalance above which blocks are migrated
+  void SetThreshold(double threshold) { this->Threshold = threshold; }
+  double GetThreshold() { return this->Threshold; }
+
+  // set the partitioner used for the first partition of each mesh. when
+  // none is set the blocks are placed as by the WeightedPartitioner
+  void SetInitialPartitioner(const sensei::PartitionerPtr &part)
+  { this->InitialPartitioner = part; }
+
+  // given an existing partitioning of data passed in the first MeshMetadata
+  // argument,return a new partittioning in the second MeshMetadata argument.
+  // keeps the previous partition of the mesh, migrating blocks only when
+  // the imbalance exceeds the threshold.
+  int GetPartition(MPI_Comm comm, const sensei::MeshMetadataPtr &in,
+    sensei::MeshMetadataPtr &out) override;
+
+  // get the fraction of the bytes that changed owner in the last
+  // partition. blocks not seen before count as moved, thus the first
+  // partition of a mesh moves all of the bytes
+  double GetMovedFraction() { return this->MovedFraction; }
+
+  // forget the previous partitions, the next call of each mesh starts over
+  void Clear() { this->Owners.clear(); }
+
+  // Initialize from XML
+  int Initialize(pugi::xml_node &node) override;
+
+protected:
+  IncrementalPartitioner() : Threshold(1.1), MovedFraction(1.0) {}
+  IncrementalPartitioner(const IncrementalPartitioner &) = default;
+
+  // the owner of each block, by block id, and the number of ranks
+  struct OwnerMap
+  {
+    OwnerMap() : NumRanks(0), Owner() {}
+
+    int NumRanks;
+    std::map<int, int> Owner;
+  };
+
+  // record the partition of the mesh for the next step
+  void SetOwners(const sensei::MeshMetadataPtr &md, int nRanks);
+
+  double Threshold;
+  double MovedFraction;
+  sensei::PartitionerPtr InitialPartitioner;
+  std::map<std::string, OwnerMap> Owners;  // indexed by mesh name
+};
+
+}
+
+#endif
@@ -0,0 +1,606 @@
+#include "JointHistogram.h"
+#include "DataAdaptor.h"
+#include "MeshMetadata.h"
+#include "MeshMetadataMap.h"
+#include "Profiler.h"
+#include "VTKUtils.h"
+#include "Error.h"
+#include "MPIUtils.h"
+
+#include <vtkDataObject.h>
+#include <vtkDataSet.h>
+#include <vtkDataSetAttributes.h>
+#include <vtkFieldData.h>
+#include <vtkObjectFactory.h>
+#include <vtkUnsignedCharArray.h>
+#ifdef ENABLE_VTK_GENERIC_ARRAYS
+#include <vtkAOSDataArrayTemplate.h>
+#include <vtkArrayDispatch.h>
+#else
+#include <vtkDataArrayDispatcher.h>
+#endif
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <errno.h>
+#include <functional>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+namespace sensei
+{
+namespace
+{
+using BinCount = std::pair<unsigned long, unsigned long>;
+
+// Copies the values [Start, End) of a scalar array into a buffer of
+// doubles. To be used with vtkArrayDispatch or vtkDataArrayDispatcher.
+struct CopyWorker
+{
+  vtkIdType Start;
+  vtkIdType End;
+  double *Out;
+
+  template <typename T>
+  void Copy(const T *vals)
+  {
+    vtkIdType n = this->End - this->Start;
+    vals += this->Start;
+    for (vtkIdType i = 0; i < n; ++i)
+      this->Out[i] = static_cast<double>(vals[i]);
+  }
+
+#ifdef ENABLE_VTK_GENERIC_ARRAYS
+  template <typename T>
+  void operator()(vtkAOSDataArrayTemplate<T> *array)
+  {
+    this->Copy(array->GetPointer(0));
+  }
+
+  template <typename ArrayT>
+  void operator()(ArrayT *array)
+  {
+    for (vtkIdType i = this->Start; i < this->End; ++i)
+      this->Out[i - this->Start] =
+        static_cast<double>(array->GetTypedComponent(i, 0));
+  }
+#else
+  template <typename T>
+  void operator()(const vtkDataArrayDispatcherPointer<T>& array)
+  {
+    this->Copy(array.RawPointer);
+  }
+#endif
+};
+
+// The bin counts of one thread, either dense or only the non-empty bins
+struct BinCounts
+{
+  void Add(unsigned long bin)
+  {
+    if (this->IsDense)
+      this->Dense[bin] += 1;
+    else
+      this->Sparse[bin] += 1;
+  }
+
+  bool IsDense;
+  std::vector<unsigned long> Dense;
+  std::unordered_map<unsigned long, unsigned long> Sparse;
+};
+
+// merge two lists of non-empty bins sorted by bin index
+void merge(const std::vector<BinCount> &a, const std::vector<BinCount> &b,
+  std::vector<BinCount> &out)
+{
+  out.clear();
+  out.reserve(a.size() + b.size());
+
+  auto ai = a.begin();
+  auto bi = b.begin();
+  while ((ai != a.end()) && (bi != b.end()))
+    {
+    if (ai->first < bi->first)
+      out.push_back(*ai++);
+    else if (bi->first < ai->first)
+      out.push_back(*bi++);
+    else
+      out.emplace_back(ai->first, (ai++)->second + (bi++)->second);
+    }
+
+  out.insert(out.end(), ai, a.end());
+  out.insert(out.end(), bi, b.end());
+}
+
+// reduce the non-empty bins of all ranks onto rank 0 with a binomial
+// tree, each message carries only the non-empty bins. the bins on the
+// other ranks are left in an unspecified state.
+void reduceSparse(MPI_Comm comm, std::vector<BinCount> &bins)
+{
+  // the bins are sent as a flat array of bin index, count pairs, the
+  // layout of std::pair is not something MPI can rely on
+  std::vector<BinCount> other;
+  std::vector<BinCount> tmp;
+
+  MPIUtils::BinomialReduce<unsigned long>(comm, 0,
+    [&](std::vector<unsigned long> &buf)
+      {
+      size_t nBins = bins.size();
+      buf.resize(2*nBins);
+      for (size_t i = 0; i < nBins; ++i)
+        {
+        buf[2*i] = bins[i].first;
+        buf[2*i + 1] = bins[i].second;
+        }
+      },
+    [&](const std::vector<unsigned long> &buf) -> int
+      {
+      size_t nBins = buf.size()/2;
+      other.resize(nBins);
+      for (size_t i = 0; i < nBins; ++i)
+        other[i] = BinCount(buf[2*i], buf[2*i + 1]);
+
+      merge(bins, other, tmp);
+      bins.swap(tmp);
+      return 0;
+      });
+}
+}
+
+//-----------------------------------------------------------------------------
+senseiNewMacro(JointHistogram);
+
+//-----------------------------------------------------------------------------
+JointHistogram::JointHistogram() :
+  Association(vtkDataObject::FIELD_ASSOCIATION_POINTS), DenseLimit(1ul << 18)
+{
+}
+
+//-----------------------------------------------------------------------------
+JointHistogram::~JointHistogram()
+{
+}
+
+//-----------------------------------------------------------------------------
+void JointHistogram::Initialize(const std::string &meshName, int association,
+  const std::vector<std::string> &arrayNames, const std::vector<int> &bins,
+  const std::string &fileName)
+{
+  this->MeshName = meshName;
+  this->Association = association;
+  this->ArrayNames = arrayNames;
+  this->FileName = fileName;
+
+  // a single value applies to all of the arrays
+  this->Bins = bins;
+  if (bins.size() == 1)
+    this->Bins.resize(arrayNames.size(), bins[0]);
+}
+
+//-----------------------------------------------------------------------------
+void JointHistogram::SetRanges(const std::vector<double> &ranges)
+{
+  this->GivenRanges = ranges;
+}
+
+//-----------------------------------------------------------------------------
+const char *JointHistogram::GetGhostArrayName()
+{
+#if VTK_MAJOR_VERSION == 6 && VTK_MINOR_VERSION == 1
+    return "vtkGhostType";
+#else
+    return vtkDataSetAttributes::GhostArrayName();
+#endif
+}
+
+//-----------------------------------------------------------------------------
+vtkDataArray* JointHistogram::GetArray(vtkDataObject* dobj, const std::string& arrayname)
+{
+  if (vtkFieldData* fd = dobj->GetAttributesAsFieldData(this->Association))
+    {
+    return fd->GetArray(arrayname.c_str());
+    }
+  return nullptr;
+}
+
+//-----------------------------------------------------------------------------
+bool JointHistogram::Execute(DataAdaptor* data)
+{
+  TimeEvent<128> mark("JointHistogram::Execute");
+
+  MPI_Comm comm = this->GetCommunicator();
+
+  int rank = 0;
+  MPI_Comm_rank(comm, &rank);
+
+  long step = data->GetDataTimeStep();
+  double time = data->GetDataTime();
+
+  unsigned int nDims = this->ArrayNames.size();
+  if ((nDims < 2) || (this->Bins.size() != nDims) ||
+    (!this->GivenRanges.empty() && (this->GivenRanges.size() != 2*nDims)))
+    {
+    SENSEI_ERROR("A joint histogram needs two or more arrays, and a number"
+      " of bins and optionally a range for each")
+    return false;
+    }
+
+  // the total number of bins
+  unsigned long nBins = 1;
+  for (unsigned int d = 0; d < nDims; ++d)
+    {
+    if ((this->Bins[d] < 1) ||
+      (nBins > std::numeric_limits<unsigned long>::max()/this->Bins[d]))
+      {
+      SENSEI_ERROR("Invalid number of bins")
+      return false;
+      }
+    nBins *= this->Bins[d];
+    }
+
+  bool dense = nBins <= this->DenseLimit;
+
+  // see what the simulation is providing
+  MeshMetadataMap mdMap;
+  MeshMetadataPtr mmd;
+  if (mdMap.Initialize(data) || mdMap.GetMeshMetadata(this->MeshName, mmd))
+    {
+    SENSEI_ERROR("Failed to get metadata for mesh \"" << this->MeshName << "\"")
+    return false;
+    }
+
+  // get the mesh object
+  vtkDataObject* mesh = nullptr;
+  if (data->GetMesh(this->MeshName, true, mesh))
+    {
+    SENSEI_ERROR("Failed to get mesh \"" << this->MeshName << "\"")
+    return false;
+    }
+
+  // from here on all ranks take part in the reductions, including those
+  // with nothing to process or that encountered an error
+  int ierr = 0;
+
+  if (mesh && data->AddArrays(mesh, this->MeshName, this->Association,
+    this->ArrayNames))
+    {
+    SENSEI_ERROR(<< data->GetClassName() << " failed to add "
+      << (this->Association == vtkDataObject::POINT ? "point" : "cell")
+      << " data arrays to mesh \"" << this->MeshName << "\"")
+    ierr = -1;
+    }
+
+  if (mesh && !ierr && (mmd->NumGhostCells || VTKUtils::AMR(mmd)) &&
+    data->AddGhostCellsArray(mesh, this->MeshName))
+    {
+    SENSEI_ERROR(<< data->GetClassName() << " failed to add ghost cells.")
+    ierr = -1;
+    }
+
+  if (mesh && !ierr && mmd->NumGhostNodes &&
+    data->AddGhostNodesArray(mesh, this->MeshName))
+    {
+    SENSEI_ERROR(<< data->GetClassName() << " failed to add ghost nodes.")
+    ierr = -1;
+    }
+
+  unsigned int nThreads = VTKUtils::GetNumberOfThreads();
+
+  // passes over the data call the kernel with chunks of the arrays
+  // converted to double
+  using ChunkFunction = std::function<void(unsigned int thread,
+    const std::vector<double*> &vals, const unsigned char *ghosts,
+    vtkIdType n)>;
+
+  auto forEachChunk = [&](ChunkFunction &kernel) -> int
+    {
+    if (!mesh || ierr)
+      return 0;
+
+    VTKUtils::ThreadDatasetFunction func = [&](unsigned int thread,
+      unsigned int, vtkDataSet *ds) -> int
+      {
+      std::vector<vtkDataArray*> arrays(nDims);
+      for (unsigned int d = 0; d < nDims; ++d)
+        {
+        arrays[d] = this->GetArray(ds, this->ArrayNames[d]);
+        if (!arrays[d] || (arrays[d]->GetNumberOfComponents() != 1) ||
+          (arrays[d]->GetNumberOfTuples() != arrays[0]->GetNumberOfTuples()))
+          {
+          SENSEI_ERROR("Array \"" << this->ArrayNames[d]
+            << "\" is missing or is not a scalar of the same length as \""
+            << this->ArrayNames[0] << "\"")
+          return -1;
+          }
+        }
+
+      vtkUnsignedCharArray *ghostArray = dynamic_cast<vtkUnsignedCharArray*>(
+        this->GetArray(ds, this->GetGhostArrayName()));
+
+      const unsigned char *ghosts =
+        ghostArray ? ghostArray->GetPointer(0) : nullptr;
+
+      const vtkIdType chunk = 4096;
+      std::vector<double> buf(nDims*chunk);
+      std::vector<double*> vals(nDims);
+      for (unsigned int d = 0; d < nDims; ++d)
+        vals[d] = buf.data() + d*chunk;
+
+      vtkIdType nTups = arrays[0]->GetNumberOfTuples();
+      for (vtkIdType start = 0; start < nTups; start += chunk)
+        {
+        vtkIdType end = std::min(start + chunk, nTups);
+        for (unsigned int d = 0; d < nDims; ++d)
+          {
+          CopyWorker worker;
+          worker.Start = start;
+          worker.End = end;
+          worker.Out = vals[d];
+#ifdef ENABLE_VTK_GENERIC_ARRAYS
+          vtkArrayDispatch::Dispatch::Execute(arrays[d], worker);
+#else
+          vtkDataArrayDispatcher<CopyWorker> dispatcher(worker);
+          dispatcher.Go(arrays[d]);
+#endif
+          }
+        kernel(thread, vals, ghosts ? ghosts + start : nullptr, end - start);
+        }
+
+      return 0;
+      };
+
+    return VTKUtils::ParallelApply(nThreads, mesh, func);
+    };
+
+  // the ranges, given or reduced in one collective. the mins are negated
+  // so that a single max reduction does both
+  this->Ranges = this->GivenRanges;
+  if (this->Ranges.empty())
+    {
+    std::vector<std::vector<double>> tr(nThreads,
+      std::vector<double>(2*nDims, std::numeric_limits<double>::lowest()));
+
+    ChunkFunction range = [&](unsigned int thread,
+      const std::vector<double*> &vals, const unsigned char *ghosts,
+      vtkIdType n)
+      {
+      double *r = tr[thread].data();
+      for (unsigned int d = 0; d < nDims; ++d)
+        {
+        const double *v = vals[d];
+        double mn = r[d];
+        double mx = r[nDims + d];
+        for (vtkIdType i = 0; i < n; ++i)
+          {
+          if (!ghosts || !ghosts[i])
+            {
+            // nan is ignored by max
+            mn = std::max(mn, -v[i]);
+            mx = std::max(mx, v[i]);
+            }
+          }
+        r[d] = mn;
+        r[nDims + d] = mx;
+        }
+      };
+
+    if (forEachChunk(range))
+      ierr = -1;
+
+    for (unsigned int i = 1; i < nThreads; ++i)
+      for (unsigned int j = 0; j < 2*nDims; ++j)
+        tr[0][j] = std::max(tr[0][j], tr[i][j]);
+
+    MPI_Allreduce(MPI_IN_PLACE, tr[0].data(), 2*nDims, MPI_DOUBLE,
+      MPI_MAX, comm);
+
+    this->Ranges.resize(2*nDims);
+    for (unsigned int d = 0; d < nDims; ++d)
+      {
+      // no data
+      if (-tr[0][d] > tr[0][nDims + d])
+        tr[0][d] = tr[0][nDims + d] = 0.0;
+
+      this->Ranges[2*d] = -tr[0][d];
+      this->Ranges[2*d + 1] = tr[0][nDims + d];
+      }
+    }
+
+  std::vector<double> scale(nDims);
+  for (unsigned int d = 0; d < nDims; ++d)
+    {
+    double width = this->Ranges[2*d + 1] - this->Ranges[2*d];
+    scale[d] = width > 0.0 ? this->Bins[d]/width : 0.0;
+    }
+
+  // bin the values, each thread with its own counts
+  std::vector<BinCounts> counts(nThreads);
+  for (unsigned int i = 0; i < nThreads; ++i)
+    {
+    counts[i].IsDense = dense;
+    if (dense && mesh)
+      counts[i].Dense.resize(nBins, 0);
+    }
+
+  ChunkFunction bin = [&](unsigned int thread,
+    const std::vector<double*> &vals, const unsigned char *ghosts,
+    vtkIdType n)
+    {
+    std::vector<unsigned long> idx(n, 0);
+    std::vector<unsigned char> valid(n, 1);
+
+    for (unsigned int d = 0; d < nDims; ++d)
+      {
+      const double *v = vals[d];
+      double mn = this->Ranges[2*d];
+      double sc = scale[d];
+      long nb = this->Bins[d];
+      for (vtkIdType i = 0; i < n; ++i)
+        {
+        // out of range values go in the end bins, nan is skipped
+        double x = (v[i] - mn)*sc;
+        long b = x >= 0.0 ? (x < nb ? long(x) : nb - 1) : 0;
+        idx[i] = idx[i]*nb + b;
+        valid[i] &= (v[i] == v[i]);
+        }
+      }
+
+    BinCounts &c = counts[thread];
+    for (vtkIdType i = 0; i < n; ++i)
+      {
+      if (valid[i] && (!ghosts || !ghosts[i]))
+        c.Add(idx[i]);
+      }
+    };
+
+  if (forEachChunk(bin))
+    ierr = -1;
+
+  if (mesh)
+    mesh->Delete();
+
+  // reduce the bins
+  this->Counts.clear();
+  if (dense)
+    {
+    counts[0].Dense.resize(nBins, 0);
+    for (unsigned int i = 1; i < nThreads; ++i)
+      {
+      if (counts[i].Dense.empty())
+        continue;
+      for (unsigned long j = 0; j < nBins; ++j)
+        counts[0].Dense[j] += counts[i].Dense[j];
+      }
+
+    std::vector<unsigned long> &bins = counts[0].Dense;
+
+    MPI_Reduce(rank == 0 ? MPI_IN_PLACE : bins.data(), bins.data(),
+      nBins, MPI_UNSIGNED_LONG, MPI_SUM, 0, comm);
+
+    if (rank == 0)
+      {
+      for (unsigned long j = 0; j < nBins; ++j)
+        {
+        if (bins[j])
+          this->Counts.emplace_back(j, bins[j]);
+        }
+      }
+    }
+  else
+    {
+    for (unsigned int i = 1; i < nThreads; ++i)
+      for (auto &c : counts[i].Sparse)
+        counts[0].Sparse[c.first] += c.second;
+
+    this->Counts.assign(counts[0].Sparse.begin(), counts[0].Sparse.end());
+    std::sort(this->Counts.begin(), this->Counts.end());
+
+    reduceSparse(comm, this->Counts);
+
+    if (rank != 0)
+      this->Counts.clear();
+    }
+
+  if ((rank == 0) && this->WriteHistogram(step, time))
+    ierr = -1;
+
+  if (ierr)
+    {
+    SENSEI_ERROR("Failed to compute the joint histogram on mesh \""
+      << this->MeshName << "\"")
+    return false;
+    }
+
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+int JointHistogram::WriteHistogram(long step, double time)
+{
+  if (this->FileName.empty())
+    return 0;
+
+  char fname[1024] = {'\0'};
+  snprintf(fname, 1024, "%s_%s_%ld.bin", this->FileName.c_str(),
+    this->MeshName.c_str(), step);
+
+  FILE *file = fopen(fname, "wb");
+  if (!file)
+    {
+    char *estr = strerror(errno);
+    SENSEI_ERROR("Failed to open \"" << fname << "\""
+      << std::endl << estr)
+    return -1;
+    }
+
+  uint32_t version = 1;
+  uint32_t nDims = this->ArrayNames.size();
+  int64_t step64 = step;
+
+  fwrite("SENSEIJH", 1, 8, file);
+  fwrite(&version, sizeof(version), 1, file);
+  fwrite(&nDims, sizeof(nDims), 1, file);
+  fwrite(&step64, sizeof(step64), 1, file);
+  fwrite(&time, sizeof(time), 1, file);
+
+  for (uint32_t d = 0; d < nDims; ++d)
+    {
+    uint32_t nBins = this->Bins[d];
+    uint32_t nameLen = this->ArrayNames[d].size();
+    fwrite(&nBins, sizeof(nBins), 1, file);
+    fwrite(&this->Ranges[2*d], sizeof(double), 2, file);
+    fwrite(&nameLen, sizeof(nameLen), 1, file);
+    fwrite(this->ArrayNames[d].c_str(), 1, nameLen, file);
+    }
+
+  uint64_t nNonZero = this->Counts.size();
+  std::vector<uint64_t> idx(nNonZero);
+  std::vector<uint64_t> cnt(nNonZero);
+  for (uint64_t i = 0; i < nNonZero; ++i)
+    {
+    idx[i] = this->Counts[i].first;
+    cnt[i] = this->Counts[i].second;
+    }
+
+  fwrite(&nNonZero, sizeof(nNonZero), 1, file);
+  fwrite(idx.data(), sizeof(uint64_t), nNonZero, file);
+  fwrite(cnt.data(), sizeof(uint64_t), nNonZero, file);
+
+  if (ferror(file))
+    {
+    SENSEI_ERROR("Failed to write \"" << fname << "\"")
+    fclose(file);
+    return -1;
+    }
+
+  fclose(file);
+
+  return 0;
+}
+
+//-----------------------------------------------------------------------------
+int JointHistogram::GetHistogram(std::vector<double> &ranges,
+  std::vector<int> &bins,
+  std::vector<std::pair<unsigned long, unsigned long>> &counts)
+{
+  if (this->Ranges.empty())
+    return -1;
+
+  ranges = this->Ranges;
+  bins = this->Bins;
+  counts = this->Counts;
+
+  return 0;
+}
+
+//-----------------------------------------------------------------------------
+int JointHistogram::Finalize()
+{
+  this->Counts.clear();
+  return 0;
+}
+
+}
@@ -0,0 +1,101 @@
+#ifndef sensei_JointHistogram_h
+#define sensei_JointHistogram_h
+
+#include "AnalysisAdaptor.h"
+#include <mpi.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+class vtkDataObject;
+class vtkDataArray;
+
+namespace sensei
+{
+
+/// @class JointHistogram
+/// @brief Computes the joint distribution of two or more arrays
+///
+/// Each value of the mesh falls in the bin given by the values of all of
+/// the arrays there, ghosts are skipped. The bins are indexed in row major
+/// order, the first array varying slowest. When the total number of bins
+/// is small they are counted in a dense array and reduced with
+/// MPI_Reduce, otherwise only the non-empty bins are kept and these are
+/// merged in a binomial tree. The ranges are reduced with a single
+/// collective before binning unless they are given.
+///
+/// Rank 0 writes each step to <fileName>_<mesh>_<step>.bin in native byte
+/// order:
+///
+///   char[8]  "SENSEIJH"
+///   uint32   version (1), uint32 number of arrays N
+///   int64    step, float64 time
+///   N times  uint32 bins, float64 min, float64 max,
+///            uint32 name length, the name
+///   uint64   number of non-empty bins M
+///   uint64[M] bin indices, in ascending order
+///   uint64[M] counts
+class JointHistogram : public AnalysisAdaptor
+{
+public:
+  static JointHistogram* New();
+  senseiTypeMacro(JointHistogram, AnalysisAdaptor);
+
+  /// @brief Initialize the adaptor.
+  ///
+  /// @param meshName name of mesh containing the arrays
+  /// @param association point or cell data
+  /// @param arrayNames two or more scalar arrays
+  /// @param bins the number of bins of each array, or a single value
+  ///        used for all of them
+  /// @param fileName the prefix of the output files, when empty nothing
+  ///        is written
+  void Initialize(const std::string &meshName, int association,
+    const std::vector<std::string> &arrayNames,
+    const std::vector<int> &bins, const std::string &fileName);
+
+  // bin the arrays over the given [min, max] pairs rather than the range
+  // of the data. values outside are counted in the end bins. an empty
+  // vector restores the default.
+  void SetRanges(const std::vector<double> &ranges);
+
+  // keep the bins in a dense array when there are at most this many
+  void SetDenseLimit(unsigned long n) { this->DenseLimit = n; }
+
+  bool Execute(DataAdaptor* data) override;
+  int GetThreadSafe() override { return 1; }
+
+  int Finalize() override;
+
+  // return the last computed histogram on rank 0. ranges has a min, max
+  // pair for each array, counts has the non-empty bins in ascending order
+  int GetHistogram(std::vector<double> &ranges, std::vector<int> &bins,
+    std::vector<std::pair<unsigned long, unsigned long>> &counts);
+
+protected:
+  JointHistogram();
+  ~JointHistogram();
+
+  JointHistogram(const JointHistogram&) = delete;
+  void operator=(const JointHistogram&) = delete;
+
+  static const char *GetGhostArrayName();
+  vtkDataArray* GetArray(vtkDataObject* dobj, const std::string& arrayname);
+
+  // report the result on rank 0
+  int WriteHistogram(long step, double time);
+
+  std::string MeshName;
+  int Association;
+  std::vector<std::string> ArrayNames;
+  std::vector<int> Bins;
+  std::string FileName;
+  std::vector<double> Ranges;
+  std::vector<double> GivenRanges;
+  unsigned long DenseLimit;
+  std::vector<std::pair<unsigned long, unsigned long>> Counts;
+};
+
+}
+
+#endif
@@ -0,0 +1,290 @@
+#include "KLLSketch.h"
+#include "Error.h"
+#include "MPIUtils.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace sensei
+{
+
+namespace
+{
+// the ratio of the capacities of adjacent levels
+constexpr double CapacityRatio = 2.0/3.0;
+
+// the capacity of level h of a sketch with nLevels levels
+unsigned long levelCapacity(unsigned int k, unsigned int nLevels,
+  unsigned int h)
+{
+  double c = std::ceil(k*std::pow(CapacityRatio, nLevels - 1 - h));
+  return std::max(2ul, static_cast<unsigned long>(c));
+}
+}
+
+// --------------------------------------------------------------------------
+KLLSketch::KLLSketch(unsigned int k) : K(std::max(k, 8u)), Count(0),
+  Min(std::numeric_limits<double>::max()),
+  Max(std::numeric_limits<double>::lowest()), NumRetained(0), Capacity(0),
+  Levels(1), Random(1)
+{
+  this->Levels[0].reserve(this->K);
+  this->UpdateCapacity();
+}
+
+// --------------------------------------------------------------------------
+void KLLSketch::UpdateCapacity()
+{
+  unsigned int nLevels = this->Levels.size();
+  this->Capacity = 0;
+  for (unsigned int h = 0; h < nLevels; ++h)
+    this->Capacity += levelCapacity(this->K, nLevels, h);
+}
+
+// --------------------------------------------------------------------------
+void KLLSketch::Compress()
+{
+  while (this->NumRetained >= this->Capacity)
+    {
+    unsigned int nLevels = this->Levels.size();
+    for (unsigned int h = 0; h < nLevels; ++h)
+      {
+      if (this->Levels[h].size() < levelCapacity(this->K, nLevels, h))
+        continue;
+
+      if (h + 1 == nLevels)
+        {
+        this->Levels.emplace_back();
+        this->UpdateCapacity();
+        }
+
+      std::vector<double> &level = this->Levels[h];
+
+      // with an odd number of items the largest one stays behind
+      std::sort(level.begin(), level.end());
+
+      size_t n = level.size();
+      double leftOver = level[n - 1];
+      bool odd = n % 2;
+      n -= odd ? 1 : 0;
+
+      // promote every other item, starting at a random offset so that the
+      // errors of successive compactions cancel on average
+      std::vector<double> &next = this->Levels[h + 1];
+      for (size_t i = this->Random() % 2; i < n; i += 2)
+        next.push_back(level[i]);
+
+      level.clear();
+      if (odd)
+        level.push_back(leftOver);
+
+      this->NumRetained -= n/2;
+      break;
+      }
+    }
+}
+
+// --------------------------------------------------------------------------
+void KLLSketch::Merge(const KLLSketch &other)
+{
+  if (!other.Count)
+    return;
+
+  unsigned int nLevels = other.Levels.size();
+  if (this->Levels.size() < nLevels)
+    {
+    this->Levels.resize(nLevels);
+    this->UpdateCapacity();
+    }
+
+  for (unsigned int h = 0; h < nLevels; ++h)
+    {
+    const std::vector<double> &level = other.Levels[h];
+    this->Levels[h].insert(this->Levels[h].end(), level.begin(), level.end());
+    }
+
+  this->Count += other.Count;
+  this->NumRetained += other.NumRetained;
+  this->Min = std::min(this->Min, other.Min);
+  this->Max = std::max(this->Max, other.Max);
+
+  this->Compress();
+}
+
+// --------------------------------------------------------------------------
+void KLLSketch::Pack(std::vector<double> &buf) const
+{
+  unsigned int nLevels = this->Levels.size();
+
+  buf.clear();
+  buf.reserve(5 + nLevels + this->NumRetained);
+  buf.push_back(this->K);
+  buf.push_back(this->Count);
+  buf.push_back(this->Min);
+  buf.push_back(this->Max);
+  buf.push_back(nLevels);
+
+  for (unsigned int h = 0; h < nLevels; ++h)
+    buf.push_back(this->Levels[h].size());
+
+  for (unsigned int h = 0; h < nLevels; ++h)
+    buf.insert(buf.end(), this->Levels[h].begin(), this->Levels[h].end());
+}
+
+// --------------------------------------------------------------------------
+int KLLSketch::Unpack(const std::vector<double> &buf)
+{
+  if (buf.size() < 5)
+    {
+    SENSEI_ERROR("Invalid sketch, " << buf.size() << " values")
+    return -1;
+    }
+
+  unsigned int nLevels = buf[4];
+  if (buf.size() < 5 + nLevels)
+    {
+    SENSEI_ERROR("Invalid sketch, " << buf.size() << " values "
+      << nLevels << " levels")
+    return -1;
+    }
+
+  this->K = buf[0];
+  this->Count = buf[1];
+  this->Min = buf[2];
+  this->Max = buf[3];
+  this->Levels.resize(nLevels);
+  this->NumRetained = 0;
+
+  const double *items = buf.data() + 5 + nLevels;
+  const double *end = buf.data() + buf.size();
+  for (unsigned int h = 0; h < nLevels; ++h)
+    {
+    unsigned long n = buf[5 + h];
+    if (items + n > end)
+      {
+      SENSEI_ERROR("Invalid sketch, level " << h << " is truncated")
+      return -1;
+      }
+    this->Levels[h].assign(items, items + n);
+    this->NumRetained += n;
+    items += n;
+    }
+
+  this->UpdateCapacity();
+
+  return 0;
+}
+
+// --------------------------------------------------------------------------
+int KLLSketch::Reduce(MPI_Comm comm, int root)
+{
+  return MPIUtils::BinomialReduce<double>(comm, root,
+    [this](std::vector<double> &buf) { this->Pack(buf); },
+    [this](const std::vector<double> &buf) -> int
+      {
+      KLLSketch other(this->K);
+      if (other.Unpack(buf))
+        return -1;
+
+      this->Merge(other);
+      return 0;
+      });
+}
+
+// --------------------------------------------------------------------------
+void KLLSketch::GetSortedItems(std::vector<double> &vals,
+  std::vector<unsigned long> &cumWeight) const
+{
+  std::vector<std::pair<double, unsigned long>> items;
+  items.reserve(this->NumRetained);
+
+  unsigned int nLevels = this->Levels.size();
+  for (unsigned int h = 0; h < nLevels; ++h)
+    {
+    unsigned long w = 1ul << h;
+    for (double v : this->Levels[h])
+      items.emplace_back(v, w);
+    }
+
+  std::sort(items.begin(), items.end());
+
+  size_t n = items.size();
+  vals.resize(n);
+  cumWeight.resize(n);
+
+  unsigned long sum = 0;
+  for (size_t i = 0; i < n; ++i)
+    {
+    sum += items[i].second;
+    vals[i] = items[i].first;
+    cumWeight[i] = sum;
+    }
+}
+
+// --------------------------------------------------------------------------
+void KLLSketch::GetQuantiles(const std::vector<double> &q,
+  std::vector<double> &vals) const
+{
+  size_t nq = q.size();
+  vals.resize(nq);
+
+  if (!this->Count)
+    {
+    std::fill(vals.begin(), vals.end(), 0.0);
+    return;
+    }
+
+  std::vector<double> items;
+  std::vector<unsigned long> cumWeight;
+  this->GetSortedItems(items, cumWeight);
+
+  // the retained weight may differ slightly from the count, ranks are
+  // taken relative to it
+  double total = cumWeight.back();
+
+  for (size_t i = 0; i < nq; ++i)
+    {
+    if (q[i] <= 0.0)
+      {
+      vals[i] = this->Min;
+      }
+    else if (q[i] >= 1.0)
+      {
+      vals[i] = this->Max;
+      }
+    else
+      {
+      unsigned long r = static_cast<unsigned long>(std::ceil(q[i]*total));
+      size_t j = std::lower_bound(cumWeight.begin(), cumWeight.end(), r)
+        - cumWeight.begin();
+      vals[i] = items[std::min(j, items.size() - 1)];
+      }
+    }
+}
+
+// --------------------------------------------------------------------------
+double KLLSketch::GetQuantile(double q) const
+{
+  std::vector<double> vals;
+  this->GetQuantiles(std::vector<double>(1, q), vals);
+  return vals[0];
+}
+
+// --------------------------------------------------------------------------
+double KLLSketch::GetCDF(double val) const
+{
+  if (!this->Count)
+    return 0.0;
+
+  std::vector<double> items;
+  std::vector<unsigned long> cumWeight;
+  this->GetSortedItems(items, cumWeight);
+
+  size_t j = std::upper_bound(items.begin(), items.end(), val)
+    - items.begin();
+
+  return j ? double(cumWeight[j - 1])/cumWeight.back() : 0.0;
+}
+
+}
@@ -0,0 +1,89 @@
+#ifndef sensei_KLLSketch_h
+#define sensei_KLLSketch_h
+
+#include <mpi.h>
+#include <random>
+#include <vector>
+
+namespace sensei
+{
+
+/// A mergeable quantile sketch (Karnin, Lang, and Liberty 2016). Values
+/// are kept in a hierarchy of compactors, an item at level h standing for
+/// 2^h values. When the sketch is full the lowest full level is sorted and
+/// every other item is promoted to the level above. The error in the rank
+/// of a query is about 1.7/K of the number of values, independent of how
+/// the values were split among the sketches that were merged, so each rank
+/// may sketch its data in a single pass and the sketches be reduced in a
+/// tree. The memory used is about 3K values.
+class KLLSketch
+{
+public:
+  // k trades memory for accuracy
+  KLLSketch(unsigned int k = 200);
+
+  // add a value. NaN has no place in the order and is skipped
+  void Insert(double val)
+  {
+    if (val != val)
+      return;
+    this->Levels[0].push_back(val);
+    this->Count += 1;
+    this->Min = val < this->Min ? val : this->Min;
+    this->Max = val > this->Max ? val : this->Max;
+    if (++this->NumRetained >= this->Capacity)
+      this->Compress();
+  }
+
+  // add the values of another sketch
+  void Merge(const KLLSketch &other);
+
+  // reduce the sketches of all ranks onto the root rank with a binomial
+  // tree. the sketch on the other ranks is left in an unspecified state.
+  int Reduce(MPI_Comm comm, int root = 0);
+
+  // the number of values inserted and their range
+  unsigned long GetCount() const { return this->Count; }
+  double GetMin() const { return this->Min; }
+  double GetMax() const { return this->Max; }
+
+  // get the value at the quantile q in [0, 1]. q = 0 and q = 1 are the
+  // exact min and max
+  double GetQuantile(double q) const;
+
+  // the same for a number of quantiles, this is cheaper than calling
+  // GetQuantile repeatedly
+  void GetQuantiles(const std::vector<double> &q,
+    std::vector<double> &vals) const;
+
+  // get the fraction of values less than or equal to val
+  double GetCDF(double val) const;
+
+  // serialize the sketch
+  void Pack(std::vector<double> &buf) const;
+  int Unpack(const std::vector<double> &buf);
+
+private:
+  // compact the lowest full level
+  void Compress();
+
+  // update the level capacities after the number of levels changes
+  void UpdateCapacity();
+
+  // gather the retained items, sorted, with their cumulative weights
+  void GetSortedItems(std::vector<double> &vals,
+    std::vector<unsigned long> &cumWeight) const;
+
+  unsigned int K;
+  unsigned long Count;
+  double Min;
+  double Max;
+  unsigned long NumRetained;
+  unsigned long Capacity;
+  std::vector<std::vector<double>> Levels;
+  std::minstd_rand Random;
+};
+
+}
+
+#endif
@@ -2,6 +2,10 @@
 #define MPIUtils_h
 
 #include <algorithm>
+#include <array>
+#include <limits>
+#include <vector>
+#include <mpi.h>
 
 namespace sensei
 {
@@ -316,6 +320,131 @@ void GlobalViewV(MPI_Comm comm, std::vector<std::vector<cpp_t>> &ldata)
   ldata.swap(gdata);
 }
 
+// helper to reduce a distributed object onto the root rank with a binomial
+// tree. at each stage the ranks with the bit set send to their partner and
+// drop out. the object is moved as a flat array of cpp_t, pack(buf) fills
+// buf with the local object and merge(buf) combines a received object into
+// the local one, returning non zero on error. the object on ranks other
+// than root is left in an unspecified state. this call must be made on all
+// ranks
+template <typename cpp_t, typename pack_t, typename merge_t>
+int BinomialReduce(MPI_Comm comm, int root, pack_t pack, merge_t merge)
+{
+  int rank = 0;
+  int nRanks = 1;
+
+  MPI_Comm_rank(comm, &rank);
+  MPI_Comm_size(comm, &nRanks);
+
+  int vrank = (rank - root + nRanks) % nRanks;
+  std::vector<cpp_t> buf;
+
+  for (int mask = 1; mask < nRanks; mask <<= 1)
+    {
+    if (vrank & mask)
+      {
+      int dest = ((vrank - mask) + root) % nRanks;
+      pack(buf);
+      MPI_Send(buf.data(), buf.size(), mpi_tt<cpp_t>::datatype(),
+        dest, 0, comm);
+      break;
+      }
+    else if (vrank + mask < nRanks)
+      {
+      int src = ((vrank + mask) + root) % nRanks;
+
+      MPI_Status stat;
+      MPI_Probe(src, 0, comm, &stat);
+
+      int n = 0;
+      MPI_Get_count(&stat, mpi_tt<cpp_t>::datatype(), &n);
+
+      buf.resize(n);
+      MPI_Recv(buf.data(), n, mpi_tt<cpp_t>::datatype(), src, 0, comm,
+        MPI_STATUS_IGNORE);
+
+      if (merge(buf))
+        return -1;
+      }
+    }
+
+  return 0;
+}
+
+// frees the node ids cached on a communicator by GetNodeIds
+inline
+int DeleteNodeIds(MPI_Comm, int, void *val, void *)
+{
+  delete static_cast<std::vector<long>*>(val);
+  return MPI_SUCCESS;
+}
+
+// helper to identify the compute node that each rank runs on. ranks that
+// can share memory, as determined by MPI_Comm_split_type, are given the
+// same id. the id is a hash of the processor name of the first rank on the
+// node, so that ranks in different communicators, for instance the
+// simulation and an in transit end point, can compare their ids. ids is
+// indexed by rank. the ids are cached on the communicator, the first call
+// on a communicator uses MPI collectives and later calls are local
+inline
+void GetNodeIds(MPI_Comm comm, std::vector<long> &ids)
+{
+  static int keyval = []() -> int
+    {
+    int kv = MPI_KEYVAL_INVALID;
+    MPI_Comm_create_keyval(MPI_COMM_NULL_COPY_FN, DeleteNodeIds, &kv, nullptr);
+    return kv;
+    }();
+
+  std::vector<long> *cached = nullptr;
+  int found = 0;
+  MPI_Comm_get_attr(comm, keyval, &cached, &found);
+  if (found)
+    {
+    ids = *cached;
+    return;
+    }
+
+  int rank = 0;
+  int nRanks = 1;
+
+  MPI_Comm_rank(comm, &rank);
+  MPI_Comm_size(comm, &nRanks);
+
+  MPI_Comm nodeComm = MPI_COMM_NULL;
+  MPI_Comm_split_type(comm, MPI_COMM_TYPE_SHARED, rank,
+    MPI_INFO_NULL, &nodeComm);
+
+  int nodeRank = 0;
+  MPI_Comm_rank(nodeComm, &nodeRank);
+
+  // 64 bit FNV-1a hash of the name
+  unsigned long id = 14695981039346656037ul;
+  if (nodeRank == 0)
+    {
+    char name[MPI_MAX_PROCESSOR_NAME] = {'\0'};
+    int len = 0;
+    MPI_Get_processor_name(name, &len);
+
+    for (int i = 0; i < len; ++i)
+      {
+      id ^= static_cast<unsigned char>(name[i]);
+      id *= 1099511628211ul;
+      }
+    }
+
+  MPI_Bcast(&id, 1, MPI_UNSIGNED_LONG, 0, nodeComm);
+  MPI_Comm_free(&nodeComm);
+
+  ids.resize(nRanks);
+  ids[rank] = static_cast<long>(id);
+
+  MPI_Allgather(MPI_IN_PLACE, 0, MPI_DATATYPE_NULL,
+    ids.data(), 1, MPI_LONG, comm);
+
+  MPI_Comm_set_attr(comm, keyval, new std::vector<long>(ids));
+}
+
 }
 }
 
@@ -64,6 +64,12 @@ int MeshMetadataFlags::ToStream(ostream &str) const
     nSet += 1;
     }
 
+  if (this->Flags & NODE)
+    {
+    str << (nSet ? "|" : "") << "NODE";
+    nSet += 1;
+    }
+
   return 0;
 }
 
@@ -94,6 +100,8 @@ int MeshMetadata::ToStream(sensei::BinaryStream &str) const
   str.Pack(this->ArrayRange);
   str.Pack(this->BlockOwner);
   str.Pack(this->BlockIds);
+  str.Pack(this->BlockNode);
+  str.Pack(this->BlockSource);
   str.Pack(this->BlockNumPoints);
   str.Pack(this->BlockNumCells);
   str.Pack(this->BlockCellArraySize);
@@ -136,6 +144,8 @@ int MeshMetadata::FromStream(sensei::BinaryStream &str)
   str.Unpack(this->ArrayRange);
   str.Unpack(this->BlockOwner);
   str.Unpack(this->BlockIds);
+  str.Unpack(this->BlockNode);
+  str.Unpack(this->BlockSource);
   str.Unpack(this->BlockNumPoints);
   str.Unpack(this->BlockNumCells);
   str.Unpack(this->BlockCellArraySize);
@@ -177,6 +187,8 @@ int MeshMetadata::ToStream(ostream &str) const
   str << "ArrayRange = " << this->ArrayRange << std::endl;
   str << "BlockOwner = " << this->BlockOwner << std::endl;
   str << "BlockIds = " << this->BlockIds << std::endl;
+  str << "BlockNode = " << this->BlockNode << std::endl;
+  str << "BlockSource = " << this->BlockSource << std::endl;
   str << "BlockNumPoints = " << this->BlockNumPoints << std::endl;
   str << "BlockNumCells = " << this->BlockNumCells << std::endl;
   str << "BlockCellArraySize = " << this->BlockCellArraySize << std::endl;
@@ -389,6 +401,8 @@ int MeshMetadata::GlobalizeView(MPI_Comm comm)
     {
     MPIUtils::GlobalViewV(comm, this->BlockOwner);
     MPIUtils::GlobalViewV(comm, this->BlockIds);
+    MPIUtils::GlobalViewV(comm, this->BlockNode);
+    MPIUtils::GlobalViewV(comm, this->BlockSource);
     MPIUtils::GlobalViewV(comm, this->NumBlocksLocal);
     MPIUtils::GlobalViewV(comm, this->BlockNumPoints);
     MPIUtils::GlobalViewV(comm, this->BlockNumCells);
@@ -430,6 +444,8 @@ int MeshMetadata::ClearBlockInfo()
 
   this->BlockIds.clear();
   this->BlockOwner.clear();
+  this->BlockNode.clear();
+  this->BlockSource.clear();
   this->NumBlocksLocal.clear();
 
   this->BlockBounds.clear();
@@ -476,6 +492,12 @@ int MeshMetadata::CopyBlockInfo(const MeshMetadataPtr &other, int i)
   if (other->BlockIds.size())
     this->BlockIds.push_back(other->BlockIds[i]);
 
+  if (other->BlockNode.size())
+    this->BlockNode.push_back(other->BlockNode[i]);
+
+  if (other->BlockSource.size())
+    this->BlockSource.push_back(other->BlockSource[i]);
+
   if (other->BlockBounds.size())
     {
     const std::array<double,6> &obi = other->BlockBounds[i];
@@ -500,6 +522,36 @@ int MeshMetadata::CopyBlockInfo(const MeshMetadataPtr &other, int i)
   return 0;
 }
 
+// --------------------------------------------------------------------------
+int MeshMetadata::LabelBlockNodes(MPI_Comm comm)
+{
+  TimeEvent<128> mark("MeshMetadata::LabelBlockNodes");
+
+  std::vector<long> rankNode;
+  MPIUtils::GetNodeIds(comm, rankNode);
+
+  int nRanks = rankNode.size();
+  unsigned long nBlocks = this->BlockOwner.size();
+
+  this->BlockNode.resize(nBlocks);
+  for (unsigned long i = 0; i < nBlocks; ++i)
+    {
+    int owner = this->BlockOwner[i];
+    if ((owner < 0) || (owner >= nRanks))
+      {
+      SENSEI_ERROR("Block " << i << " of mesh \"" << this->MeshName
+        << "\" has invalid owner " << owner)
+      this->BlockNode.clear();
+      return -1;
+      }
+    this->BlockNode[i] = rankNode[owner];
+    }
+
+  this->Flags.SetBlockNode();
+
+  return 0;
+}
+
 // --------------------------------------------------------------------------
 int MeshMetadata::ClearArrayInfo()
 {
@@ -59,6 +59,17 @@ public:
   void ClearBlockArrayRange(){ Flags &= ~RANGE; }
   bool BlockArrayRangeSet() const { return Flags & RANGE; }
 
+  // set, clear, or check flag to label each block with the compute node
+  // of its owner (MeshMetadata.BlockNode). the labels are generated by
+  // MeshMetadataMap rather than the data adaptor, see LabelBlockNodes
+  void SetBlockNode(){ Flags |= NODE; }
+  void ClearBlockNode(){ Flags &= ~NODE; }
+  bool BlockNodeSet() const { return Flags & NODE; }
+
+  // get the raw flag values. a set of flags includes another when
+  // (a.GetFlags() & b.GetFlags()) == b.GetFlags()
+  long long GetFlags() const { return Flags; }
+
 
   /// serialize/deserialize for communication and/or I/O
   int ToStream(sensei::BinaryStream &str) const;
@@ -74,7 +85,7 @@ private:
 
  // flag values
  enum { DECOMP = 0x1, SIZE = 0x2, EXTENTS = 0x4,
-   BOUNDS = 0x8, RANGE = 0x10 };
+   BOUNDS = 0x8, RANGE = 0x10, NODE = 0x20 };
 };
 
 
@@ -134,6 +145,11 @@ struct MeshMetadata
   // appends block level information of block bid from other.
   int CopyBlockInfo(const sensei::MeshMetadataPtr &other, int bid);
 
+  // fills BlockNode with the id of the compute node where the owner of
+  // each block runs, see MPIUtils::GetNodeIds. requires BlockOwner. return
+  // 0 if successful. the first call on a communicator uses MPI collectives
+  int LabelBlockNodes(MPI_Comm comm);
+
   // removes all array metadata from the instance
   int ClearArrayInfo();
 
@@ -179,6 +195,8 @@ struct MeshMetadata
 
   std::vector<int> BlockOwner;             // rank where each block resides (all, optional)
   std::vector<int> BlockIds;               // global id of each block (all, optional)
+  std::vector<long> BlockNode;             // id of the compute node where each block resides (all, optional)
+  std::vector<int> BlockSource;            // index of the sender block each block was split from (Cartesian, optional)
 
                                            // note: for AMR BlockNumPoints and BlockNumCells are always global
   std::vector<long> BlockNumPoints;        // number of points for each block (all, optional)
@@ -210,7 +228,7 @@ protected:
     NumPoints(0), NumCells(0), CellArraySize(0), NumArrays(0),
     NumGhostCells(0), NumGhostNodes(0), NumLevels(0), StaticMesh(0),
     ArrayName(), ArrayCentering(), ArrayType(), ArrayRange(),BlockOwner(),
-    BlockIds(), BlockNumPoints(), BlockNumCells(), BlockCellArraySize(),
+    BlockIds(), BlockNode(), BlockSource(), BlockNumPoints(), BlockNumCells(), BlockCellArraySize(),
     BlockExtents(), BlockBounds(), BlockArrayRange(), RefRatio(),
     BlocksPerLevel(), BlockLevel(), PeriodicBoundary(),
     Flags()
@@ -35,6 +35,15 @@ int MeshMetadataMap::Initialize(DataAdaptor *da, MeshMetadataFlags flags)
       return -1;
       }
 
+    // the data adaptor does not know where its ranks run, node labels
+    // are generated here
+    if (flags.BlockNodeSet() && md->LabelBlockNodes(da->GetCommunicator()))
+      {
+      SENSEI_ERROR("Failed to label the blocks of data object " << i
+        << " with their compute node")
+      return -1;
+      }
+
     this->Metadata[i] = md;
     this->IdMap[md->MeshName] = i;
     }
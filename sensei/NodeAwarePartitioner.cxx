@@ -0,0 +1,168 @@
+#include "NodeAwarePartitioner.h"
+#include "MPIUtils.h"
+#include "Profiler.h"
+
+#include <pugixml.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <map>
+#include <set>
+#include <utility>
+
+namespace sensei
+{
+
+// --------------------------------------------------------------------------
+int NodeAwarePartitioner::GetPartition(MPI_Comm comm,
+  const MeshMetadataPtr &mdIn, MeshMetadataPtr &mdOut)
+{
+  TimeEvent<128> mark("NodeAwarePartitioner::GetPartition");
+
+  // every rank gets the same node ids and computes the same partition
+  std::vector<long> rankNode;
+  MPIUtils::GetNodeIds(comm, rankNode);
+
+  return this->GetPartition(rankNode, mdIn, mdOut);
+}
+
+// --------------------------------------------------------------------------
+int NodeAwarePartitioner::GetPartition(const std::vector<long> &rankNode,
+  const MeshMetadataPtr &mdIn, MeshMetadataPtr &mdOut)
+{
+  mdOut = mdIn->NewCopy();
+
+  int nRanks = rankNode.size();
+  int nBlocks = mdOut->NumBlocks;
+
+  std::vector<double> costs;
+  if (this->GetBlockCosts(mdOut, costs))
+    return -1;
+
+  // the on node fraction is reported in bytes whatever the cost
+  std::vector<double> bytes;
+  if (this->GetBlockBytes(mdOut, bytes))
+    return -1;
+
+  bool haveNodes = int(mdOut->BlockNode.size()) == nBlocks;
+  if (!haveNodes)
+    {
+    SENSEI_WARNING("Mesh \"" << mdOut->MeshName << "\" has no block node "
+      "labels, the blocks are placed by load alone")
+    }
+
+  // the receivers on each node
+  std::map<long, std::vector<int>> nodeRanks;
+  for (int j = 0; j < nRanks; ++j)
+    nodeRanks[rankNode[j]].push_back(j);
+
+  double total = 0.0;
+  for (int i = 0; i < nBlocks; ++i)
+    total += costs[i];
+
+  double cap = this->Slack*total/nRanks;
+
+  // largest first
+  std::vector<int> order(nBlocks);
+  for (int i = 0; i < nBlocks; ++i)
+    order[i] = i;
+
+  std::stable_sort(order.begin(), order.end(),
+    [&costs](int a, int b) -> bool { return costs[a] > costs[b]; });
+
+  // the receivers ordered by load, ties go to the lower rank
+  std::vector<double> load(nRanks, 0.0);
+  std::set<std::pair<double, int>> ranks;
+  for (int j = 0; j < nRanks; ++j)
+    ranks.insert(std::make_pair(0.0, j));
+
+  double onNode = 0.0;
+  double totalBytes = 0.0;
+  for (int i = 0; i < nBlocks; ++i)
+    {
+    int bid = order[i];
+    double cost = costs[bid];
+
+    // the least loaded receiver on the sender's node
+    int dest = -1;
+    if (haveNodes)
+      {
+      std::map<long, std::vector<int>>::iterator it =
+        nodeRanks.find(mdOut->BlockNode[bid]);
+
+      if (it != nodeRanks.end())
+        {
+        const std::vector<int> &local = it->second;
+        int nLocal = local.size();
+        int best = local[0];
+        for (int k = 1; k < nLocal; ++k)
+          {
+          if (load[local[k]] < load[best])
+            best = local[k];
+          }
+
+        if ((load[best] + cost <= cap) || (load[best] == 0.0))
+          dest = best;
+        }
+      }
+
+    // otherwise the least loaded receiver anywhere
+    if (dest < 0)
+      dest = ranks.begin()->second;
+
+    ranks.erase(std::make_pair(load[dest], dest));
+    load[dest] += cost;
+    ranks.insert(std::make_pair(load[dest], dest));
+
+    mdOut->BlockOwner[bid] = dest;
+
+    totalBytes += bytes[bid];
+    if (haveNodes && (rankNode[dest] == mdOut->BlockNode[bid]))
+      onNode += bytes[bid];
+    }
+
+  this->OnNodeFraction = totalBytes > 0.0 ? onNode/totalBytes : 0.0;
+
+  char eventName[128];
+  snprintf(eventName, 128, "NodeAwarePartitioner::GetPartition on_node=%.4f",
+    this->OnNodeFraction);
+  Profiler::StartEvent(eventName);
+  Profiler::EndEvent(eventName);
+
+  if (this->GetVerbose())
+    {
+    SENSEI_STATUS("Kept " << 100.0*this->OnNodeFraction << "% of the bytes "
+      "of mesh \"" << mdOut->MeshName << "\" on node across "
+      << nodeRanks.size() << " receiver nodes")
+    }
+
+  this->ReportImbalance(mdOut, load);
+
+  return 0;
+}
+
+// --------------------------------------------------------------------------
+int NodeAwarePartitioner::Initialize(pugi::xml_node &node)
+{
+  TimeEvent<128> mark("NodeAwarePartitioner::Initialize");
+
+  if (this->InitializeCost(node))
+    return -1;
+
+  double slack = node.attribute("slack").as_double(1.1);
+  if (slack < 1.0)
+    {
+    SENSEI_ERROR("Invalid slack " << slack << ". The slack must be at "
+      "least 1")
+    return -1;
+    }
+  this->SetSlack(slack);
+
+  SENSEI_STATUS("Configured NodeAwarePartitioner slack=" << slack
+    << " cost=" << node.attribute("cost").as_string("cells")
+    << (this->Cost == COST_EXPRESSION ? " expression=" + this->Expression : ""))
+
+  return 0;
+}
+
+}
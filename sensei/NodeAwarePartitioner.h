@@ -0,0 +1,72 @@
+#ifndef sensei_NodeAwarePartitioner_h
+#define sensei_NodeAwarePartitioner_h
+
+#include "WeightedPartitioner.h"
+
+#include <vector>
+
+namespace sensei
+{
+
+class NodeAwarePartitioner;
+using NodeAwarePartitionerPtr = std::shared_ptr<sensei::NodeAwarePartitioner>;
+
+/// @class NodeAwarePartitioner
+/// The node aware partitioner keeps blocks on the compute node where they
+/// were produced when the simulation and the in transit end point share
+/// nodes, so that the data can move through shared memory rather than
+/// across the network. The sender labels each block with the node of its
+/// owner (MeshMetadata.BlockNode) and the receiver ranks identify their
+/// own nodes with MPIUtils::GetNodeIds. Largest first, each block goes to
+/// the least loaded receiver on its node unless that receiver's load would
+/// exceed slack times the average load, in which case it goes to the least
+/// loaded receiver anywhere. Blocks without a node label, or whose node
+/// hosts no receiver, are placed by load alone. The cost of the blocks is
+/// configured as for the WeightedPartitioner. The fraction of the bytes
+/// that stay on the node and the imbalance are logged as Profiler events.
+/// The XML is of the form:
+///
+///   <partitioner type="node" cost="cells" slack="1.1"/>
+class NodeAwarePartitioner : public sensei::WeightedPartitioner
+{
+public:
+  static sensei::NodeAwarePartitionerPtr New()
+  { return NodeAwarePartitionerPtr(new NodeAwarePartitioner); }
+
+  const char *GetClassName() override { return "NodeAwarePartitioner"; }
+
+  // set the largest load, relative to the average, that a receiver may
+  // take on before blocks from its node are sent elsewhere
+  void SetSlack(double slack) { this->Slack = slack; }
+  double GetSlack() { return this->Slack; }
+
+  // given an existing partitioning of data passed in the first MeshMetadata
+  // argument,return a new partittioning in the second MeshMetadata argument.
+  // distributes blocks to receivers on the same node as their sender where
+  // the load allows.
+  int GetPartition(MPI_Comm comm, const sensei::MeshMetadataPtr &in,
+    sensei::MeshMetadataPtr &out) override;
+
+  // assign the blocks given the node of each receiver rank. this is the
+  // part of GetPartition that does not communicate.
+  int GetPartition(const std::vector<long> &rankNode,
+    const sensei::MeshMetadataPtr &in, sensei::MeshMetadataPtr &out);
+
+  // get the fraction of the bytes placed on the node that produced them
+  // by the last partition
+  double GetOnNodeFraction() { return this->OnNodeFraction; }
+
+  // Initialize from XML
+  int Initialize(pugi::xml_node &node) override;
+
+protected:
+  NodeAwarePartitioner() : Slack(1.1), OnNodeFraction(0.0) {}
+  NodeAwarePartitioner(const NodeAwarePartitioner &) = default;
+
+  double Slack;
+  double OnNodeFraction;
+};
+
+}
+
+#endif
@@ -35,6 +35,36 @@ int PlanarSlicePartitioner::Initialize(pugi::xml_node &node)
   return 0;
 }
 
+// --------------------------------------------------------------------------
+bool PlanarSlicePartitioner::Intersects(const std::array<double,6> &bounds) const
+{
+  // compute the distance from  each corner of the block bounding box
+  // to the plane. if the block intersects the plane, at least one
+  // corner will have a different sign.
+
+  // triplets defining corner points
+  int pt_ids[] = {0,2,4, 0,3,4, 1,3,4, 1,2,4,
+    0,2,5, 0,3,5, 1,3,5, 1,2,5};
+
+  double min_d = std::numeric_limits<double>::max();
+  double max_d = std::numeric_limits<double>::lowest();
+
+  for (int q = 0; q < 8; ++q)
+    {
+    double d = 0.0;
+    for (int j = 0; j < 3; ++j)
+      d += this->Normal[j] * (bounds[pt_ids[q*3 + j]] - this->Point[j]);
+
+    min_d = std::min(min_d, d);
+    max_d = std::max(max_d, d);
+
+    if ((min_d <= 0.0) && (max_d > 0.0))
+      return true;
+    }
+
+  return false;
+}
+
 // --------------------------------------------------------------------------
 int PlanarSlicePartitioner::GetPartition(MPI_Comm comm,
   const MeshMetadataPtr &mdIn, MeshMetadataPtr &mdOut)
@@ -52,33 +82,8 @@ int PlanarSlicePartitioner::GetPartition(MPI_Comm comm,
   std::vector<int> activeBlocks;
   for (int i = 0; i < mdIn->NumBlocks; ++i)
     {
-    // compute the distance from  each corner of the block bounding box
-    // to the plane. if the block intersects the plane, at least one
-    // corner will have a different sign.
-    const std::array<double,6> &bounds = mdIn->BlockBounds[i];
-
-    // triplets defining corner points
-    int pt_ids[] = {0,2,4, 0,3,4, 1,3,4, 1,2,4,
-      0,2,5, 0,3,5, 1,3,5, 1,2,5};
-
-    double min_d = std::numeric_limits<double>::max();
-    double max_d = std::numeric_limits<double>::lowest();
-
-    for (int q = 0; q < 8; ++q)
-      {
-      double d = 0.0;
-      for (int j = 0; j < 3; ++j)
-        d += this->Normal[j] * (bounds[pt_ids[q*3 + j]] - this->Point[j]);
-
-      min_d = std::min(min_d, d);
-      max_d = std::max(max_d, d);
-
-      if ((min_d <= 0.0) && (max_d > 0.0))
-        {
-        activeBlocks.push_back(i);
-        break;
-        }
-      }
+    if (this->Intersects(mdIn->BlockBounds[i]))
+      activeBlocks.push_back(i);
     }
 
   // partition the remaining blocks to ranks equally
@@ -31,6 +31,10 @@ public:
   void SetNormal(const std::array<double,3> &n) { this->Normal = n; }
   void GetNormal(std::array<double,3> &n) { n = this->Normal; }
 
+  // returns true if the plane crosses the axis aligned box
+  // [x0, x1, y0, y1, z0, z1]
+  bool Intersects(const std::array<double,6> &bounds) const;
+
   // Initialize from XML
   int Initialize(pugi::xml_node &node) override;
 
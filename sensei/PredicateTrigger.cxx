@@ -0,0 +1,92 @@
+#include "PredicateTrigger.h"
+#include "Error.h"
+
+#include <vtkObjectFactory.h>
+
+#include <pugixml.hpp>
+
+#include <string>
+
+namespace sensei
+{
+
+//----------------------------------------------------------------------------
+senseiNewMacro(PredicateTrigger);
+
+//----------------------------------------------------------------------------
+PredicateTrigger::PredicateTrigger() : Reduce(ANY), Index(0)
+{
+}
+
+//----------------------------------------------------------------------------
+void PredicateTrigger::SetPredicate(const PredicateFunction &func)
+{
+  this->Predicate = func;
+}
+
+//----------------------------------------------------------------------------
+void PredicateTrigger::SetFinalize(const FinalizeFunction &func)
+{
+  this->FinalizeFunc = func;
+}
+
+//----------------------------------------------------------------------------
+void PredicateTrigger::SetReduce(int mode)
+{
+  this->Reduce = mode;
+}
+
+//----------------------------------------------------------------------------
+int PredicateTrigger::Initialize(pugi::xml_node node)
+{
+  std::string mode = node.attribute("reduce").as_string("any");
+  if ((mode != "any") && (mode != "all"))
+    {
+    SENSEI_ERROR("Invalid reduce \"" << mode << "\". The reduce is any or all")
+    return -1;
+    }
+
+  this->SetReduce(mode == "all" ? ALL : ANY);
+
+  return 0;
+}
+
+//----------------------------------------------------------------------------
+int PredicateTrigger::AddLocalValues(DataAdaptor *data,
+  TriggerReduction &values)
+{
+  if (!this->Predicate)
+    {
+    SENSEI_ERROR("No predicate was set")
+    return -1;
+    }
+
+  int vote = 0;
+  if (this->Predicate(data, vote))
+    {
+    SENSEI_ERROR("Failed to evaluate the predicate")
+    return -1;
+    }
+
+  this->Index = values.Add(vote ? 1.0 : 0.0, this->Reduce == ALL ?
+    TriggerReduction::MIN : TriggerReduction::MAX);
+
+  return 0;
+}
+
+//----------------------------------------------------------------------------
+int PredicateTrigger::Evaluate(const TriggerReduction &values, bool &fire)
+{
+  fire = values.Get(this->Index) > 0.0;
+  return 0;
+}
+
+//----------------------------------------------------------------------------
+int PredicateTrigger::Finalize()
+{
+  if (this->FinalizeFunc)
+    return this->FinalizeFunc();
+  return 0;
+}
+
+}
@@ -0,0 +1,61 @@
+#ifndef sensei_PredicateTrigger_h
+#define sensei_PredicateTrigger_h
+
+#include "AnalysisTrigger.h"
+
+#include <functional>
+
+namespace sensei
+{
+
+/// @class PredicateTrigger
+/// @brief Fires according to a user provided predicate.
+///
+/// The predicate is called on each rank with the data adaptor and sets
+/// its vote. The votes are reduced so that the trigger fires when any rank
+/// votes to fire, or when they all do. ConfigurableAnalysis uses it to call
+/// the Trigger function of a Python script. The XML is of the form:
+///
+///   <trigger type="python" script_file="trigger.py" reduce="any"/>
+class PredicateTrigger : public AnalysisTrigger
+{
+public:
+  static PredicateTrigger *New();
+  senseiTypeMacro(PredicateTrigger, AnalysisTrigger);
+
+  using PredicateFunction = std::function<int(DataAdaptor*, int &vote)>;
+  using FinalizeFunction = std::function<int()>;
+
+  /// @brief Set the predicate. It returns non-zero if an error occurred and
+  /// sets the vote to non-zero to fire.
+  void SetPredicate(const PredicateFunction &func);
+
+  /// @brief Set an optional function called by Finalize.
+  void SetFinalize(const FinalizeFunction &func);
+
+  enum {ANY=0, ALL=1};
+
+  /// @brief Set how the votes of the ranks are combined. The default is ANY.
+  void SetReduce(int mode);
+
+  int Initialize(pugi::xml_node node) override;
+  int AddLocalValues(DataAdaptor *data, TriggerReduction &values) override;
+  int Evaluate(const TriggerReduction &values, bool &fire) override;
+  int Finalize() override;
+
+protected:
+  PredicateTrigger();
+  ~PredicateTrigger() {}
+
+  PredicateTrigger(const PredicateTrigger&) = delete;
+  void operator=(const PredicateTrigger&) = delete;
+
+private:
+  PredicateFunction Predicate;
+  FinalizeFunction FinalizeFunc;
+  int Reduce;
+  unsigned int Index;
+};
+
+}
+#endif
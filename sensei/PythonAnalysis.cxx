@@ -57,9 +57,11 @@ int getFunction(PyObject *module, const std::string &modName,
   return 0;
 }
 
-// call the function with the given arguments
+// call the function with the given arguments. when truth is not null it
+// is set to the truth value of the returned object
 static
-int callFunction(const std::string &funcName, PyObject *func, PyObject *args)
+int callFunction(const std::string &funcName, PyObject *func, PyObject *args,
+  int *truth = nullptr)
 {
   PyObject *pyRet = PyObject_CallObject(func, args);
   if (!pyRet || PyErr_Occurred())
@@ -68,6 +70,18 @@ int callFunction(const std::string &funcName, PyObject *func, PyObject *args)
     return -1;
     }
 
+  if (truth)
+    {
+    *truth = PyObject_IsTrue(pyRet);
+    if (*truth < 0)
+      {
+      SENSEI_PYTHON_ERROR("The value returned by \"" << funcName
+        << "\" has no truth value")
+      Py_XDECREF(pyRet);
+      return -1;
+      }
+    }
+
   Py_XDECREF(pyRet);
 
   return 0;
@@ -178,7 +192,7 @@ namespace sensei
 struct PythonAnalysis::InternalsType
 {
   InternalsType() : Module(nullptr), Initialize(nullptr),
-    Execute(nullptr), Finalize(nullptr) {}
+    Execute(nullptr), Trigger(nullptr), Finalize(nullptr) {}
 
   ~InternalsType();
 
@@ -189,13 +203,15 @@ struct PythonAnalysis::InternalsType
   PyObject *Module;
   PyObject *Initialize;
   PyObject *Execute;
+  PyObject *Trigger;
   PyObject *Finalize;
 };
 
 //-----------------------------------------------------------------------------
 PythonAnalysis::InternalsType::~InternalsType()
 {
-  if (this->Initialize || this->Execute || this->Finalize || this->Module)
+  if (this->Initialize || this->Execute || this->Trigger ||
+    this->Finalize || this->Module)
     SENSEI_ERROR("PythonAnalysis::Finalize not called")
 }
 
@@ -241,11 +257,13 @@ int PythonAnalysis::Finalize()
 
   Py_XDECREF(this->Internals->Initialize);
   Py_XDECREF(this->Internals->Execute);
+  Py_XDECREF(this->Internals->Trigger);
   Py_XDECREF(this->Internals->Finalize);
   Py_XDECREF(this->Internals->Module);
 
   this->Internals->Initialize = nullptr;
   this->Internals->Execute = nullptr;
+  this->Internals->Trigger = nullptr;
   this->Internals->Finalize = nullptr;
   this->Internals->Module = nullptr;
 
@@ -303,7 +321,12 @@ int PythonAnalysis::Initialize()
     this->Internals->Initialize);
 
   ierr += getFunction(this->Internals->Module,
-    this->Internals->ScriptModule, "Execute", true,
+    this->Internals->ScriptModule, "Trigger", false,
+    this->Internals->Trigger);
+
+  // a script used as a trigger need not define Execute
+  ierr += getFunction(this->Internals->Module,
+    this->Internals->ScriptModule, "Execute", !this->Internals->Trigger,
     this->Internals->Execute);
 
   ierr += getFunction(this->Internals->Module,
@@ -315,8 +338,9 @@ int PythonAnalysis::Initialize()
     SENSEI_ERROR("Module \"" << this->Internals->ScriptModule <<
       "\" does not provide the required API. The API consists of the "
       "following functions defined at global scope:\n\n    Initialize() -> int\n"
-      "    Execute(dataAdaptor) -> int\n    Finalize() -> int\n\nOnly Execute is "
-      "required, Initialize and Finalize are optional.")
+      "    Execute(dataAdaptor) -> int\n    Trigger(dataAdaptor) -> bool\n"
+      "    Finalize() -> int\n\nOnly Execute is required, or Trigger when the "
+      "script is used as a trigger. Initialize and Finalize are optional.")
     return -1;
     }
 
@@ -375,4 +399,31 @@ bool PythonAnalysis::Execute(DataAdaptor *dataAdaptor)
   return ret == 0;
 }
 
+//-----------------------------------------------------------------------------
+int PythonAnalysis::EvaluateTrigger(DataAdaptor *dataAdaptor, int &fire)
+{
+  fire = 0;
+
+  if (!this->Internals->Trigger)
+    {
+    SENSEI_ERROR("Missing a Trigger function")
+    return -1;
+    }
+
+  // wrap the data adaptor instance
+  PyObject *pyDataAdaptor = SWIG_NewPointerObj(
+    SWIG_as_voidptr(dataAdaptor), SWIGTYPE_p_sensei__DataAdaptor, 0);
+
+  // the tuple takes owner ship with N
+  PyObject *args = Py_BuildValue("(N)", pyDataAdaptor);
+
+  // invoke the provided trigger function
+  int ret = callFunction("Trigger", this->Internals->Trigger, args, &fire);
+
+  // clean up
+  Py_DECREF(args);
+
+  return ret;
+}
+
 }
@@ -24,11 +24,18 @@ class DataAdaptor;
 //       """ Use sensei::DataAdaptor API to process data here """
 //       return
 //
+//     def Trigger(dataAdaptor):
+//       """ Decide if the analyses gated by the script run this step """
+//       return True
+//
 //     def Finalize():
 //       """ Finalization code here """
 //       return
 //
-// Initialize and Finalize are optional, while Execute is required. The script
+// Initialize and Finalize are optional, while Execute is required unless
+// the script defines Trigger. Trigger is called through EvaluateTrigger
+// when the script is used by ConfigurableAnalysis to gate the execution of
+// another analysis (see PredicateTrigger). The script
 // is specified at run time either as a module or a file. If a module is
 // specified (see SetScriptModule) the provided module is imported through
 // Python's built in import mechanism. This means that it must be in a
@@ -74,6 +81,10 @@ public:
   bool Execute(DataAdaptor* data) override;
   int Finalize() override;
 
+  /// Call the script's Trigger function. fire is set to the truth value
+  /// of what it returns. Returns non-zero if an error occurred.
+  int EvaluateTrigger(DataAdaptor *data, int &fire);
+
 protected:
   PythonAnalysis();
   ~PythonAnalysis();
@@ -0,0 +1,408 @@
+#include "Quantiles.h"
+#include "DataAdaptor.h"
+#include "KLLSketch.h"
+#include "MeshMetadata.h"
+#include "MeshMetadataMap.h"
+#include "Profiler.h"
+#include "TimeSeriesStore.h"
+#include "VTKUtils.h"
+#include "Error.h"
+
+#include <vtkCompositeDataSet.h>
+#include <vtkDataObject.h>
+#include <vtkDataSet.h>
+#include <vtkDataSetAttributes.h>
+#include <vtkFieldData.h>
+#include <vtkObjectFactory.h>
+#include <vtkUnsignedCharArray.h>
+#ifdef ENABLE_VTK_GENERIC_ARRAYS
+#include <vtkAOSDataArrayTemplate.h>
+#include <vtkArrayDispatch.h>
+#else
+#include <vtkDataArrayDispatcher.h>
+#endif
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <errno.h>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+namespace sensei
+{
+namespace
+{
+// Adds the values of a scalar array to a sketch, skipping ghosts. The
+// sketch skips NaN. To be used with vtkArrayDispatch or
+// vtkDataArrayDispatcher.
+struct InsertWorker
+{
+  KLLSketch *Sketch;
+  const unsigned char *Ghosts;
+
+  template <typename T>
+  void Insert(const T *vals, vtkIdType n)
+  {
+    if (this->Ghosts)
+      {
+      for (vtkIdType i = 0; i < n; ++i)
+        {
+        if (!this->Ghosts[i])
+          this->Sketch->Insert(static_cast<double>(vals[i]));
+        }
+      }
+    else
+      {
+      for (vtkIdType i = 0; i < n; ++i)
+        this->Sketch->Insert(static_cast<double>(vals[i]));
+      }
+  }
+
+#ifdef ENABLE_VTK_GENERIC_ARRAYS
+  template <typename T>
+  void operator()(vtkAOSDataArrayTemplate<T> *array)
+  {
+    this->Insert(array->GetPointer(0), array->GetNumberOfTuples());
+  }
+
+  template <typename ArrayT>
+  void operator()(ArrayT *array)
+  {
+    vtkIdType n = array->GetNumberOfTuples();
+    for (vtkIdType i = 0; i < n; ++i)
+      {
+      if (!this->Ghosts || !this->Ghosts[i])
+        this->Sketch->Insert(static_cast<double>(
+          array->GetTypedComponent(i, 0)));
+      }
+  }
+#else
+  template <typename T>
+  void operator()(const vtkDataArrayDispatcherPointer<T>& array)
+  {
+    this->Insert(array.RawPointer, array.NumberOfTuples);
+  }
+#endif
+};
+}
+
+//-----------------------------------------------------------------------------
+senseiNewMacro(Quantiles);
+
+//-----------------------------------------------------------------------------
+Quantiles::Quantiles() :
+  Association(vtkDataObject::FIELD_ASSOCIATION_POINTS), K(200),
+  TimeSeries(0), Store(nullptr)
+{
+}
+
+//-----------------------------------------------------------------------------
+Quantiles::~Quantiles()
+{
+  delete this->Store;
+}
+
+//-----------------------------------------------------------------------------
+void Quantiles::Initialize(const std::string &meshName, int association,
+  const std::string &arrayName, int nQuantiles, int k,
+  const std::string &fileName)
+{
+  // evenly spaced from the min to the max
+  nQuantiles = std::max(nQuantiles, 2);
+  std::vector<double> quantiles(nQuantiles);
+  for (int i = 0; i < nQuantiles; ++i)
+    quantiles[i] = double(i)/(nQuantiles - 1);
+
+  this->Initialize(meshName, association, arrayName, quantiles, k, fileName);
+}
+
+//-----------------------------------------------------------------------------
+void Quantiles::Initialize(const std::string &meshName, int association,
+  const std::string &arrayName, const std::vector<double> &quantiles,
+  int k, const std::string &fileName)
+{
+  this->MeshName = meshName;
+  this->Association = association;
+  this->ArrayName = arrayName;
+  this->QuantileList = quantiles;
+  this->K = k;
+  this->FileName = fileName;
+}
+
+//-----------------------------------------------------------------------------
+const char *Quantiles::GetGhostArrayName()
+{
+#if VTK_MAJOR_VERSION == 6 && VTK_MINOR_VERSION == 1
+    return "vtkGhostType";
+#else
+    return vtkDataSetAttributes::GhostArrayName();
+#endif
+}
+
+//-----------------------------------------------------------------------------
+vtkDataArray* Quantiles::GetArray(vtkDataObject* dobj, const std::string& arrayname)
+{
+  if (vtkFieldData* fd = dobj->GetAttributesAsFieldData(this->Association))
+    {
+    return fd->GetArray(arrayname.c_str());
+    }
+  return nullptr;
+}
+
+//-----------------------------------------------------------------------------
+bool Quantiles::Execute(DataAdaptor* data)
+{
+  TimeEvent<128> mark("Quantiles::Execute");
+
+  MPI_Comm comm = this->GetCommunicator();
+
+  int rank = 0;
+  MPI_Comm_rank(comm, &rank);
+
+  // get the current time and step
+  int step = data->GetDataTimeStep();
+  double time = data->GetDataTime();
+
+  // the blocks are processed in parallel, each thread sketching into its
+  // own sketch. these are merged and then reduced across ranks.
+  unsigned int nThreads = VTKUtils::GetNumberOfThreads();
+  std::vector<KLLSketch> sketches(nThreads, KLLSketch(this->K));
+
+  // all ranks take part in the reduction, including those with nothing to
+  // process and those that failed, otherwise the others would wait for
+  // them in the reduction forever
+  auto reduce = [&]() -> int
+    {
+    for (unsigned int i = 1; i < nThreads; ++i)
+      sketches[0].Merge(sketches[i]);
+
+    if (sketches[0].Reduce(comm, 0))
+      {
+      SENSEI_ERROR("Failed to reduce the sketches")
+      return -1;
+      }
+
+    if (rank == 0)
+      {
+      sketches[0].GetQuantiles(this->QuantileList, this->Values);
+      return this->WriteQuantiles(step, time, sketches[0].GetCount());
+      }
+
+    return 0;
+    };
+
+  // see what the simulation is providing
+  MeshMetadataMap mdMap;
+  MeshMetadataPtr mmd;
+  if (mdMap.Initialize(data) || mdMap.GetMeshMetadata(this->MeshName, mmd))
+    {
+    SENSEI_ERROR("Failed to get metadata for mesh \"" << this->MeshName << "\"")
+    reduce();
+    return false;
+    }
+
+  // get the mesh object
+  vtkDataObject* mesh = nullptr;
+  if (data->GetMesh(this->MeshName, true, mesh))
+    {
+    SENSEI_ERROR("Failed to get mesh \"" << this->MeshName << "\"")
+    reduce();
+    return false;
+    }
+
+  if (!mesh)
+    {
+    // it is not an necessarilly an error if all ranks do not have
+    // a dataset to process
+    return !reduce();
+    }
+
+  if (data->AddArray(mesh, this->MeshName, this->Association, this->ArrayName))
+    {
+    SENSEI_ERROR(<< data->GetClassName() << " failed to add "
+      << (this->Association == vtkDataObject::POINT ? "point" : "cell")
+      << " data array \"" << this->ArrayName << "\" to mesh \""
+      << this->MeshName << "\"")
+    reduce();
+    mesh->Delete();
+    return false;
+    }
+
+  // add the ghost zones
+  if ((mmd->NumGhostCells || VTKUtils::AMR(mmd)) &&
+    data->AddGhostCellsArray(mesh, this->MeshName))
+    {
+    SENSEI_ERROR(<< data->GetClassName() << " failed to add ghost cells.")
+    reduce();
+    mesh->Delete();
+    return false;
+    }
+
+  if (mmd->NumGhostNodes && data->AddGhostNodesArray(mesh, this->MeshName))
+    {
+    SENSEI_ERROR(<< data->GetClassName() << " failed to add ghost nodes.")
+    reduce();
+    mesh->Delete();
+    return false;
+    }
+
+  bool composite = dynamic_cast<vtkCompositeDataSet*>(mesh);
+
+  // sketch the local data
+  VTKUtils::ThreadDatasetFunction sketch = [&](unsigned int thread,
+    unsigned int flatIndex, vtkDataSet *ds) -> int
+    {
+    vtkDataArray* array = this->GetArray(ds, this->ArrayName);
+    if (!array)
+      {
+      SENSEI_WARNING("Dataset " << (composite ? flatIndex : rank)
+        << " has no array named \"" << this->ArrayName << "\"")
+      return 0;
+      }
+
+    if (array->GetNumberOfComponents() != 1)
+      {
+      SENSEI_ERROR("Quantiles of the " << array->GetNumberOfComponents()
+        << " component array \"" << this->ArrayName << "\" are not defined")
+      return -1;
+      }
+
+    vtkUnsignedCharArray *ghostArray = dynamic_cast<vtkUnsignedCharArray*>(
+      this->GetArray(ds, this->GetGhostArrayName()));
+
+    InsertWorker worker;
+    worker.Sketch = &sketches[thread];
+    worker.Ghosts = ghostArray ? ghostArray->GetPointer(0) : nullptr;
+
+#ifdef ENABLE_VTK_GENERIC_ARRAYS
+    vtkArrayDispatch::Dispatch::Execute(array, worker);
+#else
+    vtkDataArrayDispatcher<InsertWorker> dispatcher(worker);
+    dispatcher.Go(array);
+#endif
+    return 0;
+    };
+
+  int ierr = VTKUtils::ParallelApply(nThreads, mesh, sketch);
+
+  if (reduce())
+    ierr = -1;
+
+  mesh->Delete();
+
+  if (ierr)
+    {
+    SENSEI_ERROR("Failed to compute quantiles of \"" << this->ArrayName
+      << "\" on mesh \"" << this->MeshName << "\"")
+    return false;
+    }
+
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+int Quantiles::WriteQuantiles(int step, double time, unsigned long count)
+{
+  unsigned int nq = this->QuantileList.size();
+
+  if (this->TimeSeries && !this->FileName.empty())
+    {
+    // all steps go in one file, a record holds the values and the count
+    if (!this->Store)
+      this->Store = new TimeSeriesStore;
+
+    if (!this->Store->IsOpen())
+      {
+      std::string qstr;
+      for (unsigned int i = 0; i < nq; ++i)
+        qstr += (i ? "," : "") + std::to_string(this->QuantileList[i]);
+
+      std::string fileName = this->FileName + "_" + this->MeshName + "_"
+        + this->ArrayName + ".sts";
+
+      if (this->Store->Open(fileName, "quantiles", {{"mesh", this->MeshName},
+        {"array", this->ArrayName}, {"quantiles", qstr},
+        {"k", std::to_string(this->K)}}))
+        return -1;
+      }
+
+    return this->Store->Append(step, time, 0, this->Values.data(), nq,
+      &count, 1);
+    }
+  else if (this->FileName.empty())
+    {
+    int origPrec = std::cout.precision();
+    std::cout.precision(6);
+
+    std::cout << "Quantiles mesh \"" << this->MeshName << "\" data array \""
+      << this->ArrayName << "\" step " << step << " time " << time
+      << " count " << count << std::endl;
+
+    for (unsigned int i = 0; i < nq; ++i)
+      {
+      std::cout << std::fixed << std::setw(10) << std::right
+        << this->QuantileList[i] << " : " << std::scientific
+        << this->Values[i] << std::endl;
+      }
+
+    std::cout.precision(origPrec);
+    }
+  else
+    {
+    char fname[1024] = {'\0'};
+    snprintf(fname, 1024, "%s_%s_%s_%d.txt", this->FileName.c_str(),
+      this->MeshName.c_str(), this->ArrayName.c_str(), step);
+
+    FILE *file = fopen(fname, "w");
+    if (!file)
+      {
+      char *estr = strerror(errno);
+      SENSEI_ERROR("Failed to open \"" << fname << "\""
+        << std::endl << estr)
+      return -1;
+      }
+
+    fprintf(file, "step : %d\n", step);
+    fprintf(file, "time : %0.6g\n", time);
+    fprintf(file, "count : %lu\n", count);
+    fprintf(file, "quantiles : ");
+    for (unsigned int i = 0; i < nq; ++i)
+      fprintf(file, "%0.6g ", this->QuantileList[i]);
+    fprintf(file, "\n");
+    fprintf(file, "values : ");
+    for (unsigned int i = 0; i < nq; ++i)
+      fprintf(file, "%0.6g ", this->Values[i]);
+    fprintf(file, "\n");
+    fclose(file);
+    }
+
+  return 0;
+}
+
+//-----------------------------------------------------------------------------
+int Quantiles::GetQuantiles(std::vector<double> &quantiles,
+  std::vector<double> &values)
+{
+  if (this->Values.empty())
+    return -1;
+
+  quantiles = this->QuantileList;
+  values = this->Values;
+
+  return 0;
+}
+
+//-----------------------------------------------------------------------------
+int Quantiles::Finalize()
+{
+  this->Values.clear();
+
+  if (this->Store && this->Store->Close())
+    return -1;
+
+  return 0;
+}
+
+}
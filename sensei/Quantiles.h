@@ -0,0 +1,84 @@
+#ifndef sensei_Quantiles_h
+#define sensei_Quantiles_h
+
+#include "AnalysisAdaptor.h"
+#include <mpi.h>
+#include <string>
+#include <vector>
+
+class vtkDataObject;
+class vtkDataArray;
+
+namespace sensei
+{
+
+class KLLSketch;
+class TimeSeriesStore;
+
+/// @class Quantiles
+/// @brief Computes approximate quantiles of an array with a mergeable sketch
+///
+/// Each rank sketches its data in a single pass and the sketches are
+/// merged onto rank 0 with one tree reduction, from which any number of
+/// quantiles are found. The error in the rank of a quantile is about
+/// 1.7/K of the number of values, K = 200 gives about 1%. Either a list of
+/// quantiles in [0, 1] is given, or a number of evenly spaced quantiles
+/// describing the CDF from the min to the max. NaN values are skipped.
+class Quantiles : public AnalysisAdaptor
+{
+public:
+  static Quantiles* New();
+  senseiTypeMacro(Quantiles, AnalysisAdaptor);
+
+  // compute nQuantiles evenly spaced quantiles
+  void Initialize(const std::string &meshName, int association,
+    const std::string &arrayName, int nQuantiles, int k,
+    const std::string &fileName);
+
+  // compute the listed quantiles
+  void Initialize(const std::string &meshName, int association,
+    const std::string &arrayName, const std::vector<double> &quantiles,
+    int k, const std::string &fileName);
+
+  // append the results of every step to a single binary file named
+  // <fileName>_<mesh>_<array>.sts rather than writing a text file per
+  // step. see TimeSeriesStore.
+  void SetTimeSeries(int val) { this->TimeSeries = val; }
+  int GetTimeSeries() const { return this->TimeSeries; }
+
+  bool Execute(DataAdaptor* data) override;
+  int GetThreadSafe() override { return 1; }
+
+  int Finalize() override;
+
+  // return the last computed quantiles on rank 0
+  int GetQuantiles(std::vector<double> &quantiles,
+    std::vector<double> &values);
+
+protected:
+  Quantiles();
+  ~Quantiles();
+
+  Quantiles(const Quantiles&) = delete;
+  void operator=(const Quantiles&) = delete;
+
+  static const char *GetGhostArrayName();
+  vtkDataArray* GetArray(vtkDataObject* dobj, const std::string& arrayname);
+
+  // report the result on rank 0
+  int WriteQuantiles(int step, double time, unsigned long count);
+
+  std::string MeshName;
+  int Association;
+  std::string ArrayName;
+  std::vector<double> QuantileList;
+  std::vector<double> Values;
+  int K;
+  std::string FileName;
+  int TimeSeries;
+  TimeSeriesStore *Store;
+};
+
+}
+
+#endif
@@ -335,9 +335,11 @@ bool SliceExtract::ExecuteSlice(DataAdaptor* dataAdaptor)
   if (this->Internals->EnablePartitioner && itDataAdaptor)
     itDataAdaptor->SetPartitioner(this->Internals->SlicePartitioner);
 
-  // figure out what the simulation can provide
+  // figure out what the simulation can provide. the block bounds are
+  // used to fetch only the blocks that the slice plane crosses
   MeshMetadataFlags flags;
   flags.SetBlockDecomp();
+  flags.SetBlockBounds();
 
   MeshMetadataMap mdm;
   if (mdm.Initialize(dataAdaptor, flags))
@@ -346,6 +348,9 @@ bool SliceExtract::ExecuteSlice(DataAdaptor* dataAdaptor)
     return false;
     }
 
+  int rank = 0;
+  MPI_Comm_rank(this->GetCommunicator(), &rank);
+
   // loop over requested meshes, pull the arrays, take slice,
   // and finally write the result
   MeshRequirementsIterator mit =
@@ -362,9 +367,28 @@ bool SliceExtract::ExecuteSlice(DataAdaptor* dataAdaptor)
       return false;
       }
 
-    // get the mesh
+    // get the mesh. when the block bounds are known only the local
+    // blocks that the plane crosses are fetched, the rest are left empty
     vtkCompositeDataSet *dobj = nullptr;
-    if (dataAdaptor->GetMesh(meshName, mit.StructureOnly(), dobj))
+    if (md->BlockBounds.size() == md->BlockIds.size())
+      {
+      // the metadata may only list the local blocks
+      std::vector<int> blockIds;
+      unsigned int nBlocks = md->BlockIds.size();
+      for (unsigned int i = 0; i < nBlocks; ++i)
+        {
+        if ((md->BlockOwner[i] == rank) &&
+          this->Internals->SlicePartitioner->Intersects(md->BlockBounds[i]))
+          blockIds.push_back(md->BlockIds[i]);
+        }
+
+      if (dataAdaptor->GetMesh(meshName, mit.StructureOnly(), blockIds, dobj))
+        {
+        SENSEI_ERROR("Failed to get blocks of mesh \"" << meshName << "\"")
+        return false;
+        }
+      }
+    else if (dataAdaptor->GetMesh(meshName, mit.StructureOnly(), dobj))
       {
       SENSEI_ERROR("Failed to get mesh \"" << meshName << "\"")
       return false;
@@ -384,19 +408,19 @@ bool SliceExtract::ExecuteSlice(DataAdaptor* dataAdaptor)
       return false;
       }
 
-    // add the required arrays
+    // add the required arrays, a batch per association
     ArrayRequirementsIterator ait =
       this->Internals->Requirements.GetArrayRequirementsIterator(meshName);
+    ait.SetMode(ArrayRequirementsIterator::MODE_ASSOCIATION);
 
     while (ait)
       {
-      if (dataAdaptor->AddArray(dobj, meshName,
-         ait.Association(), ait.Array()))
+      if (dataAdaptor->AddArrays(dobj, meshName,
+         ait.Association(), ait.Arrays()))
         {
         SENSEI_ERROR("Failed to add "
           << VTKUtils::GetAttributesName(ait.Association())
-          << " data array \"" << ait.Array() << "\" to mesh \""
-          << meshName << "\"")
+          << " data arrays to mesh \"" << meshName << "\"")
         return false;
         }
       ++ait;
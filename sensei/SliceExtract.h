@@ -68,6 +68,7 @@ public:
   // SENSEI API
   void SetVerbose(int val) override;
   bool Execute(DataAdaptor* data) override;
+  int GetThreadSafe() override { return 1; }
   int Finalize() override;
 
 private:
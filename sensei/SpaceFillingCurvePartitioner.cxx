@@ -0,0 +1,220 @@
+#include "SpaceFillingCurvePartitioner.h"
+#include "Profiler.h"
+
+#include <pugixml.hpp>
+
+#include <algorithm>
+#include <array>
+#include <limits>
+
+namespace sensei
+{
+namespace
+{
+// number of bits of each coordinate used in the curve index
+const int gBits = 16;
+
+// --------------------------------------------------------------------------
+// convert the coordinates of a point into the transposed Hilbert index, in
+// place. see J. Skilling, "Programming the Hilbert curve", AIP Conference
+// Proceedings 707, 2004.
+void hilbertTranspose(uint32_t *x, int n, int b)
+{
+  uint32_t m = 1u << (b - 1);
+
+  // inverse undo
+  for (uint32_t q = m; q > 1; q >>= 1)
+    {
+    uint32_t p = q - 1;
+    for (int i = 0; i < n; ++i)
+      {
+      if (x[i] & q)
+        {
+        x[0] ^= p;
+        }
+      else
+        {
+        uint32_t t = (x[0] ^ x[i]) & p;
+        x[0] ^= t;
+        x[i] ^= t;
+        }
+      }
+    }
+
+  // gray encode
+  for (int i = 1; i < n; ++i)
+    x[i] ^= x[i-1];
+
+  uint32_t t = 0;
+  for (uint32_t q = m; q > 1; q >>= 1)
+    {
+    if (x[n-1] & q)
+      t ^= q - 1;
+    }
+
+  for (int i = 0; i < n; ++i)
+    x[i] ^= t;
+}
+
+// --------------------------------------------------------------------------
+// interleave the bits of the coordinates, most significant first
+uint64_t interleave(const uint32_t *x, int n, int b)
+{
+  uint64_t key = 0;
+  for (int j = b - 1; j >= 0; --j)
+    {
+    for (int i = 0; i < n; ++i)
+      key = (key << 1) | ((x[i] >> j) & 1u);
+    }
+  return key;
+}
+}
+
+// --------------------------------------------------------------------------
+int SpaceFillingCurvePartitioner::GetCurveOrder(const MeshMetadataPtr &md,
+  std::vector<int> &order)
+{
+  int nBlocks = md->NumBlocks;
+
+  order.resize(nBlocks);
+  for (int i = 0; i < nBlocks; ++i)
+    order[i] = i;
+
+  // the centroid of each block
+  std::vector<std::array<double,3>> centers(nBlocks);
+  if (int(md->BlockBounds.size()) == nBlocks)
+    {
+    for (int i = 0; i < nBlocks; ++i)
+      {
+      const std::array<double,6> &bds = md->BlockBounds[i];
+      for (int j = 0; j < 3; ++j)
+        centers[i][j] = 0.5*(bds[2*j] + bds[2*j+1]);
+      }
+    }
+  else if (int(md->BlockExtents.size()) == nBlocks)
+    {
+    for (int i = 0; i < nBlocks; ++i)
+      {
+      const std::array<int,6> &ext = md->BlockExtents[i];
+      for (int j = 0; j < 3; ++j)
+        centers[i][j] = 0.5*(double(ext[2*j]) + double(ext[2*j+1]));
+      }
+    }
+  else
+    {
+    SENSEI_WARNING("Mesh \"" << md->MeshName << "\" has neither block "
+      "bounds nor block extents, the blocks are not reordered")
+    return 0;
+    }
+
+  // the extent of the centroids. axes along which they do not vary are
+  // dropped
+  double lo[3] = {std::numeric_limits<double>::max(),
+    std::numeric_limits<double>::max(), std::numeric_limits<double>::max()};
+
+  double hi[3] = {std::numeric_limits<double>::lowest(),
+    std::numeric_limits<double>::lowest(), std::numeric_limits<double>::lowest()};
+
+  for (int i = 0; i < nBlocks; ++i)
+    {
+    for (int j = 0; j < 3; ++j)
+      {
+      lo[j] = std::min(lo[j], centers[i][j]);
+      hi[j] = std::max(hi[j], centers[i][j]);
+      }
+    }
+
+  int axes[3] = {0, 0, 0};
+  int nAxes = 0;
+  for (int j = 0; j < 3; ++j)
+    {
+    if (hi[j] > lo[j])
+      axes[nAxes++] = j;
+    }
+
+  if (nAxes == 0)
+    return 0;
+
+  // compute the curve index of each centroid on a 2^b grid
+  double maxCoord = double((1u << gBits) - 1u);
+
+  std::vector<uint64_t> keys(nBlocks);
+  for (int i = 0; i < nBlocks; ++i)
+    {
+    uint32_t x[3] = {0, 0, 0};
+    for (int k = 0; k < nAxes; ++k)
+      {
+      int j = axes[k];
+      x[k] = uint32_t(maxCoord*(centers[i][j] - lo[j])/(hi[j] - lo[j]) + 0.5);
+      }
+
+    if (this->Curve == CURVE_HILBERT)
+      hilbertTranspose(x, nAxes, gBits);
+
+    keys[i] = interleave(x, nAxes, gBits);
+    }
+
+  // ties are broken by block index so every rank finds the same order
+  std::stable_sort(order.begin(), order.end(),
+    [&keys](int a, int b) -> bool { return keys[a] < keys[b]; });
+
+  return 0;
+}
+
+// --------------------------------------------------------------------------
+int SpaceFillingCurvePartitioner::GetPartition(MPI_Comm comm,
+  const MeshMetadataPtr &mdIn, MeshMetadataPtr &mdOut)
+{
+  TimeEvent<128> mark("SpaceFillingCurvePartitioner::GetPartition");
+
+  mdOut = mdIn->NewCopy();
+
+  int nRanks = 1;
+  MPI_Comm_size(comm, &nRanks);
+
+  // every rank computes the same partition from the same metadata
+  std::vector<double> costs;
+  std::vector<int> order;
+  if (this->GetBlockCosts(mdOut, costs) || this->GetCurveOrder(mdOut, order))
+    return -1;
+
+  std::vector<double> load;
+  this->SplitContiguous(order, costs, nRanks, mdOut->BlockOwner, load);
+
+  this->ReportImbalance(mdOut, load);
+
+  return 0;
+}
+
+// --------------------------------------------------------------------------
+int SpaceFillingCurvePartitioner::Initialize(pugi::xml_node &node)
+{
+  TimeEvent<128> mark("SpaceFillingCurvePartitioner::Initialize");
+
+  if (this->InitializeCost(node))
+    return -1;
+
+  std::string curve = node.attribute("curve").as_string("hilbert");
+  if (curve == "hilbert")
+    {
+    this->SetCurve(CURVE_HILBERT);
+    }
+  else if (curve == "morton")
+    {
+    this->SetCurve(CURVE_MORTON);
+    }
+  else
+    {
+    SENSEI_ERROR("Invalid curve \"" << curve << "\". The curve is one of "
+      "hilbert or morton")
+    return -1;
+    }
+
+  SENSEI_STATUS("Configured SpaceFillingCurvePartitioner curve=" << curve
+    << " cost=" << node.attribute("cost").as_string("cells")
+    << (this->Cost == COST_EXPRESSION ? " expression=" + this->Expression : ""))
+
+  return 0;
+}
+
+}
@@ -0,0 +1,65 @@
+#ifndef sensei_SpaceFillingCurvePartitioner_h
+#define sensei_SpaceFillingCurvePartitioner_h
+
+#include "WeightedPartitioner.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace sensei
+{
+
+class SpaceFillingCurvePartitioner;
+using SpaceFillingCurvePartitionerPtr = std::shared_ptr<sensei::SpaceFillingCurvePartitioner>;
+
+/// @class SpaceFillingCurvePartitioner
+/// The space filling curve partitioner orders the blocks along a Hilbert
+/// or Morton curve through their centroids and cuts the curve into
+/// contiguous segments of about the same cost, so that each rank receives
+/// a compact region of the domain. The centroids are computed from
+/// MeshMetadata.BlockBounds or, for Cartesian meshes without bounds, from
+/// MeshMetadata.BlockExtents. Axes along which the centroids do not vary
+/// are dropped, so that 2D data is ordered by a 2D curve. The cost of the
+/// blocks is configured as for the WeightedPartitioner. The XML is of the
+/// form:
+///
+///   <partitioner type="sfc" curve="hilbert" cost="cells"/>
+class SpaceFillingCurvePartitioner : public sensei::WeightedPartitioner
+{
+public:
+  static sensei::SpaceFillingCurvePartitionerPtr New()
+  { return SpaceFillingCurvePartitionerPtr(new SpaceFillingCurvePartitioner); }
+
+  const char *GetClassName() override { return "SpaceFillingCurvePartitioner"; }
+
+  enum {CURVE_HILBERT=0, CURVE_MORTON=1};
+
+  // set the curve used to order the blocks, one of the CURVE_* values
+  void SetCurve(int curve) { this->Curve = curve; }
+  int GetCurve() { return this->Curve; }
+
+  // given an existing partitioning of data passed in the first MeshMetadata
+  // argument,return a new partittioning in the second MeshMetadata argument.
+  // distributes contiguous segments of the curve to ranks such that each
+  // rank has about the same cost.
+  int GetPartition(MPI_Comm comm, const sensei::MeshMetadataPtr &in,
+    sensei::MeshMetadataPtr &out) override;
+
+  // get the blocks in the order they are visited by the curve. when the
+  // metadata has neither bounds nor extents the blocks are left in order.
+  int GetCurveOrder(const sensei::MeshMetadataPtr &md,
+    std::vector<int> &order);
+
+  // Initialize from XML
+  int Initialize(pugi::xml_node &node) override;
+
+protected:
+  SpaceFillingCurvePartitioner() : Curve(CURVE_HILBERT) {}
+  SpaceFillingCurvePartitioner(const SpaceFillingCurvePartitioner &) = default;
+
+  int Curve;
+};
+
+}
+
+#endif
@@ -0,0 +1,276 @@
+#include "SubBlockPartitioner.h"
+#include "ConfigurablePartitioner.h"
+#include "VTKUtils.h"
+#include "Profiler.h"
+
+#include <pugixml.hpp>
+
+#include <algorithm>
+#include <array>
+#include <queue>
+#include <utility>
+
+namespace sensei
+{
+
+// --------------------------------------------------------------------------
+int SubBlockPartitioner::Split(const MeshMetadataPtr &mdIn, int nPieces,
+  MeshMetadataPtr &mdOut)
+{
+  int nBlocks = mdIn->NumBlocks;
+
+  // only logically Cartesian blocks with known extents can be split
+  if (!VTKUtils::LogicallyCartesian(mdIn) || VTKUtils::AMR(mdIn) ||
+    (int(mdIn->BlockExtents.size()) != nBlocks) || (nBlocks >= nPieces))
+    {
+    mdOut = mdIn->NewCopy();
+    return 0;
+    }
+
+  std::vector<double> costs;
+  if (this->GetBlockCosts(mdIn, costs))
+    return -1;
+
+  // blocks are split along the slowest varying axis that has cells
+  std::vector<int> axis(nBlocks, 0);
+  std::vector<int> pieces(nBlocks, 1);
+
+  // the most costly pieces are split first, ties go to the lower block
+  std::priority_queue<std::pair<double, int>> queue;
+
+  for (int i = 0; i < nBlocks; ++i)
+    {
+    const std::array<int,6> &ext = mdIn->BlockExtents[i];
+
+    int a = 2;
+    while ((a > 0) && (ext[2*a+1] <= ext[2*a]))
+      --a;
+    axis[i] = a;
+
+    int nLayers = ext[2*a+1] - ext[2*a];
+    if (nLayers >= 2*this->MinLayers)
+      queue.push(std::make_pair(costs[i], -i));
+    }
+
+  int total = nBlocks;
+  while ((total < nPieces) && !queue.empty())
+    {
+    int i = -queue.top().second;
+    queue.pop();
+
+    pieces[i] += 1;
+    total += 1;
+
+    const std::array<int,6> &ext = mdIn->BlockExtents[i];
+    int nLayers = ext[2*axis[i]+1] - ext[2*axis[i]];
+    if (nLayers >= (pieces[i] + 1)*this->MinLayers)
+      queue.push(std::make_pair(costs[i]/pieces[i], -i));
+    }
+
+  if (total == nBlocks)
+    {
+    SENSEI_WARNING("The blocks of mesh \"" << mdIn->MeshName
+      << "\" are too thin to be split")
+    mdOut = mdIn->NewCopy();
+    return 0;
+    }
+
+  // make the pieces. each piece starts as a copy of its block, then its
+  // extent, bounds, and sizes are narrowed to the slab
+  mdOut = mdIn->NewCopy();
+  mdOut->ClearBlockInfo();
+
+  bool haveSource = !mdIn->BlockSource.empty();
+  bool haveSizes = !mdIn->BlockNumPoints.empty();
+  bool haveCellArray = !mdIn->BlockCellArraySize.empty();
+  bool haveBounds = !mdIn->BlockBounds.empty();
+
+  for (int i = 0; i < nBlocks; ++i)
+    {
+    const std::array<int,6> &ext = mdIn->BlockExtents[i];
+
+    int a = axis[i];
+    int nLayers = ext[2*a+1] - ext[2*a];
+
+    for (int q = 0; q < pieces[i]; ++q)
+      {
+      mdOut->CopyBlockInfo(mdIn, i);
+
+      // the sender block, pieces of pieces refer to the original block
+      if (!haveSource)
+        mdOut->BlockSource.push_back(i);
+
+      if (pieces[i] == 1)
+        continue;
+
+      int id = mdOut->NumBlocks - 1;
+
+      // the pieces share the plane of points at the cut
+      std::array<int,6> &pext = mdOut->BlockExtents[id];
+      pext[2*a] = ext[2*a] + q*nLayers/pieces[i];
+      pext[2*a+1] = ext[2*a] + (q + 1)*nLayers/pieces[i];
+
+      if (haveBounds)
+        {
+        const std::array<double,6> &bds = mdIn->BlockBounds[i];
+        double dx = (bds[2*a+1] - bds[2*a])/nLayers;
+
+        std::array<double,6> &pbds = mdOut->BlockBounds[id];
+        pbds[2*a] = bds[2*a] + (pext[2*a] - ext[2*a])*dx;
+        pbds[2*a+1] = bds[2*a] + (pext[2*a+1] - ext[2*a])*dx;
+        }
+
+      if (haveSizes)
+        {
+        long nPts = 1;
+        long nCells = 1;
+        for (int d = 0; d < 3; ++d)
+          {
+          long n = pext[2*d+1] - pext[2*d] + 1;
+          nPts *= n;
+          nCells *= std::max(n - 1, 1l);
+          }
+
+        if (haveCellArray && mdIn->BlockNumCells[i])
+          {
+          mdOut->BlockCellArraySize[id] =
+            mdIn->BlockCellArraySize[i]*nCells/mdIn->BlockNumCells[i];
+          }
+
+        mdOut->BlockNumPoints[id] = nPts;
+        mdOut->BlockNumCells[id] = nCells;
+        }
+      }
+    }
+
+  // the pieces are given new ids
+  int nOut = mdOut->NumBlocks;
+  mdOut->BlockIds.resize(nOut);
+  for (int i = 0; i < nOut; ++i)
+    mdOut->BlockIds[i] = i;
+
+  // the dataset totals count the points at the cuts once per piece, the
+  // dataset extent, bounds, and ranges are unchanged
+  mdOut->NumPoints = 0;
+  mdOut->NumCells = 0;
+  mdOut->CellArraySize = 0;
+  for (int i = 0; haveSizes && (i < nOut); ++i)
+    {
+    mdOut->NumPoints += mdOut->BlockNumPoints[i];
+    mdOut->NumCells += mdOut->BlockNumCells[i];
+    mdOut->CellArraySize += haveCellArray ? mdOut->BlockCellArraySize[i] : 0;
+    }
+
+  mdOut->NumBlocksLocal = mdIn->NumBlocksLocal;
+  mdOut->Extent = mdIn->Extent;
+  mdOut->Bounds = mdIn->Bounds;
+  mdOut->ArrayRange = mdIn->ArrayRange;
+
+  return 0;
+}
+
+// --------------------------------------------------------------------------
+int SubBlockPartitioner::GetSelection(const int *ext, const int *subExt,
+  bool cells, size_t &start, size_t &count)
+{
+  size_t n[3] = {0};
+  size_t sn[3] = {0};
+  size_t s[3] = {0};
+  for (int d = 0; d < 3; ++d)
+    {
+    n[d] = ext[2*d+1] - ext[2*d] + 1;
+    sn[d] = subExt[2*d+1] - subExt[2*d] + 1;
+    s[d] = subExt[2*d] - ext[2*d];
+    if (cells)
+      {
+      n[d] = std::max(n[d] - 1, size_t(1));
+      sn[d] = std::max(sn[d] - 1, size_t(1));
+      }
+    }
+
+  // contiguous when the axes faster than the slowest split axis are whole
+  int a = 2;
+  while ((a > 0) && (sn[a] == 1))
+    --a;
+
+  for (int d = 0; d < a; ++d)
+    {
+    if (sn[d] != n[d])
+      return -1;
+    }
+
+  start = s[0] + n[0]*(s[1] + n[1]*s[2]);
+  count = sn[0]*sn[1]*sn[2];
+
+  return 0;
+}
+
+// --------------------------------------------------------------------------
+int SubBlockPartitioner::GetPartition(MPI_Comm comm,
+  const MeshMetadataPtr &mdIn, MeshMetadataPtr &mdOut)
+{
+  TimeEvent<128> mark("SubBlockPartitioner::GetPartition");
+
+  int nRanks = 1;
+  MPI_Comm_size(comm, &nRanks);
+
+  // every rank computes the same pieces from the same metadata
+  MeshMetadataPtr pieces;
+  if (this->Split(mdIn, this->BlocksPerRank*nRanks, pieces))
+    return -1;
+
+  if (this->GetVerbose())
+    {
+    SENSEI_STATUS("Split " << mdIn->NumBlocks << " blocks of mesh \""
+      << mdIn->MeshName << "\" into " << pieces->NumBlocks << " pieces for "
+      << nRanks << " ranks")
+    }
+
+  if (this->PiecePartitioner)
+    return this->PiecePartitioner->GetPartition(comm, pieces, mdOut);
+
+  return this->WeightedPartitioner::GetPartition(comm, pieces, mdOut);
+}
+
+// --------------------------------------------------------------------------
+int SubBlockPartitioner::Initialize(pugi::xml_node &node)
+{
+  TimeEvent<128> mark("SubBlockPartitioner::Initialize");
+
+  if (this->InitializeCost(node) || this->InitializeMethod(node))
+    return -1;
+
+  int blocksPerRank = node.attribute("blocks_per_rank").as_int(1);
+  int minLayers = node.attribute("min_layers").as_int(1);
+  if ((blocksPerRank < 1) || (minLayers < 1))
+    {
+    SENSEI_ERROR("Invalid blocks_per_rank " << blocksPerRank
+      << " or min_layers " << minLayers << ". Both must be at least 1")
+    return -1;
+    }
+  this->SetBlocksPerRank(blocksPerRank);
+  this->SetMinLayers(minLayers);
+
+  // the partitioner that assigns the pieces
+  pugi::xml_node partNode = node.child("partitioner");
+  if (partNode)
+    {
+    ConfigurablePartitionerPtr part = ConfigurablePartitioner::New();
+    if (part->Initialize(partNode))
+      {
+      SENSEI_ERROR("Failed to initialize the piece partitioner")
+      return -1;
+      }
+    this->SetPiecePartitioner(part);
+    }
+
+  SENSEI_STATUS("Configured SubBlockPartitioner blocks_per_rank="
+    << blocksPerRank << " min_layers=" << minLayers
+    << " cost=" << node.attribute("cost").as_string("cells")
+    << (this->Cost == COST_EXPRESSION ? " expression=" + this->Expression : "")
+    << " pieces=" << (partNode ? partNode.attribute("type").value() : "weighted"))
+
+  return 0;
+}
+
+}
@@ -0,0 +1,91 @@
+#ifndef sensei_SubBlockPartitioner_h
+#define sensei_SubBlockPartitioner_h
+
+#include "WeightedPartitioner.h"
+
+#include <cstddef>
+
+namespace sensei
+{
+
+class SubBlockPartitioner;
+using SubBlockPartitionerPtr = std::shared_ptr<sensei::SubBlockPartitioner>;
+
+/// @class SubBlockPartitioner
+/// The sub-block partitioner lets an in transit end point run on more
+/// ranks than the simulation has blocks. Logically Cartesian blocks (image,
+/// rectilinear, and structured) are split into slabs along their slowest
+/// varying non-degenerate axis, k or j for 2D data, until there are at
+/// least blocks_per_rank pieces per receiver rank. The most costly pieces
+/// are split first and no piece is made thinner than min_layers cell
+/// layers. Neighboring pieces share the plane of points at the cut, so
+/// that the pieces together have the cells of the original block. Each
+/// piece records the sender block it was cut from
+/// (MeshMetadata.BlockSource) and its sub-extent (MeshMetadata.BlockExtents),
+/// which the transport uses to read only the piece's hyperslab. With the
+/// x fastest ordering of VTK each slab is a single contiguous selection.
+/// The pieces are then assigned to ranks by a nested partitioner, or when
+/// none is given, as for the WeightedPartitioner. Meshes that are not
+/// logically Cartesian, AMR meshes, and meshes that already have enough
+/// blocks are passed to the nested partitioner unchanged. The XML is of
+/// the form:
+///
+///   <partitioner type="split" blocks_per_rank="1" min_layers="1" cost="cells">
+///     <partitioner type="sfc"/>
+///   </partitioner>
+class SubBlockPartitioner : public sensei::WeightedPartitioner
+{
+public:
+  static sensei::SubBlockPartitionerPtr New()
+  { return SubBlockPartitionerPtr(new SubBlockPartitioner); }
+
+  const char *GetClassName() override { return "SubBlockPartitioner"; }
+
+  // set the number of pieces per rank blocks are split into
+  void SetBlocksPerRank(int n) { this->BlocksPerRank = n; }
+  int GetBlocksPerRank() { return this->BlocksPerRank; }
+
+  // set the fewest cell layers a piece may have along the split axis
+  void SetMinLayers(int n) { this->MinLayers = n; }
+  int GetMinLayers() { return this->MinLayers; }
+
+  // set the partitioner that assigns the pieces to ranks. when none is
+  // set the pieces are placed as by the WeightedPartitioner
+  void SetPiecePartitioner(const sensei::PartitionerPtr &part)
+  { this->PiecePartitioner = part; }
+
+  // given an existing partitioning of data passed in the first MeshMetadata
+  // argument,return a new partittioning in the second MeshMetadata argument.
+  // splits blocks such that every rank can be given a piece.
+  int GetPartition(MPI_Comm comm, const sensei::MeshMetadataPtr &in,
+    sensei::MeshMetadataPtr &out) override;
+
+  // split the blocks into at least nPieces pieces without assigning them.
+  // the pieces are given new ids and the owner of the block they were cut
+  // from. this is the part of GetPartition that does not communicate.
+  int Split(const sensei::MeshMetadataPtr &in, int nPieces,
+    sensei::MeshMetadataPtr &out);
+
+  // compute the selection of a piece of sub-extent subExt in the data of
+  // the block of extent ext, flattened with x varying fastest. the data is
+  // cell centered when cells is set. this is how transports read a piece
+  // from the data of a whole block. returns non-zero if the piece is not a
+  // contiguous slab
+  static int GetSelection(const int *ext, const int *subExt, bool cells,
+    size_t &start, size_t &count);
+
+  // Initialize from XML
+  int Initialize(pugi::xml_node &node) override;
+
+protected:
+  SubBlockPartitioner() : BlocksPerRank(1), MinLayers(1) {}
+  SubBlockPartitioner(const SubBlockPartitioner &) = default;
+
+  int BlocksPerRank;
+  int MinLayers;
+  sensei::PartitionerPtr PiecePartitioner;
+};
+
+}
+
+#endif
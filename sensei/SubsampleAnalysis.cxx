@@ -0,0 +1,123 @@
+#include "SubsampleAnalysis.h"
+#include "SubsampleDataAdaptor.h"
+#include "DataAdaptor.h"
+#include "Profiler.h"
+#include "Error.h"
+
+#include <vtkObjectFactory.h>
+#include <vtkSmartPointer.h>
+
+#include <vector>
+
+namespace sensei
+{
+
+struct SubsampleAnalysis::InternalsType
+{
+  vtkSmartPointer<SubsampleDataAdaptor> Subsampler;
+  std::vector<vtkSmartPointer<AnalysisAdaptor>> Analyses;
+};
+
+//-----------------------------------------------------------------------------
+senseiNewMacro(SubsampleAnalysis);
+
+//-----------------------------------------------------------------------------
+SubsampleAnalysis::SubsampleAnalysis() : Internals(new InternalsType)
+{
+  this->Internals->Subsampler = vtkSmartPointer<SubsampleDataAdaptor>::New();
+}
+
+//-----------------------------------------------------------------------------
+SubsampleAnalysis::~SubsampleAnalysis()
+{
+  delete this->Internals;
+}
+
+//-----------------------------------------------------------------------------
+SubsampleDataAdaptor *SubsampleAnalysis::GetSubsampler()
+{
+  return this->Internals->Subsampler.GetPointer();
+}
+
+//-----------------------------------------------------------------------------
+void SubsampleAnalysis::AddAnalysis(AnalysisAdaptor *analysis)
+{
+  this->Internals->Analyses.push_back(analysis);
+}
+
+//-----------------------------------------------------------------------------
+void SubsampleAnalysis::ClearAnalyses()
+{
+  this->Internals->Analyses.clear();
+}
+
+//-----------------------------------------------------------------------------
+unsigned int SubsampleAnalysis::GetNumberOfAnalyses()
+{
+  return this->Internals->Analyses.size();
+}
+
+//-----------------------------------------------------------------------------
+int SubsampleAnalysis::SetCommunicator(MPI_Comm comm)
+{
+  this->Superclass::SetCommunicator(comm);
+
+  this->Internals->Subsampler->SetCommunicator(comm);
+
+  unsigned int nAnalyses = this->Internals->Analyses.size();
+  for (unsigned int i = 0; i < nAnalyses; ++i)
+    this->Internals->Analyses[i]->SetCommunicator(comm);
+
+  return 0;
+}
+
+//-----------------------------------------------------------------------------
+bool SubsampleAnalysis::Execute(DataAdaptor* data)
+{
+  TimeEvent<128> mark("SubsampleAnalysis::Execute");
+
+  SubsampleDataAdaptor *subsampler = this->Internals->Subsampler;
+  subsampler->SetDataAdaptor(data);
+
+  bool ok = true;
+  unsigned int nAnalyses = this->Internals->Analyses.size();
+  for (unsigned int i = 0; i < nAnalyses; ++i)
+    {
+    AnalysisAdaptor *analysis = this->Internals->Analyses[i];
+    if (!analysis->Execute(subsampler))
+      {
+      SENSEI_ERROR("Failed to execute " << analysis->GetClassName()
+        << " on the subsampled data")
+      ok = false;
+      }
+    }
+
+  // the subsampled meshes are only valid during this step. the data
+  // belongs to the caller and is not released here
+  subsampler->SetDataAdaptor(nullptr);
+
+  return ok;
+}
+
+//-----------------------------------------------------------------------------
+int SubsampleAnalysis::Finalize()
+{
+  int ierr = 0;
+
+  unsigned int nAnalyses = this->Internals->Analyses.size();
+  for (unsigned int i = 0; i < nAnalyses; ++i)
+    {
+    if (this->Internals->Analyses[i]->Finalize())
+      {
+      SENSEI_ERROR("Failed to finalize "
+        << this->Internals->Analyses[i]->GetClassName())
+      ierr = -1;
+      }
+    }
+
+  this->Internals->Analyses.clear();
+
+  return ierr;
+}
+
+}
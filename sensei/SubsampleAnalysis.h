@@ -0,0 +1,59 @@
+#ifndef sensei_SubsampleAnalysis_h
+#define sensei_SubsampleAnalysis_h
+
+#include "AnalysisAdaptor.h"
+
+#include <mpi.h>
+
+namespace sensei
+{
+class SubsampleDataAdaptor;
+
+/// @class SubsampleAnalysis
+/// @brief Runs a set of analyses on a subsampled view of the simulation data
+///
+/// Each step the data passed to Execute is wrapped by a SubsampleDataAdaptor
+/// and the analyses are executed, in order, on the subsampled meshes. The
+/// subsampled meshes are generated once and shared by the analyses, and
+/// are dropped at the end of the step. This reduces the amount of data
+/// that expensive back ends such as I/O and rendering have to process.
+/// See SubsampleDataAdaptor for the available methods.
+class SubsampleAnalysis : public AnalysisAdaptor
+{
+public:
+  static SubsampleAnalysis* New();
+  senseiTypeMacro(SubsampleAnalysis, AnalysisAdaptor);
+
+  /// @brief Get the adaptor used to subsample the data, to configure it.
+  SubsampleDataAdaptor *GetSubsampler();
+
+  /// @brief Add an analysis to run on the subsampled data.
+  void AddAnalysis(AnalysisAdaptor *analysis);
+
+  /// @brief Remove all of the analyses.
+  void ClearAnalyses();
+
+  /// @brief Get the number of analyses.
+  unsigned int GetNumberOfAnalyses();
+
+  int SetCommunicator(MPI_Comm comm) override;
+
+  bool Execute(DataAdaptor* data) override;
+
+  int Finalize() override;
+
+protected:
+  SubsampleAnalysis();
+  ~SubsampleAnalysis();
+
+  SubsampleAnalysis(const SubsampleAnalysis&) = delete;
+  void operator=(const SubsampleAnalysis&) = delete;
+
+private:
+  struct InternalsType;
+  InternalsType *Internals;
+};
+
+}
+
+#endif
@@ -0,0 +1,1487 @@
+#include "SubsampleDataAdaptor.h"
+#include "VTKUtils.h"
+#include "Error.h"
+
+#include <vtkAbstractArray.h>
+#include <vtkCellArray.h>
+#include <vtkCompositeDataIterator.h>
+#include <vtkCompositeDataSet.h>
+#include <vtkDataArray.h>
+#include <vtkDataObject.h>
+#include <vtkDataSet.h>
+#include <vtkDataSetAttributes.h>
+#include <vtkFieldData.h>
+#include <vtkIdList.h>
+#include <vtkImageData.h>
+#include <vtkObjectFactory.h>
+#include <vtkPointSet.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkSmartPointer.h>
+#include <vtkUniformGridAMR.h>
+#include <vtkUnstructuredGrid.h>
+
+#include <pugixml.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+using vtkDataSetPtr = vtkSmartPointer<vtkDataSet>;
+using vtkIdListPtr = vtkSmartPointer<vtkIdList>;
+using vtkCompositeDataIteratorPtr = vtkSmartPointer<vtkCompositeDataIterator>;
+
+namespace sensei
+{
+namespace
+{
+// how a mesh is subsampled
+struct SubsampleSpec
+{
+  SubsampleSpec() : Method(SubsampleDataAdaptor::METHOD_STRIDE),
+    Stride{{1,1,1}}, Fraction(1.0), Strata(8),
+    Association(vtkDataObject::POINT) {}
+
+  int Method;
+  std::array<int,3> Stride;
+  double Fraction;
+  int Strata;
+  int Association;
+  std::string ArrayName;
+};
+
+// a block of a subsampled mesh. the ids of the points and cells of the
+// full block that were kept are used to subsample its arrays. a null
+// list means that arrays of that association can not be subsampled.
+struct SampledBlock
+{
+  SampledBlock() : BlockId(0), Input(nullptr) {}
+
+  int BlockId;
+  vtkDataSet *Input;
+  vtkDataSetPtr Output;
+  vtkIdListPtr PointIds;
+  vtkIdListPtr CellIds;
+};
+
+// a subsampled mesh, the full mesh as returned by the wrapped adaptor
+// and the arrays that have been subsampled
+struct SampledMesh
+{
+  SampledMesh() : GhostCells(false), GhostNodes(false) {}
+
+  vtkCompositeDataSetPtr Input;
+  vtkCompositeDataSetPtr Output;
+  std::vector<SampledBlock> Blocks;
+  std::set<std::pair<int, std::string>> Arrays;
+  bool GhostCells;
+  bool GhostNodes;
+};
+
+// --------------------------------------------------------------------------
+uint64_t mix(uint64_t x)
+{
+  // the splitmix64 finalizer
+  x += 0x9e3779b97f4a7c15ull;
+  x = (x ^ (x >> 30))*0xbf58476d1ce4e5b9ull;
+  x = (x ^ (x >> 27))*0x94d049bb133111ebull;
+  return x ^ (x >> 31);
+}
+
+// --------------------------------------------------------------------------
+// a value uniformly distributed in [0, 1) that depends only on the block's
+// key and the element index
+inline double uniform(uint64_t key, vtkIdType i)
+{
+  return (mix(key ^ uint64_t(i)) >> 11)*(1.0/9007199254740992.0);
+}
+
+// --------------------------------------------------------------------------
+int floorDiv(int a, int b)
+{
+  return a >= 0 ? a/b : -((b - 1 - a)/b);
+}
+
+// --------------------------------------------------------------------------
+int ceilDiv(int a, int b)
+{
+  return -floorDiv(-a, b);
+}
+
+// --------------------------------------------------------------------------
+// the extent of the points of ext kept by the stride, the points whose
+// index is a multiple of it. axes that are flat are left alone. returns
+// false if no points are kept.
+bool strideExtent(const int *ext, const std::array<int,3> &stride,
+  int *sext, int *sstride)
+{
+  bool ok = true;
+  for (int a = 0; a < 3; ++a)
+    {
+    if (ext[2*a] >= ext[2*a+1])
+      {
+      sstride[a] = 1;
+      sext[2*a] = ext[2*a];
+      sext[2*a+1] = ext[2*a+1];
+      }
+    else
+      {
+      sstride[a] = stride[a];
+      sext[2*a] = ceilDiv(ext[2*a], stride[a]);
+      sext[2*a+1] = floorDiv(ext[2*a+1], stride[a]);
+      }
+    ok &= sext[2*a] <= sext[2*a+1];
+    }
+  return ok;
+}
+
+// --------------------------------------------------------------------------
+// number of points and cells in an extent, as VTK counts them
+void extentSize(const int *ext, long &nPts, long &nCells)
+{
+  nPts = 1;
+  nCells = 1;
+  for (int a = 0; a < 3; ++a)
+    {
+    long n = ext[2*a+1] - ext[2*a] + 1;
+    if (n < 1)
+      {
+      nPts = 0;
+      nCells = 0;
+      return;
+      }
+    nPts *= n;
+    nCells *= std::max(n - 1, 1l);
+    }
+}
+
+// --------------------------------------------------------------------------
+// true if the block holds particles, points with no cells or vertices
+bool particles(vtkDataSet *ds)
+{
+  vtkIdType nCells = ds->GetNumberOfCells();
+  if (nCells == 0)
+    return true;
+
+  if (vtkPolyData *pd = dynamic_cast<vtkPolyData*>(ds))
+    return nCells == pd->GetNumberOfVerts();
+
+  if (dynamic_cast<vtkImageData*>(ds))
+    return false;
+
+  return ds->GetMaxCellSize() <= 1;
+}
+
+// --------------------------------------------------------------------------
+// copy the tuples listed in ids into a new array
+vtkAbstractArray *subsetArray(vtkAbstractArray *in, vtkIdList *ids)
+{
+  vtkAbstractArray *out = in->NewInstance();
+  out->SetName(in->GetName());
+  out->SetNumberOfComponents(in->GetNumberOfComponents());
+  out->SetNumberOfTuples(ids->GetNumberOfIds());
+  in->GetTuples(ids, out);
+  return out;
+}
+
+// --------------------------------------------------------------------------
+// subsample an image keeping every stride'th point along each axis
+vtkImageData *strideImage(vtkImageData *im, const std::array<int,3> &stride,
+  vtkIdList *pointIds, vtkIdList *cellIds)
+{
+  vtkImageData *out = vtkImageData::New();
+
+  int ext[6];
+  im->GetExtent(ext);
+
+  int sext[6];
+  int s[3];
+  if (!strideExtent(ext, stride, sext, s))
+    {
+    out->SetExtent(0, -1, 0, -1, 0, -1);
+    return out;
+    }
+
+  double sp[3];
+  im->GetSpacing(sp);
+
+  out->SetOrigin(im->GetOrigin());
+  out->SetSpacing(sp[0]*s[0], sp[1]*s[1], sp[2]*s[2]);
+  out->SetExtent(sext);
+
+  // the points
+  long nx = ext[1] - ext[0] + 1;
+  long ny = ext[3] - ext[2] + 1;
+
+  long nPts = 0;
+  long nCells = 0;
+  extentSize(sext, nPts, nCells);
+
+  pointIds->SetNumberOfIds(nPts);
+  vtkIdType *pid = pointIds->GetPointer(0);
+  for (long k = sext[4]; k <= sext[5]; ++k)
+    {
+    long kk = k*s[2] - ext[4];
+    for (long j = sext[2]; j <= sext[3]; ++j)
+      {
+      long jj = j*s[1] - ext[2];
+      for (long i = sext[0]; i <= sext[1]; ++i, ++pid)
+        *pid = (i*s[0] - ext[0]) + nx*(jj + ny*kk);
+      }
+    }
+
+  // the cells. each kept cell is the cell of the full image whose first
+  // point is the kept cell's first point. along axes that collapse to a
+  // single point the last cell is used.
+  long cx = std::max(nx - 1, 1l);
+  long cy = std::max(ny - 1, 1l);
+
+  long c1[3];
+  long cs[3];
+  for (int a = 0; a < 3; ++a)
+    {
+    c1[a] = sext[2*a] + std::max(sext[2*a+1] - sext[2*a], 1) - 1;
+    cs[a] = ext[2*a] < ext[2*a+1] ? s[a] : 0;
+    }
+
+  auto cellIndex = [&](long c, int a) -> long
+  {
+    return cs[a] ? std::min(c*cs[a], long(ext[2*a+1] - 1)) - ext[2*a] : 0;
+  };
+
+  cellIds->SetNumberOfIds(nCells);
+  vtkIdType *cid = cellIds->GetPointer(0);
+  for (long k = sext[4]; k <= c1[2]; ++k)
+    {
+    long kk = cellIndex(k, 2);
+    for (long j = sext[2]; j <= c1[1]; ++j)
+      {
+      long jj = cellIndex(j, 1);
+      for (long i = sext[0]; i <= c1[0]; ++i, ++cid)
+        *cid = cellIndex(i, 0) + cx*(jj + cy*kk);
+      }
+    }
+
+  return out;
+}
+
+// --------------------------------------------------------------------------
+// select the elements to keep. center returns the position of an element
+// and is only used by stratified sampling. weights is the importance
+// array and is only used by importance sampling.
+template <typename center_t>
+void selectElements(const SubsampleSpec &spec, uint64_t key, vtkIdType n,
+  const double *bounds, const center_t &center, vtkDataArray *weights,
+  std::vector<vtkIdType> &ids)
+{
+  ids.clear();
+
+  switch (spec.Method)
+    {
+    case SubsampleDataAdaptor::METHOD_STRIDE:
+      {
+      vtkIdType s = vtkIdType(spec.Stride[0])*spec.Stride[1]*spec.Stride[2];
+      ids.reserve(n/s + 1);
+      for (vtkIdType i = 0; i < n; i += s)
+        ids.push_back(i);
+      }
+      break;
+
+    case SubsampleDataAdaptor::METHOD_RANDOM:
+      {
+      ids.reserve(spec.Fraction*n + 1);
+      for (vtkIdType i = 0; i < n; ++i)
+        {
+        if (uniform(key, i) < spec.Fraction)
+          ids.push_back(i);
+        }
+      }
+      break;
+
+    case SubsampleDataAdaptor::METHOD_STRATIFIED:
+      {
+      // bin the elements, flat axes get a single bin
+      int nb[3];
+      double x0[3];
+      double dx[3];
+      for (int a = 0; a < 3; ++a)
+        {
+        double w = bounds[2*a+1] - bounds[2*a];
+        nb[a] = w > 0.0 ? spec.Strata : 1;
+        x0[a] = bounds[2*a];
+        dx[a] = w > 0.0 ? w/spec.Strata : 1.0;
+        }
+
+      long nBins = long(nb[0])*nb[1]*nb[2];
+      std::vector<vtkIdType> offset(nBins + 1, 0);
+      std::vector<unsigned int> bin(n);
+
+      for (vtkIdType i = 0; i < n; ++i)
+        {
+        double x[3];
+        center(i, x);
+
+        long b = 0;
+        for (int a = 2; a >= 0; --a)
+          {
+          long q = std::max(0l, std::min(long((x[a] - x0[a])/dx[a]), long(nb[a] - 1)));
+          b = b*nb[a] + q;
+          }
+
+        bin[i] = b;
+        offset[b + 1] += 1;
+        }
+
+      for (long b = 0; b < nBins; ++b)
+        offset[b + 1] += offset[b];
+
+      // group the elements by bin
+      std::vector<vtkIdType> order(n);
+      std::vector<vtkIdType> next(offset.begin(), offset.end() - 1);
+      for (vtkIdType i = 0; i < n; ++i)
+        order[next[bin[i]]++] = i;
+
+      // a random subset of each bin
+      auto byChoice = [key](vtkIdType a, vtkIdType b) -> bool
+        { return uniform(key, a) < uniform(key, b); };
+
+      ids.reserve(spec.Fraction*n + nBins);
+      for (long b = 0; b < nBins; ++b)
+        {
+        vtkIdType *b0 = order.data() + offset[b];
+        vtkIdType m = offset[b + 1] - offset[b];
+        if (m == 0)
+          continue;
+
+        vtkIdType k = std::min(m, std::max(vtkIdType(1),
+          vtkIdType(std::llround(spec.Fraction*m))));
+
+        if (k < m)
+          std::nth_element(b0, b0 + k, b0 + m, byChoice);
+
+        ids.insert(ids.end(), b0, b0 + k);
+        }
+
+      std::sort(ids.begin(), ids.end());
+      }
+      break;
+
+    case SubsampleDataAdaptor::METHOD_IMPORTANCE:
+      {
+      // the magnitude of the importance array
+      int nComps = weights->GetNumberOfComponents();
+      std::vector<double> tuple(nComps);
+      std::vector<double> w(n);
+      double sum = 0.0;
+      for (vtkIdType i = 0; i < n; ++i)
+        {
+        weights->GetTuple(i, tuple.data());
+
+        double m = 0.0;
+        for (int j = 0; j < nComps; ++j)
+          m += tuple[j]*tuple[j];
+
+        w[i] = nComps > 1 ? sqrt(m) : fabs(tuple[0]);
+        sum += w[i];
+        }
+
+      // probabilities that keep about fraction*n elements. when all of
+      // the weights are zero sample uniformly
+      double scale = sum > 0.0 ? spec.Fraction*n/sum : 0.0;
+
+      ids.reserve(spec.Fraction*n + 1);
+      for (vtkIdType i = 0; i < n; ++i)
+        {
+        double p = sum > 0.0 ? std::min(1.0, scale*w[i]) : spec.Fraction;
+        if (uniform(key, i) < p)
+          ids.push_back(i);
+        }
+      }
+      break;
+    }
+}
+
+// --------------------------------------------------------------------------
+// gather the listed points of the block
+vtkPoints *subsetPoints(vtkDataSet *ds, vtkIdList *ids)
+{
+  vtkPoints *pts = vtkPoints::New();
+
+  vtkPointSet *ps = dynamic_cast<vtkPointSet*>(ds);
+  if (ps && ps->GetPoints())
+    {
+    pts->SetDataType(ps->GetPoints()->GetDataType());
+    pts->SetNumberOfPoints(ids->GetNumberOfIds());
+    ps->GetPoints()->GetData()->GetTuples(ids, pts->GetData());
+    return pts;
+    }
+
+  // implicit points
+  vtkIdType n = ids->GetNumberOfIds();
+  pts->SetDataTypeToDouble();
+  pts->SetNumberOfPoints(n);
+  for (vtkIdType i = 0; i < n; ++i)
+    {
+    double x[3];
+    ds->GetPoint(ids->GetId(i), x);
+    pts->SetPoint(i, x);
+    }
+
+  return pts;
+}
+
+// --------------------------------------------------------------------------
+// subsample the block keeping the listed points
+vtkDataSet *samplePoints(vtkDataSet *ds, const std::vector<vtkIdType> &ids,
+  vtkIdList *pointIds, vtkIdList *&cellIds)
+{
+  vtkIdType n = ids.size();
+
+  pointIds->SetNumberOfIds(n);
+  std::copy(ids.begin(), ids.end(), pointIds->GetPointer(0));
+
+  vtkPoints *pts = subsetPoints(ds, pointIds);
+
+  // the particles keep their vertices. cell data can be subsampled when
+  // there is a vertex per point
+  vtkIdType nCells = ds->GetNumberOfCells();
+  vtkCellArray *verts = nullptr;
+  if (nCells)
+    {
+    verts = vtkCellArray::New();
+    for (vtkIdType i = 0; i < n; ++i)
+      verts->InsertNextCell(1, &i);
+    }
+
+  if (nCells != ds->GetNumberOfPoints())
+    cellIds = nullptr;
+  else
+    cellIds->DeepCopy(pointIds);
+
+  vtkDataSet *out = nullptr;
+  if (dynamic_cast<vtkPolyData*>(ds))
+    {
+    vtkPolyData *pd = vtkPolyData::New();
+    pd->SetPoints(pts);
+    if (verts)
+      pd->SetVerts(verts);
+    out = pd;
+    }
+  else
+    {
+    vtkUnstructuredGrid *ug = vtkUnstructuredGrid::New();
+    ug->SetPoints(pts);
+    if (verts)
+      ug->SetCells(VTK_VERTEX, verts);
+    out = ug;
+    }
+
+  pts->Delete();
+  if (verts)
+    verts->Delete();
+
+  return out;
+}
+
+// --------------------------------------------------------------------------
+// subsample the block keeping the listed cells and the points they use
+vtkDataSet *sampleCells(vtkDataSet *ds, const std::vector<vtkIdType> &ids,
+  vtkIdList *pointIds, vtkIdList *cellIds)
+{
+  vtkIdType n = ids.size();
+
+  cellIds->SetNumberOfIds(n);
+  std::copy(ids.begin(), ids.end(), cellIds->GetPointer(0));
+
+  vtkPolyData *pd = nullptr;
+  vtkUnstructuredGrid *ug = nullptr;
+  if (dynamic_cast<vtkPolyData*>(ds))
+    {
+    pd = vtkPolyData::New();
+    pd->Allocate(n);
+    }
+  else
+    {
+    ug = vtkUnstructuredGrid::New();
+    ug->Allocate(n);
+    }
+
+  // renumber the points in the order they are first used
+  std::vector<vtkIdType> pointMap(ds->GetNumberOfPoints(), -1);
+  vtkIdList *cellPts = vtkIdList::New();
+  for (vtkIdType i = 0; i < n; ++i)
+    {
+    vtkIdType cid = ids[i];
+    ds->GetCellPoints(cid, cellPts);
+
+    vtkIdType nCellPts = cellPts->GetNumberOfIds();
+    for (vtkIdType j = 0; j < nCellPts; ++j)
+      {
+      vtkIdType &pid = pointMap[cellPts->GetId(j)];
+      if (pid < 0)
+        {
+        pid = pointIds->GetNumberOfIds();
+        pointIds->InsertNextId(cellPts->GetId(j));
+        }
+      cellPts->SetId(j, pid);
+      }
+
+    int cellType = ds->GetCellType(cid);
+    if (pd)
+      pd->InsertNextCell(cellType, cellPts);
+    else
+      ug->InsertNextCell(cellType, cellPts);
+    }
+  cellPts->Delete();
+
+  vtkPoints *pts = subsetPoints(ds, pointIds);
+
+  vtkDataSet *out = nullptr;
+  if (pd)
+    {
+    pd->SetPoints(pts);
+    out = pd;
+    }
+  else
+    {
+    ug->SetPoints(pts);
+    out = ug;
+    }
+
+  pts->Delete();
+
+  return out;
+}
+
+// --------------------------------------------------------------------------
+// parse a fraction given as a value in (0, 1] or a percentage
+int parseFraction(const std::string &str, double &fraction)
+{
+  try
+    {
+    fraction = std::stod(str);
+    }
+  catch (...)
+    {
+    SENSEI_ERROR("Invalid fraction \"" << str << "\"")
+    return -1;
+    }
+
+  if (!str.empty() && (str.back() == '%'))
+    fraction /= 100.0;
+
+  return 0;
+}
+}
+
+struct SubsampleDataAdaptor::InternalsType
+{
+  InternalsType() : Seed(0) {}
+
+  // get the subsampled mesh, generating it when it is not cached
+  SampledMesh *GetEntry(const std::string &meshName);
+
+  // subsample the arrays of the full mesh onto the subsampled mesh
+  int AddArrays(SampledMesh *entry, int association,
+    const std::vector<std::string> &arrayNames);
+
+  vtkSmartPointer<DataAdaptor> Adaptor;
+  std::map<std::string, SubsampleSpec> Specs;
+  std::map<std::string, SampledMesh> Meshes;
+  unsigned long Seed;
+};
+
+// --------------------------------------------------------------------------
+SampledMesh *SubsampleDataAdaptor::InternalsType::GetEntry(
+  const std::string &meshName)
+{
+  std::map<std::string, SampledMesh>::iterator it = this->Meshes.find(meshName);
+  if (it != this->Meshes.end())
+    return &it->second;
+
+  const SubsampleSpec &spec = this->Specs[meshName];
+
+  // the geometry is always needed to subsample
+  vtkCompositeDataSet *cd = nullptr;
+  if (this->Adaptor->GetMesh(meshName, false, cd))
+    {
+    SENSEI_ERROR("Failed to get mesh \"" << meshName << "\"")
+    return nullptr;
+    }
+
+  vtkCompositeDataSetPtr input;
+  input.TakeReference(cd);
+
+  if (dynamic_cast<vtkUniformGridAMR*>(cd))
+    {
+    SENSEI_ERROR("Subsampling AMR mesh \"" << meshName
+      << "\" is not supported")
+    return nullptr;
+    }
+
+  if ((spec.Method == METHOD_IMPORTANCE) && this->Adaptor->AddArray(cd,
+    meshName, spec.Association, spec.ArrayName))
+    {
+    SENSEI_ERROR("Failed to add " << VTKUtils::GetAttributesName(spec.Association)
+      << " data array \"" << spec.ArrayName << "\" to mesh \"" << meshName << "\"")
+    return nullptr;
+    }
+
+  // the local blocks
+  std::vector<SampledBlock> blocks;
+
+  vtkCompositeDataIteratorPtr cdit;
+  cdit.TakeReference(cd->NewIterator());
+  for (cdit->InitTraversal(); !cdit->IsDoneWithTraversal(); cdit->GoToNextItem())
+    {
+    if (vtkDataSet *ds = dynamic_cast<vtkDataSet*>(cdit->GetCurrentDataObject()))
+      {
+      SampledBlock block;
+      block.BlockId = std::max(0, int(cdit->GetCurrentFlatIndex() - 1));
+      block.Input = ds;
+      blocks.push_back(block);
+      }
+    }
+
+  // subsample the blocks
+  unsigned long seed = this->Seed;
+  VTKUtils::ThreadLoopFunction func = [&](unsigned int, unsigned int bi) -> int
+  {
+    SampledBlock &block = blocks[bi];
+    vtkDataSet *ds = block.Input;
+
+    block.PointIds = vtkIdListPtr::New();
+    block.CellIds = vtkIdListPtr::New();
+
+    vtkImageData *im = dynamic_cast<vtkImageData*>(ds);
+    if (im && (spec.Method == METHOD_STRIDE))
+      {
+      block.Output.TakeReference(strideImage(im, spec.Stride,
+        block.PointIds, block.CellIds));
+      return 0;
+      }
+
+    bool byPoint = particles(ds);
+    int assoc = byPoint ? vtkDataObject::POINT : vtkDataObject::CELL;
+    vtkIdType n = byPoint ? ds->GetNumberOfPoints() : ds->GetNumberOfCells();
+
+    vtkDataArray *weights = nullptr;
+    if (spec.Method == METHOD_IMPORTANCE)
+      {
+      vtkFieldData *atts = VTKUtils::GetAttributes(ds, spec.Association);
+      if (!atts || !(weights = atts->GetArray(spec.ArrayName.c_str())) ||
+        (weights->GetNumberOfTuples() != n) || (spec.Association != assoc))
+        {
+        SENSEI_ERROR("Block " << block.BlockId << " of mesh \"" << meshName
+          << "\" is sampled by " << (byPoint ? "point" : "cell") << " and has no "
+          << VTKUtils::GetAttributesName(assoc) << " data array \""
+          << spec.ArrayName << "\"")
+        return -1;
+        }
+      }
+
+    double bounds[6];
+    ds->GetBounds(bounds);
+
+    vtkIdList *cellPts = nullptr;
+    auto center = [&](vtkIdType i, double *x)
+    {
+      if (byPoint)
+        {
+        ds->GetPoint(i, x);
+        return;
+        }
+
+      // the average of the cell's points
+      ds->GetCellPoints(i, cellPts);
+      vtkIdType nPts = cellPts->GetNumberOfIds();
+
+      x[0] = x[1] = x[2] = 0.0;
+      for (vtkIdType j = 0; j < nPts; ++j)
+        {
+        double y[3];
+        ds->GetPoint(cellPts->GetId(j), y);
+        x[0] += y[0];
+        x[1] += y[1];
+        x[2] += y[2];
+        }
+
+      double s = nPts ? 1.0/nPts : 0.0;
+      x[0] *= s;
+      x[1] *= s;
+      x[2] *= s;
+    };
+
+    if (!byPoint && (spec.Method == METHOD_STRATIFIED))
+      cellPts = vtkIdList::New();
+
+    uint64_t key = mix(seed ^ mix(block.BlockId));
+
+    std::vector<vtkIdType> ids;
+    selectElements(spec, key, n, bounds, center, weights, ids);
+
+    if (cellPts)
+      cellPts->Delete();
+
+    if (byPoint)
+      {
+      vtkIdList *cellIds = block.CellIds;
+      block.Output.TakeReference(samplePoints(ds, ids, block.PointIds, cellIds));
+      if (!cellIds)
+        block.CellIds = nullptr;
+      }
+    else
+      {
+      block.Output.TakeReference(sampleCells(ds, ids, block.PointIds,
+        block.CellIds));
+      }
+
+    return 0;
+  };
+
+  if (VTKUtils::ParallelFor(VTKUtils::GetNumberOfThreads(), blocks.size(), func))
+    {
+    SENSEI_ERROR("Failed to subsample mesh \"" << meshName << "\"")
+    return nullptr;
+    }
+
+  // the subsampled mesh has the structure of the full mesh
+  SampledMesh &entry = this->Meshes[meshName];
+  entry.Input = input;
+  entry.Output.TakeReference(cd->NewInstance());
+  entry.Output->CopyStructure(cd);
+
+  unsigned int bi = 0;
+  for (cdit->InitTraversal(); !cdit->IsDoneWithTraversal(); cdit->GoToNextItem())
+    {
+    if (dynamic_cast<vtkDataSet*>(cdit->GetCurrentDataObject()))
+      entry.Output->SetDataSet(cdit, blocks[bi++].Output);
+    }
+
+  entry.Blocks.swap(blocks);
+
+  return &entry;
+}
+
+// --------------------------------------------------------------------------
+int SubsampleDataAdaptor::InternalsType::AddArrays(SampledMesh *entry,
+  int association, const std::vector<std::string> &arrayNames)
+{
+  VTKUtils::ThreadLoopFunction func = [&](unsigned int, unsigned int bi) -> int
+  {
+    SampledBlock &block = entry->Blocks[bi];
+
+    vtkFieldData *inAtts = VTKUtils::GetAttributes(block.Input, association);
+    vtkFieldData *outAtts = VTKUtils::GetAttributes(block.Output, association);
+    if (!inAtts || !outAtts)
+      return -1;
+
+    vtkIdList *ids = association == vtkDataObject::POINT ?
+      block.PointIds.GetPointer() : block.CellIds.GetPointer();
+
+    unsigned int nArrays = arrayNames.size();
+    for (unsigned int i = 0; i < nArrays; ++i)
+      {
+      const std::string &arrayName = arrayNames[i];
+
+      vtkAbstractArray *in = inAtts->GetAbstractArray(arrayName.c_str());
+      if (!in)
+        {
+        SENSEI_ERROR("Block " << block.BlockId << " has no "
+          << VTKUtils::GetAttributesName(association) << " data array \""
+          << arrayName << "\"")
+        return -1;
+        }
+
+      // field data is not subsampled
+      if (association == vtkDataObject::FIELD)
+        {
+        outAtts->AddArray(in);
+        continue;
+        }
+
+      if (!ids)
+        {
+        SENSEI_ERROR("Can not subsample " << VTKUtils::GetAttributesName(association)
+          << " data array \"" << arrayName << "\" on block " << block.BlockId)
+        return -1;
+        }
+
+      vtkAbstractArray *out = subsetArray(in, ids);
+      outAtts->AddArray(out);
+      out->Delete();
+      }
+
+    return 0;
+  };
+
+  return VTKUtils::ParallelFor(VTKUtils::GetNumberOfThreads(),
+    entry->Blocks.size(), func);
+}
+
+
+//----------------------------------------------------------------------------
+senseiNewMacro(SubsampleDataAdaptor);
+
+//----------------------------------------------------------------------------
+SubsampleDataAdaptor::SubsampleDataAdaptor()
+{
+  this->Internals = new InternalsType;
+}
+
+//----------------------------------------------------------------------------
+SubsampleDataAdaptor::~SubsampleDataAdaptor()
+{
+  delete this->Internals;
+}
+
+//----------------------------------------------------------------------------
+void SubsampleDataAdaptor::SetDataAdaptor(DataAdaptor *da)
+{
+  this->ClearCache();
+  this->Internals->Adaptor = da;
+}
+
+//----------------------------------------------------------------------------
+DataAdaptor *SubsampleDataAdaptor::GetDataAdaptor()
+{
+  return this->Internals->Adaptor.GetPointer();
+}
+
+//----------------------------------------------------------------------------
+int SubsampleDataAdaptor::SetStride(const std::string &meshName,
+  const std::array<int,3> &stride)
+{
+  if ((stride[0] < 1) || (stride[1] < 1) || (stride[2] < 1))
+    {
+    SENSEI_ERROR("Invalid stride " << stride[0] << ", " << stride[1]
+      << ", " << stride[2] << " for mesh \"" << meshName << "\"")
+    return -1;
+    }
+
+  SubsampleSpec spec;
+  spec.Method = METHOD_STRIDE;
+  spec.Stride = stride;
+
+  this->Internals->Specs[meshName] = spec;
+  this->Internals->Meshes.erase(meshName);
+
+  return 0;
+}
+
+//----------------------------------------------------------------------------
+int SubsampleDataAdaptor::SetRandom(const std::string &meshName,
+  double fraction)
+{
+  if ((fraction <= 0.0) || (fraction > 1.0))
+    {
+    SENSEI_ERROR("The fraction must be in (0, 1] not " << fraction)
+    return -1;
+    }
+
+  SubsampleSpec spec;
+  spec.Method = METHOD_RANDOM;
+  spec.Fraction = fraction;
+
+  this->Internals->Specs[meshName] = spec;
+  this->Internals->Meshes.erase(meshName);
+
+  return 0;
+}
+
+//----------------------------------------------------------------------------
+int SubsampleDataAdaptor::SetStratified(const std::string &meshName,
+  double fraction, int strata)
+{
+  if ((fraction <= 0.0) || (fraction > 1.0) || (strata < 1))
+    {
+    SENSEI_ERROR("The fraction must be in (0, 1] not " << fraction
+      << " and the number of strata positive not " << strata)
+    return -1;
+    }
+
+  SubsampleSpec spec;
+  spec.Method = METHOD_STRATIFIED;
+  spec.Fraction = fraction;
+  spec.Strata = strata;
+
+  this->Internals->Specs[meshName] = spec;
+  this->Internals->Meshes.erase(meshName);
+
+  return 0;
+}
+
+//----------------------------------------------------------------------------
+int SubsampleDataAdaptor::SetImportance(const std::string &meshName,
+  double fraction, int association, const std::string &arrayName)
+{
+  if ((fraction <= 0.0) || (fraction > 1.0) || arrayName.empty() ||
+    ((association != vtkDataObject::POINT) && (association != vtkDataObject::CELL)))
+    {
+    SENSEI_ERROR("Importance sampling needs a fraction in (0, 1] and a point"
+      " or cell data array")
+    return -1;
+    }
+
+  SubsampleSpec spec;
+  spec.Method = METHOD_IMPORTANCE;
+  spec.Fraction = fraction;
+  spec.Association = association;
+  spec.ArrayName = arrayName;
+
+  this->Internals->Specs[meshName] = spec;
+  this->Internals->Meshes.erase(meshName);
+
+  return 0;
+}
+
+//----------------------------------------------------------------------------
+void SubsampleDataAdaptor::RemoveMesh(const std::string &meshName)
+{
+  this->Internals->Specs.erase(meshName);
+  this->Internals->Meshes.erase(meshName);
+}
+
+//----------------------------------------------------------------------------
+bool SubsampleDataAdaptor::Subsampled(const std::string &meshName) const
+{
+  return this->Internals->Specs.count(meshName);
+}
+
+//----------------------------------------------------------------------------
+void SubsampleDataAdaptor::SetSeed(unsigned long seed)
+{
+  this->Internals->Seed = seed;
+  this->Internals->Meshes.clear();
+}
+
+//----------------------------------------------------------------------------
+int SubsampleDataAdaptor::Initialize(pugi::xml_node node)
+{
+  this->SetSeed(node.attribute("seed").as_uint(0));
+
+  for (pugi::xml_node meshNode = node.child("mesh");
+    meshNode; meshNode = meshNode.next_sibling("mesh"))
+    {
+    if (!meshNode.attribute("name"))
+      {
+      SENSEI_ERROR("A subsampled mesh is missing the name attribute")
+      return -1;
+      }
+
+    std::string meshName = meshNode.attribute("name").value();
+    std::string method = meshNode.attribute("method").as_string("stride");
+
+    double fraction = 1.0;
+    if (parseFraction(meshNode.attribute("fraction").as_string("1"), fraction))
+      return -1;
+
+    int ierr = 0;
+    if (method == "stride")
+      {
+      std::string strideStr = meshNode.attribute("stride").as_string("2");
+      std::replace(strideStr.begin(), strideStr.end(), ',', ' ');
+
+      std::vector<int> vals;
+      std::istringstream iss(strideStr);
+      int val = 0;
+      while (iss >> val)
+        vals.push_back(val);
+
+      if ((vals.size() != 1) && (vals.size() != 3))
+        {
+        SENSEI_ERROR("Invalid stride \"" << strideStr << "\" for mesh \""
+          << meshName << "\"")
+        return -1;
+        }
+
+      std::array<int,3> stride{{vals[0], vals[0], vals[0]}};
+      if (vals.size() == 3)
+        stride = {{vals[0], vals[1], vals[2]}};
+
+      ierr = this->SetStride(meshName, stride);
+      }
+    else if (method == "random")
+      {
+      ierr = this->SetRandom(meshName, fraction);
+      }
+    else if (method == "stratified")
+      {
+      ierr = this->SetStratified(meshName, fraction,
+        meshNode.attribute("strata").as_int(8));
+      }
+    else if (method == "importance")
+      {
+      int association = 0;
+      std::string assocStr = meshNode.attribute("association").as_string("point");
+      if (VTKUtils::GetAssociation(assocStr, association))
+        return -1;
+
+      ierr = this->SetImportance(meshName, fraction, association,
+        meshNode.attribute("array").as_string(""));
+      }
+    else
+      {
+      SENSEI_ERROR("Invalid subsampling method \"" << method
+        << "\" for mesh \"" << meshName << "\"")
+      return -1;
+      }
+
+    if (ierr)
+      {
+      SENSEI_ERROR("Failed to configure subsampling of mesh \""
+        << meshName << "\"")
+      return -1;
+      }
+    }
+
+  return 0;
+}
+
+//----------------------------------------------------------------------------
+void SubsampleDataAdaptor::ClearCache()
+{
+  this->Internals->Meshes.clear();
+}
+
+//----------------------------------------------------------------------------
+int SubsampleDataAdaptor::GetNumberOfMeshes(unsigned int &numMeshes)
+{
+  numMeshes = 0;
+
+  if (!this->Internals->Adaptor)
+    {
+    SENSEI_ERROR("No data adaptor was set")
+    return -1;
+    }
+
+  return this->Internals->Adaptor->GetNumberOfMeshes(numMeshes);
+}
+
+//----------------------------------------------------------------------------
+int SubsampleDataAdaptor::GetMeshMetadata(unsigned int id,
+  MeshMetadataPtr &metadata)
+{
+  if (!this->Internals->Adaptor)
+    {
+    SENSEI_ERROR("No data adaptor was set")
+    return -1;
+    }
+
+  // the sizes of strided images are computed from the extents
+  MeshMetadataFlags flags = metadata->Flags;
+  if (flags.BlockSizeSet())
+    metadata->Flags.SetBlockExtents();
+
+  int ierr = this->Internals->Adaptor->GetMeshMetadata(id, metadata);
+
+  metadata->Flags = flags;
+
+  if (ierr)
+    return -1;
+
+  std::map<std::string, SubsampleSpec>::iterator it =
+    this->Internals->Specs.find(metadata->MeshName);
+
+  if (it == this->Internals->Specs.end())
+    return 0;
+
+  if (VTKUtils::AMR(metadata))
+    {
+    SENSEI_ERROR("Subsampling AMR mesh \"" << metadata->MeshName
+      << "\" is not supported")
+    return -1;
+    }
+
+  const SubsampleSpec &spec = it->second;
+  unsigned int nBlocks = metadata->BlockNumPoints.size();
+
+  bool image = (metadata->BlockType == VTK_IMAGE_DATA) ||
+    (metadata->BlockType == VTK_UNIFORM_GRID);
+
+  if (image && (spec.Method == METHOD_STRIDE))
+    {
+    int s[3];
+    strideExtent(metadata->Extent.data(), spec.Stride,
+      metadata->Extent.data(), s);
+
+    unsigned int nExts = metadata->BlockExtents.size();
+    for (unsigned int i = 0; i < nExts; ++i)
+      {
+      int *ext = metadata->BlockExtents[i].data();
+      if (!strideExtent(ext, spec.Stride, ext, s))
+        {
+        ext[0] = ext[2] = ext[4] = 0;
+        ext[1] = ext[3] = ext[5] = -1;
+        }
+      }
+
+    if (flags.BlockSizeSet() && (nExts == nBlocks))
+      {
+      metadata->NumPoints = 0;
+      metadata->NumCells = 0;
+      for (unsigned int i = 0; i < nBlocks; ++i)
+        {
+        extentSize(metadata->BlockExtents[i].data(),
+          metadata->BlockNumPoints[i], metadata->BlockNumCells[i]);
+
+        metadata->NumPoints += metadata->BlockNumPoints[i];
+        metadata->NumCells += metadata->BlockNumCells[i];
+        }
+
+      flags.ClearBlockSize();
+      }
+
+    if (!metadata->Flags.BlockExtentsSet())
+      metadata->BlockExtents.clear();
+    }
+  else
+    {
+    // sampled by element
+    int blockType = metadata->BlockType;
+    if (blockType != VTK_POLY_DATA)
+      metadata->BlockType = VTK_UNSTRUCTURED_GRID;
+
+    if ((blockType == VTK_IMAGE_DATA) || (blockType == VTK_UNIFORM_GRID) ||
+      (blockType == VTK_RECTILINEAR_GRID))
+      metadata->CoordinateType = VTK_DOUBLE;
+
+    metadata->Extent = {{0, -1, 0, -1, 0, -1}};
+    metadata->BlockExtents.clear();
+    }
+
+  if (!flags.BlockSizeSet())
+    return 0;
+
+  // the sizes are only known by sampling
+  SampledMesh *entry = this->Internals->GetEntry(metadata->MeshName);
+  if (!entry)
+    return -1;
+
+  std::map<int, unsigned int> blockIndex;
+  unsigned int nEntryBlocks = entry->Blocks.size();
+  for (unsigned int i = 0; i < nEntryBlocks; ++i)
+    blockIndex[entry->Blocks[i].BlockId] = i;
+
+  bool byId = metadata->BlockIds.size() == nBlocks;
+
+  metadata->NumPoints = 0;
+  metadata->NumCells = 0;
+  metadata->CellArraySize = 0;
+  metadata->BlockCellArraySize.resize(nBlocks);
+
+  for (unsigned int i = 0; i < nBlocks; ++i)
+    {
+    unsigned int bi = i;
+    if (byId)
+      {
+      std::map<int, unsigned int>::iterator bit =
+        blockIndex.find(metadata->BlockIds[i]);
+
+      // a block on another rank
+      if (bit == blockIndex.end())
+        continue;
+
+      bi = bit->second;
+      }
+    else if (i >= nEntryBlocks)
+      {
+      SENSEI_ERROR("The metadata of mesh \"" << metadata->MeshName
+        << "\" has more blocks than the mesh")
+      return -1;
+      }
+
+    vtkDataSet *ds = entry->Blocks[bi].Output;
+
+    long cellArraySize = 0;
+    if (vtkUnstructuredGrid *ug = dynamic_cast<vtkUnstructuredGrid*>(ds))
+      cellArraySize = ug->GetCells() ? ug->GetCells()->GetSize() : 0;
+    else if (vtkPolyData *pd = dynamic_cast<vtkPolyData*>(ds))
+      cellArraySize = pd->GetVerts()->GetSize() + pd->GetLines()->GetSize()
+        + pd->GetPolys()->GetSize() + pd->GetStrips()->GetSize();
+
+    metadata->BlockNumPoints[i] = ds->GetNumberOfPoints();
+    metadata->BlockNumCells[i] = ds->GetNumberOfCells();
+    metadata->BlockCellArraySize[i] = cellArraySize;
+
+    metadata->NumPoints += metadata->BlockNumPoints[i];
+    metadata->NumCells += metadata->BlockNumCells[i];
+    metadata->CellArraySize += cellArraySize;
+    }
+
+  return 0;
+}
+
+//----------------------------------------------------------------------------
+int SubsampleDataAdaptor::GetMesh(const std::string &meshName,
+  bool structureOnly, vtkDataObject *&mesh)
+{
+  mesh = nullptr;
+
+  vtkCompositeDataSet *cd = nullptr;
+  if (this->GetMesh(meshName, structureOnly, cd))
+    return -1;
+
+  mesh = cd;
+
+  return 0;
+}
+
+//----------------------------------------------------------------------------
+int SubsampleDataAdaptor::GetMesh(const std::string &meshName,
+  bool structureOnly, vtkCompositeDataSet *&mesh)
+{
+  mesh = nullptr;
+
+  if (!this->Internals->Adaptor)
+    {
+    SENSEI_ERROR("No data adaptor was set")
+    return -1;
+    }
+
+  if (!this->Subsampled(meshName))
+    return this->Internals->Adaptor->GetMesh(meshName, structureOnly, mesh);
+
+  SampledMesh *entry = this->Internals->GetEntry(meshName);
+  if (!entry)
+    return -1;
+
+  // the cache holds one reference and the caller the other
+  mesh = entry->Output.GetPointer();
+  mesh->Register(nullptr);
+
+  return 0;
+}
+
+//----------------------------------------------------------------------------
+int SubsampleDataAdaptor::GetMesh(const std::string &meshName,
+  bool structureOnly, const std::vector<int> &blockIds,
+  vtkCompositeDataSet *&mesh)
+{
+  mesh = nullptr;
+
+  if (!this->Internals->Adaptor)
+    {
+    SENSEI_ERROR("No data adaptor was set")
+    return -1;
+    }
+
+  if (!this->Subsampled(meshName))
+    return this->Internals->Adaptor->GetMesh(meshName, structureOnly,
+      blockIds, mesh);
+
+  // a subset of the blocks of the subsampled mesh
+  return this->Superclass::GetMesh(meshName, structureOnly, blockIds, mesh);
+}
+
+//----------------------------------------------------------------------------
+int SubsampleDataAdaptor::AddGhostNodesArray(vtkDataObject* mesh,
+  const std::string &meshName)
+{
+  if (!this->Internals->Adaptor)
+    {
+    SENSEI_ERROR("No data adaptor was set")
+    return -1;
+    }
+
+  if (!this->Subsampled(meshName))
+    return this->Internals->Adaptor->AddGhostNodesArray(mesh, meshName);
+
+  SampledMesh *entry = this->Internals->GetEntry(meshName);
+  if (!entry)
+    return -1;
+
+  if (entry->GhostNodes)
+    return 0;
+
+  if (this->Internals->Adaptor->AddGhostNodesArray(entry->Input, meshName) ||
+    this->Internals->AddArrays(entry, vtkDataObject::POINT,
+      {vtkDataSetAttributes::GhostArrayName()}))
+    {
+    SENSEI_ERROR("Failed to add ghost nodes to mesh \"" << meshName << "\"")
+    return -1;
+    }
+
+  entry->GhostNodes = true;
+
+  return 0;
+}
+
+//----------------------------------------------------------------------------
+int SubsampleDataAdaptor::AddGhostCellsArray(vtkDataObject* mesh,
+  const std::string &meshName)
+{
+  if (!this->Internals->Adaptor)
+    {
+    SENSEI_ERROR("No data adaptor was set")
+    return -1;
+    }
+
+  if (!this->Subsampled(meshName))
+    return this->Internals->Adaptor->AddGhostCellsArray(mesh, meshName);
+
+  SampledMesh *entry = this->Internals->GetEntry(meshName);
+  if (!entry)
+    return -1;
+
+  if (entry->GhostCells)
+    return 0;
+
+  if (this->Internals->Adaptor->AddGhostCellsArray(entry->Input, meshName) ||
+    this->Internals->AddArrays(entry, vtkDataObject::CELL,
+      {vtkDataSetAttributes::GhostArrayName()}))
+    {
+    SENSEI_ERROR("Failed to add ghost cells to mesh \"" << meshName << "\"")
+    return -1;
+    }
+
+  entry->GhostCells = true;
+
+  return 0;
+}
+
+//----------------------------------------------------------------------------
+int SubsampleDataAdaptor::AddArray(vtkDataObject* mesh,
+  const std::string &meshName, int association, const std::string &arrayName)
+{
+  return this->AddArrays(mesh, meshName, association,
+    std::vector<std::string>(1, arrayName));
+}
+
+//----------------------------------------------------------------------------
+int SubsampleDataAdaptor::AddArrays(vtkDataObject* mesh,
+  const std::string &meshName, int association,
+  const std::vector<std::string> &arrayNames)
+{
+  if (!this->Internals->Adaptor)
+    {
+    SENSEI_ERROR("No data adaptor was set")
+    return -1;
+    }
+
+  if (!this->Subsampled(meshName))
+    return this->Internals->Adaptor->AddArrays(mesh, meshName,
+      association, arrayNames);
+
+  SampledMesh *entry = this->Internals->GetEntry(meshName);
+  if (!entry)
+    return -1;
+
+  // the arrays not yet subsampled are fetched in a single batch. the
+  // caller's object shares its blocks with the subsampled mesh
+  std::vector<std::string> missing;
+  unsigned int nArrays = arrayNames.size();
+  for (unsigned int i = 0; i < nArrays; ++i)
+    {
+    if (!entry->Arrays.count(std::make_pair(association, arrayNames[i])))
+      missing.push_back(arrayNames[i]);
+    }
+
+  if (missing.empty())
+    return 0;
+
+  if (this->Internals->Adaptor->AddArrays(entry->Input, meshName,
+    association, missing) ||
+    this->Internals->AddArrays(entry, association, missing))
+    {
+    SENSEI_ERROR("Failed to add " << VTKUtils::GetAttributesName(association)
+      << " data arrays to mesh \"" << meshName << "\"")
+    return -1;
+    }
+
+  unsigned int nMissing = missing.size();
+  for (unsigned int i = 0; i < nMissing; ++i)
+    entry->Arrays.insert(std::make_pair(association, missing[i]));
+
+  return 0;
+}
+
+//----------------------------------------------------------------------------
+int SubsampleDataAdaptor::GetArrayZeroCopy(const std::string &meshName,
+  int association, const std::string &arrayName, int &zeroCopy)
+{
+  if (!this->Internals->Adaptor)
+    {
+    SENSEI_ERROR("No data adaptor was set")
+    return -1;
+    }
+
+  // subsampled arrays are copies
+  if (this->Subsampled(meshName))
+    {
+    zeroCopy = 0;
+    return 0;
+    }
+
+  return this->Internals->Adaptor->GetArrayZeroCopy(meshName,
+    association, arrayName, zeroCopy);
+}
+
+//----------------------------------------------------------------------------
+int SubsampleDataAdaptor::ReleaseData()
+{
+  this->ClearCache();
+
+  if (this->Internals->Adaptor)
+    return this->Internals->Adaptor->ReleaseData();
+
+  return 0;
+}
+
+//----------------------------------------------------------------------------
+double SubsampleDataAdaptor::GetDataTime()
+{
+  return this->Internals->Adaptor ?
+    this->Internals->Adaptor->GetDataTime() : this->Superclass::GetDataTime();
+}
+
+//----------------------------------------------------------------------------
+void SubsampleDataAdaptor::SetDataTime(double time)
+{
+  if (this->Internals->Adaptor)
+    this->Internals->Adaptor->SetDataTime(time);
+  else
+    this->Superclass::SetDataTime(time);
+}
+
+//----------------------------------------------------------------------------
+long SubsampleDataAdaptor::GetDataTimeStep()
+{
+  return this->Internals->Adaptor ?
+    this->Internals->Adaptor->GetDataTimeStep() :
+    this->Superclass::GetDataTimeStep();
+}
+
+//----------------------------------------------------------------------------
+void SubsampleDataAdaptor::SetDataTimeStep(long index)
+{
+  if (this->Internals->Adaptor)
+    this->Internals->Adaptor->SetDataTimeStep(index);
+  else
+    this->Superclass::SetDataTimeStep(index);
+}
+
+//----------------------------------------------------------------------------
+void SubsampleDataAdaptor::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+
+  std::map<std::string, SubsampleSpec>::iterator it = this->Internals->Specs.begin();
+  std::map<std::string, SubsampleSpec>::iterator end = this->Internals->Specs.end();
+  for (; it != end; ++it)
+    {
+    const SubsampleSpec &spec = it->second;
+    os << indent << it->first << ": method " << spec.Method << " stride "
+      << spec.Stride[0] << ", " << spec.Stride[1] << ", " << spec.Stride[2]
+      << " fraction " << spec.Fraction << " strata " << spec.Strata
+      << " array " << spec.ArrayName << endl;
+    }
+}
+
+}
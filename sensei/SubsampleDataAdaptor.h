@@ -0,0 +1,162 @@
+#ifndef sensei_SubsampleDataAdaptor_h
+#define sensei_SubsampleDataAdaptor_h
+
+#include "DataAdaptor.h"
+
+#include <array>
+#include <string>
+
+namespace pugi { class xml_node; }
+
+namespace sensei
+{
+
+/// @brief A DataAdaptor that presents a decimated view of another adaptor's
+/// meshes.
+///
+/// SubsampleDataAdaptor wraps another data adaptor. Meshes that have not
+/// been configured for subsampling are passed through untouched. For the
+/// others the full mesh is fetched from the wrapped adaptor once per step
+/// and a subset of its points or cells is selected on each block. The
+/// arrays and ghost arrays that callers add are fetched on the full mesh
+/// and only the selected tuples are copied to the subsampled mesh. Like
+/// CachingDataAdaptor, callers share the subsampled mesh for the rest of
+/// the step and must not modify it beyond adding arrays through this
+/// adaptor.
+///
+/// The following methods are available:
+///
+///   stride      vtkImageData blocks keep every n'th point along each axis
+///               and remain vtkImageData. The points kept are those whose
+///               global index is a multiple of the stride, so neighboring
+///               blocks stay consistent. Other blocks keep every n'th
+///               element, n being the product of the strides, such that
+///               a stride of 2 keeps about 1/8 of the data of any mesh.
+///   random      each element is kept with the given probability.
+///   stratified  the block's bounds are split into strata^3 bins and a
+///               fraction of the elements of each non-empty bin is kept,
+///               at least one, so that sparse regions remain represented.
+///   importance  each element is kept with a probability proportional to
+///               the magnitude of the named array, scaled so that about the
+///               given fraction of the elements is kept.
+///
+/// Blocks that have no cells, or only vertex cells, such as particles are
+/// sampled by point, others by cell. vtkPolyData blocks remain vtkPolyData,
+/// all other blocks sampled by element become vtkUnstructuredGrid holding
+/// the selected cells and the points they use. The random choices are a
+/// function of the seed, block id, and element index only, thus the same
+/// elements are selected each step when the mesh does not change.
+///
+/// The metadata of a subsampled mesh reports the new block type, extents,
+/// and sizes. The sizes of meshes sampled at random are only known by
+/// sampling, requesting them generates the subsampled mesh. Bounds and
+/// array ranges are those of the full mesh. AMR meshes are not supported.
+class SubsampleDataAdaptor : public DataAdaptor
+{
+public:
+  static SubsampleDataAdaptor *New();
+  senseiTypeMacro(SubsampleDataAdaptor, DataAdaptor);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  enum {METHOD_STRIDE=0, METHOD_RANDOM=1, METHOD_STRATIFIED=2,
+    METHOD_IMPORTANCE=3};
+
+  /// @brief Set the adaptor to subsample. This clears the cache. The
+  /// communicator is not changed.
+  void SetDataAdaptor(DataAdaptor *da);
+  DataAdaptor *GetDataAdaptor();
+
+  /// @brief Keep every stride[i]'th point along axis i of the named mesh.
+  int SetStride(const std::string &meshName, const std::array<int,3> &stride);
+
+  /// @brief Keep a random fraction, in (0, 1], of the named mesh's elements.
+  int SetRandom(const std::string &meshName, double fraction);
+
+  /// @brief Keep a fraction of the elements in each of strata^3 spatial bins.
+  int SetStratified(const std::string &meshName, double fraction, int strata);
+
+  /// @brief Keep elements with a probability proportional to the magnitude
+  /// of the named array. The array's association must be that of the
+  /// sampled elements.
+  int SetImportance(const std::string &meshName, double fraction,
+    int association, const std::string &arrayName);
+
+  /// @brief Stop subsampling the named mesh
+  void RemoveMesh(const std::string &meshName);
+
+  /// @brief Returns true if the named mesh is subsampled
+  bool Subsampled(const std::string &meshName) const;
+
+  /// @brief Set the seed of the random choices
+  void SetSeed(unsigned long seed);
+
+  /// @brief Configure from XML. The node contains a mesh element per
+  /// subsampled mesh:
+  ///
+  ///   <parent seed="0">
+  ///     <mesh name="mesh" method="stride" stride="2,2,1"/>
+  ///     <mesh name="particles" method="random" fraction="12.5%"/>
+  ///     <mesh name="cells" method="stratified" fraction="0.1" strata="8"/>
+  ///     <mesh name="ions" method="importance" fraction="0.05"
+  ///       array="energy" association="point"/>
+  ///   </parent>
+  ///
+  /// The stride is either a single value used for all axes or three.
+  int Initialize(pugi::xml_node node);
+
+  /// @brief Ends the step. Drops the subsampled meshes without releasing
+  /// the wrapped adaptor's data.
+  void ClearCache();
+
+  // DataAdaptor API, see DataAdaptor for details
+  int GetNumberOfMeshes(unsigned int &numMeshes) override;
+
+  int GetMeshMetadata(unsigned int id, MeshMetadataPtr &metadata) override;
+
+  int GetMesh(const std::string &meshName, bool structureOnly,
+    vtkDataObject *&mesh) override;
+
+  int GetMesh(const std::string &meshName, bool structureOnly,
+    vtkCompositeDataSet *&mesh) override;
+
+  int GetMesh(const std::string &meshName, bool structureOnly,
+    const std::vector<int> &blockIds, vtkCompositeDataSet *&mesh) override;
+
+  int AddGhostNodesArray(vtkDataObject* mesh,
+    const std::string &meshName) override;
+
+  int AddGhostCellsArray(vtkDataObject* mesh,
+    const std::string &meshName) override;
+
+  int AddArray(vtkDataObject* mesh, const std::string &meshName,
+    int association, const std::string &arrayName) override;
+
+  int AddArrays(vtkDataObject* mesh, const std::string &meshName,
+    int association, const std::vector<std::string> &arrayNames) override;
+
+  int GetArrayZeroCopy(const std::string &meshName, int association,
+    const std::string &arrayName, int &zeroCopy) override;
+
+  int ReleaseData() override;
+
+  double GetDataTime() override;
+  void SetDataTime(double time) override;
+
+  long GetDataTimeStep() override;
+  void SetDataTimeStep(long index) override;
+
+protected:
+  SubsampleDataAdaptor();
+  ~SubsampleDataAdaptor();
+
+  SubsampleDataAdaptor(const SubsampleDataAdaptor&) = delete;
+  void operator=(const SubsampleDataAdaptor&) = delete;
+
+private:
+  struct InternalsType;
+  InternalsType *Internals;
+};
+
+}
+
+#endif
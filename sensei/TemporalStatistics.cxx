@@ -0,0 +1,483 @@
+#include "TemporalStatistics.h"
+#include "DataAdaptor.h"
+#include "MeshMetadata.h"
+#include "MeshMetadataMap.h"
+#include "Profiler.h"
+#include "VTKDataAdaptor.h"
+#include "VTKUtils.h"
+#include "Error.h"
+
+#include <vtkCompositeDataSet.h>
+#include <vtkDataObject.h>
+#include <vtkDataSet.h>
+#include <vtkDoubleArray.h>
+#include <vtkFieldData.h>
+#include <vtkMultiBlockDataSet.h>
+#include <vtkObjectFactory.h>
+#include <vtkSmartPointer.h>
+#ifdef ENABLE_VTK_GENERIC_ARRAYS
+#include <vtkAOSDataArrayTemplate.h>
+#include <vtkArrayDispatch.h>
+#else
+#include <vtkDataArrayDispatcher.h>
+#endif
+
+#include <algorithm>
+#include <map>
+#include <vector>
+
+namespace sensei
+{
+namespace
+{
+// The running statistics of one array on one block
+struct Accumulator
+{
+  Accumulator() : Count(0), NumComponents(0), NumValues(0) {}
+
+  // size for the array, resetting the statistics if its shape changed
+  bool Resize(vtkIdType nValues, int nComps)
+  {
+    if ((nValues == this->NumValues) && (nComps == this->NumComponents))
+      return false;
+
+    this->Count = 0;
+    this->NumValues = nValues;
+    this->NumComponents = nComps;
+
+    size_t n = nValues*nComps;
+    this->Mean.assign(n, 0.0);
+    this->M2.assign(n, 0.0);
+    this->Min.assign(n, 0.0);
+    this->Max.assign(n, 0.0);
+    this->EMA.assign(n, 0.0);
+
+    return true;
+  }
+
+  long Count;
+  int NumComponents;
+  vtkIdType NumValues;
+  std::vector<double> Mean;
+  std::vector<double> M2;
+  std::vector<double> Min;
+  std::vector<double> Max;
+  std::vector<double> EMA;
+};
+
+// Welford's update of an accumulator with the values of the current step.
+// the loops have no branches so that the compiler can vectorize them. To
+// be used with vtkArrayDispatch or vtkDataArrayDispatcher.
+struct UpdateWorker
+{
+  Accumulator *Acc;
+  double Alpha;
+
+  template <typename T>
+  void Update(const T *vals)
+  {
+    Accumulator &a = *this->Acc;
+    size_t n = a.NumValues*a.NumComponents;
+
+    a.Count += 1;
+
+    double *mean = a.Mean.data();
+    double *m2 = a.M2.data();
+    double *mn = a.Min.data();
+    double *mx = a.Max.data();
+    double *ema = a.EMA.data();
+
+    if (a.Count == 1)
+      {
+      for (size_t i = 0; i < n; ++i)
+        {
+        double x = static_cast<double>(vals[i]);
+        mean[i] = x;
+        mn[i] = x;
+        mx[i] = x;
+        ema[i] = x;
+        }
+      return;
+      }
+
+    double invCount = 1.0/a.Count;
+    for (size_t i = 0; i < n; ++i)
+      {
+      double x = static_cast<double>(vals[i]);
+      double d = x - mean[i];
+      mean[i] += d*invCount;
+      m2[i] += d*(x - mean[i]);
+      mn[i] = std::min(mn[i], x);
+      mx[i] = std::max(mx[i], x);
+      }
+
+    if (this->Alpha > 0.0)
+      {
+      double alpha = this->Alpha;
+      for (size_t i = 0; i < n; ++i)
+        ema[i] += alpha*(static_cast<double>(vals[i]) - ema[i]);
+      }
+  }
+
+#ifdef ENABLE_VTK_GENERIC_ARRAYS
+  template <typename T>
+  void operator()(vtkAOSDataArrayTemplate<T> *array)
+  {
+    this->Update(array->GetPointer(0));
+  }
+
+  // arrays with other memory layouts are copied first
+  template <typename ArrayT>
+  void operator()(ArrayT *array)
+  {
+    using T = typename ArrayT::ValueType;
+    int nComps = array->GetNumberOfComponents();
+    vtkIdType nTups = array->GetNumberOfTuples();
+    std::vector<T> tmp(nTups*nComps);
+    for (vtkIdType i = 0; i < nTups; ++i)
+      for (int j = 0; j < nComps; ++j)
+        tmp[i*nComps + j] = array->GetTypedComponent(i, j);
+    this->Update(tmp.data());
+  }
+#else
+  template <typename T>
+  void operator()(const vtkDataArrayDispatcherPointer<T>& array)
+  {
+    this->Update(array.RawPointer);
+  }
+#endif
+};
+
+// wrap a vector of statistics in a VTK array
+vtkDoubleArray *newArray(const std::string &name, const Accumulator &acc,
+  const std::vector<double> &vals)
+{
+  vtkDoubleArray *da = vtkDoubleArray::New();
+  da->SetName(name.c_str());
+  da->SetNumberOfComponents(acc.NumComponents);
+  da->SetNumberOfTuples(acc.NumValues);
+  std::copy(vals.begin(), vals.end(), da->GetPointer(0));
+  return da;
+}
+}
+
+// each block has the structure of the mesh, used when the statistics are
+// written, and an accumulator per array
+struct TemporalStatistics::InternalsType
+{
+  InternalsType() : Association(vtkDataObject::POINT), Alpha(0.0),
+    Interval(0), NumBlocks(0), StepsSinceWrite(0), LastStep(0),
+    LastTime(0.0) {}
+
+  struct Block
+  {
+    vtkSmartPointer<vtkDataSet> Structure;
+    std::vector<Accumulator> Arrays;
+  };
+
+  std::string MeshName;
+  int Association;
+  std::vector<std::string> ArrayNames;
+  double Alpha;
+  int Interval;
+  vtkSmartPointer<AnalysisAdaptor> Writer;
+
+  // indexed by block id
+  std::map<int, Block> Blocks;
+  int NumBlocks;
+
+  long StepsSinceWrite;
+  long LastStep;
+  double LastTime;
+};
+
+//-----------------------------------------------------------------------------
+senseiNewMacro(TemporalStatistics);
+
+//-----------------------------------------------------------------------------
+TemporalStatistics::TemporalStatistics() : Internals(new InternalsType)
+{
+}
+
+//-----------------------------------------------------------------------------
+TemporalStatistics::~TemporalStatistics()
+{
+  delete this->Internals;
+}
+
+//-----------------------------------------------------------------------------
+void TemporalStatistics::Initialize(const std::string &meshName,
+  int association, const std::vector<std::string> &arrayNames, double alpha,
+  int interval)
+{
+  this->Internals->MeshName = meshName;
+  this->Internals->Association = association;
+  this->Internals->ArrayNames = arrayNames;
+  this->Internals->Alpha = std::max(0.0, std::min(alpha, 1.0));
+  this->Internals->Interval = std::max(interval, 0);
+}
+
+//-----------------------------------------------------------------------------
+void TemporalStatistics::SetWriter(AnalysisAdaptor *writer)
+{
+  this->Internals->Writer = writer;
+}
+
+//-----------------------------------------------------------------------------
+AnalysisAdaptor *TemporalStatistics::GetWriter()
+{
+  return this->Internals->Writer.GetPointer();
+}
+
+//-----------------------------------------------------------------------------
+int TemporalStatistics::GetThreadSafe()
+{
+  AnalysisAdaptor *writer = this->Internals->Writer.GetPointer();
+  return writer ? writer->GetThreadSafe() : 1;
+}
+
+//-----------------------------------------------------------------------------
+bool TemporalStatistics::Execute(DataAdaptor* data)
+{
+  TimeEvent<128> mark("TemporalStatistics::Execute");
+
+  InternalsType &internals = *this->Internals;
+
+  // see what the simulation is providing
+  MeshMetadataMap mdMap;
+  if (mdMap.Initialize(data))
+    {
+    SENSEI_ERROR("Failed to get metadata")
+    return false;
+    }
+
+  MeshMetadataPtr mmd;
+  if (mdMap.GetMeshMetadata(internals.MeshName, mmd))
+    {
+    SENSEI_ERROR("Failed to get metadata for mesh \""
+      << internals.MeshName << "\"")
+    return false;
+    }
+
+  // the structure is needed to write the statistics
+  vtkDataObject* mesh = nullptr;
+  if (data->GetMesh(internals.MeshName, false, mesh))
+    {
+    SENSEI_ERROR("Failed to get mesh \"" << internals.MeshName << "\"")
+    return false;
+    }
+
+  if (mesh && data->AddArrays(mesh, internals.MeshName,
+    internals.Association, internals.ArrayNames))
+    {
+    SENSEI_ERROR(<< data->GetClassName() << " failed to add "
+      << (internals.Association == vtkDataObject::POINT ? "point" : "cell")
+      << " data arrays to mesh \"" << internals.MeshName << "\"")
+    mesh->Delete();
+    return false;
+    }
+
+  internals.NumBlocks = mmd->NumBlocks;
+
+  if (mesh)
+    {
+    // a lone dataset is the rank'th block
+    vtkCompositeDataSetPtr cd =
+      VTKUtils::AsCompositeData(this->GetCommunicator(), mesh, true);
+
+    unsigned int nArrays = internals.ArrayNames.size();
+
+    // create or update the blocks. this is done up front so that the
+    // blocks can be processed in parallel
+    VTKUtils::ThreadDatasetFunction initBlock = [&](unsigned int,
+      unsigned int flatIndex, vtkDataSet *ds) -> int
+      {
+      InternalsType::Block &block = internals.Blocks[flatIndex - 1];
+      block.Arrays.resize(nArrays);
+
+      bool changed = !block.Structure;
+      for (unsigned int i = 0; i < nArrays; ++i)
+        {
+        vtkDataArray *da = ds->GetAttributesAsFieldData(internals.Association)->
+          GetArray(internals.ArrayNames[i].c_str());
+        if (!da)
+          {
+          SENSEI_ERROR("Block " << flatIndex - 1 << " has no array \""
+            << internals.ArrayNames[i] << "\"")
+          return -1;
+          }
+
+        if (block.Arrays[i].Resize(da->GetNumberOfTuples(),
+          da->GetNumberOfComponents()) && block.Structure)
+          {
+          SENSEI_WARNING("Array \"" << internals.ArrayNames[i]
+            << "\" on block " << flatIndex - 1
+            << " changed shape, its statistics are reset")
+          changed = true;
+          }
+        }
+
+      if (changed)
+        {
+        vtkDataSet *structure = ds->NewInstance();
+        structure->CopyStructure(ds);
+        block.Structure.TakeReference(structure);
+        }
+
+      return 0;
+      };
+
+    // accumulate the statistics
+    VTKUtils::ThreadDatasetFunction update = [&](unsigned int,
+      unsigned int flatIndex, vtkDataSet *ds) -> int
+      {
+      // the blocks were created by initBlock, the map must not be
+      // modified while the threads look them up
+      auto it = internals.Blocks.find(flatIndex - 1);
+      if (it == internals.Blocks.end())
+        {
+        SENSEI_ERROR("Block " << flatIndex - 1 << " was not initialized")
+        return -1;
+        }
+
+      InternalsType::Block &block = it->second;
+      for (unsigned int i = 0; i < nArrays; ++i)
+        {
+        vtkDataArray *da = ds->GetAttributesAsFieldData(internals.Association)->
+          GetArray(internals.ArrayNames[i].c_str());
+
+        UpdateWorker worker;
+        worker.Acc = &block.Arrays[i];
+        worker.Alpha = internals.Alpha;
+
+#ifdef ENABLE_VTK_GENERIC_ARRAYS
+        vtkArrayDispatch::Dispatch::Execute(da, worker);
+#else
+        vtkDataArrayDispatcher<UpdateWorker> dispatcher(worker);
+        dispatcher.Go(da);
+#endif
+        }
+      return 0;
+      };
+
+    if (VTKUtils::ParallelApply(1, cd, initBlock) ||
+      VTKUtils::ParallelApply(VTKUtils::GetNumberOfThreads(), cd, update))
+      {
+      SENSEI_ERROR("Failed to update the statistics on mesh \""
+        << internals.MeshName << "\"")
+      return false;
+      }
+    }
+
+  internals.LastStep = data->GetDataTimeStep();
+  internals.LastTime = data->GetDataTime();
+  internals.StepsSinceWrite += 1;
+
+  if ((internals.Interval > 0) &&
+    (internals.StepsSinceWrite >= internals.Interval) &&
+    this->WriteStatistics(internals.LastStep, internals.LastTime))
+    return false;
+
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+int TemporalStatistics::WriteStatistics(long step, double time)
+{
+  TimeEvent<128> mark("TemporalStatistics::WriteStatistics");
+
+  InternalsType &internals = *this->Internals;
+
+  internals.StepsSinceWrite = 0;
+
+  if (!internals.Writer)
+    {
+    SENSEI_WARNING("No writer was set, the statistics are not written")
+    return 0;
+    }
+
+  // the blocks are placed at their block id
+  vtkMultiBlockDataSet *mb = vtkMultiBlockDataSet::New();
+  mb->SetNumberOfBlocks(internals.NumBlocks);
+
+  const char *names[] = {"_mean", "_variance", "_min", "_max", "_ema"};
+  int nStats = internals.Alpha > 0.0 ? 5 : 4;
+
+  unsigned int nArrays = internals.ArrayNames.size();
+
+  for (auto &it : internals.Blocks)
+    {
+    InternalsType::Block &block = it.second;
+
+    vtkDataSet *ds = block.Structure->NewInstance();
+    ds->CopyStructure(block.Structure);
+
+    vtkFieldData *fd = ds->GetAttributesAsFieldData(internals.Association);
+
+    for (unsigned int i = 0; i < nArrays; ++i)
+      {
+      const Accumulator &acc = block.Arrays[i];
+
+      // the unbiased sample variance
+      std::vector<double> var(acc.M2);
+      double scale = acc.Count > 1 ? 1.0/(acc.Count - 1) : 0.0;
+      for (double &v : var)
+        v *= scale;
+
+      const std::vector<double> *stats[] =
+        {&acc.Mean, &var, &acc.Min, &acc.Max, &acc.EMA};
+
+      for (int j = 0; j < nStats; ++j)
+        {
+        vtkDoubleArray *da = newArray(internals.ArrayNames[i] + names[j],
+          acc, *stats[j]);
+        fd->AddArray(da);
+        da->Delete();
+        }
+      }
+
+    mb->SetBlock(it.first, ds);
+    ds->Delete();
+    }
+
+  VTKDataAdaptor *va = VTKDataAdaptor::New();
+  va->SetCommunicator(this->GetCommunicator());
+  va->SetDataObject(internals.MeshName + "_stats", mb);
+  va->SetDataTimeStep(step);
+  va->SetDataTime(time);
+  mb->Delete();
+
+  int ierr = internals.Writer->Execute(va) ? 0 : -1;
+
+  va->ReleaseData();
+  va->Delete();
+
+  if (ierr)
+    {
+    SENSEI_ERROR("Failed to write the statistics of mesh \""
+      << internals.MeshName << "\"")
+    return -1;
+    }
+
+  return 0;
+}
+
+//-----------------------------------------------------------------------------
+int TemporalStatistics::Finalize()
+{
+  InternalsType &internals = *this->Internals;
+
+  // write what was accumulated since the last write
+  int ierr = 0;
+  if (internals.StepsSinceWrite)
+    ierr = this->WriteStatistics(internals.LastStep, internals.LastTime);
+
+  if (internals.Writer)
+    ierr = internals.Writer->Finalize() || ierr;
+
+  internals.Blocks.clear();
+
+  return ierr ? -1 : 0;
+}
+
+}
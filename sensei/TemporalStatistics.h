@@ -0,0 +1,74 @@
+#ifndef sensei_TemporalStatistics_h
+#define sensei_TemporalStatistics_h
+
+#include "AnalysisAdaptor.h"
+#include <mpi.h>
+#include <string>
+#include <vector>
+
+namespace sensei
+{
+
+/// @class TemporalStatistics
+/// @brief Accumulates per point or per cell statistics over time
+///
+/// For each of the listed arrays the running mean, variance, min, and max
+/// of every value are updated in place each step with Welford's method,
+/// and optionally an exponential moving average with weight alpha given to
+/// the newest value. Each block keeps its own accumulators, and blocks are
+/// processed in parallel. Multi-component arrays are accumulated per
+/// component.
+///
+/// Every interval steps, and in Finalize, the accumulators are handed to
+/// the writer as a mesh named "<mesh>_stats" with the structure of the
+/// input mesh and the arrays <array>_mean, <array>_variance, <array>_min,
+/// <array>_max and, when enabled, <array>_ema. Any analysis adaptor that
+/// writes its input, for instance VTKPosthocIO, may be used as the writer.
+class TemporalStatistics : public AnalysisAdaptor
+{
+public:
+  static TemporalStatistics* New();
+  senseiTypeMacro(TemporalStatistics, AnalysisAdaptor);
+
+  /// @brief Initialize the adaptor.
+  ///
+  /// @param meshName name of mesh containing the arrays
+  /// @param association point or cell data
+  /// @param arrayNames the arrays to accumulate statistics of
+  /// @param alpha the weight of the newest value in the exponential moving
+  ///        average, 0 disables it
+  /// @param interval write the statistics every interval steps, 0 writes
+  ///        them only in Finalize
+  void Initialize(const std::string &meshName, int association,
+    const std::vector<std::string> &arrayNames, double alpha = 0.0,
+    int interval = 0);
+
+  /// @brief Set the analysis used to write the statistics.
+  void SetWriter(AnalysisAdaptor *writer);
+  AnalysisAdaptor *GetWriter();
+
+  bool Execute(DataAdaptor* data) override;
+
+  /// @brief Thread safe when the writer is, or when there is no writer.
+  int GetThreadSafe() override;
+
+  int Finalize() override;
+
+protected:
+  TemporalStatistics();
+  ~TemporalStatistics();
+
+  TemporalStatistics(const TemporalStatistics&) = delete;
+  void operator=(const TemporalStatistics&) = delete;
+
+  // pass the statistics to the writer
+  int WriteStatistics(long step, double time);
+
+private:
+  struct InternalsType;
+  InternalsType *Internals;
+};
+
+}
+
+#endif
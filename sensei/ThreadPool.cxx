@@ -0,0 +1,104 @@
+#include "ThreadPool.h"
+
+namespace sensei
+{
+
+// --------------------------------------------------------------------------
+ThreadPool::ThreadPool() : Active(0), Done(false)
+{
+}
+
+// --------------------------------------------------------------------------
+ThreadPool::~ThreadPool()
+{
+  this->Finalize();
+}
+
+// --------------------------------------------------------------------------
+int ThreadPool::Initialize(unsigned int nThreads)
+{
+  this->Finalize();
+
+  this->Done = false;
+
+  for (unsigned int i = 0; i < nThreads; ++i)
+    this->Threads.emplace_back(&ThreadPool::Run, this);
+
+  return 0;
+}
+
+// --------------------------------------------------------------------------
+void ThreadPool::Finalize()
+{
+  if (this->Threads.empty())
+    return;
+
+  // the queue is drained before the threads exit
+    {
+    std::lock_guard<std::mutex> lock(this->Mutex);
+    this->Done = true;
+    }
+  this->TaskReady.notify_all();
+
+  unsigned int nThreads = this->Threads.size();
+  for (unsigned int i = 0; i < nThreads; ++i)
+    this->Threads[i].join();
+
+  this->Threads.clear();
+}
+
+// --------------------------------------------------------------------------
+void ThreadPool::Push(const std::function<void()> &task)
+{
+  // with no threads the task is run immediately
+  if (this->Threads.empty())
+    {
+    task();
+    return;
+    }
+
+    {
+    std::lock_guard<std::mutex> lock(this->Mutex);
+    this->Tasks.push_back(task);
+    }
+  this->TaskReady.notify_one();
+}
+
+// --------------------------------------------------------------------------
+void ThreadPool::Wait()
+{
+  std::unique_lock<std::mutex> lock(this->Mutex);
+  this->TasksDone.wait(lock, [this]() -> bool {
+    return this->Tasks.empty() && (this->Active == 0); });
+}
+
+// --------------------------------------------------------------------------
+void ThreadPool::Run()
+{
+  while (true)
+    {
+    std::function<void()> task;
+      {
+      std::unique_lock<std::mutex> lock(this->Mutex);
+      this->TaskReady.wait(lock, [this]() -> bool {
+        return !this->Tasks.empty() || this->Done; });
+
+      if (this->Tasks.empty())
+        return;
+
+      task = std::move(this->Tasks.front());
+      this->Tasks.pop_front();
+      this->Active += 1;
+      }
+
+    task();
+
+      {
+      std::lock_guard<std::mutex> lock(this->Mutex);
+      this->Active -= 1;
+      }
+    this->TasksDone.notify_all();
+    }
+}
+
+}
@@ -0,0 +1,58 @@
+#ifndef sensei_ThreadPool_h
+#define sensei_ThreadPool_h
+
+#include <functional>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace sensei
+{
+
+/// @brief A fixed size pool of threads that execute queued tasks.
+///
+/// Tasks are pushed onto a shared queue and picked up by the first idle
+/// thread. Wait provides a join barrier, it blocks until all of the tasks
+/// pushed so far have completed.
+class ThreadPool
+{
+public:
+  ThreadPool();
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&) = delete;
+  void operator=(const ThreadPool&) = delete;
+
+  /// @brief Start n threads. Any running threads are stopped first.
+  /// Returns 0 if successful.
+  int Initialize(unsigned int nThreads);
+
+  /// @brief Wait for queued tasks to complete and stop the threads.
+  void Finalize();
+
+  /// @brief Get the number of threads in the pool
+  unsigned int GetNumberOfThreads() const { return this->Threads.size(); }
+
+  /// @brief Queue a task for execution.
+  void Push(const std::function<void()> &task);
+
+  /// @brief Block until all of the queued tasks have completed.
+  void Wait();
+
+private:
+  void Run();
+
+  std::vector<std::thread> Threads;
+  std::deque<std::function<void()>> Tasks;
+  std::mutex Mutex;
+  std::condition_variable TaskReady;
+  std::condition_variable TasksDone;
+  unsigned long Active;
+  bool Done;
+};
+
+}
+
+#endif
@@ -0,0 +1,279 @@
+#include "TimeBudgetScheduler.h"
+#include "Error.h"
+
+#include <pugixml.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <sstream>
+#include <iomanip>
+
+namespace sensei
+{
+
+// --------------------------------------------------------------------------
+static double getSystemTime()
+{
+  using namespace std::chrono;
+  return duration_cast<duration<double>>(
+    steady_clock::now().time_since_epoch()).count();
+}
+
+// --------------------------------------------------------------------------
+TimeBudgetScheduler::TimeBudgetScheduler() : Budget(0.0), Smoothing(0.5),
+  Verbose(0), StartTime(-1.0), InSituTime(0.0), Step(0)
+{
+}
+
+// --------------------------------------------------------------------------
+int TimeBudgetScheduler::Initialize(const pugi::xml_node &node)
+{
+  std::string budgetStr = node.attribute("budget").as_string("");
+  if (budgetStr.empty())
+    {
+    SENSEI_ERROR("The scheduler requires a budget")
+    return -1;
+    }
+
+  double budget = 0.0;
+  try
+    {
+    budget = std::stod(budgetStr);
+    }
+  catch (...)
+    {
+    SENSEI_ERROR("Invalid budget \"" << budgetStr << "\"")
+    return -1;
+    }
+
+  if (budgetStr.back() == '%')
+    budget /= 100.0;
+
+  if ((budget <= 0.0) || (budget > 1.0))
+    {
+    SENSEI_ERROR("The budget must be in (0, 1] or (0%, 100%], not \""
+      << budgetStr << "\"")
+    return -1;
+    }
+
+  this->SetBudget(budget);
+
+  this->Smoothing = node.attribute("smoothing").as_double(0.5);
+  if ((this->Smoothing <= 0.0) || (this->Smoothing > 1.0))
+    {
+    SENSEI_ERROR("The smoothing must be in (0, 1] not " << this->Smoothing)
+    return -1;
+    }
+
+  this->Verbose = node.attribute("verbose").as_int(0);
+
+  return 0;
+}
+
+// --------------------------------------------------------------------------
+void TimeBudgetScheduler::SetBudget(double budget)
+{
+  this->Budget = budget;
+}
+
+// --------------------------------------------------------------------------
+unsigned int TimeBudgetScheduler::AddAnalysis(const std::string &name,
+  int priority, unsigned int minCadence)
+{
+  AnalysisRecord rec;
+  rec.Name = name;
+  rec.Priority = priority;
+  rec.MinCadence = minCadence;
+  rec.Cost = -1.0;
+  rec.LastTime = -1.0;
+  rec.StepsSinceRun = 0;
+  rec.RunCount = 0;
+  rec.SkipCount = 0;
+
+  this->Analyses.push_back(rec);
+
+  return this->Analyses.size() - 1;
+}
+
+// --------------------------------------------------------------------------
+void TimeBudgetScheduler::SetExecuteTime(unsigned int i, double seconds)
+{
+  if (i < this->Analyses.size())
+    this->Analyses[i].LastTime = seconds;
+}
+
+// --------------------------------------------------------------------------
+double TimeBudgetScheduler::GetCost(unsigned int i) const
+{
+  return i < this->Analyses.size() ? this->Analyses[i].Cost : -1.0;
+}
+
+// --------------------------------------------------------------------------
+int TimeBudgetScheduler::Schedule(MPI_Comm comm, std::vector<int> &run)
+{
+  return this->Schedule(comm, getSystemTime(), run);
+}
+
+// --------------------------------------------------------------------------
+int TimeBudgetScheduler::Schedule(MPI_Comm comm, double now,
+  std::vector<int> &run)
+{
+  unsigned int nAnalyses = this->Analyses.size();
+
+  // analyses with a 0 entry on input, for instance those whose triggers did
+  // not fire, are not eligible to run this step
+  std::vector<int> eligible(nAnalyses, 1);
+  if (run.size() == nAnalyses)
+    eligible = run;
+
+  run = eligible;
+
+  if (!this->Enabled() || (nAnalyses == 0))
+    return 0;
+
+  if (this->StartTime < 0.0)
+    this->StartTime = now;
+
+  // gather the times measured during the previous step and the elapsed
+  // time. the slowest rank determines the cost, and after the reduction
+  // every rank makes the same decision.
+  std::vector<double> times(nAnalyses + 1);
+  for (unsigned int i = 0; i < nAnalyses; ++i)
+    {
+    times[i] = this->Analyses[i].LastTime;
+    this->Analyses[i].LastTime = -1.0;
+    }
+  times[nAnalyses] = now - this->StartTime;
+
+  MPI_Allreduce(MPI_IN_PLACE, times.data(), nAnalyses + 1,
+    MPI_DOUBLE, MPI_MAX, comm);
+
+  double elapsed = times[nAnalyses];
+
+  // update the cost estimates
+  for (unsigned int i = 0; i < nAnalyses; ++i)
+    {
+    AnalysisRecord &rec = this->Analyses[i];
+    double t = times[i];
+    if (t < 0.0)
+      continue;
+
+    this->InSituTime += t;
+
+    rec.Cost = rec.Cost < 0.0 ? t :
+      this->Smoothing*t + (1.0 - this->Smoothing)*rec.Cost;
+    }
+
+  double available = this->Budget*elapsed - this->InSituTime;
+
+  // analyses that must run, either because they have reached their
+  // minimum cadence or because their cost is not yet known
+  std::vector<unsigned int> optional;
+  for (unsigned int i = 0; i < nAnalyses; ++i)
+    {
+    AnalysisRecord &rec = this->Analyses[i];
+    if (!eligible[i])
+      {
+      continue;
+      }
+    else if ((rec.Cost < 0.0) ||
+      (rec.MinCadence && (rec.StepsSinceRun + 1 >= rec.MinCadence)))
+      {
+      available -= std::max(0.0, rec.Cost);
+      }
+    else
+      {
+      run[i] = 0;
+      optional.push_back(i);
+      }
+    }
+
+  // the rest run in priority order while the budget allows. ties go to
+  // the one that has waited the longest
+  std::stable_sort(optional.begin(), optional.end(),
+    [this](unsigned int a, unsigned int b) -> bool
+    {
+      const AnalysisRecord &ra = this->Analyses[a];
+      const AnalysisRecord &rb = this->Analyses[b];
+      if (ra.Priority != rb.Priority)
+        return ra.Priority > rb.Priority;
+      return ra.StepsSinceRun > rb.StepsSinceRun;
+    });
+
+  unsigned int nOptional = optional.size();
+  for (unsigned int j = 0; j < nOptional; ++j)
+    {
+    unsigned int i = optional[j];
+    if (this->Analyses[i].Cost <= available)
+      {
+      run[i] = 1;
+      available -= this->Analyses[i].Cost;
+      }
+    }
+
+  // update the bookkeeping
+  for (unsigned int i = 0; i < nAnalyses; ++i)
+    {
+    AnalysisRecord &rec = this->Analyses[i];
+    if (run[i])
+      {
+      rec.StepsSinceRun = 0;
+      rec.RunCount += 1;
+      }
+    else
+      {
+      rec.StepsSinceRun += 1;
+      rec.SkipCount += 1;
+      }
+    }
+
+  if (this->Verbose)
+    {
+    std::ostringstream oss;
+    for (unsigned int i = 0; i < nAnalyses; ++i)
+      oss << " " << this->Analyses[i].Name << "=" << (run[i] ? "run" : "skip");
+
+    SENSEI_STATUS("Scheduler step " << this->Step << " elapsed " << elapsed
+      << " s, in situ " << this->InSituTime << " s, available "
+      << available << " s," << oss.str())
+    }
+
+  this->Step += 1;
+
+  return 0;
+}
+
+// --------------------------------------------------------------------------
+void TimeBudgetScheduler::PrintSummary(MPI_Comm comm) const
+{
+  if (!this->Enabled())
+    return;
+
+  int rank = 0;
+  MPI_Comm_rank(comm, &rank);
+  if (rank != 0)
+    return;
+
+  double elapsed = this->StartTime < 0.0 ? 0.0 :
+    getSystemTime() - this->StartTime;
+
+  double pctInSitu = elapsed > 0.0 ? 100.0*this->InSituTime/elapsed : 0.0;
+
+  std::ostringstream oss;
+  oss << std::setprecision(3);
+
+  unsigned int nAnalyses = this->Analyses.size();
+  for (unsigned int i = 0; i < nAnalyses; ++i)
+    {
+    const AnalysisRecord &rec = this->Analyses[i];
+    oss << std::endl << "  " << rec.Name << " priority=" << rec.Priority
+      << " min_cadence=" << rec.MinCadence << " ran=" << rec.RunCount
+      << " skipped=" << rec.SkipCount << " cost=" << rec.Cost << " s";
+    }
+
+  SENSEI_STATUS("Scheduler budget " << 100.0*this->Budget << "% used "
+    << pctInSitu << "% (" << this->InSituTime << " of " << elapsed
+    << " s) over " << this->Step << " steps" << oss.str())
+}
+
+}
@@ -0,0 +1,106 @@
+#ifndef sensei_TimeBudgetScheduler_h
+#define sensei_TimeBudgetScheduler_h
+
+#include <mpi.h>
+#include <string>
+#include <vector>
+
+namespace pugi { class xml_node; }
+
+namespace sensei
+{
+
+/// @brief Decides on each step which analyses run so that the time spent
+/// in situ stays within a fraction of the total wall time.
+///
+/// The scheduler is configured with a budget, the fraction of wall time
+/// that may be spent in the analyses, and for each analysis a priority
+/// and a minimum cadence. The cost of each analysis is estimated from its
+/// measured execution times. On each step the analyses are considered in
+/// priority order and run if their estimated cost fits in the unspent
+/// budget. An analysis with a minimum cadence of N is run at least once
+/// every N steps regardless of the budget, and an analysis whose cost is
+/// not yet known is always run.
+///
+/// The decision is made collectively, measured times are reduced with
+/// a single MPI_Allreduce per step, so that every rank runs the same set
+/// of analyses.
+///
+/// The XML is of the form:
+///
+///   <scheduler budget="5%" smoothing="0.5" verbose="0"/>
+///
+/// where budget is either a fraction (0.05) or a percentage (5%) and
+/// smoothing is the weight given to the most recent measurement when
+/// updating the estimated costs.
+class TimeBudgetScheduler
+{
+public:
+  TimeBudgetScheduler();
+
+  /// @brief Configure the scheduler from XML. Enables the scheduler.
+  int Initialize(const pugi::xml_node &node);
+
+  /// @brief Set the fraction of wall time that may be spent in situ.
+  /// A budget greater than 0 enables the scheduler.
+  void SetBudget(double budget);
+  double GetBudget() const { return this->Budget; }
+
+  /// @brief returns true if a budget has been set
+  bool Enabled() const { return this->Budget > 0.0; }
+
+  /// @brief Register an analysis. A larger priority is considered first.
+  /// A min cadence of N guarantees the analysis runs at least every N
+  /// steps, 0 disables the guarantee. Returns the index used to identify
+  /// the analysis in the other calls.
+  unsigned int AddAnalysis(const std::string &name, int priority,
+    unsigned int minCadence);
+
+  /// @brief Decide which analyses run this step. This is collective on
+  /// comm. If on input run has an entry for each analysis, those with a 0
+  /// entry are not eligible and are skipped regardless of their cadence.
+  /// On return run has an entry for each analysis, 1 if the analysis
+  /// should be executed.
+  int Schedule(MPI_Comm comm, std::vector<int> &run);
+
+  /// @brief As above with the wall time, in seconds, of the call given.
+  /// This lets the decisions be tested with fixed timings.
+  int Schedule(MPI_Comm comm, double now, std::vector<int> &run);
+
+  /// @brief Record the execution time in seconds of the i'th analysis for
+  /// the current step. The times are used in the next call to Schedule.
+  void SetExecuteTime(unsigned int i, double seconds);
+
+  /// @brief Get the estimated cost in seconds of the i'th analysis, -1 if
+  /// it is not yet known.
+  double GetCost(unsigned int i) const;
+
+  /// @brief Report the number of steps each analysis ran and was skipped
+  /// and the fraction of wall time spent in situ.
+  void PrintSummary(MPI_Comm comm) const;
+
+private:
+  struct AnalysisRecord
+  {
+    std::string Name;
+    int Priority;
+    unsigned int MinCadence;
+    double Cost;          // estimated cost, identical on all ranks
+    double LastTime;      // time measured on this rank, -1 if not run
+    unsigned int StepsSinceRun;
+    long RunCount;
+    long SkipCount;
+  };
+
+  double Budget;
+  double Smoothing;
+  int Verbose;
+  double StartTime;
+  double InSituTime;
+  long Step;
+  std::vector<AnalysisRecord> Analyses;
+};
+
+}
+
+#endif
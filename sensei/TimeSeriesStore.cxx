@@ -0,0 +1,237 @@
+#include "TimeSeriesStore.h"
+#include "Error.h"
+
+#include <cstring>
+#include <errno.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+namespace sensei
+{
+namespace
+{
+const char *MAGIC = "SENSEITS";
+const uint32_t VERSION = 1;
+
+// the fixed size part of a record following its length
+const uint32_t RECORD_HEADER_SIZE = 2*sizeof(uint64_t) + 3*sizeof(uint32_t);
+
+template <typename T>
+char *pack(char *p, const T &val)
+{
+  memcpy(p, &val, sizeof(T));
+  return p + sizeof(T);
+}
+}
+
+// --------------------------------------------------------------------------
+TimeSeriesStore::TimeSeriesStore() : File(nullptr), SyncInterval(100),
+  NumUnsynced(0), Buffer(1 << 20)
+{
+}
+
+// --------------------------------------------------------------------------
+TimeSeriesStore::~TimeSeriesStore()
+{
+  this->Close();
+}
+
+// --------------------------------------------------------------------------
+int TimeSeriesStore::Open(const std::string &fileName,
+  const std::string &kind, const Metadata &metadata)
+{
+  this->Close();
+
+  this->FileName = fileName;
+
+  struct stat st;
+  bool exists = (stat(fileName.c_str(), &st) == 0) && (st.st_size > 0);
+
+  if (exists && this->Recover(kind))
+    return -1;
+
+  this->File = fopen(fileName.c_str(), exists ? "ab" : "wb");
+  if (!this->File)
+    {
+    char *estr = strerror(errno);
+    SENSEI_ERROR("Failed to open \"" << fileName << "\"" << std::endl << estr)
+    return -1;
+    }
+
+  // appends go to the buffer, which is written when full
+  setvbuf(this->File, this->Buffer.data(), _IOFBF, this->Buffer.size());
+
+  if (exists)
+    return 0;
+
+  std::string text = "kind=" + kind + "\n";
+  for (const auto &kv : metadata)
+    text += kv.first + "=" + kv.second + "\n";
+
+  uint32_t textLen = text.size();
+
+  fwrite(MAGIC, 1, 8, this->File);
+  fwrite(&VERSION, sizeof(VERSION), 1, this->File);
+  fwrite(&textLen, sizeof(textLen), 1, this->File);
+  fwrite(text.c_str(), 1, textLen, this->File);
+
+  if (ferror(this->File) || this->Sync())
+    {
+    SENSEI_ERROR("Failed to write the header of \"" << fileName << "\"")
+    this->Close();
+    return -1;
+    }
+
+  return 0;
+}
+
+// --------------------------------------------------------------------------
+int TimeSeriesStore::Recover(const std::string &kind)
+{
+  const char *fileName = this->FileName.c_str();
+
+  FILE *file = fopen(fileName, "rb");
+  if (!file)
+    {
+    char *estr = strerror(errno);
+    SENSEI_ERROR("Failed to open \"" << fileName << "\"" << std::endl << estr)
+    return -1;
+    }
+
+  char magic[8] = {'\0'};
+  uint32_t version = 0;
+  uint32_t textLen = 0;
+  std::string text;
+
+  if ((fread(magic, 1, 8, file) != 8) || strncmp(magic, MAGIC, 8) ||
+    (fread(&version, sizeof(version), 1, file) != 1) ||
+    (version != VERSION) ||
+    (fread(&textLen, sizeof(textLen), 1, file) != 1))
+    {
+    SENSEI_ERROR("\"" << fileName << "\" is not a version " << VERSION
+      << " time series file")
+    fclose(file);
+    return -1;
+    }
+
+  text.resize(textLen);
+  if ((fread(&text[0], 1, textLen, file) != textLen) ||
+    (text.compare(0, kind.size() + 6, "kind=" + kind + "\n")))
+    {
+    SENSEI_ERROR("\"" << fileName << "\" does not hold " << kind << " records")
+    fclose(file);
+    return -1;
+    }
+
+  // find the end of the last complete record
+  fseek(file, 0, SEEK_END);
+  long size = ftell(file);
+
+  long good = 16 + textLen;
+  uint32_t len = 0;
+  while (fseek(file, good, SEEK_SET) == 0 &&
+    fread(&len, sizeof(len), 1, file) == 1 &&
+    (len >= RECORD_HEADER_SIZE) &&
+    (good + long(sizeof(len)) + long(len) <= size))
+    good += sizeof(len) + len;
+
+  fclose(file);
+
+  if (good < size)
+    {
+    SENSEI_WARNING("Dropping " << size - good << " bytes of a partial record"
+      " at the end of \"" << fileName << "\"")
+
+    if (truncate(fileName, good))
+      {
+      char *estr = strerror(errno);
+      SENSEI_ERROR("Failed to truncate \"" << fileName << "\""
+        << std::endl << estr)
+      return -1;
+      }
+    }
+
+  return 0;
+}
+
+// --------------------------------------------------------------------------
+int TimeSeriesStore::AppendRecord(long step, double time, unsigned int var,
+  const double *values, unsigned int nValues, const uint64_t *counts,
+  unsigned int nCounts)
+{
+  if (!this->File)
+    {
+    SENSEI_ERROR("The time series file is not open")
+    return -1;
+    }
+
+  uint32_t len = RECORD_HEADER_SIZE + nValues*sizeof(double) +
+    nCounts*sizeof(uint64_t);
+
+  // the record is assembled so that it is a single buffered write
+  this->Record.resize(sizeof(len) + len);
+
+  char *p = this->Record.data();
+  p = pack(p, len);
+  p = pack(p, int64_t(step));
+  p = pack(p, time);
+  p = pack(p, uint32_t(var));
+  p = pack(p, uint32_t(nValues));
+  p = pack(p, uint32_t(nCounts));
+
+  if (nValues)
+    memcpy(p, values, nValues*sizeof(double));
+  p += nValues*sizeof(double);
+
+  if (nCounts)
+    memcpy(p, counts, nCounts*sizeof(uint64_t));
+
+  if (fwrite(this->Record.data(), 1, this->Record.size(), this->File)
+    != this->Record.size())
+    {
+    char *estr = strerror(errno);
+    SENSEI_ERROR("Failed to write to \"" << this->FileName << "\""
+      << std::endl << estr)
+    return -1;
+    }
+
+  this->NumUnsynced += 1;
+
+  if (this->SyncInterval && (this->NumUnsynced >= this->SyncInterval))
+    return this->Sync();
+
+  return 0;
+}
+
+// --------------------------------------------------------------------------
+int TimeSeriesStore::Sync()
+{
+  this->NumUnsynced = 0;
+
+  if (fflush(this->File) || fsync(fileno(this->File)))
+    {
+    char *estr = strerror(errno);
+    SENSEI_ERROR("Failed to flush \"" << this->FileName << "\""
+      << std::endl << estr)
+    return -1;
+    }
+
+  return 0;
+}
+
+// --------------------------------------------------------------------------
+int TimeSeriesStore::Close()
+{
+  if (!this->File)
+    return 0;
+
+  int ierr = this->Sync();
+
+  fclose(this->File);
+  this->File = nullptr;
+
+  return ierr;
+}
+
+}
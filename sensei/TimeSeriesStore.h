@@ -0,0 +1,105 @@
+#ifndef sensei_TimeSeriesStore_h
+#define sensei_TimeSeriesStore_h
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace sensei
+{
+
+/// An append only binary file holding the results of an analysis over
+/// the whole run, replacing a small file per step. The file starts with a
+/// header describing its contents, after which each call to Append adds a
+/// record. Appends are buffered, and the file is flushed to disk every
+/// SyncInterval records and when it is closed. Reopening an existing file
+/// continues it, dropping a partial record left by a run that was
+/// interrupted. Everything is in native byte order:
+///
+///   char[8]   "SENSEITS"
+///   uint32    version (1)
+///   uint32    length of the metadata text
+///   char[]    metadata, key=value lines, always including kind
+///
+/// followed by any number of records:
+///
+///   uint32    length of the rest of the record in bytes
+///   int64     step
+///   float64   time
+///   uint32    variable index
+///   uint32    number of values N
+///   uint32    number of counts M
+///   float64[N] values, such as a range or quantiles
+///   uint64[M]  counts, such as histogram bins
+///
+/// The tools/sensei_time_series script reads these files.
+class TimeSeriesStore
+{
+public:
+  using Metadata = std::vector<std::pair<std::string, std::string>>;
+
+  TimeSeriesStore();
+  ~TimeSeriesStore();
+
+  TimeSeriesStore(const TimeSeriesStore&) = delete;
+  void operator=(const TimeSeriesStore&) = delete;
+
+  // open the file for appending. a new file is created with a header
+  // holding the kind of the records and the metadata, an existing file
+  // must hold the same kind. returns 0 if successful.
+  int Open(const std::string &fileName, const std::string &kind,
+    const Metadata &metadata = Metadata());
+
+  // flush the file to disk and close it
+  int Close();
+
+  bool IsOpen() const { return this->File != nullptr; }
+
+  // flush to disk every n records, 0 only when the file is closed
+  void SetSyncInterval(unsigned int n) { this->SyncInterval = n; }
+  unsigned int GetSyncInterval() const { return this->SyncInterval; }
+
+  // append a record. returns 0 if successful.
+  template <typename count_t>
+  int Append(long step, double time, unsigned int var,
+    const double *values, unsigned int nValues,
+    const count_t *counts, unsigned int nCounts)
+  {
+    this->Counts.assign(counts, counts + nCounts);
+    return this->AppendRecord(step, time, var, values, nValues,
+      this->Counts.data(), nCounts);
+  }
+
+  int Append(long step, double time, unsigned int var,
+    const double *values, unsigned int nValues)
+  {
+    return this->AppendRecord(step, time, var, values, nValues,
+      nullptr, 0);
+  }
+
+private:
+  int AppendRecord(long step, double time, unsigned int var,
+    const double *values, unsigned int nValues,
+    const uint64_t *counts, unsigned int nCounts);
+
+  // flush the buffered records to disk
+  int Sync();
+
+  // check the header of an existing file and drop any partial record at
+  // its end
+  int Recover(const std::string &kind);
+
+  std::string FileName;
+  FILE *File;
+  unsigned int SyncInterval;
+  unsigned int NumUnsynced;
+  std::vector<char> Buffer;
+  std::vector<char> Record;
+  std::vector<uint64_t> Counts;
+};
+
+}
+
+#endif
@@ -0,0 +1,173 @@
+#include "TopK.h"
+#include "Error.h"
+#include "MPIUtils.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace sensei
+{
+namespace
+{
+// orders candidates by descending value, ties by location so that the
+// result does not depend on the order of insertion
+bool greater(const TopK::Candidate &a, const TopK::Candidate &b)
+{
+  if (a.Value != b.Value)
+    return a.Value > b.Value;
+
+  if (a.Block != b.Block)
+    return a.Block < b.Block;
+
+  return std::lexicographical_compare(a.Location, a.Location + 3,
+    b.Location, b.Location + 3);
+}
+}
+
+// --------------------------------------------------------------------------
+TopK::TopK(unsigned int k, unsigned int nSets) : K(std::max(k, 1u)),
+  Sets(nSets), Thresholds(nSets, std::numeric_limits<double>::lowest())
+{
+}
+
+// --------------------------------------------------------------------------
+void TopK::Clear()
+{
+  unsigned int nSets = this->Sets.size();
+  for (unsigned int i = 0; i < nSets; ++i)
+    {
+    this->Sets[i].clear();
+    this->Thresholds[i] = std::numeric_limits<double>::lowest();
+    }
+}
+
+// --------------------------------------------------------------------------
+void TopK::Prune(unsigned int set)
+{
+  std::vector<Candidate> &cands = this->Sets[set];
+  if (cands.size() <= this->K)
+    return;
+
+  // linear time partition about the k'th largest
+  std::nth_element(cands.begin(), cands.begin() + this->K - 1, cands.end(),
+    greater);
+
+  cands.resize(this->K);
+
+  this->Thresholds[set] = cands[this->K - 1].Value;
+}
+
+// --------------------------------------------------------------------------
+void TopK::Merge(const TopK &other)
+{
+  unsigned int nSets = std::min(this->Sets.size(), other.Sets.size());
+  for (unsigned int i = 0; i < nSets; ++i)
+    {
+    for (const Candidate &c : other.Sets[i])
+      this->Insert(i, c.Value, c.Block, c.Location[0], c.Location[1],
+        c.Location[2]);
+    this->Prune(i);
+    }
+}
+
+// --------------------------------------------------------------------------
+void TopK::GetCandidates(unsigned int set, std::vector<Candidate> &cands)
+{
+  this->Prune(set);
+  cands = this->Sets[set];
+  std::sort(cands.begin(), cands.end(), greater);
+}
+
+// --------------------------------------------------------------------------
+void TopK::Pack(std::vector<double> &buf)
+{
+  // the number of candidates in each set followed by the candidates.
+  // block ids and locations are exact in a double up to 2^53
+  unsigned int nSets = this->Sets.size();
+
+  buf.clear();
+  buf.push_back(nSets);
+
+  for (unsigned int i = 0; i < nSets; ++i)
+    {
+    this->Prune(i);
+    buf.push_back(this->Sets[i].size());
+    }
+
+  for (unsigned int i = 0; i < nSets; ++i)
+    {
+    for (const Candidate &c : this->Sets[i])
+      {
+      buf.push_back(c.Value);
+      buf.push_back(c.Block);
+      buf.push_back(c.Location[0]);
+      buf.push_back(c.Location[1]);
+      buf.push_back(c.Location[2]);
+      }
+    }
+}
+
+// --------------------------------------------------------------------------
+int TopK::Unpack(const std::vector<double> &buf)
+{
+  size_t n = buf.size();
+  if (n < 1)
+    {
+    SENSEI_ERROR("Invalid buffer, no header")
+    return -1;
+    }
+
+  unsigned int nSets = buf[0];
+  if (n < 1 + nSets)
+    {
+    SENSEI_ERROR("Invalid buffer, " << nSets << " sets but only "
+      << n << " values")
+    return -1;
+    }
+
+  size_t total = 0;
+  for (unsigned int i = 0; i < nSets; ++i)
+    total += buf[1 + i];
+
+  if (n != 1 + nSets + 5*total)
+    {
+    SENSEI_ERROR("Invalid buffer, expected " << 1 + nSets + 5*total
+      << " values but have " << n)
+    return -1;
+    }
+
+  this->Sets.resize(nSets);
+  this->Thresholds.resize(nSets);
+  this->Clear();
+
+  const double *p = buf.data() + 1 + nSets;
+  for (unsigned int i = 0; i < nSets; ++i)
+    {
+    size_t nc = buf[1 + i];
+    std::vector<Candidate> &cands = this->Sets[i];
+    cands.resize(nc);
+    for (size_t j = 0; j < nc; ++j, p += 5)
+      cands[j] = {p[0], int(p[1]), {long(p[2]), long(p[3]), long(p[4])}};
+    this->Prune(i);
+    }
+
+  return 0;
+}
+
+// --------------------------------------------------------------------------
+int TopK::Reduce(MPI_Comm comm, int root)
+{
+  return MPIUtils::BinomialReduce<double>(comm, root,
+    [this](std::vector<double> &buf) { this->Pack(buf); },
+    [this](const std::vector<double> &buf) -> int
+      {
+      TopK other(this->K);
+      if (other.Unpack(buf))
+        return -1;
+
+      this->Merge(other);
+      return 0;
+      });
+}
+
+}
@@ -0,0 +1,83 @@
+#ifndef sensei_TopK_h
+#define sensei_TopK_h
+
+#include <mpi.h>
+#include <vector>
+
+namespace sensei
+{
+
+/// Finds the K largest values of a distributed field, optionally for a
+/// number of independent sets, such as the time shifts of an
+/// autocorrelation. Each value is tagged with the block and the grid
+/// location it came from. Candidates are buffered and pruned to the K
+/// largest with a linear time selection whenever the buffer reaches 2K,
+/// and values below the current K'th largest are rejected without being
+/// buffered, so the local selection is linear in the number of values.
+/// The candidates of all ranks are then reduced in a binomial tree, each
+/// message carrying at most K candidates per set.
+class TopK
+{
+public:
+  struct Candidate
+  {
+    double Value;
+    int Block;
+    long Location[3];
+  };
+
+  // k is the number of values to keep in each of nSets sets
+  TopK(unsigned int k = 10, unsigned int nSets = 1);
+
+  // discard the candidates
+  void Clear();
+
+  // the smallest value that could be kept in the set
+  double GetThreshold(unsigned int set) const
+  { return this->Thresholds[set]; }
+
+  // offer a value
+  void Insert(unsigned int set, double val, int block,
+    long i, long j = 0, long k = 0)
+  {
+    // this also rejects nan
+    if (!(val >= this->Thresholds[set]))
+      return;
+
+    std::vector<Candidate> &cands = this->Sets[set];
+    cands.push_back({val, block, {i, j, k}});
+
+    if (cands.size() >= 2*this->K)
+      this->Prune(set);
+  }
+
+  // add the candidates of another instance with the same k and sets
+  void Merge(const TopK &other);
+
+  // reduce the candidates of all ranks onto the root rank with a binomial
+  // tree. the candidates on the other ranks are left in an unspecified
+  // state.
+  int Reduce(MPI_Comm comm, int root = 0);
+
+  // get the at most k largest values of the set, in descending order
+  void GetCandidates(unsigned int set, std::vector<Candidate> &cands);
+
+  unsigned int GetK() const { return this->K; }
+  unsigned int GetNumberOfSets() const { return this->Sets.size(); }
+
+  // serialize the candidates
+  void Pack(std::vector<double> &buf);
+  int Unpack(const std::vector<double> &buf);
+
+private:
+  // keep only the k largest candidates of the set
+  void Prune(unsigned int set);
+
+  unsigned int K;
+  std::vector<std::vector<Candidate>> Sets;
+  std::vector<double> Thresholds;
+};
+
+}
+
+#endif
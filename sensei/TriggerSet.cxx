@@ -0,0 +1,126 @@
+#include "TriggerSet.h"
+#include "DataAdaptor.h"
+#include "Error.h"
+
+#include <sstream>
+
+namespace sensei
+{
+
+// --------------------------------------------------------------------------
+void TriggerSet::AddTrigger(unsigned int first, unsigned int last,
+  const std::string &name, AnalysisTrigger *trigger)
+{
+  TriggerRecord rec;
+  rec.First = first;
+  rec.Last = last;
+  rec.Name = name;
+  rec.Trigger = trigger;
+  rec.FireCount = 0;
+
+  this->Triggers.push_back(rec);
+}
+
+// --------------------------------------------------------------------------
+int TriggerSet::Evaluate(MPI_Comm comm, DataAdaptor *data,
+  unsigned int nAnalyses, std::vector<int> &run)
+{
+  run.assign(nAnalyses, 1);
+
+  unsigned int nTriggers = this->Triggers.size();
+  if (nTriggers == 0)
+    return 0;
+
+  // gather the local values of all of the triggers and reduce them
+  // together
+  this->Values.Clear();
+  for (unsigned int i = 0; i < nTriggers; ++i)
+    {
+    TriggerRecord &rec = this->Triggers[i];
+    if (rec.Trigger->AddLocalValues(data, this->Values))
+      {
+      SENSEI_ERROR("Failed to evaluate " << rec.Trigger->GetClassName()
+        << " of " << rec.Name)
+      return -1;
+      }
+    }
+
+  if (this->Values.Allreduce(comm))
+    return -1;
+
+  // an analysis with triggers runs if any of them fires
+  for (unsigned int i = 0; i < nTriggers; ++i)
+    {
+    const TriggerRecord &rec = this->Triggers[i];
+    for (unsigned int j = rec.First; j < rec.Last; ++j)
+      run[j] = 0;
+    }
+
+  for (unsigned int i = 0; i < nTriggers; ++i)
+    {
+    TriggerRecord &rec = this->Triggers[i];
+
+    bool fire = false;
+    if (rec.Trigger->Evaluate(this->Values, fire))
+      {
+      SENSEI_ERROR("Failed to evaluate " << rec.Trigger->GetClassName()
+        << " of " << rec.Name)
+      return -1;
+      }
+
+    if (fire)
+      {
+      rec.FireCount += 1;
+      for (unsigned int j = rec.First; j < rec.Last; ++j)
+        run[j] = 1;
+      }
+    }
+
+  this->Step += 1;
+
+  return 0;
+}
+
+// --------------------------------------------------------------------------
+int TriggerSet::Finalize()
+{
+  int ierr = 0;
+  unsigned int nTriggers = this->Triggers.size();
+  for (unsigned int i = 0; i < nTriggers; ++i)
+    {
+    TriggerRecord &rec = this->Triggers[i];
+    if (rec.Trigger->Finalize())
+      {
+      SENSEI_ERROR("Failed to finalize " << rec.Trigger->GetClassName()
+        << " of " << rec.Name)
+      ierr = -1;
+      }
+    }
+  return ierr;
+}
+
+// --------------------------------------------------------------------------
+void TriggerSet::PrintSummary(MPI_Comm comm) const
+{
+  if (this->Triggers.empty())
+    return;
+
+  int rank = 0;
+  MPI_Comm_rank(comm, &rank);
+  if (rank != 0)
+    return;
+
+  std::ostringstream oss;
+  unsigned int nTriggers = this->Triggers.size();
+  for (unsigned int i = 0; i < nTriggers; ++i)
+    {
+    const TriggerRecord &rec = this->Triggers[i];
+    oss << std::endl << "  " << rec.Name << " "
+      << rec.Trigger->GetClassName() << " fired=" << rec.FireCount;
+    }
+
+  SENSEI_STATUS("Triggers evaluated over " << this->Step << " steps"
+    << oss.str())
+}
+
+}
@@ -0,0 +1,73 @@
+#ifndef sensei_TriggerSet_h
+#define sensei_TriggerSet_h
+
+#include "AnalysisTrigger.h"
+
+#include <vtkSmartPointer.h>
+
+#include <mpi.h>
+#include <string>
+#include <vector>
+
+namespace sensei
+{
+class DataAdaptor;
+
+/// @brief Decides on each step which analyses run from the triggers
+/// attached to them.
+///
+/// An analysis without triggers always runs. An analysis with triggers
+/// runs on the steps where at least one of them fires. The values of all
+/// of the triggers are reduced with a single MPI_Allreduce per step so
+/// that every rank runs the same set of analyses.
+///
+/// In ConfigurableAnalysis triggers are given as children of the
+/// analysis they gate, for instance:
+///
+///   <analysis type="catalyst" pipeline="slice" ... >
+///     <trigger type="range" mesh="mesh" array="data" above="0.9"/>
+///     <trigger type="entropy" mesh="mesh" array="data" change="0.25"/>
+///   </analysis>
+class TriggerSet
+{
+public:
+  TriggerSet() : Step(0) {}
+
+  /// @brief Attach a trigger to the analyses with indices in [first, last).
+  /// The name is used when reporting.
+  void AddTrigger(unsigned int first, unsigned int last,
+    const std::string &name, AnalysisTrigger *trigger);
+
+  /// @brief returns true if no trigger has been added
+  bool Empty() const { return this->Triggers.empty(); }
+
+  /// @brief Evaluate the triggers. This is collective on comm. On return
+  /// run has an entry for each of the nAnalyses analyses, 1 if the
+  /// analysis should be executed.
+  int Evaluate(MPI_Comm comm, DataAdaptor *data, unsigned int nAnalyses,
+    std::vector<int> &run);
+
+  /// @brief Finalize the triggers
+  int Finalize();
+
+  /// @brief Report the number of steps each trigger fired
+  void PrintSummary(MPI_Comm comm) const;
+
+private:
+  struct TriggerRecord
+  {
+    unsigned int First;
+    unsigned int Last;
+    std::string Name;
+    vtkSmartPointer<AnalysisTrigger> Trigger;
+    long FireCount;
+  };
+
+  long Step;
+  TriggerReduction Values;
+  std::vector<TriggerRecord> Triggers;
+};
+
+}
+
+#endif
@@ -206,19 +206,19 @@ bool VTKAmrWriter::Execute(DataAdaptor* dataAdaptor)
       return false;
       }
 
-    // add the required arrays
+    // add the required arrays, a batch per association
     ArrayRequirementsIterator ait =
       this->Requirements.GetArrayRequirementsIterator(meshName);
+    ait.SetMode(ArrayRequirementsIterator::MODE_ASSOCIATION);
 
     while (ait)
       {
-      if (dataAdaptor->AddArray(dobj, mit.MeshName(),
-         ait.Association(), ait.Array()))
+      if (dataAdaptor->AddArrays(dobj, mit.MeshName(),
+         ait.Association(), ait.Arrays()))
         {
         SENSEI_ERROR("Failed to add "
           << VTKUtils::GetAttributesName(ait.Association())
-          << " data array \"" << ait.Array() << "\" to mesh \""
-          << meshName << "\"")
+          << " data arrays to mesh \"" << meshName << "\"")
         return false;
         }
 
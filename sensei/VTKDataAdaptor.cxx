@@ -21,6 +21,8 @@
 
 #include <functional>
 #include <map>
+#include <set>
+#include <algorithm>
 #include <utility>
 
 using vtkDataObjectPtr = vtkSmartPointer<vtkDataObject>;
@@ -195,6 +197,65 @@ int VTKDataAdaptor::GetMesh(const std::string &meshName, bool structureOnly,
   return -1;
 }
 
+//----------------------------------------------------------------------------
+int VTKDataAdaptor::GetMesh(const std::string &meshName, bool structureOnly,
+  const std::vector<int> &blockIds, vtkCompositeDataSet *&mesh)
+{
+  mesh = nullptr;
+
+  vtkDataObject *dobj = nullptr;
+  if (this->GetDataObject(meshName, dobj))
+    {
+    SENSEI_ERROR("Failed to get mesh \"" << meshName << "\"")
+    return -1;
+    }
+
+  std::set<int> selected(blockIds.begin(), blockIds.end());
+
+  if (vtkCompositeDataSet *cd = dynamic_cast<vtkCompositeDataSet*>(dobj))
+    {
+    vtkCompositeDataSet *cdo = cd->NewInstance();
+    cdo->CopyStructure(cd);
+
+    // only the requested blocks are copied, the rest are left empty.
+    // the block id is the flat index of the leaf, see VTKUtils::GetMetadata
+    vtkCompositeDataIterator *cdit = cd->NewIterator();
+    while (!cdit->IsDoneWithTraversal())
+      {
+      int bid = std::max(0, int(cdit->GetCurrentFlatIndex() - 1));
+      if (selected.count(bid))
+        {
+        vtkDataObject *dobj = cd->GetDataSet(cdit);
+        vtkDataObject *dobjo = dobj->NewInstance();
+        if (!structureOnly)
+          {
+          if (vtkDataSet *ds = dynamic_cast<vtkDataSet*>(dobj))
+            {
+            vtkDataSet *dso = static_cast<vtkDataSet*>(dobjo);
+            dso->CopyStructure(ds);
+            }
+          }
+        cdo->SetDataSet(cdit, dobjo);
+        dobjo->Delete();
+        }
+
+      cdit->GoToNextItem();
+      }
+
+    cdit->Delete();
+
+    mesh = cdo;
+    return 0;
+    }
+
+  // a dataset is a single block with the rank as its id
+  if (dynamic_cast<vtkDataSet*>(dobj))
+    return this->Superclass::GetMesh(meshName, structureOnly, blockIds, mesh);
+
+  SENSEI_ERROR("Unsupoorted data object type " << dobj->GetClassName())
+  return -1;
+}
+
 //----------------------------------------------------------------------------
 int VTKDataAdaptor::AddArray(vtkDataObject* mesh, const std::string &meshName,
   int association, const std::string &arrayName)
@@ -238,6 +299,57 @@ int VTKDataAdaptor::AddArray(vtkDataObject* mesh, const std::string &meshName,
   return 0;
 }
 
+//----------------------------------------------------------------------------
+int VTKDataAdaptor::AddArrays(vtkDataObject* mesh, const std::string &meshName,
+  int association, const std::vector<std::string> &arrayNames)
+{
+  // define helper function to add all of the arrays to each block. this
+  // way the composite tree is traversed once rather than once per array
+  VTKUtils::BinaryDatasetFunction addArrays =
+    [&](vtkDataSet *ds, vtkDataSet *dsOut) -> int
+    {
+    vtkFieldData *dsa = VTKUtils::GetAttributes(ds, association);
+    vtkFieldData *dsaOut = VTKUtils::GetAttributes(dsOut, association);
+
+    unsigned int nArrays = arrayNames.size();
+    for (unsigned int i = 0; i < nArrays; ++i)
+      {
+      const std::string &arrayName = arrayNames[i];
+
+      vtkDataArray *da = dsa->GetArray(arrayName.c_str());
+      if (!da)
+        {
+        SENSEI_ERROR("No " << VTKUtils::GetAttributesName(association)
+          << " data array \"" << arrayName << "\" in mesh \""
+          << meshName)
+        return -1;
+        }
+
+      dsaOut->AddArray(da);
+      }
+
+    return 0;
+    };
+
+  // get the cached copy of the mesh
+  vtkDataObject *dobj = nullptr;
+  if (this->GetDataObject(meshName, dobj))
+    {
+    SENSEI_ERROR("Failed to get mesh \"" << meshName << "\"")
+    return -1;
+    }
+
+  // apply the helper function
+  if (VTKUtils::Apply(dobj, mesh, addArrays))
+    {
+    SENSEI_ERROR("Failed to add " << VTKUtils::GetAttributesName(association)
+      << " data arrays to mesh \"" << meshName  << "\"")
+    return -1;
+    }
+
+  return 0;
+}
+
 // TODO
 /*
 //----------------------------------------------------------------------------
@@ -84,6 +84,20 @@ public:
   int GetMesh(const std::string &meshName, bool structure_only,
     vtkDataObject *&mesh) override;
 
+  /// @brief Return a subset of the blocks of the mesh.
+  ///
+  /// Only the requested blocks are copied. When the data object is a
+  /// vtkDataSet it is treated as a single block whose id is the rank.
+  ///
+  /// @param[in] meshName the name of the mesh to access (see GetMeshMetadata)
+  /// @param[in] structureOnly When set to true the returned mesh may not
+  ///            have any geometry or topology information.
+  /// @param[in] blockIds the global ids of the blocks to return
+  /// @param[out] mesh a reference to a pointer where a new VTK object is stored
+  /// @returns zero if successful, non zero if an error occurred
+  int GetMesh(const std::string &meshName, bool structureOnly,
+    const std::vector<int> &blockIds, vtkCompositeDataSet *&mesh) override;
+
   /// @brief Adds the specified field array to the mesh.
   ///
   /// This method will add the requested array to the mesh, if available. If the
@@ -99,6 +113,19 @@ public:
   int AddArray(vtkDataObject* mesh, const std::string &meshName,
     int association, const std::string &arrayName) override;
 
+  /// @brief Adds the vector of field arrays to the mesh.
+  ///
+  /// All of the arrays are added in a single traversal of the mesh.
+  ///
+  /// @param[in] mesh the VTK object returned from GetMesh
+  /// @param[in] meshName the name of the mesh on which the array is stored
+  /// @param[in] association field association; one of
+  ///            vtkDataObject::FieldAssociations or vtkDataObject::AttributeTypes.
+  /// @param[in] arrayNames a vector of array names to add
+  /// @returns zero if successful, non zero if an error occurred
+  int AddArrays(vtkDataObject* mesh, const std::string &meshName,
+    int association, const std::vector<std::string> &arrayNames) override;
+
   /// @brief Release data allocated for the current timestep.
   ///
   /// Releases the data allocated for the current timestep. This is expected to
@@ -1,8 +1,14 @@
 #include "senseiConfig.h"
 #include "VTKHistogram.h"
+#include "TimeSeriesStore.h"
 #include "Error.h"
 
 #include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <type_traits>
 #include <vector>
 #include <cstdio>
 #include <cstring>
@@ -25,129 +31,323 @@
 
 namespace sensei
 {
-// Private worker for Histogram method. Computes the local Histogram on
-// array (passed to operator()). To be used with vtkArrayDispatch.
-//
-// Inputs:
-// range: Global range of data
-// bins: Number of Histogram bins
-// array: Local data.
-//
-// Outputs:
-// Histogram: The Histogram of the local data.
-#ifdef ENABLE_VTK_GENERIC_ARRAYS
-struct VTKHistogram::Internals
+namespace
 {
-  const double *Range;
-  int Bins;
-  std::vector<unsigned int> Histogram;
+// the kernels below work on chunks of this many values. within a chunk the
+// loops have no branches or loop carried dependencies, so that the
+// compiler can vectorize them.
+constexpr vtkIdType ChunkSize = 256;
+
+// the number of lanes the min and max reductions are spread over
+constexpr int NumLanes = 8;
+
+// the arithmetic type used when binning values of type T. float data is
+// binned in single precision which doubles the vector width.
+template <typename T>
+using calc_t = typename std::conditional<std::is_same<T,float>::value,
+  float, double>::type;
+
+// Load the selected component, or the magnitude when comp is negative, of
+// tuples [i, i + n) into buf.
+template <typename T, typename ct>
+void loadChunk(const T *vals, int nComps, int comp, vtkIdType i, int n,
+  ct *buf)
+{
+  if (nComps == 1)
+    {
+    const T *p = vals + i;
+    for (int j = 0; j < n; ++j)
+      buf[j] = static_cast<ct>(p[j]);
+    }
+  else if (comp >= 0)
+    {
+    const T *p = vals + i*nComps + comp;
+    for (int j = 0; j < n; ++j)
+      buf[j] = static_cast<ct>(p[j*nComps]);
+    }
+  else
+    {
+    const T *p = vals + i*nComps;
+    for (int j = 0; j < n; ++j)
+      {
+      ct sum = ct(0);
+      for (int c = 0; c < nComps; ++c)
+        {
+        ct v = static_cast<ct>(p[j*nComps + c]);
+        sum += v*v;
+        }
+      buf[j] = std::sqrt(sum);
+      }
+    }
+}
 
-  Internals(const double *range, int bins) :
-    Range(range), Bins(bins), Histogram(bins,0.0) {}
+#ifdef ENABLE_VTK_GENERIC_ARRAYS
+// the same for arrays that are not AOS
+template <typename ArrayT, typename ct>
+void loadChunkGeneric(ArrayT *array, int nComps, int comp, vtkIdType i,
+  int n, ct *buf)
+{
+  for (int j = 0; j < n; ++j)
+    {
+    if (comp >= 0)
+      {
+      buf[j] = static_cast<ct>(array->GetTypedComponent(i + j, comp));
+      }
+    else
+      {
+      ct sum = ct(0);
+      for (int c = 0; c < nComps; ++c)
+        {
+        ct v = static_cast<ct>(array->GetTypedComponent(i + j, c));
+        sum += v*v;
+        }
+      buf[j] = std::sqrt(sum);
+      }
+    }
+}
+#endif
 
-  template <typename ArrayT>
-  void operator()(ArrayT *array)
-  {
-    assert(array);
-    assert(array->GetNumberOfComponents() == 1);
+// Reduce the min and max of a chunk into the lanes. Ghosts are replaced
+// by the identity of the reduction rather than branched on.
+template <typename ct>
+void rangeChunk(const ct *buf, const unsigned char *ghosts, int n,
+  ct *lo, ct *hi)
+{
+  const ct hiId = std::numeric_limits<ct>::lowest();
+  const ct loId = std::numeric_limits<ct>::max();
 
-    typedef typename ArrayT::ValueType ValueType;
+  int j = 0;
+  int vn = (n/NumLanes)*NumLanes;
+  if (ghosts)
+    {
+    for (; j < vn; j += NumLanes)
+      {
+      for (int k = 0; k < NumLanes; ++k)
+        {
+        ct v = buf[j + k];
+        bool g = ghosts[j + k];
+        lo[k] = std::min(lo[k], g ? loId : v);
+        hi[k] = std::max(hi[k], g ? hiId : v);
+        }
+      }
+    for (; j < n; ++j)
+      {
+      if (!ghosts[j])
+        {
+        lo[0] = std::min(lo[0], buf[j]);
+        hi[0] = std::max(hi[0], buf[j]);
+        }
+      }
+    }
+  else
+    {
+    for (; j < vn; j += NumLanes)
+      {
+      for (int k = 0; k < NumLanes; ++k)
+        {
+        lo[k] = std::min(lo[k], buf[j + k]);
+        hi[k] = std::max(hi[k], buf[j + k]);
+        }
+      }
+    for (; j < n; ++j)
+      {
+      lo[0] = std::min(lo[0], buf[j]);
+      hi[0] = std::max(hi[0], buf[j]);
+      }
+    }
+}
 
-    ValueType width = static_cast<ValueType>((this->Range[1]
-      - this->Range[0]) / this->Bins);
+// Compute the min and max of tuples [start, end) skipping ghosts. load
+// fills a chunk with the values of the variable.
+template <typename ct, typename load_t>
+void rangeKernel(const load_t &load, const unsigned char *ghosts,
+  vtkIdType start, vtkIdType end, double range[2])
+{
+  ct lo[NumLanes];
+  ct hi[NumLanes];
+  for (int k = 0; k < NumLanes; ++k)
+    {
+    lo[k] = std::numeric_limits<ct>::max();
+    hi[k] = std::numeric_limits<ct>::lowest();
+    }
 
-    ValueType min = static_cast<ValueType>(this->Range[0]);
-    vtkIdType numTuples = array->GetNumberOfTuples();
+  ct buf[ChunkSize];
+  for (vtkIdType i = start; i < end; i += ChunkSize)
+    {
+    int n = static_cast<int>(std::min(ChunkSize, end - i));
+    load(i, n, buf);
+    rangeChunk(buf, ghosts ? ghosts + i : nullptr, n, lo, hi);
+    }
 
-    // + 1 to store val == max. These will be moved to this last bin before
-    // returning (Avoids having to branch in the loop below);
-    this->Histogram.resize(this->Bins + 1, 0);
-    for (vtkIdType tIdx = 0; tIdx < numTuples; ++tIdx)
+  // an empty or all ghost range leaves the identity, which is not merged
+  for (int k = 0; k < NumLanes; ++k)
+    {
+    if (lo[k] <= hi[k])
       {
-      int bin = static_cast<int>((array->GetComponent(tIdx, 0) - min) / width);
-      ++this->Histogram[bin];
+      range[0] = std::min(range[0], static_cast<double>(lo[k]));
+      range[1] = std::max(range[1], static_cast<double>(hi[k]));
       }
+    }
+}
 
-    // Merge the last two bins (the last is only when val == max)
-    this->Histogram[this->Bins-1] += this->Histogram[this->Bins];
-    this->Histogram.resize(this->Bins);
-  }
-};
-#else
-struct VTKHistogram::Internals
+// Bin tuples [start, end) skipping ghosts and NaN. hist must have nBins + 1
+// entries, the last one collects the ghosts and NaN and is discarded. Bin
+// indices for a chunk are computed with a multiply by the inverse width,
+// clamped so that val == max lands in the last bin, and ghosts and NaN are
+// redirected to the discard bin with a select. The scatter into the
+// histogram follows.
+template <typename ct, typename load_t>
+void binKernel(const load_t &load, const unsigned char *ghosts,
+  vtkIdType start, vtkIdType end, double min, double invWidth, int nBins,
+  unsigned int *hist)
 {
-  vtkUnsignedCharArray* GhostArray;
-  const double *Range;
-  int Bins;
-  std::vector<unsigned int> Histogram;
+  const ct cmin = static_cast<ct>(min);
+  const ct cinv = static_cast<ct>(invWidth);
+  const ct cmax = static_cast<ct>(nBins - 1);
 
-  Internals(const double *range, int bins) :
-    GhostArray(NULL), Range(range), Bins(bins), Histogram(bins,0.0) {}
+  ct buf[ChunkSize];
+  int ids[ChunkSize];
 
-  template <typename T>
-  void operator()(const vtkDataArrayDispatcherPointer<T>& array)
-  {
-    assert(array.NumberOfComponents == 1);
-
-    typedef T ValueType;
-    ValueType width = static_cast<ValueType>((this->Range[1] - this->Range[0]) / this->Bins);
-    ValueType min = static_cast<ValueType>(this->Range[0]);
-    vtkIdType numTuples = array.NumberOfTuples;
-
-    // + 1 to store val == max. These will be moved to this last bin before
-    // returning (Avoids having to branch in the loop below);
-    this->Histogram.resize(this->Bins + 1, 0);
-    if (this->GhostArray)
+  for (vtkIdType i = start; i < end; i += ChunkSize)
+    {
+    int n = static_cast<int>(std::min(ChunkSize, end - i));
+    load(i, n, buf);
+
+    // clamping in floating point first keeps the conversion defined for
+    // values outside of the range, as ghosts may be. the constant is the
+    // first argument of std::max so that NaN, which compares false, is
+    // replaced by 0
+    for (int j = 0; j < n; ++j)
       {
-      for (vtkIdType tIdx = 0; tIdx < numTuples; ++tIdx)
-        {
-        if (this->GhostArray->GetValue(tIdx) == 0)
-          {
-          int bin = static_cast<int>((array.RawPointer[tIdx] - min) / width);
-          ++this->Histogram[bin];
-          }
-        }
+      ct x = (buf[j] - cmin)*cinv;
+      x = std::min(std::max(ct(0), x), cmax);
+      ids[j] = static_cast<int>(x);
       }
-    else
+
+    // NaN is not counted, as it is left out of the range
+    for (int j = 0; j < n; ++j)
+      ids[j] = buf[j] != buf[j] ? nBins : ids[j];
+
+    if (ghosts)
       {
-      for (vtkIdType tIdx = 0; tIdx < numTuples; ++tIdx)
-        {
-        int bin = static_cast<int>((array.RawPointer[tIdx] - min) / width);
-        ++this->Histogram[bin];
-        }
+      const unsigned char *pg = ghosts + i;
+      for (int j = 0; j < n; ++j)
+        ids[j] = pg[j] ? nBins : ids[j];
       }
 
-    // Merge the last two bins (the last is only when val == max)
-    this->Histogram[this->Bins-1] += this->Histogram[this->Bins];
-    this->Histogram.resize(this->Bins);
+    for (int j = 0; j < n; ++j)
+      ++hist[ids[j]];
+    }
+}
+
+// Private worker for Histogram method. Computes the local Histogram of a
+// variable over tuples [Start, End) of the array (passed to operator()),
+// skipping ghosts. To be used with vtkArrayDispatch or
+// vtkDataArrayDispatcher.
+//
+// Inputs:
+// range: Global range of the variable
+// bins: Number of Histogram bins
+// array: Local data.
+//
+// Outputs:
+// Histogram: The Histogram of the local data, with an extra bin for ghosts
+struct BinWorker
+{
+  const unsigned char *Ghosts;
+  vtkIdType Start;
+  vtkIdType End;
+  int Component;
+  double Min;
+  double InvWidth;
+  int Bins;
+  unsigned int *Histogram;
+
+  template <typename T>
+  void Bin(const T *vals, int nComps)
+  {
+    using ct = calc_t<T>;
+    int comp = this->Component;
+    binKernel<ct>([&](vtkIdType i, int n, ct *buf)
+      { loadChunk(vals, nComps, comp, i, n, buf); },
+      this->Ghosts, this->Start, this->End, this->Min, this->InvWidth,
+      this->Bins, this->Histogram);
+  }
+
+#ifdef ENABLE_VTK_GENERIC_ARRAYS
+  template <typename T>
+  void operator()(vtkAOSDataArrayTemplate<T> *array)
+  {
+    this->Bin(array->GetPointer(0), array->GetNumberOfComponents());
+  }
+
+  // arrays with other memory layouts are gathered a chunk at a time
+  template <typename ArrayT>
+  void operator()(ArrayT *array)
+  {
+    using ct = calc_t<typename ArrayT::ValueType>;
+    int nComps = array->GetNumberOfComponents();
+    int comp = this->Component;
+    binKernel<ct>([&](vtkIdType i, int n, ct *buf)
+      { loadChunkGeneric(array, nComps, comp, i, n, buf); },
+      this->Ghosts, this->Start, this->End, this->Min, this->InvWidth,
+      this->Bins, this->Histogram);
   }
+#else
+  template <typename T>
+  void operator()(const vtkDataArrayDispatcherPointer<T>& array)
+  {
+    this->Bin(array.RawPointer, array.NumberOfComponents);
+  }
+#endif
 };
 
-// Compute array range by skipping ghost elements.
+// Compute the range of a variable by skipping ghost elements.
 class ComponentRangeWorker
 {
 public:
-  ComponentRangeWorker(vtkUnsignedCharArray* ghostArray) :
-    GhostArray(ghostArray)
+  ComponentRangeWorker(const unsigned char *ghosts, vtkIdType start,
+    vtkIdType end, int comp) : Ghosts(ghosts), Start(start), End(end),
+    Component(comp)
     {
     this->Range[0] = vtkTypeTraits<double>::Max();
     this->Range[1] = vtkTypeTraits<double>::Min();
     }
 
+  template <typename T>
+  void Reduce(const T *vals, int nComps)
+    {
+    using ct = calc_t<T>;
+    int comp = this->Component;
+    rangeKernel<ct>([&](vtkIdType i, int n, ct *buf)
+      { loadChunk(vals, nComps, comp, i, n, buf); },
+      this->Ghosts, this->Start, this->End, this->Range);
+    }
+
+#ifdef ENABLE_VTK_GENERIC_ARRAYS
+  template <typename T>
+  void operator()(vtkAOSDataArrayTemplate<T> *array)
+    {
+    this->Reduce(array->GetPointer(0), array->GetNumberOfComponents());
+    }
+
+  template <typename ArrayT>
+  void operator()(ArrayT *array)
+    {
+    using ct = calc_t<typename ArrayT::ValueType>;
+    int nComps = array->GetNumberOfComponents();
+    int comp = this->Component;
+    rangeKernel<ct>([&](vtkIdType i, int n, ct *buf)
+      { loadChunkGeneric(array, nComps, comp, i, n, buf); },
+      this->Ghosts, this->Start, this->End, this->Range);
+    }
+#else
   template <typename T>
   void operator()(const vtkDataArrayDispatcherPointer<T>& array)
     {
-    assert(array.NumberOfComponents == 1);
-    vtkIdType numTuples = array.NumberOfTuples;
-    for (vtkIdType cc=0; cc < numTuples; cc++)
-      {
-      if (this->GhostArray->GetValue(cc) == 0)
-        {
-        this->Range[0] = std::min(this->Range[0], static_cast<double>(array.RawPointer[cc]));
-        this->Range[1] = std::max(this->Range[1], static_cast<double>(array.RawPointer[cc]));
-        }
-      }
+    this->Reduce(array.RawPointer, array.NumberOfComponents);
     }
+#endif
 
   void GetRange(double r[2])
     {
@@ -155,181 +355,462 @@ public:
     }
 private:
   double Range[2];
-  vtkUnsignedCharArray* GhostArray;
+  const unsigned char *Ghosts;
+  vtkIdType Start;
+  vtkIdType End;
+  int Component;
 };
-#endif
+}
 
 // --------------------------------------------------------------------------
-VTKHistogram::VTKHistogram()
+constexpr int VTKHistogram::MAGNITUDE;
+
+// --------------------------------------------------------------------------
+VTKHistogram::VTKHistogram(unsigned int nVars, unsigned int nThreads) :
+  NumVars(std::max(nVars, 1u)), NumThreads(std::max(nThreads, 1u)), Bins(0),
+  Refine(1), RangeRequest(MPI_REQUEST_NULL),
+  HistogramRequest(MPI_REQUEST_NULL), Comm(MPI_COMM_NULL), Step(0),
+  Time(0.0), Store(nullptr)
 {
-  this->Range[0] = VTK_DOUBLE_MAX;
-  this->Range[1] = VTK_DOUBLE_MIN;
-  this->Worker = NULL;
+  this->Range.resize(2*this->NumVars);
+  for (unsigned int i = 0; i < this->NumVars; ++i)
+    {
+    this->Range[2*i] = VTK_DOUBLE_MAX;
+    this->Range[2*i+1] = VTK_DOUBLE_MIN;
+    }
+
+  unsigned int n = this->NumVars*this->NumThreads;
+  this->ThreadRange.resize(2*n);
+  for (unsigned int i = 0; i < n; ++i)
+    {
+    this->ThreadRange[2*i] = VTK_DOUBLE_MAX;
+    this->ThreadRange[2*i+1] = VTK_DOUBLE_MIN;
+    }
 }
 
 // --------------------------------------------------------------------------
 VTKHistogram::~VTKHistogram()
 {
-  delete this->Worker;
+  // non-blocking collectives can not be freed, they must be completed
+  int finalized = 0;
+  MPI_Finalized(&finalized);
+  if (!finalized)
+    {
+    MPI_Wait(&this->RangeRequest, MPI_STATUS_IGNORE);
+    MPI_Wait(&this->HistogramRequest, MPI_STATUS_IGNORE);
+    }
 }
 
 // --------------------------------------------------------------------------
 void VTKHistogram::AddRange(vtkDataArray* da,
-  vtkUnsignedCharArray* ghostArray)
+  vtkUnsignedCharArray* ghostArray, unsigned int thread,
+  vtkIdType start, vtkIdType end, unsigned int var, int component)
 {
-#ifdef ENABLE_VTK_GENERIC_ARRAYS
-  (void)ghostArray;
-  if (da)
+  if (!da)
+    return;
+
+  if (end < 0)
+    end = da->GetNumberOfTuples();
+
+  double *range = &this->ThreadRange[2*(thread*this->NumVars + var)];
+  double crange[2] = { vtkTypeTraits<double>::Max(), vtkTypeTraits<double>::Min() };
+
+  if (!ghostArray && (start == 0) && (end == da->GetNumberOfTuples()))
     {
-    double crange[2];
-    da->GetRange(crange);
-    this->Range[0] = std::min(this->Range[0], crange[0]);
-    this->Range[1] = std::max(this->Range[1], crange[1]);
+    // VTK caches the range of the whole array, a component of -1 is
+    // the magnitude as here
+    da->GetRange(crange, component);
     }
-#else
-  double crange[2] = { vtkTypeTraits<double>::Max(), vtkTypeTraits<double>::Min() };
-  if (da && ghostArray)
+  else
     {
-    ComponentRangeWorker worker(ghostArray);
+    ComponentRangeWorker worker(ghostArray ? ghostArray->GetPointer(0) : nullptr,
+      start, end, component);
+#ifdef ENABLE_VTK_GENERIC_ARRAYS
+    vtkArrayDispatch::Dispatch::Execute(da, worker);
+#else
     vtkDataArrayDispatcher<ComponentRangeWorker> dispatcher(worker);
     dispatcher.Go(da);
+#endif
     worker.GetRange(crange);
     }
-  else if (da)
-    {
-    da->GetRange(crange);
-    }
-  this->Range[0] = std::min(this->Range[0], crange[0]);
-  this->Range[1] = std::max(this->Range[1], crange[1]);
-#endif
+
+  range[0] = std::min(range[0], crange[0]);
+  range[1] = std::max(range[1], crange[1]);
 }
 
 // --------------------------------------------------------------------------
 void VTKHistogram::Compute(vtkDataArray* da,
-  vtkUnsignedCharArray* ghostArray)
+  vtkUnsignedCharArray* ghostArray, unsigned int thread,
+  vtkIdType start, vtkIdType end, unsigned int var, int component)
 {
-  if (da)
-    {
+  if (!da)
+    return;
+
+  const double *range = &this->Range[2*var];
+  double width = (range[1] - range[0]) / this->Bins;
+
+  BinWorker worker;
+  worker.Ghosts = ghostArray ? ghostArray->GetPointer(0) : nullptr;
+  worker.Start = start;
+  worker.End = end < 0 ? da->GetNumberOfTuples() : end;
+  worker.Component = component;
+  worker.Min = range[0];
+  worker.InvWidth = width > 0.0 ? 1.0 / width : 0.0;
+  worker.Bins = this->Bins;
+  worker.Histogram = &this->ThreadHistogram[
+    (thread*this->NumVars + var)*(this->Bins + 1)];
+
 #ifdef ENABLE_VTK_GENERIC_ARRAYS
-    (void)ghostArray;
-    vtkArrayDispatch::Dispatch::Execute(da, *this->Worker);
+  vtkArrayDispatch::Dispatch::Execute(da, worker);
 #else
-    this->Worker->GhostArray = ghostArray;
-    vtkDataArrayDispatcher<Internals> dispatcher(*this->Worker);
-    dispatcher.Go(da);
-    this->Worker->GhostArray = NULL;
+  vtkDataArrayDispatcher<BinWorker> dispatcher(worker);
+  dispatcher.Go(da);
 #endif
+}
+
+// --------------------------------------------------------------------------
+void VTKHistogram::GetLocalRange(std::vector<double> &range)
+{
+  unsigned int nVars = this->NumVars;
+  range.resize(2*nVars);
+  for (unsigned int j = 0; j < nVars; ++j)
+    {
+    double r[2] = {this->Range[2*j], this->Range[2*j+1]};
+    for (unsigned int i = 0; i < this->NumThreads; ++i)
+      {
+      const double *tr = &this->ThreadRange[2*(i*nVars + j)];
+      r[0] = std::min(r[0], tr[0]);
+      r[1] = std::max(r[1], tr[1]);
+      }
+    range[2*j] = r[0];
+    range[2*j+1] = r[1];
+    }
+}
+
+// --------------------------------------------------------------------------
+void VTKHistogram::GetLocalHistogram(std::vector<unsigned int> &hist)
+{
+  unsigned int nVars = this->NumVars;
+  int nBins = this->Bins;
+
+  // combine the per-thread histograms, dropping the ghost bins
+  hist.assign(nVars*nBins, 0);
+  for (unsigned int i = 0; i < this->NumThreads; ++i)
+    {
+    for (unsigned int j = 0; j < nVars; ++j)
+      {
+      const unsigned int *thist =
+        &this->ThreadHistogram[(i*nVars + j)*(nBins + 1)];
+      unsigned int *vhist = &hist[j*nBins];
+      for (int k = 0; k < nBins; ++k)
+        vhist[k] += thist[k];
+      }
     }
 }
 
 // --------------------------------------------------------------------------
 void VTKHistogram::PreCompute(MPI_Comm comm, int bins)
 {
-  double g_range[2];
-  // Find the global max/min
-  MPI_Allreduce(&this->Range[0], &g_range[0], 1, MPI_DOUBLE, MPI_MIN, comm);
-  MPI_Allreduce(&this->Range[1], &g_range[1], 1, MPI_DOUBLE, MPI_MAX, comm);
-  this->Range[0] = g_range[0];
-  this->Range[1] = g_range[1];
-  this->Worker = new Internals(this->Range, bins);
+  this->StartRange(comm);
+  this->FinishRange(this->Range);
+
+  this->Bins = bins;
+  this->ThreadHistogram.assign(this->NumThreads*this->NumVars*(bins + 1), 0);
+}
+
+// --------------------------------------------------------------------------
+void VTKHistogram::PreCompute(int bins, const std::vector<double> &range)
+{
+  std::copy(range.begin(), range.begin() + 2*this->NumVars,
+    this->Range.begin());
+
+  this->Bins = bins;
+  this->ThreadHistogram.assign(this->NumThreads*this->NumVars*(bins + 1), 0);
+}
+
+// --------------------------------------------------------------------------
+void VTKHistogram::PreComputeProvisional(int bins, int refine)
+{
+  this->GetLocalRange(this->Range);
+
+  this->Refine = std::max(refine, 1);
+  this->Bins = bins*this->Refine;
+  this->ThreadHistogram.assign(
+    this->NumThreads*this->NumVars*(this->Bins + 1), 0);
+}
+
+// --------------------------------------------------------------------------
+void VTKHistogram::Rebin(const std::vector<double> &range)
+{
+  unsigned int nVars = this->NumVars;
+  int nFine = this->Bins;
+  int nBins = nFine/this->Refine;
+
+  std::vector<unsigned int> hist(this->NumThreads*nVars*(nBins + 1), 0);
+
+  for (unsigned int j = 0; j < nVars; ++j)
+    {
+    // an empty local range has no counts
+    double fmin = this->Range[2*j];
+    double fmax = this->Range[2*j+1];
+    if (fmin > fmax)
+      continue;
+
+    double fwidth = (fmax - fmin) / nFine;
+
+    double gmin = range[2*j];
+    double gwidth = (range[2*j+1] - gmin) / nBins;
+    double ginv = gwidth > 0.0 ? 1.0 / gwidth : 0.0;
+
+    unsigned int *vhist = &hist[j*(nBins + 1)];
+    for (unsigned int i = 0; i < this->NumThreads; ++i)
+      {
+      const unsigned int *thist =
+        &this->ThreadHistogram[(i*nVars + j)*(nFine + 1)];
+
+      for (int k = 0; k < nFine; ++k)
+        {
+        if (!thist[k])
+          continue;
+
+        double x = (fmin + (k + 0.5)*fwidth - gmin)*ginv;
+        x = std::min(std::max(0.0, x), double(nBins - 1));
+        vhist[static_cast<int>(x)] += thist[k];
+        }
+      }
+    }
+
+  std::copy(range.begin(), range.begin() + 2*nVars, this->Range.begin());
+
+  this->Bins = nBins;
+  this->Refine = 1;
+  this->ThreadHistogram.swap(hist);
+}
+
+// --------------------------------------------------------------------------
+void VTKHistogram::StartRange(MPI_Comm comm)
+{
+  MPI_Wait(&this->RangeRequest, MPI_STATUS_IGNORE);
+
+  // the mins are negated so that a single reduction finds the ranges of
+  // all of the variables
+  this->GetLocalRange(this->GlobalRange);
+
+  unsigned int nVars = this->NumVars;
+  for (unsigned int j = 0; j < nVars; ++j)
+    this->GlobalRange[2*j] = -this->GlobalRange[2*j];
+
+  MPI_Iallreduce(MPI_IN_PLACE, this->GlobalRange.data(), 2*nVars,
+    MPI_DOUBLE, MPI_MAX, comm, &this->RangeRequest);
+}
+
+// --------------------------------------------------------------------------
+int VTKHistogram::FinishRange(std::vector<double> &range)
+{
+  if (this->RangeRequest != MPI_REQUEST_NULL)
+    {
+    MPI_Wait(&this->RangeRequest, MPI_STATUS_IGNORE);
+
+    unsigned int nVars = this->NumVars;
+    for (unsigned int j = 0; j < nVars; ++j)
+      this->GlobalRange[2*j] = -this->GlobalRange[2*j];
+    }
+
+  if (this->GlobalRange.empty())
+    return -1;
+
+  range = this->GlobalRange;
+  return 0;
+}
+
+// --------------------------------------------------------------------------
+void VTKHistogram::PostCompute(MPI_Comm comm, int step, double time,
+  const std::string &meshName, const std::vector<std::string> &varNames,
+  const std::string &fileName)
+{
+  this->StartPostCompute(comm, step, time, meshName, varNames, fileName);
+  this->FinishPostCompute();
 }
 
 // --------------------------------------------------------------------------
-void VTKHistogram::PostCompute(MPI_Comm comm, int nBins, int step,
-  double time, const std::string &meshName, const std::string &arrayName,
+void VTKHistogram::StartPostCompute(MPI_Comm comm, int step, double time,
+  const std::string &meshName, const std::vector<std::string> &varNames,
   const std::string &fileName)
 {
-  std::vector<unsigned int> gHist(nBins, 0);
+  this->FinishPostCompute();
+
+  unsigned int nVars = this->NumVars;
+  int nBins = this->Bins;
 
-  MPI_Reduce(&this->Worker->Histogram[0], &gHist[0],
-    nBins, MPI_UNSIGNED, MPI_SUM, 0, comm);
+  this->GetLocalHistogram(this->LocalHistogram);
 
   int rank = 0;
   MPI_Comm_rank(comm, &rank);
 
+  // a single reduction for all of the variables
+  this->Histogram.assign(rank == 0 ? nVars*nBins : 0, 0);
+
+  MPI_Ireduce(this->LocalHistogram.data(), this->Histogram.data(),
+    nVars*nBins, MPI_UNSIGNED, MPI_SUM, 0, comm, &this->HistogramRequest);
+
+  this->Comm = comm;
+  this->Step = step;
+  this->Time = time;
+  this->MeshName = meshName;
+  this->VarNames = varNames;
+  this->FileName = fileName;
+}
+
+// --------------------------------------------------------------------------
+void VTKHistogram::FinishPostCompute()
+{
+  if (this->HistogramRequest == MPI_REQUEST_NULL)
+    return;
+
+  MPI_Wait(&this->HistogramRequest, MPI_STATUS_IGNORE);
+
+  this->LocalHistogram.clear();
+
+  int rank = 0;
+  MPI_Comm_rank(this->Comm, &rank);
+
   if (rank == 0)
+    this->WriteHistogram();
+}
+
+// --------------------------------------------------------------------------
+void VTKHistogram::WriteHistogram()
+{
+  MPI_Comm comm = this->Comm;
+  int step = this->Step;
+  double time = this->Time;
+  const std::string &meshName = this->MeshName;
+  const std::vector<std::string> &varNames = this->VarNames;
+  const std::string &fileName = this->FileName;
+  const std::vector<unsigned int> &gHist = this->Histogram;
+
+  unsigned int nVars = this->NumVars;
+  int nBins = this->Bins;
+
+  // if there was an error range is initialized to [DOUBLE_MAX, DOUBLE_MIN]
+  for (unsigned int j = 0; j < nVars; ++j)
     {
-    // if there was an error range is initialized to [DOUBLE_MAX, DOUBLE_MIN]
-    if (this->Range[0] >= this->Range[1])
+    if (this->Range[2*j] >= this->Range[2*j+1])
       {
       SENSEI_ERROR("Invalid histgram range ["
-        << this->Range[0] << " - " << this->Range[1] << "]")
+        << this->Range[2*j] << " - " << this->Range[2*j+1] << "] for \""
+        << varNames[j] << "\"")
       MPI_Abort(comm, -1);
       return;
       }
+    }
 
-    if (fileName.empty())
+  if (this->Store)
+    {
+    // a record per variable, the range followed by the bins
+    for (unsigned int j = 0; j < nVars; ++j)
       {
-      // print the histogram nBins, range of each bin and count.
-      int origPrec = cout.precision();
-      std::cout.precision(4);
+      if (this->Store->Append(step, time, j, &this->Range[2*j], 2,
+        &gHist[j*nBins], nBins))
+        {
+        SENSEI_ERROR("Failed to append the histogram of \""
+          << varNames[j] << "\"")
+        MPI_Abort(comm, -1);
+        return;
+        }
+      }
+    }
+  else if (fileName.empty())
+    {
+    // print the histogram nBins, range of each bin and count.
+    int origPrec = cout.precision();
+    std::cout.precision(4);
+
+    for (unsigned int j = 0; j < nVars; ++j)
+      {
+      const double *range = &this->Range[2*j];
+      const unsigned int *vhist = &gHist[j*nBins];
 
       std::cout << "Histogram mesh \"" << meshName << "\" data array \""
-        << arrayName << "\" step " << step << " time " << time << std::endl;
+        << varNames[j] << "\" step " << step << " time " << time << std::endl;
 
-      double width = (this->Range[1] - this->Range[0]) / nBins;
+      double width = (range[1] - range[0]) / nBins;
       for (int i = 0; i < nBins; ++i)
         {
         const int wid = 15;
-        std::cout << std::scientific << std::setw(wid) << std::right << this->Range[0] + i*width
-          << " - " << std::setw(wid) << std::left << this->Range[0] + (i+1)*width
-          << ": " << std::fixed << gHist[i] << std::endl;
+        std::cout << std::scientific << std::setw(wid) << std::right << range[0] + i*width
+          << " - " << std::setw(wid) << std::left << range[0] + (i+1)*width
+          << ": " << std::fixed << vhist[i] << std::endl;
         }
-
-      std::cout.precision(origPrec);
       }
+
+    std::cout.precision(origPrec);
+    }
+  else
+    {
+    // all of the variables go in one file. with a single variable the
+    // array name is part of the file name, as it always was
+    char fname[1024] = {'\0'};
+    if (nVars == 1)
+      snprintf(fname, 1024, "%s_%s_%s_%d.txt", fileName.c_str(),
+        meshName.c_str(), varNames[0].c_str(), step);
     else
+      snprintf(fname, 1024, "%s_%s_%d.txt", fileName.c_str(),
+        meshName.c_str(), step);
+
+    FILE *file = fopen(fname, "w");
+    if (!file)
       {
-      char fname[1024] = {'\0'};
-      snprintf(fname, 1024, "%s_%s_%s_%d.txt", fileName.c_str(),
-        meshName.c_str(), arrayName.c_str(), step);
+      char *estr = strerror(errno);
+      SENSEI_ERROR("Failed to open \"" << fname << "\""
+        << std::endl << estr)
+      MPI_Abort(comm, -1);
+      return;
+      }
 
-      FILE *file = fopen(fname, "w");
-      if (!file)
-        {
-        char *estr = strerror(errno);
-        SENSEI_ERROR("Failed to open \"" << fname << "\""
-          << std::endl << estr)
-        MPI_Abort(comm, -1);
-        return;
-        }
+    fprintf(file, "step : %d\n", step);
+    fprintf(file, "time : %0.6g\n", time);
+    fprintf(file, "num bins : %d\n", nBins);
+    for (unsigned int j = 0; j < nVars; ++j)
+      {
+      const double *range = &this->Range[2*j];
+      const unsigned int *vhist = &gHist[j*nBins];
 
-      fprintf(file, "step : %d\n", step);
-      fprintf(file, "time : %0.6g\n", time);
-      fprintf(file, "num bins : %d\n", nBins);
-      fprintf(file, "range : %0.6g %0.6g\n", this->Range[0], this->Range[1]);
+      if (nVars > 1)
+        fprintf(file, "array : %s\n", varNames[j].c_str());
+      fprintf(file, "range : %0.6g %0.6g\n", range[0], range[1]);
       fprintf(file, "bin edges : ");
-      double width = (this->Range[1] - this->Range[0]) / nBins;
+      double width = (range[1] - range[0]) / nBins;
       for (int i = 0; i < nBins + 1; ++i)
-        fprintf(file, "%0.6g ", this->Range[0] + i*width);
+        fprintf(file, "%0.6g ", range[0] + i*width);
       fprintf(file, "\n");
       fprintf(file, "counts : ");
       for (int i = 0; i < nBins; ++i)
-        fprintf(file, "%d ", gHist[i]);
+        fprintf(file, "%d ", vhist[i]);
       fprintf(file, "\n");
-      fclose(file);
       }
-
-    // cache the last result, the simulation can access it
-    this->Worker->Histogram = gHist;
+    fclose(file);
     }
 }
 
 // --------------------------------------------------------------------------
-int VTKHistogram::GetHistogram(MPI_Comm comm, double &min, double &max,
-  std::vector<unsigned int> &bins)
+int VTKHistogram::GetHistogram(MPI_Comm comm, unsigned int var,
+  double &min, double &max, std::vector<unsigned int> &bins)
 {
-  if (!this->Worker)
+  if ((this->Bins < 1) || (var >= this->NumVars))
     return -1;
 
+  this->FinishPostCompute();
+
   int rank = 0;
   MPI_Comm_rank(comm, &rank);
 
-  if (rank == 0)
+  if ((rank == 0) && !this->Histogram.empty())
     {
-    min = this->Range[0];
-    max = this->Range[1];
-    bins = this->Worker->Histogram;
+    min = this->Range[2*var];
+    max = this->Range[2*var+1];
+    bins.assign(this->Histogram.begin() + var*this->Bins,
+      this->Histogram.begin() + (var + 1)*this->Bins);
     }
 
   return 0;
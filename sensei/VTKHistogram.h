@@ -4,6 +4,7 @@
 class vtkUnsignedCharArray;
 class vtkDataArray;
 
+#include <vtkType.h>
 #include <mpi.h>
 #include <string>
 #include <vector>
@@ -11,34 +12,143 @@ class vtkDataArray;
 namespace sensei
 {
 
+class TimeSeriesStore;
+
+/// Computes histograms of one or more variables. A variable is a component
+/// of a data array or the magnitude of its tuples. The ranges of all of the
+/// variables are reduced together, as are the histograms, so that the cost
+/// in collectives does not grow with the number of variables.
+///
+/// The reductions may be overlapped with computation. StartRange reduces
+/// the ranges in the background while the data is binned into a
+/// provisional histogram, or over a range known in advance, and
+/// StartPostCompute reduces the bins in the background so that the caller
+/// may complete the reduction later, for instance at the next time step.
 class VTKHistogram
 {
 public:
-    VTKHistogram();
+    // pass as the component to bin the magnitude of the tuples
+    static constexpr int MAGNITUDE = -1;
+
+    // nVars is the number of variables. nThreads is the number of threads
+    // that may call AddRange and Compute concurrently, each passing its own
+    // thread id in [0, nThreads)
+    VTKHistogram(unsigned int nVars = 1, unsigned int nThreads = 1);
     ~VTKHistogram();
 
-    void AddRange(vtkDataArray* da, vtkUnsignedCharArray* ghostArray);
+    // accumulate the range of the var'th variable over values [start, end)
+    // of the array, by default the whole array. ghosts are skipped.
+    void AddRange(vtkDataArray* da, vtkUnsignedCharArray* ghostArray,
+      unsigned int thread = 0, vtkIdType start = 0, vtkIdType end = -1,
+      unsigned int var = 0, int component = 0);
 
-    // compute the global min and max
+    // combine the per-thread ranges and compute the global min and max of
+    // all of the variables
     void PreCompute(MPI_Comm comm, int bins);
 
-    // do the local histgram calculation
-    void Compute(vtkDataArray* da, vtkUnsignedCharArray* ghostArray);
+    // bin over the given ranges, a min max pair per variable, in place of
+    // the global range. values outside of the range are counted in the
+    // first and last bins.
+    void PreCompute(int bins, const std::vector<double> &range);
+
+    // bin into a provisional histogram with bins*refine bins spanning the
+    // local range of each variable. Use with StartRange, and once the
+    // global range is known call Rebin to produce the final histogram.
+    void PreComputeProvisional(int bins, int refine = 32);
+
+    // re-bin the provisional histogram over the given ranges. each
+    // provisional bin is counted in the bin containing its center, so a
+    // value may be counted in a neighbouring bin when it lies within half
+    // a provisional bin width of an edge.
+    void Rebin(const std::vector<double> &range);
+
+    // start a non-blocking reduction of the per-thread ranges accumulated
+    // by AddRange. FinishRange completes it.
+    void StartRange(MPI_Comm comm);
+
+    // complete the range reduction started by StartRange, or PreCompute,
+    // returning the global ranges, a min max pair per variable. returns
+    // non-zero if no range was reduced.
+    int FinishRange(std::vector<double> &range);
 
-    // do the reduction, write the result to a file, or cout.
-    // the result is cached on rank 0.
-    void PostCompute(MPI_Comm comm, int nBins, int step, double time,
-      const std::string &meshName, const std::string &arrayName,
+    // do the local histgram calculation of the var'th variable over values
+    // [start, end) of the array, by default the whole array. ghosts are
+    // skipped.
+    void Compute(vtkDataArray* da, vtkUnsignedCharArray* ghostArray,
+      unsigned int thread = 0, vtkIdType start = 0, vtkIdType end = -1,
+      unsigned int var = 0, int component = 0);
+
+    // combine the per-thread histograms, do the reduction, write the
+    // results of all of the variables to a file, or cout. varNames
+    // labels the variables in the output. the result is cached on rank 0.
+    void PostCompute(MPI_Comm comm, int step, double time,
+      const std::string &meshName, const std::vector<std::string> &varNames,
+      const std::string &fileName);
+
+    // the same as PostCompute, except that the reduction runs in the
+    // background. FinishPostCompute completes it and writes the results.
+    void StartPostCompute(MPI_Comm comm, int step, double time,
+      const std::string &meshName, const std::vector<std::string> &varNames,
       const std::string &fileName);
 
-    // return the last computed results on rank 0
-    int GetHistogram(MPI_Comm comm, double &min, double &max,
-      std::vector<unsigned int> &bins);
+    void FinishPostCompute();
+
+    // append the results to the store instead of writing a file per step.
+    // the store is not owned and must be open on rank 0.
+    void SetStore(TimeSeriesStore *store) { this->Store = store; }
+
+    // combine the per-thread ranges accumulated by AddRange on this rank,
+    // a min max pair per variable. there is no communication.
+    void GetLocalRange(std::vector<double> &range);
+
+    // combine the per-thread histograms computed on this rank, Bins
+    // values per variable. there is no communication.
+    void GetLocalHistogram(std::vector<unsigned int> &hist);
+
+    // return the last computed results of the var'th variable on rank 0.
+    // a reduction in progress is completed first.
+    int GetHistogram(MPI_Comm comm, unsigned int var, double &min,
+      double &max, std::vector<unsigned int> &bins);
 
 private:
-  double Range[2];
-  struct Internals;
-  Internals *Worker;
+  VTKHistogram(const VTKHistogram&) = delete;
+  void operator=(const VTKHistogram&) = delete;
+
+  // report the reduced histograms on rank 0
+  void WriteHistogram();
+
+  unsigned int NumVars;
+  unsigned int NumThreads;
+  int Bins;
+
+  // the refinement of the provisional histogram, 1 when not provisional
+  int Refine;
+
+  // global range of each variable, min max pairs
+  std::vector<double> Range;
+
+  // per thread ranges and histograms, indexed by thread*NumVars + var. each
+  // histogram has an extra bin used to discard ghosts
+  std::vector<double> ThreadRange;
+  std::vector<unsigned int> ThreadHistogram;
+
+  // the result on rank 0, indexed by var*Bins + bin
+  std::vector<unsigned int> Histogram;
+
+  // the range reduction. the mins are negated while it is in progress
+  MPI_Request RangeRequest;
+  std::vector<double> GlobalRange;
+
+  // the bin reduction and what is needed to report its result
+  MPI_Request HistogramRequest;
+  std::vector<unsigned int> LocalHistogram;
+  MPI_Comm Comm;
+  int Step;
+  double Time;
+  std::string MeshName;
+  std::vector<std::string> VarNames;
+  std::string FileName;
+  TimeSeriesStore *Store;
 };
 
 }
@@ -312,19 +312,19 @@ bool VTKPosthocIO::Execute(DataAdaptor* dataAdaptor)
       return false;
       }
 
-    // add the required arrays
+    // add the required arrays, a batch per association
     ArrayRequirementsIterator ait =
       this->Requirements.GetArrayRequirementsIterator(meshName);
+    ait.SetMode(ArrayRequirementsIterator::MODE_ASSOCIATION);
 
     while (ait)
       {
-      if (dataAdaptor->AddArray(dobj, mit.MeshName(),
-         ait.Association(), ait.Array()))
+      if (dataAdaptor->AddArrays(dobj, mit.MeshName(),
+         ait.Association(), ait.Arrays()))
         {
         SENSEI_ERROR("Failed to add "
           << VTKUtils::GetAttributesName(ait.Association())
-          << " data array \"" << ait.Array() << "\" to mesh \""
-          << meshName << "\"")
+          << " data arrays to mesh \"" << meshName << "\"")
         return false;
         }
       ++ait;
@@ -357,44 +357,59 @@ bool VTKPosthocIO::Execute(DataAdaptor* dataAdaptor)
     if (dynamic_cast<vtkUniformGridAMR*>(cd.GetPointer()))
       bidShift = 0;
 
-    // write the blocks
-    for (it->InitTraversal(); !it->IsDoneWithTraversal(); it->GoToNextItem())
-      {
-      vtkDataSet *ds = dynamic_cast<vtkDataSet*>(it->GetCurrentDataObject());
-      if (!ds)
-        {
-        // this should never happen
-        SENSEI_ERROR("Block at " << it->GetCurrentFlatIndex() << " is null")
-        return false;
-        }
+    it->Delete();
+
+    // look these up before the threads start, operator[] may insert
+    long fileId = this->FileId[meshName];
+    std::string blockExt = this->BlockExt[meshName];
 
+    // write the blocks, each to its own file, in parallel
+    VTKUtils::ThreadDatasetFunction writeBlock = [&](unsigned int,
+      unsigned int flatIndex, vtkDataSet *ds) -> int
+      {
       // skip writing blocks that have no data
       if (ds->GetNumberOfCells() < 1)
-        continue;
+        return 0;
 
-      long blockId = it->GetCurrentFlatIndex() - bidShift;
+      long blockId = flatIndex - bidShift;
       if (blockId < 0)
         {
         // this should never happen
         SENSEI_ERROR("Negative index! Dataset is " << cd->GetClassName())
-        return false;
+        return -1;
         }
 
       std::string fileName =
         getBlockFileName(this->OutputDir, meshName, blockId,
-          this->FileId[meshName], this->BlockExt[meshName]);
+          fileId, blockExt);
 
+      // the mesh may be shared with other analyses and must not be
+      // modified. when the ghost array is renamed, a shallow copy of the
+      // block holding a renamed shallow copy of the ghost array is written
+      vtkDataSet *outDs = ds;
+      std::string ghostName = this->GetGhostArrayName();
       vtkDataArray *ga = ds->GetCellData()->GetArray("vtkGhostType");
-      if (ga)
+      if (ga && (ghostName != "vtkGhostType"))
         {
-        ga->SetName(this->GetGhostArrayName().c_str());
-        ds->UpdateCellGhostArrayCache();
+        vtkDataArray *oga = ga->NewInstance();
+        oga->ShallowCopy(ga);
+        oga->SetName(ghostName.c_str());
+
+        outDs = ds->NewInstance();
+        outDs->ShallowCopy(ds);
+        outDs->GetCellData()->RemoveArray("vtkGhostType");
+        outDs->GetCellData()->AddArray(oga);
+        oga->Delete();
+        }
+      else
+        {
+        outDs->Register(nullptr);
         }
 
       if (this->Writer == VTKPosthocIO::WRITER_VTK_LEGACY)
         {
         vtkDataSetWriter *writer = vtkDataSetWriter::New();
-        writer->SetInputData(ds);
+        writer->SetInputData(outDs);
         writer->SetFileName(fileName.c_str());
         writer->SetFileTypeToBinary();
         writer->Write();
@@ -403,7 +418,7 @@ bool VTKPosthocIO::Execute(DataAdaptor* dataAdaptor)
       else
         {
         vtkXMLDataSetWriter *writer = vtkXMLDataSetWriter::New();
-        writer->SetInputData(ds);
+        writer->SetInputData(outDs);
         writer->SetDataModeToAppended();
         writer->EncodeAppendedDataOff();
         writer->SetCompressorTypeToNone();
@@ -411,8 +426,17 @@ bool VTKPosthocIO::Execute(DataAdaptor* dataAdaptor)
         writer->Write();
         writer->Delete();
         }
+
+      outDs->UnRegister(nullptr);
+
+      return 0;
+      };
+
+    if (VTKUtils::ParallelApply(VTKUtils::GetNumberOfThreads(), cd, writeBlock))
+      {
+      SENSEI_ERROR("Failed to write the blocks of mesh \"" << meshName << "\"")
+      return false;
       }
-    it->Delete();
 
     // this is default initialized to 0 by definition of std::map. & we count
     // empty steps
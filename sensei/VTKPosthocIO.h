@@ -60,6 +60,7 @@ public:
 
   // SENSEI API
   bool Execute(DataAdaptor* data) override;
+  int GetThreadSafe() override { return 1; }
   int Finalize() override;
 
 protected:
@@ -3,6 +3,7 @@
 #include "MPIUtils.h"
 #include "MeshMetadata.h"
 #include "Error.h"
+#include "ThreadPool.h"
 
 
 #include <vtkCompositeDataIterator.h>
@@ -55,7 +56,8 @@
 #include <vtkSmartPointer.h>
 #include <vtkIntArray.h>
 #include <vtkVersionMacros.h>
-#if ((VTK_VERSION_MAJOR >= 8) && (VTK_VERSION_MINOR >= 2))
+#if ((VTK_VERSION_MAJOR >= 8) && (VTK_VERSION_MINOR >= 2)) || \
+  defined(ENABLE_VTK_GENERIC_ARRAYS)
 #include <vtkAOSDataArrayTemplate.h>
 #include <vtkSOADataArrayTemplate.h>
 #endif
@@ -68,7 +70,12 @@
 #include <vtkUnsignedCharArray.h>
 
 #include <sstream>
+#include <cstring>
 #include <functional>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
 #include <mpi.h>
 
 using vtkDataObjectPtr = vtkSmartPointer<vtkDataObject>;
@@ -375,11 +382,12 @@ int Apply(vtkCompositeDataSet *cd, vtkCompositeDataSet *cdo,
         return 1;
         }
       }
-    // process data set leaves
+    // process data set leaves. leaves that are empty in the output, as
+    // in a mesh holding a subset of the blocks, are skipped
     else if(vtkDataSet *ds = dynamic_cast<vtkDataSet*>(obj))
       {
       vtkDataSet *dsOut = static_cast<vtkDataSet*>(objOut);
-      int ret = func(ds, dsOut);
+      int ret = dsOut ? func(ds, dsOut) : 0;
       if (ret < 0)
         {
         // stop with error
@@ -509,6 +517,297 @@ int Apply(vtkDataObject *dobj, DatasetFunction &func)
   return 0;
 }
 
+//----------------------------------------------------------------------------
+static ThreadPool &GetThreadPool()
+{
+  static ThreadPool pool;
+  return pool;
+}
+
+//----------------------------------------------------------------------------
+void SetNumberOfThreads(unsigned int nThreads)
+{
+  // the calling thread participates, the pool supplies the rest
+  ThreadPool &pool = GetThreadPool();
+  if (nThreads > 1)
+    pool.Initialize(nThreads - 1);
+  else
+    pool.Finalize();
+}
+
+//----------------------------------------------------------------------------
+unsigned int GetNumberOfThreads()
+{
+  return GetThreadPool().GetNumberOfThreads() + 1;
+}
+
+namespace
+{
+// a leaf of the input and its counterpart in the output
+struct Leaf
+{
+  unsigned int FlatIndex;
+  vtkDataSet *Input;
+  vtkDataSet *Output;
+};
+
+// flatten the leaves of the input, and optionally the output, into a list.
+// leaves that are empty in the output are skipped.
+int GetLeaves(vtkDataObject *dobj, vtkDataObject *dobjo,
+  std::vector<Leaf> &leaves)
+{
+  if (vtkCompositeDataSet *cd = dynamic_cast<vtkCompositeDataSet*>(dobj))
+    {
+    vtkCompositeDataSet *cdo = static_cast<vtkCompositeDataSet*>(dobjo);
+
+    vtkCompositeDataIteratorPtr cdit;
+    cdit.TakeReference(cd->NewIterator());
+    for (cdit->InitTraversal(); !cdit->IsDoneWithTraversal(); cdit->GoToNextItem())
+      {
+      vtkDataObject *obj = cd->GetDataSet(cdit);
+      vtkDataSet *ds = dynamic_cast<vtkDataSet*>(obj);
+      if (!ds)
+        {
+        SENSEI_ERROR("Can't apply to " << (obj ? obj->GetClassName() : "null")
+          << " at index " << cdit->GetCurrentFlatIndex())
+        return -1;
+        }
+
+      vtkDataSet *dso = nullptr;
+      if (cdo && !(dso = static_cast<vtkDataSet*>(cdo->GetDataSet(cdit))))
+        continue;
+
+      leaves.push_back({cdit->GetCurrentFlatIndex(), ds, dso});
+      }
+    }
+  else if (vtkDataSet *ds = dynamic_cast<vtkDataSet*>(dobj))
+    {
+    leaves.push_back({0, ds, static_cast<vtkDataSet*>(dobjo)});
+    }
+  else
+    {
+    SENSEI_ERROR("Unsupoorted data object type " << dobj->GetClassName())
+    return -1;
+    }
+
+  return 0;
+}
+
+// a range of work items owned by one thread. the owner takes items from
+// the front, idle threads steal the back half.
+struct WorkRange
+{
+  WorkRange() : Begin(0), End(0) {}
+
+  std::mutex Mutex;
+  unsigned int Begin;
+  unsigned int End;
+};
+
+// runs a function over n items on the calling thread and the pool
+class WorkStealingLoop
+{
+public:
+  using Function = ThreadLoopFunction;
+
+  WorkStealingLoop(unsigned int nThreads, unsigned int nItems) :
+    Ranges(nThreads), Status(0), NumDone(0)
+  {
+    // contiguous ranges keep neighboring blocks on the same thread
+    for (unsigned int i = 0; i < nThreads; ++i)
+      {
+      this->Ranges[i].Begin = (i*nItems)/nThreads;
+      this->Ranges[i].End = ((i + 1)*nItems)/nThreads;
+      }
+  }
+
+  int Execute(ThreadPool &pool, Function &func)
+  {
+    unsigned int nThreads = this->Ranges.size();
+
+    for (unsigned int i = 1; i < nThreads; ++i)
+      {
+      pool.Push([this,&func,i]()
+        {
+        this->Run(i, func);
+
+          {
+          std::lock_guard<std::mutex> lock(this->Mutex);
+          this->NumDone += 1;
+          }
+        this->Done.notify_one();
+        });
+      }
+
+    this->Run(0, func);
+
+    // the tasks reference this object, wait for all of them to finish
+    std::unique_lock<std::mutex> lock(this->Mutex);
+    this->Done.wait(lock, [this,nThreads]() -> bool {
+      return this->NumDone == nThreads - 1; });
+
+    return this->Status;
+  }
+
+private:
+  void Run(unsigned int thread, Function &func)
+  {
+    unsigned int item = 0;
+    while ((this->Status == 0) && this->Next(thread, item))
+      {
+      int ret = func(thread, item);
+      if (ret < 0)
+        {
+        this->Status = -1;
+        }
+      else if (ret > 0)
+        {
+        int ok = 0;
+        this->Status.compare_exchange_strong(ok, 1);
+        }
+      }
+  }
+
+  bool Next(unsigned int thread, unsigned int &item)
+  {
+    WorkRange &own = this->Ranges[thread];
+      {
+      std::lock_guard<std::mutex> lock(own.Mutex);
+      if (own.Begin < own.End)
+        {
+        item = own.Begin++;
+        return true;
+        }
+      }
+
+    // out of work, steal the back half of another thread's range
+    unsigned int nThreads = this->Ranges.size();
+    for (unsigned int i = 1; i < nThreads; ++i)
+      {
+      WorkRange &victim = this->Ranges[(thread + i) % nThreads];
+
+      unsigned int begin = 0;
+      unsigned int end = 0;
+        {
+        std::lock_guard<std::mutex> lock(victim.Mutex);
+        if (victim.Begin >= victim.End)
+          continue;
+
+        begin = victim.Begin + (victim.End - victim.Begin)/2;
+        end = victim.End;
+        victim.End = begin;
+        }
+
+        {
+        std::lock_guard<std::mutex> lock(own.Mutex);
+        own.Begin = begin + 1;
+        own.End = end;
+        }
+
+      item = begin;
+      return true;
+      }
+
+    return false;
+  }
+
+  std::vector<WorkRange> Ranges;
+  std::atomic<int> Status;
+  std::mutex Mutex;
+  std::condition_variable Done;
+  unsigned int NumDone;
+};
+
+// process the leaves on up to nThreads threads
+int ParallelApply(unsigned int nThreads, const std::vector<Leaf> &leaves,
+  ThreadBinaryDatasetFunction &func, ThreadReduceFunction *reduce)
+{
+  ThreadLoopFunction body = [&](unsigned int thread,
+    unsigned int item) -> int
+    {
+    const Leaf &leaf = leaves[item];
+    int ret = func(thread, leaf.FlatIndex, leaf.Input, leaf.Output);
+    if (ret < 0)
+      {
+      SENSEI_ERROR("Function failed in apply at data set index "
+        << leaf.FlatIndex)
+      }
+    return ret;
+    };
+
+  return ParallelFor(nThreads, leaves.size(), body, reduce);
+}
+}
+
+//----------------------------------------------------------------------------
+int ParallelFor(unsigned int nThreads, unsigned int nItems,
+  ThreadLoopFunction &func, ThreadReduceFunction *reduce)
+{
+  ThreadPool &pool = GetThreadPool();
+
+  unsigned int nActive = std::min(nThreads, pool.GetNumberOfThreads() + 1);
+  nActive = std::min(nActive, nItems);
+
+  int ret = 0;
+  if (nActive > 1)
+    {
+    WorkStealingLoop loop(nActive, nItems);
+    ret = loop.Execute(pool, func);
+    }
+  else
+    {
+    for (unsigned int i = 0; (i < nItems) && (ret == 0); ++i)
+      ret = func(0, i);
+    }
+
+  if (ret < 0)
+    return -1;
+
+  // combine the per-thread results
+  if (reduce)
+    {
+    for (unsigned int i = 0; i < nThreads; ++i)
+      {
+      if ((*reduce)(i) < 0)
+        {
+        SENSEI_ERROR("Reduction failed for thread " << i)
+        return -1;
+        }
+      }
+    }
+
+  return 0;
+}
+
+//----------------------------------------------------------------------------
+int ParallelApply(unsigned int nThreads, vtkDataObject *dobj,
+  vtkDataObject *dobjo, ThreadBinaryDatasetFunction &func,
+  ThreadReduceFunction *reduce)
+{
+  std::vector<Leaf> leaves;
+  if (GetLeaves(dobj, dobjo, leaves))
+    return -1;
+
+  return ParallelApply(nThreads, leaves, func, reduce);
+}
+
+//----------------------------------------------------------------------------
+int ParallelApply(unsigned int nThreads, vtkDataObject *dobj,
+  ThreadDatasetFunction &func, ThreadReduceFunction *reduce)
+{
+  std::vector<Leaf> leaves;
+  if (GetLeaves(dobj, nullptr, leaves))
+    return -1;
+
+  ThreadBinaryDatasetFunction bfunc = [&func](unsigned int thread,
+    unsigned int flatIndex, vtkDataSet *ds, vtkDataSet *) -> int
+    {
+    return func(thread, flatIndex, ds);
+    };
+
+  return ParallelApply(nThreads, leaves, bfunc, reduce);
+}
+
 //----------------------------------------------------------------------------
 int GetGhostLayerMetadata(vtkDataObject *mesh,
   int &nGhostCellLayers, int &nGhostNodeLayers)
@@ -807,7 +1106,8 @@ int GetMetadata(MPI_Comm comm, vtkDataSet *ds, MeshMetadataPtr metadata)
 
   VTKUtils::GetArrayMetadata(ds, metadata);
 
-  if (VTKUtils::GetBlockMetadata(rank, 0, ds, metadata))
+  // the dataset is the rank'th block, as in AsCompositeData
+  if (VTKUtils::GetBlockMetadata(rank, rank, ds, metadata))
     {
     SENSEI_ERROR("Failed to get block metadata for block " << rank)
     return -1;
@@ -859,6 +1159,122 @@ vtkCompositeDataSetPtr AsCompositeData(MPI_Comm comm,
   return cd;
 }
 
+// --------------------------------------------------------------------------
+vtkDataArray *NewAOSArray(const std::string &name, int vtkType, void *data,
+  vtkIdType nTuples, int nComps, size_t stride, int &zeroCopy)
+{
+  zeroCopy = 0;
+
+  vtkDataArray *da = vtkDataArray::CreateDataArray(vtkType);
+  if (!da)
+    {
+    SENSEI_ERROR("Failed to create an array of type " << vtkType)
+    return nullptr;
+    }
+
+  da->SetName(name.c_str());
+  da->SetNumberOfComponents(nComps);
+
+  size_t tupleSize = nComps*da->GetDataTypeSize();
+  if ((stride == 0) || (stride == tupleSize))
+    {
+    // packed, reference the simulation's memory. save is set so that VTK
+    // does not try to free it
+    da->SetVoidArray(data, nTuples*nComps, 1);
+    zeroCopy = 1;
+    return da;
+    }
+
+  if (stride < tupleSize)
+    {
+    SENSEI_ERROR("Invalid stride " << stride << " for tuples of "
+      << tupleSize << " bytes")
+    da->Delete();
+    return nullptr;
+    }
+
+  // strided, gather the tuples
+  da->SetNumberOfTuples(nTuples);
+
+  const char *src = static_cast<const char*>(data);
+  char *dest = static_cast<char*>(da->GetVoidPointer(0));
+  for (vtkIdType i = 0; i < nTuples; ++i)
+    {
+    memcpy(dest, src, tupleSize);
+    src += stride;
+    dest += tupleSize;
+    }
+
+  return da;
+}
+
+// --------------------------------------------------------------------------
+vtkDataArray *NewSOAArray(const std::string &name, int vtkType,
+  const std::vector<void*> &comps, vtkIdType nTuples, int &zeroCopy)
+{
+  zeroCopy = 0;
+
+  int nComps = comps.size();
+  if (nComps < 1)
+    {
+    SENSEI_ERROR("No components were provided for array \"" << name << "\"")
+    return nullptr;
+    }
+
+  // a single component is the same in either layout. prefer the AOS
+  // array since it is what most of VTK expects
+  if (nComps == 1)
+    return NewAOSArray(name, vtkType, comps[0], nTuples, 1, 0, zeroCopy);
+
+#if defined(ENABLE_VTK_GENERIC_ARRAYS)
+  vtkDataArray *da = nullptr;
+  switch (vtkType)
+    {
+    vtkTemplateMacro(
+      vtkSOADataArrayTemplate<VTK_TT> *soa =
+        vtkSOADataArrayTemplate<VTK_TT>::New();
+      soa->SetNumberOfComponents(nComps);
+      for (int j = 0; j < nComps; ++j)
+        soa->SetArray(j, static_cast<VTK_TT*>(comps[j]), nTuples, true, true);
+      da = soa;
+      );
+    default:
+      SENSEI_ERROR("Failed to create an array of type " << vtkType)
+      return nullptr;
+    }
+
+  da->SetName(name.c_str());
+  zeroCopy = 1;
+
+  return da;
+#else
+  vtkDataArray *da = vtkDataArray::CreateDataArray(vtkType);
+  if (!da)
+    {
+    SENSEI_ERROR("Failed to create an array of type " << vtkType)
+    return nullptr;
+    }
+
+  da->SetName(name.c_str());
+  da->SetNumberOfComponents(nComps);
+  da->SetNumberOfTuples(nTuples);
+
+  // interleave the components
+  size_t valSize = da->GetDataTypeSize();
+  char *dest = static_cast<char*>(da->GetVoidPointer(0));
+  for (vtkIdType i = 0; i < nTuples; ++i)
+    {
+    for (int j = 0; j < nComps; ++j)
+      {
+      memcpy(dest, static_cast<const char*>(comps[j]) + i*valSize, valSize);
+      dest += valSize;
+      }
+    }
+
+  return da;
+#endif
+}
+
 /*
 int arrayCpy(void *&wptr, vtkDataArray *da)
 {
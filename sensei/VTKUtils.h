@@ -8,8 +8,10 @@ class vtkDataObject;
 class vtkFieldData;
 class vtkDataSetAttributes;
 class vtkCompositeDataSet;
+class vtkDataArray;
 
 #include <vtkSmartPointer.h>
+#include <vtkType.h>
 #include <functional>
 #include <vector>
 #include <mpi.h>
@@ -61,6 +63,55 @@ using DatasetFunction = std::function<int(vtkDataSet*)>;
 /// The function is called once for each leaf dataset
 int Apply(vtkDataObject *dobj, DatasetFunction &func);
 
+/// Set the number of threads used by ParallelApply, including the calling
+/// thread. The default is 1, in which case the leaves are processed
+/// serially. This should be set before any analysis executes, and set back
+/// to 1 to stop the threads.
+void SetNumberOfThreads(unsigned int nThreads);
+unsigned int GetNumberOfThreads();
+
+/// callback that processes a leaf dataset in ParallelApply. thread is in
+/// [0, nThreads) and may be used to index per-thread results. flatIndex is
+/// the leaf's flat index in the composite dataset, 0 for a lone dataset.
+/// return 0 for success, > zero to stop without error, < zero to stop with error
+using ThreadDatasetFunction =
+  std::function<int(unsigned int thread, unsigned int flatIndex, vtkDataSet*)>;
+
+/// callback that processes input and output leaf datasets in ParallelApply
+using ThreadBinaryDatasetFunction = std::function<int(unsigned int thread,
+  unsigned int flatIndex, vtkDataSet*, vtkDataSet*)>;
+
+/// callback invoked once per thread, in thread order on the calling thread,
+/// after all of the leaves have been processed. it is used to reduce
+/// per-thread results. return 0 for success, < zero for an error.
+using ThreadReduceFunction = std::function<int(unsigned int thread)>;
+
+/// callback that processes one item of ParallelFor on the given thread
+/// return 0 for success, > zero to stop without error, < zero to stop with error
+using ThreadLoopFunction =
+  std::function<int(unsigned int thread, unsigned int item)>;
+
+/// Runs the function over the items [0, nItems) on up to nThreads threads,
+/// at most GetNumberOfThreads, with work stealing. This is the engine of
+/// ParallelApply, and is useful when the work is split at a finer grain
+/// than the blocks. Returns 0 if successful.
+int ParallelFor(unsigned int nThreads, unsigned int nItems,
+  ThreadLoopFunction &func, ThreadReduceFunction *reduce = nullptr);
+
+/// Parallel variants of Apply. The leaves are gathered into a list and
+/// processed by up to nThreads threads, at most GetNumberOfThreads, with
+/// work stealing to balance blocks of uneven cost. The function must be
+/// safe to call concurrently on different leaves. Callers typically get
+/// nThreads from GetNumberOfThreads, size their per-thread results with
+/// it, and combine those in the optional reduce function. Leaves that are
+/// empty in the output are skipped. Returns 0 if successful.
+int ParallelApply(unsigned int nThreads, vtkDataObject *dobj,
+  ThreadDatasetFunction &func, ThreadReduceFunction *reduce = nullptr);
+
+int ParallelApply(unsigned int nThreads, vtkDataObject *input,
+  vtkDataObject *output, ThreadBinaryDatasetFunction &func,
+  ThreadReduceFunction *reduce = nullptr);
+
 /// Store ghost layer metadata in the mesh
 int SetGhostLayerMetadata(vtkDataObject *mesh,
   int nGhostCellLayers, int nGhostNodeLayers);
@@ -82,6 +133,24 @@ int GetMetadata(MPI_Comm comm, vtkCompositeDataSet *cd, MeshMetadataPtr);
 vtkCompositeDataSetPtr AsCompositeData(MPI_Comm comm,
   vtkDataObject *dobj, bool take = true);
 
+/// Create a VTK array from memory owned by the simulation. The array has
+/// nTuples tuples of nComps values of the given VTK type, and successive
+/// tuples begin stride bytes apart, a stride of 0 means that the tuples are
+/// packed. Packed data is zero-copied, the array references the
+/// simulation's memory and zeroCopy is set to 1. Such memory must remain
+/// valid until the data adaptor's ReleaseData is called. Strided data is
+/// copied and zeroCopy is set to 0. Returns nullptr if an error occurred.
+vtkDataArray *NewAOSArray(const std::string &name, int vtkType, void *data,
+  vtkIdType nTuples, int nComps, size_t stride, int &zeroCopy);
+
+/// Create a VTK array from memory owned by the simulation that is laid
+/// out as a structure of arrays, one pointer per component. When VTK is
+/// built with generic arrays the components are zero-copied into a
+/// vtkSOADataArrayTemplate, otherwise they are interleaved into a copy.
+/// zeroCopy is set as in NewAOSArray. Returns nullptr if an error occurred.
+vtkDataArray *NewSOAArray(const std::string &name, int vtkType,
+  const std::vector<void*> &comps, vtkIdType nTuples, int &zeroCopy);
+
 /// Return true if the mesh or block type is AMR
 inline bool AMR(const MeshMetadataPtr &md)
 {
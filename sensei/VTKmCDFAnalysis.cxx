@@ -3,6 +3,7 @@
 #include "CDFReducer.h"
 #include "CinemaHelper.h"
 #include "DataAdaptor.h"
+#include "TimeSeriesStore.h"
 #include <Profiler.h>
 #include <Error.h>
 
@@ -54,6 +55,7 @@ VTKmCDFAnalysis::VTKmCDFAnalysis()
   , Helper(nullptr)
   , NumberOfQuantiles(10)
   , RequestSize(10)
+  , Store(nullptr)
 {
 }
 
@@ -61,6 +63,7 @@ VTKmCDFAnalysis::VTKmCDFAnalysis()
 VTKmCDFAnalysis::~VTKmCDFAnalysis()
 {
     delete this->Helper;
+    delete this->Store;
 }
 
 //-----------------------------------------------------------------------------
@@ -100,7 +103,8 @@ void VTKmCDFAnalysis::Initialize(
 bool VTKmCDFAnalysis::Execute(DataAdaptor* data)
 {
   TimeEvent<128> mark("VTKmCDFAnalysis::execute");
-  this->Helper->AddTimeEntry();
+  if (this->TimeSeriesFile.empty())
+    this->Helper->AddTimeEntry();
 
   // Get the mesh from the simulation:
   vtkDataObject* mesh = nullptr;
@@ -196,6 +200,30 @@ bool VTKmCDFAnalysis::Execute(DataAdaptor* data)
   double* cdf = reducer.Compute(sorted->GetPointer(0), sorted->GetNumberOfTuples(), this->NumberOfQuantiles);
   Profiler::EndEvent("VTKm CDF");
 
+  if (!this->TimeSeriesFile.empty())
+  {
+    // all steps go in one file, the result is on rank 0
+    int rank = 0;
+    MPI_Comm_rank(this->Communicator, &rank);
+    if (rank != 0)
+      return true;
+
+    if (!this->Store)
+    {
+      this->Store = new TimeSeriesStore;
+      if (this->Store->Open(this->TimeSeriesFile, "cdf",
+        {{"mesh", this->MeshName}, {"field", this->FieldName},
+        {"quantiles", std::to_string(this->NumberOfQuantiles)}}))
+      {
+        SENSEI_ERROR("Failed to open the CDF time series");
+        return false;
+      }
+    }
+
+    return !this->Store->Append(data->GetDataTimeStep(), data->GetDataTime(),
+      0, cdf, this->NumberOfQuantiles);
+  }
+
   Profiler::StartEvent("Cinema CDF export");
   this->Helper->WriteCDF(this->NumberOfQuantiles, cdf);
   this->Helper->WriteMetadata();
@@ -204,4 +232,13 @@ bool VTKmCDFAnalysis::Execute(DataAdaptor* data)
   return true;
 }
 
+//-----------------------------------------------------------------------------
+int VTKmCDFAnalysis::Finalize()
+{
+  if (this->Store && this->Store->Close())
+    return -1;
+
+  return 0;
+}
+
 }
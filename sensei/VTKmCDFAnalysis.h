@@ -8,6 +8,7 @@
 namespace sensei
 {
 class CinemaHelper;
+class TimeSeriesStore;
 
 class VTKmCDFAnalysis : public AnalysisAdaptor
 {
@@ -24,9 +25,14 @@ public:
     int requestSize,
     MPI_Comm comm);
 
+  // append the CDF of every step to the given file rather than writing a
+  // Cinema database entry per step. see TimeSeriesStore.
+  void SetTimeSeriesFile(const std::string &fileName)
+  { this->TimeSeriesFile = fileName; }
+
   bool Execute(DataAdaptor* data) override;
 
-  int Finalize() override { return 0; }
+  int Finalize() override;
 
 protected:
   VTKmCDFAnalysis();
@@ -39,6 +45,8 @@ protected:
   CinemaHelper* Helper;
   int NumberOfQuantiles;
   int RequestSize;
+  std::string TimeSeriesFile;
+  TimeSeriesStore* Store;
 
 private:
   VTKmCDFAnalysis(const VTKmCDFAnalysis&);
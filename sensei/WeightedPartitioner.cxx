@@ -0,0 +1,601 @@
+#include "WeightedPartitioner.h"
+#include "Profiler.h"
+#include "XMLUtils.h"
+
+#include <vtkAbstractArray.h>
+#include <vtkDataObject.h>
+#include <vtkType.h>
+
+#include <pugixml.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <queue>
+#include <utility>
+
+namespace sensei
+{
+namespace
+{
+// --------------------------------------------------------------------------
+bool isVariable(const std::string &tok)
+{
+  return (tok == "cells") || (tok == "points") ||
+    (tok == "cell_array_size") || (tok == "bytes");
+}
+
+// --------------------------------------------------------------------------
+int precedence(const std::string &op)
+{
+  if (op == "neg")
+    return 3;
+  if ((op == "*") || (op == "/"))
+    return 2;
+  if ((op == "+") || (op == "-"))
+    return 1;
+  return 0;
+}
+
+// --------------------------------------------------------------------------
+// convert an infix expression into postfix order. the tokens are numbers,
+// variables, the binary operators + - * /, unary minus (neg), and
+// parentheses
+int compile(const std::string &expr, std::vector<std::string> &program)
+{
+  program.clear();
+
+  std::vector<std::string> ops;
+  bool operand = true; // true when an operand is expected
+
+  size_t n = expr.size();
+  size_t i = 0;
+  while (i < n)
+    {
+    char c = expr[i];
+    if (isspace(c))
+      {
+      ++i;
+      }
+    else if (isdigit(c) || (c == '.'))
+      {
+      char *end = nullptr;
+      strtod(expr.c_str() + i, &end);
+      size_t len = end - (expr.c_str() + i);
+      if (!operand || (len == 0))
+        {
+        SENSEI_ERROR("Unexpected number at position " << i << " in \""
+          << expr << "\"")
+        return -1;
+        }
+      program.push_back(expr.substr(i, len));
+      operand = false;
+      i += len;
+      }
+    else if (isalpha(c) || (c == '_'))
+      {
+      size_t j = i;
+      while ((j < n) && (isalnum(expr[j]) || (expr[j] == '_')))
+        ++j;
+      std::string var = expr.substr(i, j - i);
+      if (!operand || !isVariable(var))
+        {
+        SENSEI_ERROR("Unexpected \"" << var << "\" in \"" << expr
+          << "\". The variables are cells, points, cell_array_size, "
+          "and bytes")
+        return -1;
+        }
+      program.push_back(var);
+      operand = false;
+      i = j;
+      }
+    else if (c == '(')
+      {
+      if (!operand)
+        {
+        SENSEI_ERROR("Unexpected ( at position " << i << " in \""
+          << expr << "\"")
+        return -1;
+        }
+      ops.push_back("(");
+      ++i;
+      }
+    else if (c == ')')
+      {
+      while (!ops.empty() && (ops.back() != "("))
+        {
+        program.push_back(ops.back());
+        ops.pop_back();
+        }
+      if (operand || ops.empty())
+        {
+        SENSEI_ERROR("Unbalanced ) at position " << i << " in \""
+          << expr << "\"")
+        return -1;
+        }
+      ops.pop_back();
+      ++i;
+      }
+    else if ((c == '+') || (c == '-') || (c == '*') || (c == '/'))
+      {
+      std::string op(1, c);
+      if (operand)
+        {
+        // a sign
+        if (c == '-')
+          {
+          ops.push_back("neg");
+          }
+        else if (c != '+')
+          {
+          SENSEI_ERROR("Unexpected " << op << " at position " << i
+            << " in \"" << expr << "\"")
+          return -1;
+          }
+        }
+      else
+        {
+        // binary operators are left associative
+        while (!ops.empty() && (precedence(ops.back()) >= precedence(op)))
+          {
+          program.push_back(ops.back());
+          ops.pop_back();
+          }
+        ops.push_back(op);
+        operand = true;
+        }
+      ++i;
+      }
+    else
+      {
+      SENSEI_ERROR("Unexpected " << c << " at position " << i << " in \""
+        << expr << "\"")
+      return -1;
+      }
+    }
+
+  if (operand)
+    {
+    SENSEI_ERROR("Incomplete expression \"" << expr << "\"")
+    return -1;
+    }
+
+  while (!ops.empty())
+    {
+    if (ops.back() == "(")
+      {
+      SENSEI_ERROR("Unbalanced ( in \"" << expr << "\"")
+      return -1;
+      }
+    program.push_back(ops.back());
+    ops.pop_back();
+    }
+
+  return 0;
+}
+
+// --------------------------------------------------------------------------
+// evaluate an expression in postfix order. the variables are given in the
+// order cells, points, cell_array_size, bytes
+double evaluate(const std::vector<std::string> &program, const double vars[4])
+{
+  std::vector<double> stack;
+
+  unsigned int n = program.size();
+  for (unsigned int i = 0; i < n; ++i)
+    {
+    const std::string &tok = program[i];
+    if (tok == "cells")
+      {
+      stack.push_back(vars[0]);
+      }
+    else if (tok == "points")
+      {
+      stack.push_back(vars[1]);
+      }
+    else if (tok == "cell_array_size")
+      {
+      stack.push_back(vars[2]);
+      }
+    else if (tok == "bytes")
+      {
+      stack.push_back(vars[3]);
+      }
+    else if (tok == "neg")
+      {
+      stack.back() = -stack.back();
+      }
+    else if ((tok == "+") || (tok == "-") || (tok == "*") || (tok == "/"))
+      {
+      double b = stack.back();
+      stack.pop_back();
+      double &a = stack.back();
+      switch (tok[0])
+        {
+        case '+': a += b; break;
+        case '-': a -= b; break;
+        case '*': a *= b; break;
+        case '/': a = b != 0.0 ? a/b : 0.0; break;
+        }
+      }
+    else
+      {
+      stack.push_back(atof(tok.c_str()));
+      }
+    }
+
+  return stack.empty() ? 0.0 : stack.back();
+}
+
+// --------------------------------------------------------------------------
+// estimate the size in bytes of the i'th block
+double blockBytes(const MeshMetadataPtr &md, int i, bool haveCellArray)
+{
+  double nPts = md->BlockNumPoints[i];
+  double nCells = md->BlockNumCells[i];
+
+  double bytes = 0.0;
+
+  // structured blocks have implicit coordinates
+  if ((md->BlockType != VTK_IMAGE_DATA) && (md->BlockType != VTK_UNIFORM_GRID)
+    && (md->BlockType != VTK_RECTILINEAR_GRID))
+    bytes += 3.0*nPts*vtkAbstractArray::GetDataTypeSize(md->CoordinateType);
+
+  if (haveCellArray)
+    bytes += md->BlockCellArraySize[i]*sizeof(vtkIdType);
+
+  for (int j = 0; j < md->NumArrays; ++j)
+    {
+    double nElem = md->ArrayCentering[j] == vtkDataObject::POINT ? nPts : nCells;
+    bytes += nElem*md->ArrayComponents[j]*
+      vtkAbstractArray::GetDataTypeSize(md->ArrayType[j]);
+    }
+
+  return bytes;
+}
+}
+
+// --------------------------------------------------------------------------
+int WeightedPartitioner::SetExpression(const std::string &expr)
+{
+  std::vector<std::string> program;
+  if (compile(expr, program))
+    return -1;
+
+  this->Expression = expr;
+  this->Program = program;
+
+  return 0;
+}
+
+// --------------------------------------------------------------------------
+int WeightedPartitioner::GetBlockCosts(const MeshMetadataPtr &md,
+  std::vector<double> &costs)
+{
+  int nBlocks = md->NumBlocks;
+
+  costs.assign(nBlocks, 1.0);
+
+  if ((this->Cost == COST_EXPRESSION) && this->Program.empty())
+    {
+    SENSEI_ERROR("The cost is an expression but none was set")
+    return -1;
+    }
+
+  // the sender may not provide sizes, in that case the blocks are treated
+  // as if they were all the same
+  if ((int(md->BlockNumCells.size()) != nBlocks) ||
+    (int(md->BlockNumPoints.size()) != nBlocks))
+    {
+    SENSEI_WARNING("Mesh \"" << md->MeshName << "\" has no block sizes, "
+      "all blocks are given the same cost")
+    return 0;
+    }
+
+  bool haveCellArray = int(md->BlockCellArraySize.size()) == nBlocks;
+
+  for (int i = 0; i < nBlocks; ++i)
+    {
+    switch (this->Cost)
+      {
+      case COST_CELLS:
+        costs[i] = md->BlockNumCells[i];
+        break;
+
+      case COST_POINTS:
+        costs[i] = md->BlockNumPoints[i];
+        break;
+
+      case COST_BYTES:
+        costs[i] = blockBytes(md, i, haveCellArray);
+        break;
+
+      case COST_EXPRESSION:
+        {
+        double vars[4] = {double(md->BlockNumCells[i]),
+          double(md->BlockNumPoints[i]),
+          haveCellArray ? double(md->BlockCellArraySize[i]) : 0.0,
+          blockBytes(md, i, haveCellArray)};
+
+        costs[i] = std::max(0.0, evaluate(this->Program, vars));
+        }
+        break;
+
+      default:
+        SENSEI_ERROR("Invalid cost " << this->Cost)
+        return -1;
+      }
+    }
+
+  return 0;
+}
+
+// --------------------------------------------------------------------------
+int WeightedPartitioner::GetBlockBytes(const MeshMetadataPtr &md,
+  std::vector<double> &bytes)
+{
+  int nBlocks = md->NumBlocks;
+
+  bytes.assign(nBlocks, 1.0);
+
+  if ((int(md->BlockNumCells.size()) != nBlocks) ||
+    (int(md->BlockNumPoints.size()) != nBlocks))
+    return 0;
+
+  bool haveCellArray = int(md->BlockCellArraySize.size()) == nBlocks;
+
+  for (int i = 0; i < nBlocks; ++i)
+    bytes[i] = blockBytes(md, i, haveCellArray);
+
+  return 0;
+}
+
+// --------------------------------------------------------------------------
+int WeightedPartitioner::GetPartition(MPI_Comm comm, const MeshMetadataPtr &mdIn,
+  MeshMetadataPtr &mdOut)
+{
+  TimeEvent<128> mark("WeightedPartitioner::GetPartition");
+
+  mdOut = mdIn->NewCopy();
+
+  int nRanks = 1;
+  MPI_Comm_size(comm, &nRanks);
+
+  // every rank computes the same partition from the same metadata
+  std::vector<double> costs;
+  if (this->GetBlockCosts(mdOut, costs))
+    return -1;
+
+  int nBlocks = mdOut->NumBlocks;
+  std::vector<double> load(nRanks, 0.0);
+
+  if (this->Method == METHOD_CONTIGUOUS)
+    {
+    std::vector<int> order(nBlocks);
+    for (int i = 0; i < nBlocks; ++i)
+      order[i] = i;
+
+    this->SplitContiguous(order, costs, nRanks, mdOut->BlockOwner, load);
+    }
+  else if ((this->Method == METHOD_GREEDY) || (this->Method == METHOD_LPT))
+    {
+    // the largest blocks go first with LPT
+    std::vector<int> order(nBlocks);
+    for (int i = 0; i < nBlocks; ++i)
+      order[i] = i;
+
+    if (this->Method == METHOD_LPT)
+      std::stable_sort(order.begin(), order.end(),
+        [&costs](int a, int b) -> bool { return costs[a] > costs[b]; });
+
+    // each block goes to the least loaded rank, ties go to the lower rank
+    using rankLoad = std::pair<double, int>;
+    std::priority_queue<rankLoad, std::vector<rankLoad>,
+      std::greater<rankLoad>> ranks;
+
+    for (int j = 0; j < nRanks; ++j)
+      ranks.push(rankLoad(0.0, j));
+
+    for (int i = 0; i < nBlocks; ++i)
+      {
+      int bid = order[i];
+
+      rankLoad rl = ranks.top();
+      ranks.pop();
+
+      mdOut->BlockOwner[bid] = rl.second;
+      rl.first += costs[bid];
+      load[rl.second] = rl.first;
+
+      ranks.push(rl);
+      }
+    }
+  else
+    {
+    SENSEI_ERROR("Invalid method " << this->Method)
+    return -1;
+    }
+
+  this->ReportImbalance(mdOut, load);
+
+  return 0;
+}
+
+// --------------------------------------------------------------------------
+void WeightedPartitioner::SplitContiguous(const std::vector<int> &order,
+  const std::vector<double> &costs, int nRanks, std::vector<int> &owner,
+  std::vector<double> &load)
+{
+  int nBlocks = order.size();
+
+  load.assign(nRanks, 0.0);
+
+  // find the smallest largest load with which the blocks, in order, can
+  // be split into nRanks ranges by bisection
+  double total = 0.0;
+  double lo = 0.0;
+  for (int i = 0; i < nBlocks; ++i)
+    {
+    total += costs[order[i]];
+    lo = std::max(lo, costs[order[i]]);
+    }
+
+  double hi = total;
+  for (int it = 0; (it < 64) && (hi - lo > 1e-9*hi); ++it)
+    {
+    double mid = 0.5*(lo + hi);
+
+    int nParts = 1;
+    double sum = 0.0;
+    for (int i = 0; i < nBlocks; ++i)
+      {
+      double cost = costs[order[i]];
+      if (sum + cost > mid)
+        {
+        ++nParts;
+        sum = 0.0;
+        }
+      sum += cost;
+      }
+
+    if (nParts <= nRanks)
+      hi = mid;
+    else
+      lo = mid;
+    }
+
+  // split the blocks. a new range is started when the bound would be
+  // exceeded or when each of the remaining ranks needs a block
+  int rank = 0;
+  int nOnRank = 0;
+  for (int i = 0; i < nBlocks; ++i)
+    {
+    int bid = order[i];
+    double cost = costs[bid];
+
+    if (nOnRank && (rank < nRanks - 1) &&
+      ((load[rank] + cost > hi) || (nBlocks - i <= nRanks - 1 - rank)))
+      {
+      ++rank;
+      nOnRank = 0;
+      }
+
+    owner[bid] = rank;
+    load[rank] += cost;
+    ++nOnRank;
+    }
+}
+
+// --------------------------------------------------------------------------
+void WeightedPartitioner::ReportImbalance(const MeshMetadataPtr &md,
+  const std::vector<double> &load)
+{
+  int nRanks = load.size();
+
+  double total = 0.0;
+  double maxLoad = 0.0;
+  for (int j = 0; j < nRanks; ++j)
+    {
+    total += load[j];
+    maxLoad = std::max(maxLoad, load[j]);
+    }
+
+  this->Imbalance = total > 0.0 ? maxLoad*nRanks/total : 1.0;
+
+  char eventName[128];
+  snprintf(eventName, 128, "%s::GetPartition imbalance=%.4f",
+    this->GetClassName(), this->Imbalance);
+  Profiler::StartEvent(eventName);
+  Profiler::EndEvent(eventName);
+
+  if (this->GetVerbose())
+    {
+    SENSEI_STATUS("Placed " << md->NumBlocks << " blocks of mesh \""
+      << md->MeshName << "\" on " << nRanks << " ranks with imbalance "
+      << this->Imbalance << " (" << this->GetClassName() << ")")
+    }
+}
+
+// --------------------------------------------------------------------------
+int WeightedPartitioner::InitializeCost(pugi::xml_node &node)
+{
+  std::string cost = node.attribute("cost").as_string("cells");
+  if (cost == "cells")
+    {
+    this->SetCost(COST_CELLS);
+    }
+  else if (cost == "points")
+    {
+    this->SetCost(COST_POINTS);
+    }
+  else if (cost == "bytes")
+    {
+    this->SetCost(COST_BYTES);
+    }
+  else if (cost == "expression")
+    {
+    if (XMLUtils::RequireAttribute(node, "expression") ||
+      this->SetExpression(node.attribute("expression").value()))
+      {
+      SENSEI_ERROR("Failed to initialize the cost expression")
+      return -1;
+      }
+    this->SetCost(COST_EXPRESSION);
+    }
+  else
+    {
+    SENSEI_ERROR("Invalid cost \"" << cost << "\". The cost is one of "
+      "cells, points, bytes, or expression")
+    return -1;
+    }
+
+  this->SetVerbose(node.attribute("verbose").as_int(0));
+
+  return 0;
+}
+
+// --------------------------------------------------------------------------
+int WeightedPartitioner::InitializeMethod(pugi::xml_node &node)
+{
+  std::string method = node.attribute("method").as_string("lpt");
+  if (method == "greedy")
+    {
+    this->SetMethod(METHOD_GREEDY);
+    }
+  else if (method == "lpt")
+    {
+    this->SetMethod(METHOD_LPT);
+    }
+  else if (method == "contiguous")
+    {
+    this->SetMethod(METHOD_CONTIGUOUS);
+    }
+  else
+    {
+    SENSEI_ERROR("Invalid method \"" << method << "\". The method is one of "
+      "greedy, lpt, or contiguous")
+    return -1;
+    }
+
+  return 0;
+}
+
+// --------------------------------------------------------------------------
+int WeightedPartitioner::Initialize(pugi::xml_node &node)
+{
+  TimeEvent<128> mark("WeightedPartitioner::Initialize");
+
+  if (this->InitializeCost(node) || this->InitializeMethod(node))
+    return -1;
+
+  SENSEI_STATUS("Configured WeightedPartitioner cost="
+    << node.attribute("cost").as_string("cells")
+    << (this->Cost == COST_EXPRESSION ? " expression=" + this->Expression : "")
+    << " method=" << node.attribute("method").as_string("lpt"))
+
+  return 0;
+}
+
+}
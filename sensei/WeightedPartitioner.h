@@ -0,0 +1,120 @@
+#ifndef sensei_WeightedPartitioner_h
+#define sensei_WeightedPartitioner_h
+
+#include "Partitioner.h"
+
+#include <string>
+#include <vector>
+
+namespace sensei
+{
+
+class WeightedPartitioner;
+using WeightedPartitionerPtr = std::shared_ptr<sensei::WeightedPartitioner>;
+
+/// @class WeightedPartitioner
+/// The weighted partitioner distributes blocks to ranks such that the
+/// total cost of the blocks on each rank is balanced. The cost of a block
+/// is computed from the block size metadata provided by the sender
+/// (MeshMetadata.BlockNumCells, BlockNumPoints, and BlockCellArraySize)
+/// and is one of:
+///
+///   cells      : the number of cells
+///   points     : the number of points
+///   bytes      : an estimate of the size of the block's coordinates,
+///                cell arrays, and data arrays in bytes
+///   expression : an arithmetic expression of the variables cells,
+///                points, cell_array_size, and bytes, for instance
+///                "cells + 0.25*points"
+///
+/// The blocks are assigned by one of the following methods:
+///
+///   greedy     : in order, each block goes to the least loaded rank
+///   lpt        : largest first, each block goes to the least loaded rank
+///   contiguous : consecutive blocks share a rank, and the ranges are
+///                chosen to minimize the largest load
+///
+/// When the sender does not provide the block sizes each block is given
+/// the same cost. The achieved imbalance, the largest load over the
+/// average, is logged as a Profiler event. The XML is of the form:
+///
+///   <partitioner type="weighted" cost="cells" method="lpt"
+///     expression="cells + 0.25*points"/>
+class WeightedPartitioner : public sensei::Partitioner
+{
+public:
+  static sensei::WeightedPartitionerPtr New()
+  { return WeightedPartitionerPtr(new WeightedPartitioner); }
+
+  const char *GetClassName() override { return "WeightedPartitioner"; }
+
+  enum {COST_CELLS=0, COST_POINTS=1, COST_BYTES=2, COST_EXPRESSION=3};
+  enum {METHOD_GREEDY=0, METHOD_LPT=1, METHOD_CONTIGUOUS=2};
+
+  // set the cost of each block, one of the COST_* values
+  void SetCost(int cost) { this->Cost = cost; }
+  int GetCost() { return this->Cost; }
+
+  // set the expression used with COST_EXPRESSION. returns non-zero if
+  // the expression could not be parsed
+  int SetExpression(const std::string &expr);
+
+  // set the assignment heuristic, one of the METHOD_* values
+  void SetMethod(int method) { this->Method = method; }
+  int GetMethod() { return this->Method; }
+
+  // given an existing partitioning of data passed in the first MeshMetadata
+  // argument,return a new partittioning in the second MeshMetadata argument.
+  // distributes blocks to ranks such that each rank has about the same
+  // cost.
+  int GetPartition(MPI_Comm comm, const sensei::MeshMetadataPtr &in,
+    sensei::MeshMetadataPtr &out) override;
+
+  // get the imbalance achieved by the last partition, the largest load
+  // over the average load
+  double GetImbalance() { return this->Imbalance; }
+
+  // compute the cost of each block
+  int GetBlockCosts(const sensei::MeshMetadataPtr &md,
+    std::vector<double> &costs);
+
+  // estimate the size of each block in bytes whatever the cost. blocks
+  // are given a size of 1 when the sender does not provide the sizes
+  int GetBlockBytes(const sensei::MeshMetadataPtr &md,
+    std::vector<double> &bytes);
+
+  // Initialize from XML
+  int Initialize(pugi::xml_node &node) override;
+
+protected:
+  WeightedPartitioner() : Cost(COST_CELLS), Method(METHOD_LPT),
+    Imbalance(1.0) {}
+  WeightedPartitioner(const WeightedPartitioner &) = default;
+
+  // parse the cost, expression, and verbose attributes
+  int InitializeCost(pugi::xml_node &node);
+
+  // parse the method attribute
+  int InitializeMethod(pugi::xml_node &node);
+
+  // assign the blocks, taken in the given order, to ranks in contiguous
+  // ranges minimizing the largest load. owner is indexed by block, and
+  // load receives the load of each rank.
+  void SplitContiguous(const std::vector<int> &order,
+    const std::vector<double> &costs, int nRanks, std::vector<int> &owner,
+    std::vector<double> &load);
+
+  // compute the imbalance from the load of each rank and log it
+  void ReportImbalance(const sensei::MeshMetadataPtr &md,
+    const std::vector<double> &load);
+
+  int Cost;
+  int Method;
+  double Imbalance;
+  std::string Expression;
+  std::vector<std::string> Program; // the expression in postfix order
+};
+
+}
+
+#endif
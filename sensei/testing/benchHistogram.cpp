@@ -0,0 +1,136 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <string>
+#include <vector>
+#include <mpi.h>
+#include <vtkDoubleArray.h>
+#include <vtkFloatArray.h>
+#include <vtkUnsignedCharArray.h>
+#include "VTKHistogram.h"
+#include "VTKUtils.h"
+
+// Reports the throughput of the histogram kernels in GB/s of array data
+// processed, for float and double arrays with and without ghosts. The
+// range and binning passes are timed separately.
+//
+// usage: benchHistogram [num values] [num repetitions] [num threads]
+
+namespace
+{
+double getSystemTime()
+{
+  using namespace std::chrono;
+  return duration_cast<duration<double>>(
+    steady_clock::now().time_since_epoch()).count();
+}
+
+template <typename array_t>
+void benchmark(const char *typeName, vtkIdType nVals, int nReps,
+  unsigned int nThreads, bool useGhosts)
+{
+  using value_t = typename array_t::ValueType;
+
+  array_t *da = array_t::New();
+  da->SetNumberOfTuples(nVals);
+
+  vtkUnsignedCharArray *ghosts = vtkUnsignedCharArray::New();
+  ghosts->SetNumberOfTuples(nVals);
+
+  std::mt19937 gen(12345);
+  std::normal_distribution<double> dist(5.0, 2.0);
+  for (vtkIdType i = 0; i < nVals; ++i)
+    {
+    *da->GetPointer(i) = static_cast<value_t>(dist(gen));
+    *ghosts->GetPointer(i) = (i % 16) == 0 ? 1 : 0;
+    }
+
+  vtkUnsignedCharArray *ga = useGhosts ? ghosts : nullptr;
+
+  // split the array as Histogram does
+  const vtkIdType pieceSize = 65536;
+  unsigned int nPieces = (nVals + pieceSize - 1)/pieceSize;
+
+  double rangeTime = 0.0;
+  double binTime = 0.0;
+  for (int r = 0; r < nReps; ++r)
+    {
+    sensei::VTKHistogram hist(1, nThreads);
+
+    sensei::VTKUtils::ThreadLoopFunction addRange =
+      [&](unsigned int thread, unsigned int i) -> int
+      {
+      hist.AddRange(da, ga, thread, i*pieceSize,
+        std::min((i + 1)*pieceSize, nVals));
+      return 0;
+      };
+
+    sensei::VTKUtils::ThreadLoopFunction compute =
+      [&](unsigned int thread, unsigned int i) -> int
+      {
+      hist.Compute(da, ga, thread, i*pieceSize,
+        std::min((i + 1)*pieceSize, nVals));
+      return 0;
+      };
+
+    double t0 = getSystemTime();
+    sensei::VTKUtils::ParallelFor(nThreads, nPieces, addRange);
+    double t1 = getSystemTime();
+
+    hist.PreCompute(MPI_COMM_SELF, 100);
+
+    double t2 = getSystemTime();
+    sensei::VTKUtils::ParallelFor(nThreads, nPieces, compute);
+    double t3 = getSystemTime();
+
+    rangeTime += t1 - t0;
+    binTime += t3 - t2;
+    }
+
+  double bytes = double(nReps)*nVals*(sizeof(value_t) + (useGhosts ? 1 : 0));
+
+  std::cerr << std::setw(8) << typeName
+    << std::setw(8) << (useGhosts ? "ghosts" : "none")
+    << std::setw(12) << std::fixed << std::setprecision(3)
+    << bytes/rangeTime/1.0e9 << std::setw(12) << bytes/binTime/1.0e9
+    << std::endl;
+
+  da->Delete();
+  ghosts->Delete();
+}
+}
+
+int main(int argc, char **argv)
+{
+  MPI_Init(&argc, &argv);
+
+  vtkIdType nVals = argc > 1 ? atol(argv[1]) : 1 << 24;
+  int nReps = argc > 2 ? atoi(argv[2]) : 5;
+  unsigned int nThreads = argc > 3 ? atoi(argv[3]) : 1;
+
+  sensei::VTKUtils::SetNumberOfThreads(nThreads);
+
+  int rank = 0;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  if (rank == 0)
+    {
+    std::cerr << "benchHistogram " << nVals << " values " << nReps
+      << " repetitions " << nThreads << " threads" << std::endl
+      << std::setw(8) << "type" << std::setw(8) << "ghosts"
+      << std::setw(12) << "range GB/s" << std::setw(12) << "bin GB/s"
+      << std::endl;
+
+    benchmark<vtkFloatArray>("float", nVals, nReps, nThreads, false);
+    benchmark<vtkFloatArray>("float", nVals, nReps, nThreads, true);
+    benchmark<vtkDoubleArray>("double", nVals, nReps, nThreads, false);
+    benchmark<vtkDoubleArray>("double", nVals, nReps, nThreads, true);
+    }
+
+  sensei::VTKUtils::SetNumberOfThreads(1);
+
+  MPI_Finalize();
+
+  return 0;
+}
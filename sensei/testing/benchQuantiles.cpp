@@ -0,0 +1,169 @@
+#include "senseiConfig.h"
+#include "KLLSketch.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+#include <mpi.h>
+
+#if defined(ENABLE_VTKM) && defined(ENABLE_VTK_MPI)
+#include <vtkType.h>
+#include <vtkMPIController.h>
+#include <vtkNew.h>
+#include "CDFReducer.h"
+#define HAVE_CDF_REDUCER
+#endif
+
+// Compares the accuracy and run time of quantiles computed with the
+// KLLSketch and, when VTK-m and VTK MPI are enabled, the CDFReducer. The
+// error reported is the largest difference between the requested quantile
+// and the exact rank, relative to the number of values, of the value
+// returned. The sketch time includes sketching the local data, the
+// reduction and the queries. The CDFReducer time includes the local sort
+// that it requires. Returns non-zero if the error of the sketch exceeds
+// its bound.
+//
+// usage: benchQuantiles [values per rank] [num quantiles] [k]
+
+namespace
+{
+double getSystemTime()
+{
+  using namespace std::chrono;
+  return duration_cast<duration<double>>(
+    steady_clock::now().time_since_epoch()).count();
+}
+
+// the largest error in the rank of the values over all ranks. sorted are
+// the local values
+double rankError(MPI_Comm comm, const std::vector<double> &sorted,
+  const std::vector<double> &q, std::vector<double> vals)
+{
+  int rank = 0;
+  MPI_Comm_rank(comm, &rank);
+
+  unsigned int nq = q.size();
+  vals.resize(nq);
+  MPI_Bcast(vals.data(), nq, MPI_DOUBLE, 0, comm);
+
+  std::vector<long> counts(nq + 1);
+  for (unsigned int i = 0; i < nq; ++i)
+    counts[i] = std::upper_bound(sorted.begin(), sorted.end(), vals[i])
+      - sorted.begin();
+  counts[nq] = sorted.size();
+
+  MPI_Allreduce(MPI_IN_PLACE, counts.data(), nq + 1, MPI_LONG, MPI_SUM, comm);
+
+  double maxErr = 0.0;
+  for (unsigned int i = 0; i < nq; ++i)
+    maxErr = std::max(maxErr,
+      std::fabs(double(counts[i])/counts[nq] - q[i]));
+
+  return maxErr;
+}
+}
+
+int main(int argc, char **argv)
+{
+  MPI_Init(&argc, &argv);
+
+  long nVals = argc > 1 ? atol(argv[1]) : 1 << 22;
+  int nQuantiles = argc > 2 ? atoi(argv[2]) : 11;
+  int k = argc > 3 ? atoi(argv[3]) : 200;
+
+  MPI_Comm comm = MPI_COMM_WORLD;
+
+  int rank = 0;
+  int nRanks = 1;
+  MPI_Comm_rank(comm, &rank);
+  MPI_Comm_size(comm, &nRanks);
+
+  // each rank has a differently shifted normal distribution
+  std::vector<double> vals(nVals);
+  std::mt19937 gen(12345 + rank);
+  std::normal_distribution<double> dist(5.0 + rank, 2.0);
+  for (long i = 0; i < nVals; ++i)
+    vals[i] = dist(gen);
+
+  nQuantiles = std::max(nQuantiles, 3);
+  std::vector<double> q(nQuantiles);
+  for (int i = 0; i < nQuantiles; ++i)
+    q[i] = double(i)/(nQuantiles - 1);
+
+  // sketch
+  MPI_Barrier(comm);
+  double t0 = getSystemTime();
+
+  sensei::KLLSketch sketch(k);
+  for (long i = 0; i < nVals; ++i)
+    sketch.Insert(vals[i]);
+
+  sketch.Reduce(comm, 0);
+
+  std::vector<double> sketchVals;
+  if (rank == 0)
+    sketch.GetQuantiles(q, sketchVals);
+
+  MPI_Barrier(comm);
+  double sketchTime = getSystemTime() - t0;
+
+  std::vector<double> sorted(vals);
+
+#if defined(HAVE_CDF_REDUCER)
+  vtkNew<vtkMPIController> controller;
+  controller->Initialize(nullptr, nullptr, 1);
+
+  MPI_Barrier(comm);
+  t0 = getSystemTime();
+
+  std::sort(sorted.begin(), sorted.end());
+
+  CDFReducer reducer(controller);
+  reducer.SetBufferSize(nQuantiles);
+  double *cdf = reducer.Compute(sorted.data(), nVals, nQuantiles);
+  std::vector<double> cdfVals(cdf, cdf + nQuantiles);
+
+  MPI_Barrier(comm);
+  double cdfTime = getSystemTime() - t0;
+#else
+  std::sort(sorted.begin(), sorted.end());
+#endif
+
+  double sketchErr = rankError(comm, sorted, q, sketchVals);
+#if defined(HAVE_CDF_REDUCER)
+  double cdfErr = rankError(comm, sorted, q, cdfVals);
+#endif
+
+  // the expected error is about 1.7/k, allow for some variation
+  double bound = 3.0/k;
+  int result = sketchErr > bound ? -1 : 0;
+
+  if (rank == 0)
+    {
+    std::cerr << "benchQuantiles " << nRanks << " ranks " << nVals
+      << " values per rank " << nQuantiles << " quantiles k " << k << std::endl
+      << std::setw(12) << "method" << std::setw(14) << "time (s)"
+      << std::setw(14) << "rank diff" << std::endl
+      << std::setw(12) << "KLLSketch" << std::setw(14) << std::scientific
+      << std::setprecision(3) << sketchTime << std::setw(14) << sketchErr
+      << std::endl;
+#if defined(HAVE_CDF_REDUCER)
+    std::cerr << std::setw(12) << "CDFReducer" << std::setw(14) << cdfTime
+      << std::setw(14) << cdfErr << std::endl;
+#else
+    std::cerr << "CDFReducer is not available in this build" << std::endl;
+#endif
+    if (result)
+      std::cerr << "The sketch rank difference " << sketchErr
+        << " exceeds the bound " << bound << std::endl;
+    }
+
+  MPI_Finalize();
+
+  return result;
+}
@@ -0,0 +1,93 @@
+#ifndef partitionerTestUtils_h
+#define partitionerTestUtils_h
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+#include <pugixml.hpp>
+#include <vtkDataObject.h>
+#include <vtkType.h>
+#include "MeshMetadata.h"
+
+// Fixtures shared by the partitioner tests
+
+namespace partitionerTestUtils
+{
+// unstructured blocks with the given numbers of cells and a cell data
+// array. block i is owned by rank i % nOwners
+inline
+sensei::MeshMetadataPtr newMetadata(const std::vector<long> &cells,
+  int nOwners = 1, const std::string &name = "mesh")
+{
+  sensei::MeshMetadataPtr md = sensei::MeshMetadata::New();
+  md->MeshName = name;
+  md->BlockType = VTK_UNSTRUCTURED_GRID;
+  md->NumBlocks = cells.size();
+  md->NumArrays = 1;
+  md->ArrayName = {"data"};
+  md->ArrayCentering = {vtkDataObject::CELL};
+  md->ArrayComponents = {1};
+  md->ArrayType = {VTK_DOUBLE};
+  md->GlobalView = true;
+
+  for (int i = 0; i < md->NumBlocks; ++i)
+    {
+    md->BlockOwner.push_back(i % nOwners);
+    md->BlockIds.push_back(i);
+    md->BlockNumCells.push_back(cells[i]);
+    md->BlockNumPoints.push_back(2*cells[i]);
+    md->BlockCellArraySize.push_back(9*cells[i]);
+    }
+
+  return md;
+}
+
+// image blocks stacked along z, each of nx by ny by nz cells, with a point
+// data array. all are owned by rank 0
+inline
+sensei::MeshMetadataPtr newImageMetadata(int nBlocks, int nx, int ny, int nz)
+{
+  sensei::MeshMetadataPtr md = sensei::MeshMetadata::New();
+  md->MeshName = "mesh";
+  md->BlockType = VTK_IMAGE_DATA;
+  md->NumBlocks = nBlocks;
+  md->NumArrays = 1;
+  md->ArrayName = {"data"};
+  md->ArrayCentering = {vtkDataObject::POINT};
+  md->ArrayComponents = {1};
+  md->ArrayType = {VTK_DOUBLE};
+  md->GlobalView = true;
+
+  for (int i = 0; i < nBlocks; ++i)
+    {
+    int k0 = i*nz;
+    md->BlockOwner.push_back(0);
+    md->BlockIds.push_back(i);
+    md->BlockExtents.push_back({0, nx, 0, ny, k0, k0 + nz});
+    md->BlockBounds.push_back({0.0, 1.0*nx, 0.0, 1.0*ny, 1.0*k0, 1.0*(k0 + nz)});
+    md->BlockNumPoints.push_back((nx + 1l)*(ny + 1l)*(nz + 1l));
+    md->BlockNumCells.push_back(long(nx)*std::max(ny, 1)*std::max(nz, 1));
+    }
+
+  return md;
+}
+
+// a partitioner of the given type initialized from the partitioner
+// element of the XML. returns nullptr if initialization fails
+template <typename partitioner_t>
+std::shared_ptr<partitioner_t> newPartitioner(const std::string &xml)
+{
+  pugi::xml_document doc;
+  doc.load_string(xml.c_str());
+  pugi::xml_node node = doc.child("partitioner");
+
+  std::shared_ptr<partitioner_t> part = partitioner_t::New();
+  if (part->Initialize(node))
+    return nullptr;
+
+  return part;
+}
+}
+
+#endif
@@ -33,6 +33,41 @@ def check_array(array):
     return -1
   return 0
 
+def get_array(ds, name, assoc):
+  return ds.GetPointData().GetArray(name) \
+    if assoc == vtk.vtkDataObject.POINT else ds.GetCellData().GetArray(name)
+
+def check_batched(da, md, ds):
+  # requests the arrays of each centering with a single AddArrays call and
+  # checks that they match those requested one at a time in ds
+  bds = da.GetMesh(md.MeshName, False)
+  for assoc in [vtk.vtkDataObject.POINT, vtk.vtkDataObject.CELL]:
+    names = [md.ArrayName[j] for j in range(md.NumArrays) \
+      if md.ArrayCentering[j] == assoc]
+    if len(names) and da.AddArrays(bds, md.MeshName, assoc, names):
+      error_message('failed to add the arrays of mesh "%s" in one call'%( \
+        md.MeshName))
+      return -1
+
+  it = ds.NewIterator()
+  while not it.IsDoneWithTraversal():
+    blk = it.GetCurrentDataObject()
+    bblk = bds.GetDataSet(it)
+    j = 0
+    while j < md.NumArrays:
+      name = md.ArrayName[j]
+      assoc = md.ArrayCentering[j]
+      array = get_array(blk, name, assoc)
+      barray = get_array(bblk, name, assoc) if bblk is not None else None
+      if array is None or barray is None or not np.array_equal( \
+        vtknp.vtk_to_numpy(array), vtknp.vtk_to_numpy(barray)):
+        error_message('array "%s" of mesh "%s" differs when requested ' \
+          'in one call'%(name, md.MeshName))
+        return -1
+      j += 1
+    it.GoToNextItem()
+  return 0
+
 def read_data(engine, fileName, verbose):
   # initialize the data adaptor
   status_message('initializing ADIOS2DataAdaptor file=%s engine=%s'%(fileName,engine))
@@ -118,6 +153,11 @@ def read_data(engine, fileName, verbose):
 
           j += 1
         it.GoToNextItem()
+
+      # the same arrays requested in one call
+      if check_batched(da, md, ds):
+        retval = -1
+
       i += 1
 
     n_steps += 1
@@ -0,0 +1,260 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <mpi.h>
+#include <vtkCellData.h>
+#include <vtkCompositeDataIterator.h>
+#include <vtkCompositeDataSet.h>
+#include <vtkDataArray.h>
+#include <vtkDoubleArray.h>
+#include <vtkFloatArray.h>
+#include <vtkImageData.h>
+#include <vtkIntArray.h>
+#include <vtkMultiBlockDataSet.h>
+#include <vtkPointData.h>
+#include "Error.h"
+#include "VTKDataAdaptor.h"
+#include "VTKUtils.h"
+
+// Serves a multiblock with several point and cell arrays of different
+// types and component counts, then requests three arrays of each
+// centering in a single AddArrays call and one at a time with AddArray,
+// and checks that the two meshes hold the same arrays. This is done with
+// the VTKDataAdaptor's single pass AddArrays and with the default one
+// implemented by DataAdaptor.
+
+namespace
+{
+const int N = 4;
+
+// fill an array with values that depend on the block, the array, the
+// tuple and the component
+void fill(vtkDataArray *da, const char *name, int nComps, long nTuples,
+  int block, int arrayId)
+{
+  da->SetName(name);
+  da->SetNumberOfComponents(nComps);
+  da->SetNumberOfTuples(nTuples);
+  for (long i = 0; i < nTuples; ++i)
+    {
+    for (int j = 0; j < nComps; ++j)
+      da->SetComponent(i, j, 1000*block + 100*arrayId + 3*i + j);
+    }
+}
+
+// two image blocks per rank, each with three point and three cell arrays
+vtkMultiBlockDataSet *newMesh()
+{
+  int rank = 0;
+  int nRanks = 1;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &nRanks);
+
+  vtkMultiBlockDataSet *mb = vtkMultiBlockDataSet::New();
+  mb->SetNumberOfBlocks(2*nRanks);
+
+  for (int b = 2*rank; b < 2*(rank + 1); ++b)
+    {
+    vtkImageData *im = vtkImageData::New();
+    im->SetExtent(0, N, 0, N, b*N, (b + 1)*N);
+
+    vtkFieldData *fd[2] = {im->GetPointData(), im->GetCellData()};
+    long nTuples[2] = {im->GetNumberOfPoints(), im->GetNumberOfCells()};
+    for (int c = 0; c < 2; ++c)
+      {
+      vtkDataArray *arrays[3] = {vtkDoubleArray::New(),
+        vtkFloatArray::New(), vtkIntArray::New()};
+
+      fill(arrays[0], "d", 1, nTuples[c], b, 3*c);
+      fill(arrays[1], "f", 3, nTuples[c], b, 3*c + 1);
+      fill(arrays[2], "i", 2, nTuples[c], b, 3*c + 2);
+
+      for (int j = 0; j < 3; ++j)
+        {
+        fd[c]->AddArray(arrays[j]);
+        arrays[j]->Delete();
+        }
+      }
+
+    mb->SetBlock(b, im);
+    im->Delete();
+    }
+
+  return mb;
+}
+
+// check that the arrays of each block of the two meshes are the same
+int compare(vtkDataObject *batched, vtkDataObject *single,
+  int association, const std::vector<std::string> &names,
+  const char *variant)
+{
+  vtkCompositeDataSet *cdBatched =
+    dynamic_cast<vtkCompositeDataSet*>(batched);
+
+  vtkCompositeDataSet *cdSingle =
+    dynamic_cast<vtkCompositeDataSet*>(single);
+
+  if (!cdBatched || !cdSingle)
+    {
+    SENSEI_ERROR("The " << variant << " meshes are not composite")
+    return -1;
+    }
+
+  int nBlocks = 0;
+  vtkCompositeDataIterator *it = cdSingle->NewIterator();
+  for (it->InitTraversal(); !it->IsDoneWithTraversal(); it->GoToNextItem())
+    {
+    vtkDataSet *dsSingle =
+      dynamic_cast<vtkDataSet*>(it->GetCurrentDataObject());
+
+    vtkDataSet *dsBatched =
+      dynamic_cast<vtkDataSet*>(cdBatched->GetDataSet(it));
+
+    if (!dsSingle || !dsBatched)
+      {
+      SENSEI_ERROR("Block " << it->GetCurrentFlatIndex() << " of the "
+        << variant << " meshes is missing")
+      it->Delete();
+      return -1;
+      }
+
+    vtkFieldData *fdSingle =
+      sensei::VTKUtils::GetAttributes(dsSingle, association);
+
+    vtkFieldData *fdBatched =
+      sensei::VTKUtils::GetAttributes(dsBatched, association);
+
+    if (fdBatched->GetNumberOfArrays() != int(names.size()))
+      {
+      SENSEI_ERROR("The " << variant << " AddArrays added "
+        << fdBatched->GetNumberOfArrays() << " arrays, " << names.size()
+        << " were expected")
+      it->Delete();
+      return -1;
+      }
+
+    unsigned int nNames = names.size();
+    for (unsigned int i = 0; i < nNames; ++i)
+      {
+      vtkDataArray *aSingle = fdSingle->GetArray(names[i].c_str());
+      vtkDataArray *aBatched = fdBatched->GetArray(names[i].c_str());
+
+      bool same = aSingle && aBatched &&
+        (aSingle->GetDataType() == aBatched->GetDataType()) &&
+        (aSingle->GetNumberOfComponents() ==
+          aBatched->GetNumberOfComponents()) &&
+        (aSingle->GetNumberOfTuples() == aBatched->GetNumberOfTuples());
+
+      long nTuples = same ? aSingle->GetNumberOfTuples() : 0;
+      int nComps = same ? aSingle->GetNumberOfComponents() : 0;
+      for (long j = 0; same && (j < nTuples); ++j)
+        {
+        for (int k = 0; same && (k < nComps); ++k)
+          same = aSingle->GetComponent(j, k) == aBatched->GetComponent(j, k);
+        }
+
+      if (!same)
+        {
+        SENSEI_ERROR("The " << variant << " "
+          << sensei::VTKUtils::GetAttributesName(association)
+          << " data array \"" << names[i]
+          << "\" differs from the one fetched alone")
+        it->Delete();
+        return -1;
+        }
+      }
+
+    nBlocks += 1;
+    }
+  it->Delete();
+
+  if (nBlocks != 2)
+    {
+    SENSEI_ERROR("The " << variant << " meshes have " << nBlocks
+      << " local blocks, 2 were expected")
+    return -1;
+    }
+
+  return 0;
+}
+
+int testAddArrays(sensei::VTKDataAdaptor *da, bool useDefault)
+{
+  const char *variant = useDefault ? "default" : "VTKDataAdaptor";
+  int assocs[2] = {vtkDataObject::POINT, vtkDataObject::CELL};
+
+  // the arrays are requested out of order to check that the order does
+  // not matter
+  std::vector<std::string> names({"i", "d", "f"});
+
+  for (int c = 0; c < 2; ++c)
+    {
+    vtkDataObject *batched = nullptr;
+    vtkDataObject *single = nullptr;
+    if (da->GetMesh("mesh", false, batched) ||
+      da->GetMesh("mesh", false, single))
+      {
+      SENSEI_ERROR("Failed to get the mesh")
+      return -1;
+      }
+
+    int ierr = useDefault ?
+      da->sensei::DataAdaptor::AddArrays(batched, "mesh", assocs[c], names) :
+      da->AddArrays(batched, "mesh", assocs[c], names);
+
+    for (unsigned int i = 0; !ierr && (i < names.size()); ++i)
+      ierr = da->AddArray(single, "mesh", assocs[c], names[i]);
+
+    if (ierr)
+      {
+      SENSEI_ERROR("Failed to add the "
+        << sensei::VTKUtils::GetAttributesName(assocs[c])
+        << " data arrays with the " << variant << " AddArrays")
+      }
+    else
+      {
+      ierr = compare(batched, single, assocs[c], names, variant);
+      }
+
+    batched->Delete();
+    single->Delete();
+
+    if (ierr)
+      return -1;
+    }
+
+  return 0;
+}
+}
+
+int main(int argc, char **argv)
+{
+  MPI_Init(&argc, &argv);
+
+  int rank = 0;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+  vtkMultiBlockDataSet *mb = newMesh();
+
+  sensei::VTKDataAdaptor *da = sensei::VTKDataAdaptor::New();
+  da->SetCommunicator(MPI_COMM_WORLD);
+  da->SetDataObject("mesh", mb);
+  mb->Delete();
+
+  int result = 0;
+  if (testAddArrays(da, false) || testAddArrays(da, true))
+    result = -1;
+
+  da->ReleaseData();
+  da->Delete();
+
+  int globalResult = 0;
+  MPI_Allreduce(&result, &globalResult, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+
+  if ((rank == 0) && !globalResult)
+    std::cerr << "AddArrays checks passed" << std::endl;
+
+  MPI_Finalize();
+
+  return globalResult;
+}
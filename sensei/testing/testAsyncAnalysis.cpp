@@ -0,0 +1,187 @@
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <mpi.h>
+#include <pugixml.hpp>
+#include <vtkDoubleArray.h>
+#include <vtkImageData.h>
+#include <vtkPointData.h>
+#include "Error.h"
+#include "ConfigurableAnalysis.h"
+#include "VTKDataAdaptor.h"
+
+// Runs a histogram through ConfigurableAnalysis in asynchronous mode for
+// several steps, overwriting the simulation data as soon as Execute
+// returns, and checks that the histograms written are those of the same
+// run in synchronous mode. This checks that the analysis works on a
+// snapshot of each step taken before Execute returns.
+
+namespace
+{
+const int N = 8;
+const int N_STEPS = 4;
+
+// an image of N^3 cells per rank stacked along z
+vtkImageData *newImage()
+{
+  int rank = 0;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+  vtkImageData *im = vtkImageData::New();
+  im->SetExtent(0, N, 0, N, rank*N, (rank + 1)*N);
+
+  vtkDoubleArray *da = vtkDoubleArray::New();
+  da->SetName("data");
+  da->SetNumberOfTuples(im->GetNumberOfPoints());
+  im->GetPointData()->AddArray(da);
+  da->Delete();
+
+  return im;
+}
+
+// the values of the array at the given step. each step has its own range
+void setValues(vtkImageData *im, int step)
+{
+  int rank = 0;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+  vtkDoubleArray *da = static_cast<vtkDoubleArray*>(
+    im->GetPointData()->GetArray("data"));
+
+  long nPts = da->GetNumberOfTuples();
+  for (long i = 0; i < nPts; ++i)
+    da->SetValue(i, (i % 23)*(step + 1) + rank);
+}
+
+// run N_STEPS steps, writing the histograms with the given prefix
+int run(const std::string &prefix, bool async)
+{
+  vtkImageData *im = newImage();
+
+  sensei::VTKDataAdaptor *data = sensei::VTKDataAdaptor::New();
+  data->SetCommunicator(MPI_COMM_WORLD);
+
+  std::string xml = std::string("<sensei async=\"") + (async ? "1" : "0")
+    + "\" async_queue_depth=\"2\">"
+    "<analysis type=\"histogram\" mesh=\"mesh\" array=\"data\""
+    " association=\"point\" bins=\"16\" file=\"" + prefix + "\""
+    " enabled=\"1\"/></sensei>";
+
+  pugi::xml_document doc;
+  doc.load_string(xml.c_str());
+
+  sensei::ConfigurableAnalysis *analysis = sensei::ConfigurableAnalysis::New();
+  analysis->SetCommunicator(MPI_COMM_WORLD);
+
+  int result = 0;
+  if (analysis->Initialize(doc.child("sensei")))
+    {
+    SENSEI_ERROR("Failed to initialize the analysis")
+    result = -1;
+    }
+
+  for (int step = 0; step < N_STEPS; ++step)
+    {
+    setValues(im, step);
+    data->SetDataObject("mesh", im);
+    data->SetDataTimeStep(step);
+    data->SetDataTime(step);
+
+    if (!analysis->Execute(data))
+      {
+      SENSEI_ERROR("Failed to execute step " << step)
+      result = -1;
+      }
+
+    // the simulation moves on while the step is analyzed
+    data->ReleaseData();
+    setValues(im, 100);
+    }
+
+  analysis->Finalize();
+  analysis->Delete();
+
+  data->Delete();
+  im->Delete();
+
+  return result;
+}
+
+// read a file into a string
+int readFile(const std::string &fileName, std::string &contents)
+{
+  std::ifstream ifs(fileName);
+  if (!ifs)
+    {
+    SENSEI_ERROR("Failed to open \"" << fileName << "\"")
+    return -1;
+    }
+
+  std::ostringstream oss;
+  oss << ifs.rdbuf();
+  contents = oss.str();
+
+  return 0;
+}
+}
+
+int main(int argc, char **argv)
+{
+  int threadLevel = MPI_THREAD_SINGLE;
+  MPI_Init_thread(&argc, &argv, MPI_THREAD_MULTIPLE, &threadLevel);
+
+  int rank = 0;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+  if (threadLevel < MPI_THREAD_MULTIPLE)
+    {
+    if (rank == 0)
+      std::cerr << "MPI_THREAD_MULTIPLE is not available, skipping"
+        << std::endl;
+    MPI_Finalize();
+    return 0;
+    }
+
+  std::string outputDir = argc > 1 ? argv[1] : ".";
+  std::string syncPrefix = outputDir + "/testAsyncAnalysis_sync";
+  std::string asyncPrefix = outputDir + "/testAsyncAnalysis_async";
+
+  // every rank runs both, each is collective
+  int result = 0;
+  if (run(syncPrefix, false))
+    result = -1;
+
+  if (run(asyncPrefix, true))
+    result = -1;
+
+  // the histograms are written by rank 0
+  for (int step = 0; !result && (rank == 0) && (step < N_STEPS); ++step)
+    {
+    std::string suffix = "_mesh_data_" + std::to_string(step) + ".txt";
+
+    std::string syncHist;
+    std::string asyncHist;
+    if (readFile(syncPrefix + suffix, syncHist) ||
+      readFile(asyncPrefix + suffix, asyncHist))
+      {
+      result = -1;
+      }
+    else if (syncHist != asyncHist)
+      {
+      SENSEI_ERROR("The asynchronous histogram of step " << step
+        << " differs from the synchronous one")
+      result = -1;
+      }
+    }
+
+  int globalResult = 0;
+  MPI_Allreduce(&result, &globalResult, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+
+  if ((rank == 0) && !globalResult)
+    std::cerr << "Asynchronous analysis checks passed" << std::endl;
+
+  MPI_Finalize();
+
+  return globalResult;
+}
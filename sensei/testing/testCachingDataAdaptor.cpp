@@ -0,0 +1,217 @@
+#include <cstring>
+#include <iostream>
+#include <mpi.h>
+#include <vtkCellData.h>
+#include <vtkDataSetAttributes.h>
+#include <vtkDoubleArray.h>
+#include <vtkImageData.h>
+#include <vtkPointData.h>
+#include <vtkUnsignedCharArray.h>
+#include "Error.h"
+#include "CachingDataAdaptor.h"
+#include "MeshMetadata.h"
+#include "VTKDataAdaptor.h"
+#include "VTKPosthocIO.h"
+
+// Shares an image between analyses through the CachingDataAdaptor. Checks
+// that a second request for the mesh, its arrays, and its metadata is
+// served from the cache with the same objects, and that writing the mesh
+// with VTKPosthocIO in VisIt mode, which names the ghost array avtGhostZones
+// in the files it writes, leaves the shared mesh and its ghost array
+// unchanged for the analyses that hold it.
+
+namespace
+{
+// an image of n^3 cells per rank stacked along z. the first layer of
+// cells is flagged as ghost cells
+vtkImageData *newImage(int n)
+{
+  int rank = 0;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+  vtkImageData *im = vtkImageData::New();
+  im->SetExtent(0, n, 0, n, rank*n, (rank + 1)*n);
+
+  long nPts = im->GetNumberOfPoints();
+  vtkDoubleArray *data = vtkDoubleArray::New();
+  data->SetName("data");
+  data->SetNumberOfTuples(nPts);
+  for (long i = 0; i < nPts; ++i)
+    data->SetValue(i, i);
+  im->GetPointData()->AddArray(data);
+  data->Delete();
+
+  long nCells = im->GetNumberOfCells();
+  vtkUnsignedCharArray *ghosts = vtkUnsignedCharArray::New();
+  ghosts->SetName("vtkGhostType");
+  ghosts->SetNumberOfTuples(nCells);
+  for (long i = 0; i < nCells; ++i)
+    ghosts->SetValue(i, i < n*n ? vtkDataSetAttributes::DUPLICATECELL : 0);
+  im->GetCellData()->AddArray(ghosts);
+  ghosts->Delete();
+
+  return im;
+}
+
+// get the mesh with its data and ghost arrays, as an analysis would
+int getArrays(sensei::DataAdaptor *da, vtkDataObject *&mesh,
+  vtkDataArray *&data, vtkDataArray *&ghosts)
+{
+  mesh = nullptr;
+  data = nullptr;
+  ghosts = nullptr;
+
+  if (da->GetMesh("mesh", false, mesh) ||
+    da->AddArray(mesh, "mesh", vtkDataObject::POINT, "data") ||
+    da->AddArray(mesh, "mesh", vtkDataObject::CELL, "vtkGhostType"))
+    {
+    SENSEI_ERROR("Failed to get the mesh")
+    return -1;
+    }
+
+  vtkDataSet *ds = dynamic_cast<vtkDataSet*>(mesh);
+  if (!ds || !(data = ds->GetPointData()->GetArray("data")) ||
+    !(ghosts = ds->GetCellData()->GetArray("vtkGhostType")))
+    {
+    SENSEI_ERROR("The mesh is missing its arrays")
+    return -1;
+    }
+
+  return 0;
+}
+
+int testCache(sensei::CachingDataAdaptor *cache)
+{
+  // the metadata is generated once
+  sensei::MeshMetadataFlags flags;
+  flags.SetBlockDecomp();
+  flags.SetBlockSize();
+
+  for (int i = 0; i < 2; ++i)
+    {
+    sensei::MeshMetadataPtr md = sensei::MeshMetadata::New(flags);
+    if (cache->GetMeshMetadata(0, md) || (md->MeshName != "mesh"))
+      {
+      SENSEI_ERROR("Failed to get metadata")
+      return -1;
+      }
+    }
+
+  long hits = 0;
+  long misses = 0;
+  cache->GetMetadataCacheStatistics(hits, misses);
+  if ((hits != 1) || (misses != 1))
+    {
+    SENSEI_ERROR("The metadata had " << hits << " hits and "
+      << misses << " misses")
+    return -1;
+    }
+
+  // the second analysis is given the objects of the first
+  vtkDataObject *mesh[2] = {nullptr};
+  vtkDataArray *data[2] = {nullptr};
+  vtkDataArray *ghosts[2] = {nullptr};
+
+  if (getArrays(cache, mesh[0], data[0], ghosts[0]))
+    return -1;
+
+  long misses0 = 0;
+  cache->GetCacheStatistics(hits, misses0);
+
+  if (getArrays(cache, mesh[1], data[1], ghosts[1]))
+    return -1;
+
+  cache->GetCacheStatistics(hits, misses);
+
+  int result = 0;
+  if ((mesh[0] != mesh[1]) || (data[0] != data[1]) || (ghosts[0] != ghosts[1]))
+    {
+    SENSEI_ERROR("The second request was not given the cached objects")
+    result = -1;
+    }
+
+  if ((hits < 3) || (misses != misses0))
+    {
+    SENSEI_ERROR("The second request had " << hits << " hits and "
+      << misses - misses0 << " misses")
+    result = -1;
+    }
+
+  mesh[0]->Delete();
+  mesh[1]->Delete();
+
+  return result;
+}
+
+int testPosthocIO(sensei::CachingDataAdaptor *cache)
+{
+  vtkDataObject *mesh = nullptr;
+  vtkDataArray *data = nullptr;
+  vtkDataArray *ghosts = nullptr;
+  if (getArrays(cache, mesh, data, ghosts))
+    return -1;
+
+  // the writer runs while an analysis holds the mesh and its ghost cells
+  sensei::VTKPosthocIO *writer = sensei::VTKPosthocIO::New();
+  if (writer->SetOutputDir("testCachingDataAdaptor") ||
+    writer->SetMode(sensei::VTKPosthocIO::MODE_VISIT) ||
+    !writer->Execute(cache) || writer->Finalize())
+    {
+    SENSEI_ERROR("Failed to write the mesh")
+    writer->Delete();
+    mesh->Delete();
+    return -1;
+    }
+  writer->Delete();
+
+  int result = 0;
+  vtkDataSet *ds = static_cast<vtkDataSet*>(mesh);
+  if (strcmp(ghosts->GetName(), "vtkGhostType") ||
+    (ds->GetCellData()->GetArray("vtkGhostType") != ghosts) ||
+    ds->GetCellData()->GetArray("avtGhostZones") ||
+    (ds->GetCellData()->GetNumberOfArrays() != 1) ||
+    (ds->GetPointData()->GetArray("data") != data))
+    {
+    SENSEI_ERROR("Writing the mesh modified the shared ghost array")
+    result = -1;
+    }
+
+  mesh->Delete();
+
+  return result;
+}
+}
+
+int main(int argc, char **argv)
+{
+  MPI_Init(&argc, &argv);
+
+  vtkImageData *im = newImage(8);
+
+  sensei::VTKDataAdaptor *dataAdaptor = sensei::VTKDataAdaptor::New();
+  dataAdaptor->SetDataObject("mesh", im);
+  im->Delete();
+
+  sensei::CachingDataAdaptor *cache = sensei::CachingDataAdaptor::New();
+  cache->SetCommunicator(MPI_COMM_WORLD);
+  cache->SetDataAdaptor(dataAdaptor);
+
+  int result = 0;
+  if (testCache(cache) || testPosthocIO(cache))
+    result = -1;
+
+  cache->SetDataAdaptor(nullptr);
+  cache->Delete();
+
+  dataAdaptor->ReleaseData();
+  dataAdaptor->Delete();
+
+  int rank = 0;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  if ((rank == 0) && !result)
+    std::cerr << "Caching data adaptor checks passed" << std::endl;
+
+  MPI_Finalize();
+
+  return result;
+}
@@ -0,0 +1,314 @@
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <mpi.h>
+#include <pugixml.hpp>
+#include <vtkDoubleArray.h>
+#include <vtkImageData.h>
+#include <vtkPointData.h>
+#include "senseiConfig.h"
+#include "Error.h"
+#include "CachingDataAdaptor.h"
+#include "ConfigurableAnalysis.h"
+#include "Histogram.h"
+#include "ThreadPool.h"
+#include "VTKDataAdaptor.h"
+#if defined(ENABLE_VTK_IO)
+#include "VTKPosthocIO.h"
+#endif
+
+// Runs two thread safe analyses, histograms of two arrays of one mesh, on
+// a thread pool as ConfigurableAnalysis does in concurrent mode. The
+// analyses share the mesh through a thread safe CachingDataAdaptor. When
+// VTK IO is enabled the mesh is also written by VTKPosthocIO at the same
+// time. Checks over several steps that the histograms are those computed
+// one at a time without the cache. Then runs the same histograms through
+// ConfigurableAnalysis with threads="2" and checks that the files written
+// are those written with the analyses run one at a time.
+
+namespace
+{
+// an image of n^3 cells per rank stacked along z with two point arrays
+vtkImageData *newImage(int n)
+{
+  int rank = 0;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+  vtkImageData *im = vtkImageData::New();
+  im->SetExtent(0, n, 0, n, rank*n, (rank + 1)*n);
+
+  long nPts = im->GetNumberOfPoints();
+  const char *names[] = {"a", "b"};
+  for (int j = 0; j < 2; ++j)
+    {
+    vtkDoubleArray *da = vtkDoubleArray::New();
+    da->SetName(names[j]);
+    da->SetNumberOfTuples(nPts);
+    for (long i = 0; i < nPts; ++i)
+      da->SetValue(i, j ? (i % 17)*(i % 5) : i % 31 + rank);
+    im->GetPointData()->AddArray(da);
+    da->Delete();
+    }
+
+  return im;
+}
+
+sensei::Histogram *newHistogram(const std::string &arrayName)
+{
+  sensei::Histogram *hist = sensei::Histogram::New();
+  hist->Initialize(16, "mesh", vtkDataObject::POINT, arrayName, "");
+  return hist;
+}
+
+// compare the last histograms of the two analyses
+int compare(sensei::Histogram *ref, sensei::Histogram *hist,
+  const char *name, int step)
+{
+  double min[2] = {0.0};
+  double max[2] = {0.0};
+  std::vector<unsigned int> bins[2];
+
+  ref->GetHistogram(min[0], max[0], bins[0]);
+  hist->GetHistogram(min[1], max[1], bins[1]);
+
+  int rank = 0;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+  // the bins are reduced to rank 0
+  if ((rank == 0) && (bins[0].empty() || (bins[0] != bins[1]) ||
+    (min[0] != min[1]) || (max[0] != max[1])))
+    {
+    SENSEI_ERROR("The concurrent histogram of \"" << name
+      << "\" is wrong at step " << step)
+    return -1;
+    }
+
+  return 0;
+}
+
+// run the histograms through ConfigurableAnalysis with the given number
+// of threads, writing them with the given prefix
+void runConfigurable(vtkImageData *im, const std::string &prefix,
+  int nThreads, int nSteps)
+{
+  sensei::VTKDataAdaptor *dataAdaptor = sensei::VTKDataAdaptor::New();
+  dataAdaptor->SetCommunicator(MPI_COMM_WORLD);
+
+  std::string xml = "<sensei threads=\"" + std::to_string(nThreads) + "\">";
+  const char *names[] = {"a", "b"};
+  for (int j = 0; j < 2; ++j)
+    {
+    xml += std::string("<analysis type=\"histogram\" mesh=\"mesh\" array=\"")
+      + names[j] + "\" association=\"point\" bins=\"16\" file=\""
+      + prefix + "\" enabled=\"1\"/>";
+    }
+  xml += "</sensei>";
+
+  pugi::xml_document doc;
+  doc.load_string(xml.c_str());
+
+  // errors abort
+  sensei::ConfigurableAnalysis *analysis = sensei::ConfigurableAnalysis::New();
+  analysis->SetCommunicator(MPI_COMM_WORLD);
+  analysis->Initialize(doc.child("sensei"));
+
+  for (int step = 0; step < nSteps; ++step)
+    {
+    dataAdaptor->SetDataObject("mesh", im);
+    dataAdaptor->SetDataTimeStep(step);
+    analysis->Execute(dataAdaptor);
+    dataAdaptor->ReleaseData();
+    }
+
+  analysis->Finalize();
+  analysis->Delete();
+
+  dataAdaptor->Delete();
+}
+
+// compare the files written with and without threads
+int compareFiles(const std::string &refName, const std::string &name)
+{
+  std::ifstream refFile(refName);
+  std::ifstream file(name);
+  if (!refFile || !file)
+    {
+    SENSEI_ERROR("Failed to open \"" << refName << "\" or \""
+      << name << "\"")
+    return -1;
+    }
+
+  std::ostringstream ref;
+  std::ostringstream hist;
+  ref << refFile.rdbuf();
+  hist << file.rdbuf();
+
+  if (ref.str() != hist.str())
+    {
+    SENSEI_ERROR("The histogram in \"" << name << "\" is wrong")
+    return -1;
+    }
+
+  return 0;
+}
+
+// both runs are collective, the files are written by rank 0
+int testConfigurable(vtkImageData *im, const std::string &outputDir)
+{
+  int rank = 0;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+  const int nSteps = 4;
+  std::string refPrefix = outputDir + "/testConcurrentAnalysis_serial";
+  std::string prefix = outputDir + "/testConcurrentAnalysis_threads";
+
+  runConfigurable(im, refPrefix, 0, nSteps);
+  runConfigurable(im, prefix, 2, nSteps);
+
+  if (rank != 0)
+    return 0;
+
+  int result = 0;
+  const char *names[] = {"a", "b"};
+  for (int step = 0; step < nSteps; ++step)
+    {
+    for (int j = 0; j < 2; ++j)
+      {
+      std::string suffix = std::string("_mesh_") + names[j] + "_"
+        + std::to_string(step) + ".txt";
+
+      if (compareFiles(refPrefix + suffix, prefix + suffix))
+        result = -1;
+      }
+    }
+
+  return result;
+}
+}
+
+int main(int argc, char **argv)
+{
+  int threadLevel = MPI_THREAD_SINGLE;
+  MPI_Init_thread(&argc, &argv, MPI_THREAD_MULTIPLE, &threadLevel);
+
+  int rank = 0;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+  if (threadLevel < MPI_THREAD_MULTIPLE)
+    {
+    if (rank == 0)
+      std::cerr << "MPI_THREAD_MULTIPLE is not available, skipping"
+        << std::endl;
+    MPI_Finalize();
+    return 0;
+    }
+
+  vtkImageData *im = newImage(16);
+
+  sensei::VTKDataAdaptor *dataAdaptor = sensei::VTKDataAdaptor::New();
+  dataAdaptor->SetDataObject("mesh", im);
+
+  sensei::CachingDataAdaptor *cache = sensei::CachingDataAdaptor::New();
+  cache->SetCommunicator(MPI_COMM_WORLD);
+  cache->SetThreadSafe(1);
+
+  const char *names[] = {"a", "b"};
+  sensei::Histogram *ref[2] = {nullptr};
+  sensei::Histogram *hist[2] = {nullptr};
+  for (int j = 0; j < 2; ++j)
+    {
+    ref[j] = newHistogram(names[j]);
+    hist[j] = newHistogram(names[j]);
+    }
+
+#if defined(ENABLE_VTK_IO)
+  sensei::VTKPosthocIO *writer = sensei::VTKPosthocIO::New();
+  writer->SetOutputDir("testConcurrentAnalysis");
+  writer->SetMode(sensei::VTKPosthocIO::MODE_VISIT);
+#endif
+
+  sensei::ThreadPool pool;
+  pool.Initialize(2);
+
+  int result = 0;
+  for (int step = 0; step < 8; ++step)
+    {
+    dataAdaptor->SetDataTimeStep(step);
+
+    // one at a time without the cache
+    for (int j = 0; j < 2; ++j)
+      ref[j]->Execute(dataAdaptor);
+
+    // concurrently through the cache
+    cache->SetDataAdaptor(dataAdaptor);
+
+    int ok[3] = {1, 1, 1};
+    for (int j = 0; j < 2; ++j)
+      {
+      sensei::Histogram *h = hist[j];
+      int *okj = ok + j;
+      pool.Push([h,cache,okj]() { *okj = h->Execute(cache); });
+      }
+
+#if defined(ENABLE_VTK_IO)
+    pool.Push([writer,cache,&ok]() { ok[2] = writer->Execute(cache); });
+#endif
+
+    pool.Wait();
+
+    cache->SetDataAdaptor(nullptr);
+
+    if (!ok[0] || !ok[1] || !ok[2])
+      {
+      SENSEI_ERROR("An analysis failed at step " << step)
+      result = -1;
+      continue;
+      }
+
+    for (int j = 0; j < 2; ++j)
+      {
+      if (compare(ref[j], hist[j], names[j], step))
+        result = -1;
+      }
+    }
+
+  pool.Finalize();
+
+#if defined(ENABLE_VTK_IO)
+  writer->Finalize();
+  writer->Delete();
+#endif
+
+  for (int j = 0; j < 2; ++j)
+    {
+    ref[j]->Finalize();
+    ref[j]->Delete();
+    hist[j]->Finalize();
+    hist[j]->Delete();
+    }
+
+  cache->Delete();
+
+  dataAdaptor->ReleaseData();
+  dataAdaptor->Delete();
+
+  // the histogram files are written to the directory given on the
+  // command line
+  if (testConfigurable(im, argc > 1 ? argv[1] : "."))
+    result = -1;
+
+  im->Delete();
+
+  int globalResult = 0;
+  MPI_Allreduce(&result, &globalResult, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+  result = globalResult;
+
+  if ((rank == 0) && !result)
+    std::cerr << "Concurrent analysis checks passed" << std::endl;
+
+  MPI_Finalize();
+
+  return result;
+}
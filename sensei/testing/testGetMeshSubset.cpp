@@ -0,0 +1,281 @@
+#include <algorithm>
+#include <array>
+#include <iostream>
+#include <set>
+#include <string>
+#include <vector>
+#include <mpi.h>
+#include <vtkCompositeDataIterator.h>
+#include <vtkCompositeDataSet.h>
+#include <vtkDoubleArray.h>
+#include <vtkImageData.h>
+#include <vtkMultiBlockDataSet.h>
+#include <vtkPointData.h>
+#include "senseiConfig.h"
+#include "Error.h"
+#include "MeshMetadata.h"
+#include "VTKDataAdaptor.h"
+#if defined(ENABLE_VTK_IO) && defined(ENABLE_VTK_FILTERS)
+#include "SliceExtract.h"
+#endif
+
+// Serves a multiblock with two blocks per rank, stacked along z, and
+// checks that the block subset and bounding box variants of GetMesh return
+// exactly the local blocks asked for, with both the VTKDataAdaptor and the
+// default DataAdaptor implementations. The metadata only lists the local
+// blocks while NumBlocks counts all of them, as with the miniapps. When
+// SliceExtract is available also checks that a slice fetches only the
+// local blocks that the slice plane crosses.
+
+namespace
+{
+const int N = 4;
+
+// two image blocks of N^3 cells per rank stacked along z. the blocks of
+// the other ranks are left empty
+vtkMultiBlockDataSet *newMesh()
+{
+  int rank = 0;
+  int nRanks = 1;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &nRanks);
+
+  vtkMultiBlockDataSet *mb = vtkMultiBlockDataSet::New();
+  mb->SetNumberOfBlocks(2*nRanks);
+
+  for (int b = 2*rank; b < 2*(rank + 1); ++b)
+    {
+    vtkImageData *im = vtkImageData::New();
+    im->SetExtent(0, N, 0, N, b*N, (b + 1)*N);
+
+    vtkDoubleArray *da = vtkDoubleArray::New();
+    da->SetName("data");
+    long nPts = im->GetNumberOfPoints();
+    da->SetNumberOfTuples(nPts);
+    for (long i = 0; i < nPts; ++i)
+      da->SetValue(i, b);
+    im->GetPointData()->AddArray(da);
+    da->Delete();
+
+    mb->SetBlock(b, im);
+    im->Delete();
+    }
+
+  return mb;
+}
+
+// records the block ids passed to the block subset variant of GetMesh
+class RecordingDataAdaptor : public sensei::VTKDataAdaptor
+{
+public:
+  static RecordingDataAdaptor *New();
+  senseiTypeMacro(RecordingDataAdaptor, sensei::VTKDataAdaptor);
+
+  using sensei::VTKDataAdaptor::GetMesh;
+
+  int GetMesh(const std::string &meshName, bool structureOnly,
+    const std::vector<int> &blockIds, vtkCompositeDataSet *&mesh) override
+  {
+    this->BlockIds = blockIds;
+    return this->sensei::VTKDataAdaptor::GetMesh(meshName, structureOnly,
+      blockIds, mesh);
+  }
+
+  std::vector<int> BlockIds;
+
+protected:
+  RecordingDataAdaptor() {}
+  ~RecordingDataAdaptor() {}
+};
+
+senseiNewMacro(RecordingDataAdaptor);
+
+// check that the non-empty blocks of the mesh are those expected
+int checkBlocks(const char *variant, vtkCompositeDataSet *mesh,
+  const std::set<int> &expected)
+{
+  int rank = 0;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+  if (!mesh)
+    {
+    SENSEI_ERROR("The " << variant << " variant returned no mesh")
+    return -1;
+    }
+
+  std::set<int> present;
+  vtkCompositeDataIterator *it = mesh->NewIterator();
+  for (it->InitTraversal(); !it->IsDoneWithTraversal(); it->GoToNextItem())
+    {
+    int bid = std::max(0, int(it->GetCurrentFlatIndex() - 1));
+    vtkImageData *im = dynamic_cast<vtkImageData*>(it->GetCurrentDataObject());
+    int ext[6] = {0};
+    if (im)
+      im->GetExtent(ext);
+    if (!im || (ext[4] != bid*N) || (ext[5] != (bid + 1)*N))
+      {
+      SENSEI_ERROR("Block " << bid << " of the " << variant
+        << " variant is wrong")
+      it->Delete();
+      return -1;
+      }
+    present.insert(bid);
+    }
+  it->Delete();
+
+  if (present != expected)
+    {
+    SENSEI_ERROR("The " << variant << " variant returned " << present.size()
+      << " blocks on rank " << rank << ", " << expected.size()
+      << " were expected")
+    return -1;
+    }
+
+  return 0;
+}
+
+int testSubset(sensei::DataAdaptor *da)
+{
+  int rank = 0;
+  int nRanks = 1;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &nRanks);
+
+  int result = 0;
+
+  // the metadata lists only the local blocks
+  sensei::MeshMetadataPtr md = sensei::MeshMetadata::New();
+  md->Flags.SetBlockDecomp();
+  md->Flags.SetBlockBounds();
+  if (da->GetMeshMetadata(0, md) || (md->NumBlocks != 2*nRanks) ||
+    (md->BlockIds.size() != 2) || (md->BlockBounds.size() != 2))
+    {
+    SENSEI_ERROR("Unexpected metadata on rank " << rank)
+    result = -1;
+    }
+
+  // the second local block and the first block of the next rank, only
+  // the local one is returned
+  std::vector<int> blockIds({2*rank + 1});
+  if (nRanks > 1)
+    blockIds.push_back((2*rank + 2) % (2*nRanks));
+  std::set<int> expected({2*rank + 1});
+
+  vtkCompositeDataSet *mesh = nullptr;
+  if (da->GetMesh("mesh", false, blockIds, mesh) ||
+    checkBlocks("block subset", mesh, expected))
+    result = -1;
+
+  if (mesh)
+    mesh->Delete();
+
+  // the default implementation, fetches the full mesh and drops the rest
+  mesh = nullptr;
+  if (da->sensei::DataAdaptor::GetMesh("mesh", false, blockIds, mesh) ||
+    checkBlocks("default block subset", mesh, expected))
+    result = -1;
+
+  if (mesh)
+    mesh->Delete();
+
+  // a box that crosses the boundary between blocks 1 and 2
+  std::array<double,6> box({0.0, 1.0, 0.0, 1.0, 1.5*N, 2.5*N});
+
+  expected.clear();
+  for (int b = 2*rank; b < 2*(rank + 1); ++b)
+    {
+    if ((b*N <= box[5]) && ((b + 1)*N >= box[4]))
+      expected.insert(b);
+    }
+
+  mesh = nullptr;
+  if (da->GetMesh("mesh", false, box, mesh) ||
+    checkBlocks("bounding box", mesh, expected))
+    result = -1;
+
+  if (mesh)
+    mesh->Delete();
+
+  return result;
+}
+
+#if defined(ENABLE_VTK_IO) && defined(ENABLE_VTK_FILTERS)
+// a slice through the middle of block 1 needs only that block
+int testSlice(RecordingDataAdaptor *da, const std::string &outputDir)
+{
+  int rank = 0;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+  sensei::SliceExtract *slice = sensei::SliceExtract::New();
+  slice->SetCommunicator(MPI_COMM_WORLD);
+  slice->SetOperation(sensei::SliceExtract::OP_PLANAR_SLICE);
+  slice->SetPoint({0.5*N, 0.5*N, 1.5*N});
+  slice->SetNormal({0.0, 0.0, 1.0});
+  slice->SetWriterOutputDir(outputDir);
+  slice->AddDataRequirement("mesh", vtkDataObject::POINT, {"data"});
+
+  da->BlockIds.clear();
+
+  int result = 0;
+  if (!slice->Execute(da) || slice->Finalize())
+    {
+    SENSEI_ERROR("Failed to slice the mesh")
+    result = -1;
+    }
+
+  std::vector<int> expected;
+  if (rank == 0)
+    expected.push_back(1);
+
+  if (!result && (da->BlockIds != expected))
+    {
+    SENSEI_ERROR("The slice fetched " << da->BlockIds.size()
+      << " blocks on rank " << rank << ", " << expected.size()
+      << " were expected")
+    result = -1;
+    }
+
+  slice->Delete();
+
+  return result;
+}
+#endif
+}
+
+int main(int argc, char **argv)
+{
+  MPI_Init(&argc, &argv);
+
+  int rank = 0;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+  vtkMultiBlockDataSet *mb = newMesh();
+
+  RecordingDataAdaptor *da = RecordingDataAdaptor::New();
+  da->SetCommunicator(MPI_COMM_WORLD);
+  da->SetDataObject("mesh", mb);
+  da->SetDataTimeStep(0);
+  da->SetDataTime(0.0);
+  mb->Delete();
+
+  int result = testSubset(da);
+
+#if defined(ENABLE_VTK_IO) && defined(ENABLE_VTK_FILTERS)
+  // the slices are written to the directory given on the command line
+  if (testSlice(da, argc > 1 ? argv[1] : "./"))
+    result = -1;
+#endif
+
+  da->ReleaseData();
+  da->Delete();
+
+  int globalResult = 0;
+  MPI_Allreduce(&result, &globalResult, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+
+  if ((rank == 0) && !globalResult)
+    std::cerr << "GetMesh subset checks passed" << std::endl;
+
+  MPI_Finalize();
+
+  return globalResult;
+}
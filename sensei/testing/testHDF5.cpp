@@ -5,6 +5,7 @@
 #include <vtkCellData.h>
 #include <vtkCharArray.h>
 #include <vtkCompositeDataIterator.h>
+#include <vtkCompositeDataSet.h>
 #include <vtkDataArray.h>
 #include <vtkDataSetAttributes.h>
 #include <vtkDoubleArray.h>
@@ -103,6 +104,94 @@ int check_array(vtkDataArray* array)
   return 0;
 }
 
+// fetches the arrays of each centering with a single AddArrays call and
+// checks that they match those fetched one at a time with AddArray
+int check_batched(sensei::DataAdaptor* da,
+                  const sensei::MeshMetadataPtr& mmd,
+                  vtkDataObject* mesh)
+{
+  const std::string& meshName = mmd->MeshName;
+
+  vtkDataObject* batched = nullptr;
+  if (da->GetMesh(meshName, false, batched))
+    {
+      SENSEI_ERROR("Failed to get mesh \"" << meshName << "\"");
+      return -1;
+    }
+
+  int assoc_ids[2] = { vtkDataObject::POINT, vtkDataObject::CELL };
+  for (int k = 0; k < 2; k++)
+    {
+      std::vector<std::string> names;
+      for (int j = 0; j < mmd->NumArrays; j++)
+        {
+          if (mmd->ArrayCentering[j] == assoc_ids[k])
+            names.push_back(mmd->ArrayName[j]);
+        }
+
+      if (!names.empty() &&
+          da->AddArrays(batched, meshName, assoc_ids[k], names))
+        {
+          SENSEI_ERROR("Failed to add the arrays of mesh \""
+                       << meshName << "\" in one call");
+          batched->Delete();
+          return -1;
+        }
+    }
+
+  vtkCompositeDataSet* cds = vtkCompositeDataSet::SafeDownCast(mesh);
+  vtkCompositeDataSet* bcds = vtkCompositeDataSet::SafeDownCast(batched);
+
+  int retval = 0;
+  vtkCompositeDataIterator* it = cds->NewIterator();
+  for (it->InitTraversal(); !retval && !it->IsDoneWithTraversal();
+       it->GoToNextItem())
+    {
+      vtkDataSet* bds = vtkDataSet::SafeDownCast(it->GetCurrentDataObject());
+      vtkDataSet* bbds = vtkDataSet::SafeDownCast(bcds->GetDataSet(it));
+
+      for (int j = 0; !retval && (j < mmd->NumArrays); j++)
+        {
+          const char* name = mmd->ArrayName[j].c_str();
+          bool point = mmd->ArrayCentering[j] == vtkDataObject::POINT;
+
+          vtkDataArray* array = point ? bds->GetPointData()->GetArray(name)
+                                      : bds->GetCellData()->GetArray(name);
+
+          vtkDataArray* barray = nullptr;
+          if (bbds)
+            barray = point ? bbds->GetPointData()->GetArray(name)
+                           : bbds->GetCellData()->GetArray(name);
+
+          bool same = array && barray &&
+                      (array->GetNumberOfTuples() ==
+                       barray->GetNumberOfTuples()) &&
+                      (array->GetNumberOfComponents() ==
+                       barray->GetNumberOfComponents());
+
+          int n_tuple = same ? array->GetNumberOfTuples() : 0;
+          int n_comp = same ? array->GetNumberOfComponents() : 0;
+          for (int i = 0; same && (i < n_tuple); i++)
+            {
+              for (int c = 0; same && (c < n_comp); c++)
+                same = array->GetComponent(i, c) == barray->GetComponent(i, c);
+            }
+
+          if (!same)
+            {
+              SENSEI_ERROR("Array \"" << name << "\" of mesh \"" << meshName
+                                      << "\" differs when fetched in one call");
+              retval = -1;
+            }
+        }
+    }
+  it->Delete();
+
+  batched->Delete();
+
+  return retval;
+}
+
 int readMe(TimedAdaptorWrap* daWrap, MPI_Comm& comm)
 {
   int rank, n_ranks;
@@ -250,6 +339,11 @@ int readMe(TimedAdaptorWrap* daWrap, MPI_Comm& comm)
               it->GoToNextItem();
             } // while it
           it->Delete();
+
+          // the batched request reads the same arrays
+          if (check_batched(da, mmd, mesh))
+            retval = -1;
+
           i += 1;
           mesh->Delete();
         } // while mesh
@@ -648,6 +742,7 @@ int main(int argc, char** argv)
       return 0;
     }
 
+  int ierr = 0;
   std::string method = "MPI"; // or "POSIX"
   if (argv[1][0] == 'w')
     {
@@ -693,11 +788,11 @@ int main(int argc, char** argv)
 
       TimedAdaptorWrap* result = GetReadAdaptor(file_name, method, comm);
 
-      readMe(result, comm);
+      ierr = readMe(result, comm);
 
       delete result;
     }
 
   MPI_Finalize();
-  return 0;
+  return ierr;
 }
@@ -0,0 +1,275 @@
+#include <iostream>
+#include <string>
+#include <mpi.h>
+#include <pugixml.hpp>
+#include <vtkCellData.h>
+#include <vtkCompositeDataIterator.h>
+#include <vtkDoubleArray.h>
+#include <vtkImageData.h>
+#include <vtkMultiBlockDataSet.h>
+#include <vtkPointData.h>
+#include "Error.h"
+#include "HDF5AnalysisAdaptor.h"
+#include "HDF5DataAdaptor.h"
+#include "MeshMetadata.h"
+#include "SubBlockPartitioner.h"
+#include "VTKDataAdaptor.h"
+
+// Writes an image with a block per rank through the HDF5 transport and
+// reads it back with the SubBlockPartitioner, which splits each block into
+// slabs along z. The pieces are read through HDF5 hyperslabs of the sender
+// blocks. Checks that every point and cell value of each piece is the
+// value written at its location, and that the pieces hold all of the cells.
+
+namespace
+{
+const int NX = 4;
+const int NY = 3;
+const int NZ = 8;
+
+// the value at grid location i,j,k, for cells the location of the lower
+// corner
+double value(int i, int j, int k)
+{
+  return i + 10*j + 100*k;
+}
+
+// an image of NX by NY by NZ cells per rank stacked along z, with a point
+// and a cell array
+vtkImageData *newImage(int rank)
+{
+  int ext[6] = {0, NX, 0, NY, rank*NZ, (rank + 1)*NZ};
+
+  vtkImageData *im = vtkImageData::New();
+  im->SetExtent(ext);
+
+  for (int c = 0; c < 2; ++c)
+    {
+    vtkDoubleArray *da = vtkDoubleArray::New();
+    da->SetName(c ? "cd" : "pd");
+
+    for (int k = ext[4]; k <= ext[5] - c; ++k)
+      for (int j = ext[2]; j <= ext[3] - c; ++j)
+        for (int i = ext[0]; i <= ext[1] - c; ++i)
+          da->InsertNextValue(value(i, j, k));
+
+    if (c)
+      im->GetCellData()->AddArray(da);
+    else
+      im->GetPointData()->AddArray(da);
+
+    da->Delete();
+    }
+
+  return im;
+}
+
+int writeImage(const std::string &fileName)
+{
+  int rank = 0;
+  int nRanks = 1;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &nRanks);
+
+  vtkMultiBlockDataSet *mb = vtkMultiBlockDataSet::New();
+  mb->SetNumberOfBlocks(nRanks);
+
+  vtkImageData *im = newImage(rank);
+  mb->SetBlock(rank, im);
+  im->Delete();
+
+  sensei::VTKDataAdaptor *da = sensei::VTKDataAdaptor::New();
+  da->SetCommunicator(MPI_COMM_WORLD);
+  da->SetDataObject("image", mb);
+  da->SetDataTimeStep(0);
+  da->SetDataTime(0.0);
+  mb->Delete();
+
+  sensei::HDF5AnalysisAdaptor *aw = sensei::HDF5AnalysisAdaptor::New();
+  aw->SetCommunicator(MPI_COMM_WORLD);
+  aw->SetStreamName(fileName);
+  aw->SetStreaming(false);
+  aw->SetCollective(false);
+
+  int result = 0;
+  if (!aw->Execute(da) || aw->Finalize())
+    {
+    SENSEI_ERROR("Failed to write \"" << fileName << "\"")
+    result = -1;
+    }
+
+  aw->Delete();
+
+  da->ReleaseData();
+  da->Delete();
+
+  return result;
+}
+
+// check the values of a piece against those written at its location
+int checkPiece(vtkImageData *im, long &nCells)
+{
+  int ext[6] = {0};
+  im->GetExtent(ext);
+
+  for (int c = 0; c < 2; ++c)
+    {
+    vtkDataArray *da = c ? im->GetCellData()->GetArray("cd") :
+      im->GetPointData()->GetArray("pd");
+
+    long n = 0;
+    for (int k = ext[4]; k <= ext[5] - c; ++k)
+      for (int j = ext[2]; j <= ext[3] - c; ++j)
+        for (int i = ext[0]; i <= ext[1] - c; ++i)
+          ++n;
+
+    if (!da || (da->GetNumberOfTuples() != n))
+      {
+      SENSEI_ERROR("The piece with extent [" << ext[0] << ", " << ext[1]
+        << ", " << ext[2] << ", " << ext[3] << ", " << ext[4] << ", "
+        << ext[5] << "] has " << (da ? da->GetNumberOfTuples() : 0) << " "
+        << (c ? "cell" : "point") << " values, " << n << " expected")
+      return -1;
+      }
+
+    long q = 0;
+    for (int k = ext[4]; k <= ext[5] - c; ++k)
+      for (int j = ext[2]; j <= ext[3] - c; ++j)
+        for (int i = ext[0]; i <= ext[1] - c; ++i, ++q)
+          {
+          if (da->GetTuple1(q) != value(i, j, k))
+            {
+            SENSEI_ERROR("The " << (c ? "cell" : "point") << " value at "
+              << i << ", " << j << ", " << k << " is " << da->GetTuple1(q)
+              << " but " << value(i, j, k) << " was written")
+            return -1;
+            }
+          }
+
+    if (c)
+      nCells += n;
+    }
+
+  return 0;
+}
+
+int readPieces(const std::string &fileName)
+{
+  int nRanks = 1;
+  MPI_Comm_size(MPI_COMM_WORLD, &nRanks);
+
+  // two slabs of each block per rank
+  pugi::xml_document doc;
+  doc.load_string("<partitioner type=\"split\" blocks_per_rank=\"2\"/>");
+  pugi::xml_node node = doc.child("partitioner");
+
+  sensei::SubBlockPartitionerPtr part = sensei::SubBlockPartitioner::New();
+  if (part->Initialize(node))
+    {
+    SENSEI_ERROR("Failed to initialize the partitioner")
+    return -1;
+    }
+
+  sensei::HDF5DataAdaptor *da = sensei::HDF5DataAdaptor::New();
+  da->SetCommunicator(MPI_COMM_WORLD);
+  da->SetStreaming(false);
+  da->SetCollective(false);
+  da->SetStreamName(fileName);
+  da->SetPartitioner(part);
+
+  if (da->OpenStream())
+    {
+    SENSEI_ERROR("Failed to open \"" << fileName << "\"")
+    da->Delete();
+    return -1;
+    }
+
+  int result = 0;
+
+  // the receiver metadata has the pieces
+  sensei::MeshMetadataPtr md;
+  if (da->GetMeshMetadata(0, md) || (md->MeshName != "image") ||
+    (md->NumBlocks < 2*nRanks) ||
+    (int(md->BlockSource.size()) != md->NumBlocks))
+    {
+    SENSEI_ERROR("The blocks were not split into at least " << 2*nRanks
+      << " pieces")
+    result = -1;
+    }
+
+  vtkDataObject *mesh = nullptr;
+  if (!result && (da->GetMesh("image", false, mesh) ||
+    da->AddArray(mesh, "image", vtkDataObject::POINT, "pd") ||
+    da->AddArray(mesh, "image", vtkDataObject::CELL, "cd")))
+    {
+    SENSEI_ERROR("Failed to read the pieces")
+    result = -1;
+    }
+
+  long nCells = 0;
+  if (mesh)
+    {
+    vtkCompositeDataIterator *it =
+      static_cast<vtkMultiBlockDataSet*>(mesh)->NewIterator();
+    for (it->InitTraversal(); !it->IsDoneWithTraversal(); it->GoToNextItem())
+      {
+      vtkImageData *im = dynamic_cast<vtkImageData*>(
+        it->GetCurrentDataObject());
+      if (!im || checkPiece(im, nCells))
+        {
+        result = -1;
+        break;
+        }
+      }
+    it->Delete();
+    mesh->Delete();
+    }
+
+  da->ReleaseData();
+  da->CloseStream();
+  da->Delete();
+
+  // together the pieces hold every cell once
+  MPI_Allreduce(MPI_IN_PLACE, &nCells, 1, MPI_LONG, MPI_SUM, MPI_COMM_WORLD);
+  if (!result && (nCells != long(NX)*NY*NZ*nRanks))
+    {
+    SENSEI_ERROR("The pieces hold " << nCells << " cells, "
+      << long(NX)*NY*NZ*nRanks << " were written")
+    result = -1;
+    }
+
+  return result;
+}
+}
+
+int main(int argc, char **argv)
+{
+  MPI_Init(&argc, &argv);
+
+  int rank = 0;
+  int nRanks = 1;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &nRanks);
+
+  std::string fileName = std::string(argc > 1 ? argv[1] : "h5subblock") +
+    ".n" + std::to_string(nRanks);
+
+  // the file is read back only if every rank wrote its block
+  int result = writeImage(fileName);
+
+  int globalResult = 0;
+  MPI_Allreduce(&result, &globalResult, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+
+  if (!globalResult)
+    {
+    result = readPieces(fileName);
+    MPI_Allreduce(&result, &globalResult, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+    }
+
+  if ((rank == 0) && !globalResult)
+    std::cerr << "HDF5 sub-block checks passed" << std::endl;
+
+  MPI_Finalize();
+
+  return globalResult;
+}
@@ -1,10 +1,14 @@
 #include <random>
 #include <iostream>
+#include <limits>
+#include <string>
 #include <mpi.h>
+#include <pugixml.hpp>
 #include <vtkDoubleArray.h>
 #include <vtkImageData.h>
 #include <vtkPointData.h>
 #include "Error.h"
+#include "ConfigurableAnalysis.h"
 #include "Histogram.h"
 #include "VTKDataAdaptor.h"
 
@@ -103,10 +107,239 @@ int validateHistogram(double min, double max, std::vector<unsigned int> &bins)
   return 0;
 }
 
+// NaN is not counted. bins the values 0 to 9 with every 7th value NaN,
+// each value is in a bin of its own
+int testNaN()
+{
+  int nRanks = 1;
+  MPI_Comm_size(MPI_COMM_WORLD, &nRanks);
+
+  unsigned int nVals = 1000;
+  std::vector<unsigned int> expected(10, 0);
+
+  vtkDoubleArray *da = vtkDoubleArray::New();
+  da->SetNumberOfTuples(nVals);
+  da->SetName("nan");
+  for (unsigned int i = 0; i < nVals; ++i)
+    {
+    if (i % 7)
+      {
+      da->SetValue(i, i % 10);
+      expected[i % 10] += nRanks;
+      }
+    else
+      {
+      da->SetValue(i, std::numeric_limits<double>::quiet_NaN());
+      }
+    }
+
+  vtkImageData *im = vtkImageData::New();
+  im->SetDimensions(10, 10, 10);
+  im->GetPointData()->AddArray(da);
+  da->Delete();
+
+  sensei::VTKDataAdaptor *dataAdaptor = sensei::VTKDataAdaptor::New();
+  dataAdaptor->SetDataObject("mesh", im);
+  im->Delete();
+
+  sensei::Histogram *analysisAdaptor = sensei::Histogram::New();
+  analysisAdaptor->Initialize(10, "mesh", vtkDataObject::POINT, "nan", "");
+  analysisAdaptor->Execute(dataAdaptor);
+
+  double min = 0.0;
+  double max = 0.0;
+  std::vector<unsigned int> bins;
+  analysisAdaptor->GetHistogram(min, max, bins);
+
+  analysisAdaptor->Finalize();
+  analysisAdaptor->Delete();
+  dataAdaptor->Delete();
+
+  int rank = 0;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  if (rank != 0)
+    return 0;
+
+  if ((min != 0.0) || (max != 9.0) || (bins != expected))
+    {
+    SENSEI_ERROR("Wrong histogram of data with NaN, range "
+      << min << ", " << max)
+    return -1;
+    }
+
+  return 0;
+}
+
+// several arrays and components are binned in one pass. the values are
+// integers that each fall in a bin of their own, so that the counts are
+// known exactly. a is a scalar, v is the vector (3k, 4k, 0) with component
+// 1 in [0, 36] and magnitude in [0, 45]
+vtkImageData *newMultiArrayImage(std::vector<unsigned int> &aBins,
+  std::vector<unsigned int> &vBins)
+{
+  int nRanks = 1;
+  MPI_Comm_size(MPI_COMM_WORLD, &nRanks);
+
+  unsigned int nVals = 1000;
+  aBins.assign(10, 0);
+  vBins.assign(10, 0);
+
+  vtkDoubleArray *a = vtkDoubleArray::New();
+  a->SetNumberOfTuples(nVals);
+  a->SetName("a");
+
+  vtkDoubleArray *b = vtkDoubleArray::New();
+  b->SetNumberOfTuples(nVals);
+  b->SetName("b");
+
+  vtkDoubleArray *v = vtkDoubleArray::New();
+  v->SetNumberOfComponents(3);
+  v->SetNumberOfTuples(nVals);
+  v->SetName("v");
+
+  for (unsigned int i = 0; i < nVals; ++i)
+    {
+    unsigned int j = (3*i) % 10;
+    a->SetValue(i, j);
+    b->SetValue(i, i % 4);
+    aBins[j] += nRanks;
+
+    unsigned int k = (i/7) % 10;
+    double vk[3] = {3.0*k, 4.0*k, 0.0};
+    v->SetTuple(i, vk);
+    vBins[k] += nRanks;
+    }
+
+  vtkImageData *im = vtkImageData::New();
+  im->SetDimensions(10, 10, 10);
+  im->GetPointData()->AddArray(a);
+  im->GetPointData()->AddArray(b);
+  im->GetPointData()->AddArray(v);
+  a->Delete();
+  b->Delete();
+  v->Delete();
+
+  return im;
+}
+
+int testMultiArray()
+{
+  std::vector<unsigned int> aBins;
+  std::vector<unsigned int> vBins;
+  vtkImageData *im = newMultiArrayImage(aBins, vBins);
+
+  sensei::VTKDataAdaptor *dataAdaptor = sensei::VTKDataAdaptor::New();
+  dataAdaptor->SetDataObject("mesh", im);
+  im->Delete();
+
+  sensei::Histogram *analysisAdaptor = sensei::Histogram::New();
+  analysisAdaptor->Initialize(10, "mesh", vtkDataObject::POINT,
+    std::vector<std::string>({"a", "v:1", "v:mag", "v"}), "");
+  analysisAdaptor->Execute(dataAdaptor);
+
+  int rank = 0;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+  const char *names[] = {"a", "v:1", "v:mag", "v"};
+  double maxs[] = {9.0, 36.0, 45.0, 45.0};
+
+  int testResult = 0;
+  if (analysisAdaptor->GetNumberOfHistograms() != 4)
+    {
+    SENSEI_ERROR("Wrong number of histograms "
+      << analysisAdaptor->GetNumberOfHistograms())
+    testResult = -1;
+    }
+
+  for (unsigned int i = 0; (rank == 0) && !testResult && (i < 4); ++i)
+    {
+    double min = 0.0;
+    double max = 0.0;
+    std::vector<unsigned int> bins;
+    analysisAdaptor->GetHistogram(i, min, max, bins);
+
+    if ((min != 0.0) || (max != maxs[i]) || (bins != (i ? vBins : aBins)))
+      {
+      SENSEI_ERROR("Wrong histogram of \"" << names[i] << "\", range "
+        << min << ", " << max)
+      testResult = -1;
+      }
+    }
+
+  analysisAdaptor->Finalize();
+  analysisAdaptor->Delete();
+  dataAdaptor->Delete();
+
+  return testResult;
+}
+
+// the data asked for in asynchronous mode is taken from the lists of
+// arrays, with the component selections removed. asking for an array
+// that does not exist aborts
+int testMultiArrayAsync()
+{
+  int threadLevel = MPI_THREAD_SINGLE;
+  MPI_Query_thread(&threadLevel);
+  if (threadLevel < MPI_THREAD_MULTIPLE)
+    return 0;
+
+  pugi::xml_document doc;
+  doc.load_string(
+    "<sensei async=\"1\">"
+    "  <analysis type=\"histogram\" mesh=\"mesh\" array=\"a, v:1 v:mag\""
+    "    association=\"point\" bins=\"10\" enabled=\"1\"/>"
+    "  <analysis type=\"joint_histogram\" mesh=\"mesh\" array=\"a,b\""
+    "    association=\"point\" bins=\"10,4\" enabled=\"1\"/>"
+    "  <analysis type=\"temporal_statistics\" mesh=\"mesh\" array=\"a b\""
+    "    association=\"point\" enabled=\"1\"/>"
+    "</sensei>");
+
+  sensei::ConfigurableAnalysis *analysis = sensei::ConfigurableAnalysis::New();
+  if (analysis->Initialize(doc.child("sensei")))
+    {
+    SENSEI_ERROR("Failed to initialize the analyses")
+    analysis->Delete();
+    return -1;
+    }
+
+  std::vector<unsigned int> aBins;
+  std::vector<unsigned int> vBins;
+  vtkImageData *im = newMultiArrayImage(aBins, vBins);
+
+  sensei::VTKDataAdaptor *dataAdaptor = sensei::VTKDataAdaptor::New();
+  dataAdaptor->SetDataObject("mesh", im);
+  im->Delete();
+
+  int testResult = 0;
+  for (long step = 0; step < 2; ++step)
+    {
+    dataAdaptor->SetDataTimeStep(step);
+    if (!analysis->Execute(dataAdaptor))
+      testResult = -1;
+    }
+
+  if (analysis->Finalize())
+    testResult = -1;
+
+  analysis->Delete();
+  dataAdaptor->Delete();
+
+  return testResult;
+}
 
 int main(int argc, char **argv)
 {
-  MPI_Init(&argc, &argv);
+  int threadLevel = MPI_THREAD_SINGLE;
+  MPI_Init_thread(&argc, &argv, MPI_THREAD_MULTIPLE, &threadLevel);
+
+  std::string mode = argc > 1 ? argv[1] : "";
+  if ((mode == "nan") || (mode == "multi"))
+    {
+    int testResult = mode == "nan" ? testNaN() :
+      (testMultiArray() || testMultiArrayAsync() ? -1 : 0);
+    MPI_Finalize();
+    return testResult;
+    }
 
   std::vector<double> vals;
   getSequence(vals);
@@ -132,6 +365,14 @@ int main(int argc, char **argv)
   analysisAdaptor->Initialize(gNBins, "mesh", vtkDataObject::POINT,
      "normal", "");
 
+  // in pipelined mode the bins are reduced in the background and the
+  // range is given so that the result is exact
+  if (mode == "pipelined")
+    {
+    analysisAdaptor->SetPipelined(1);
+    analysisAdaptor->SetRange(gMin, gMax);
+    }
+
   analysisAdaptor->Execute(dataAdaptor);
   dataAdaptor->Delete();
 
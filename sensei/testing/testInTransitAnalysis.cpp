@@ -0,0 +1,173 @@
+#include <iostream>
+#include <memory>
+#include <string>
+#include <mpi.h>
+#include <pugixml.hpp>
+#include <vtkDoubleArray.h>
+#include <vtkImageData.h>
+#include <vtkPointData.h>
+#include "Error.h"
+#include "ConfigurableAnalysis.h"
+#include "InTransitDataAdaptor.h"
+#include "PlanarSlicePartitioner.h"
+#include "VTKDataAdaptor.h"
+
+// Runs SliceExtract through ConfigurableAnalysis, with the data cache on,
+// on data served by an in transit data adaptor. Checks that the analysis
+// receives the in transit adaptor itself, rather than the cache wrapping
+// it, by checking that it set its slice partitioner on the adaptor, and
+// that the mesh was fetched from the adaptor.
+
+namespace
+{
+const int N = 4;
+
+// an image of N^3 cells per rank stacked along z
+vtkImageData *newImage()
+{
+  int rank = 0;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+  vtkImageData *im = vtkImageData::New();
+  im->SetExtent(0, N, 0, N, rank*N, (rank + 1)*N);
+
+  long nPts = im->GetNumberOfPoints();
+  vtkDoubleArray *da = vtkDoubleArray::New();
+  da->SetName("data");
+  da->SetNumberOfTuples(nPts);
+  for (long i = 0; i < nPts; ++i)
+    da->SetValue(i, i + rank);
+  im->GetPointData()->AddArray(da);
+  da->Delete();
+
+  return im;
+}
+
+// serves the data of a VTKDataAdaptor as if it had been moved in transit
+class TestInTransitDataAdaptor : public sensei::InTransitDataAdaptor
+{
+public:
+  static TestInTransitDataAdaptor *New();
+  senseiTypeMacro(TestInTransitDataAdaptor, sensei::InTransitDataAdaptor);
+
+  int GetSenderMeshMetadata(unsigned int id,
+    sensei::MeshMetadataPtr &metadata) override
+  { return this->Data->GetMeshMetadata(id, metadata); }
+
+  int GetNumberOfMeshes(unsigned int &numMeshes) override
+  { return this->Data->GetNumberOfMeshes(numMeshes); }
+
+  int GetMeshMetadata(unsigned int id,
+    sensei::MeshMetadataPtr &metadata) override
+  { return this->Data->GetMeshMetadata(id, metadata); }
+
+  int GetMesh(const std::string &meshName, bool structureOnly,
+    vtkDataObject *&mesh) override
+  {
+    this->NumGetMesh += 1;
+    return this->Data->GetMesh(meshName, structureOnly, mesh);
+  }
+
+  int AddArray(vtkDataObject* mesh, const std::string &meshName,
+    int association, const std::string &arrayName) override
+  { return this->Data->AddArray(mesh, meshName, association, arrayName); }
+
+  // the data is owned by the test
+  int ReleaseData() override { return 0; }
+
+  int OpenStream() override { return 0; }
+  int CloseStream() override { return 0; }
+  int AdvanceStream() override { return 0; }
+  int StreamGood() override { return 1; }
+  int Finalize() override { return 0; }
+
+  sensei::VTKDataAdaptor *Data;
+  int NumGetMesh;
+
+protected:
+  TestInTransitDataAdaptor() : Data(nullptr), NumGetMesh(0) {}
+  ~TestInTransitDataAdaptor() {}
+};
+
+senseiNewMacro(TestInTransitDataAdaptor);
+}
+
+int main(int argc, char **argv)
+{
+  MPI_Init(&argc, &argv);
+
+  int rank = 0;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+  std::string outputDir = argc > 1 ? argv[1] : "./";
+
+  vtkImageData *im = newImage();
+
+  sensei::VTKDataAdaptor *data = sensei::VTKDataAdaptor::New();
+  data->SetCommunicator(MPI_COMM_WORLD);
+  data->SetDataObject("mesh", im);
+  data->SetDataTimeStep(0);
+  data->SetDataTime(0.0);
+  im->Delete();
+
+  TestInTransitDataAdaptor *itData = TestInTransitDataAdaptor::New();
+  itData->SetCommunicator(MPI_COMM_WORLD);
+  itData->Data = data;
+  itData->SetDataTimeStep(0);
+  itData->SetDataTime(0.0);
+
+  // a slice through the middle of the first block
+  std::string xml = "<sensei cache=\"1\">"
+    "<analysis type=\"SliceExtract\" operation=\"planar_slice\""
+    " enable_partitioner=\"1\" enabled=\"1\">"
+    "<mesh name=\"mesh\"><point_arrays>data</point_arrays></mesh>"
+    "<point>2 2 2</point><normal>0 0 1</normal>"
+    "<writer mode=\"paraview\" output_dir=\"" + outputDir + "\"/>"
+    "</analysis></sensei>";
+
+  pugi::xml_document doc;
+  doc.load_string(xml.c_str());
+
+  sensei::ConfigurableAnalysis *analysis = sensei::ConfigurableAnalysis::New();
+  analysis->SetCommunicator(MPI_COMM_WORLD);
+
+  int result = 0;
+  if (analysis->Initialize(doc.child("sensei")) || !analysis->Execute(itData))
+    {
+    SENSEI_ERROR("Failed to slice the in transit data")
+    result = -1;
+    }
+
+  // the analysis found the in transit adaptor and set its partitioner
+  if (!std::dynamic_pointer_cast<sensei::PlanarSlicePartitioner>(
+    itData->GetPartitioner()))
+    {
+    SENSEI_ERROR("The slice partitioner was not set on the in transit"
+      " data adaptor")
+    result = -1;
+    }
+
+  if (itData->NumGetMesh < 1)
+    {
+    SENSEI_ERROR("The mesh was not fetched from the in transit data adaptor")
+    result = -1;
+    }
+
+  analysis->Finalize();
+  analysis->Delete();
+
+  itData->Delete();
+
+  data->ReleaseData();
+  data->Delete();
+
+  int globalResult = 0;
+  MPI_Allreduce(&result, &globalResult, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+
+  if ((rank == 0) && !globalResult)
+    std::cerr << "In transit analysis checks passed" << std::endl;
+
+  MPI_Finalize();
+
+  return globalResult;
+}
@@ -0,0 +1,214 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <mpi.h>
+#include "Error.h"
+#include "MeshMetadata.h"
+#include "BlockPartitioner.h"
+#include "IncrementalPartitioner.h"
+#include "partitionerTestUtils.h"
+
+// Partitions a mesh over a series of time steps with the
+// IncrementalPartitioner. Checks that small changes in the block sizes
+// leave the partition alone, that a large change migrates a small part of
+// the data to restore the balance, that new blocks are placed moving
+// little else, that the partition of a static mesh is reused, and that the
+// first partition is made by the nested partitioner.
+
+namespace
+{
+int partition(MPI_Comm comm, const sensei::IncrementalPartitionerPtr &part,
+  const sensei::MeshMetadataPtr &in, sensei::MeshMetadataPtr &out,
+  double minMoved, double maxMoved, double maxImbalance, const char *step)
+{
+  int nRanks = 1;
+  MPI_Comm_size(comm, &nRanks);
+
+  if (part->GetPartition(comm, in, out))
+    {
+    SENSEI_ERROR("Failed to partition " << step)
+    return -1;
+    }
+
+  for (int i = 0; i < out->NumBlocks; ++i)
+    {
+    int owner = out->BlockOwner[i];
+    if ((owner < 0) || (owner >= nRanks))
+      {
+      SENSEI_ERROR("Block " << i << " has owner " << owner << " in " << step)
+      return -1;
+      }
+    }
+
+  double moved = part->GetMovedFraction();
+  if ((moved < minMoved) || (moved > maxMoved))
+    {
+    SENSEI_ERROR("The moved fraction " << moved << " of " << step
+      << " is not in [" << minMoved << ", " << maxMoved << "]")
+    return -1;
+    }
+
+  double imbalance = part->GetImbalance();
+  if ((maxImbalance > 0.0) && (imbalance > maxImbalance))
+    {
+    SENSEI_ERROR("The imbalance " << imbalance << " of " << step
+      << " is larger than " << maxImbalance)
+    return -1;
+    }
+
+  return 0;
+}
+
+int testSteps(MPI_Comm comm)
+{
+  int nRanks = 1;
+  MPI_Comm_size(comm, &nRanks);
+
+  sensei::IncrementalPartitionerPtr part =
+    partitionerTestUtils::newPartitioner<sensei::IncrementalPartitioner>(
+    "<partitioner type=\"incremental\" threshold=\"1.1\" cost=\"cells\"/>");
+
+  if (!part)
+    return -1;
+
+  // the first step places all of the data
+  int nBlocks = 16*nRanks;
+  std::vector<long> cells(nBlocks, 1000);
+
+  sensei::MeshMetadataPtr out;
+  if (partition(comm, part, partitionerTestUtils::newMetadata(cells), out,
+    1.0, 1.0, 1.0, "the first step"))
+    return -1;
+
+  std::vector<int> owner = out->BlockOwner;
+
+  // a few percent change moves nothing
+  for (int i = 0; i < nBlocks; ++i)
+    cells[i] += 40*(i % 3 - 1);
+
+  if (partition(comm, part, partitionerTestUtils::newMetadata(cells), out,
+    0.0, 0.0, 0.0, "the second step"))
+    return -1;
+
+  if (out->BlockOwner != owner)
+    {
+    SENSEI_ERROR("Blocks moved in the second step")
+    return -1;
+    }
+
+  // the blocks of rank 0 grow by 60%. with blocks of at most 10% of the
+  // average load the imbalance is restored to within 1.1 + 0.1 by moving
+  // a small part of the data
+  for (int i = 0; i < nBlocks; ++i)
+    {
+    if (owner[i] == 0)
+      cells[i] = 1.6*cells[i];
+    }
+
+  if (partition(comm, part, partitionerTestUtils::newMetadata(cells), out,
+    0.0, 0.25, 1.2, "the third step"))
+    return -1;
+
+  // new blocks are placed, about 5% of the data
+  for (int i = 0; i < nRanks; ++i)
+    cells.push_back(1000);
+
+  if (partition(comm, part, partitionerTestUtils::newMetadata(cells), out,
+    0.0, 0.1, 1.2, "the fourth step"))
+    return -1;
+
+  return 0;
+}
+
+int testStatic(MPI_Comm comm)
+{
+  int nRanks = 1;
+  MPI_Comm_size(comm, &nRanks);
+
+  sensei::IncrementalPartitionerPtr part =
+    partitionerTestUtils::newPartitioner<sensei::IncrementalPartitioner>(
+    "<partitioner type=\"incremental\" threshold=\"1.1\" cost=\"cells\"/>");
+
+  if (!part)
+    return -1;
+
+  int nBlocks = 16*nRanks;
+  std::vector<long> cells(nBlocks, 1000);
+
+  sensei::MeshMetadataPtr in =
+    partitionerTestUtils::newMetadata(cells, 1, "static");
+  in->StaticMesh = 1;
+
+  sensei::MeshMetadataPtr out;
+  if (partition(comm, part, in, out, 1.0, 1.0, 1.0, "the static mesh"))
+    return -1;
+
+  std::vector<int> owner = out->BlockOwner;
+
+  // even a large change reuses the partition
+  for (int i = 0; i < nBlocks; ++i)
+    {
+    if (owner[i] == 0)
+      in->BlockNumCells[i] *= 3;
+    }
+
+  if (partition(comm, part, in, out, 0.0, 0.0, 0.0, "the static mesh") ||
+    (out->BlockOwner != owner))
+    {
+    SENSEI_ERROR("The partition of the static mesh was not reused")
+    return -1;
+    }
+
+  return 0;
+}
+
+int testNested(MPI_Comm comm)
+{
+  sensei::IncrementalPartitionerPtr part =
+    partitionerTestUtils::newPartitioner<sensei::IncrementalPartitioner>(
+    "<partitioner type=\"incremental\"><partitioner type=\"block\"/>"
+    "</partitioner>");
+
+  if (!part)
+    return -1;
+
+  int nRanks = 1;
+  MPI_Comm_size(comm, &nRanks);
+
+  std::vector<long> cells(16*nRanks + 3, 1000);
+  sensei::MeshMetadataPtr in = partitionerTestUtils::newMetadata(cells);
+
+  sensei::MeshMetadataPtr out;
+  if (partition(comm, part, in, out, 1.0, 1.0, 0.0, "the nested partitioner"))
+    return -1;
+
+  sensei::MeshMetadataPtr block;
+  if (sensei::BlockPartitioner::New()->GetPartition(comm, in, block) ||
+    (block->BlockOwner != out->BlockOwner))
+    {
+    SENSEI_ERROR("The first partition was not made by the block partitioner")
+    return -1;
+    }
+
+  return 0;
+}
+}
+
+int main(int argc, char **argv)
+{
+  MPI_Init(&argc, &argv);
+
+  int result = 0;
+  if (testSteps(MPI_COMM_WORLD) || testStatic(MPI_COMM_WORLD) ||
+    testNested(MPI_COMM_WORLD))
+    result = -1;
+
+  int rank = 0;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  if ((rank == 0) && !result)
+    std::cerr << "Incremental partitioner checks passed" << std::endl;
+
+  MPI_Finalize();
+
+  return result;
+}
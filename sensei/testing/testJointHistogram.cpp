@@ -0,0 +1,133 @@
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+#include <mpi.h>
+#include <vtkDoubleArray.h>
+#include <vtkImageData.h>
+#include <vtkIntArray.h>
+#include <vtkPointData.h>
+#include "Error.h"
+#include "JointHistogram.h"
+#include "VTKDataAdaptor.h"
+
+// Checks the joint histogram of two integer valued arrays of different
+// types against a direct count. The ranges and bins are chosen so that
+// each pair of values has its own bin. Both the dense and the sparse bin
+// storage are checked.
+
+namespace
+{
+const long gNx = 1000;
+const int gXBins = 37;
+const int gYBins = 23;
+
+double xVal(long i) { return i % gXBins; }
+int yVal(long i) { return (i*7) % gYBins; }
+
+int validate(sensei::JointHistogram *hist, int nRanks)
+{
+  std::vector<double> ranges;
+  std::vector<int> bins;
+  std::vector<std::pair<unsigned long, unsigned long>> counts;
+  if (hist->GetHistogram(ranges, bins, counts))
+    {
+    SENSEI_ERROR("No histogram")
+    return -1;
+    }
+
+  std::map<unsigned long, unsigned long> expected;
+  for (long i = 0; i < nRanks*gNx; ++i)
+    expected[long(xVal(i))*gYBins + yVal(i)] += 1;
+
+  if (counts.size() != expected.size())
+    {
+    SENSEI_ERROR("Wrong number of non-empty bins " << counts.size()
+      << " expected " << expected.size())
+    return -1;
+    }
+
+  auto it = expected.begin();
+  for (size_t i = 0; i < counts.size(); ++i, ++it)
+    {
+    if ((counts[i].first != it->first) || (counts[i].second != it->second))
+      {
+      SENSEI_ERROR("Bin " << counts[i].first << " has count "
+        << counts[i].second << " expected bin " << it->first << " count "
+        << it->second)
+      return -1;
+      }
+    }
+
+  return 0;
+}
+}
+
+int main(int argc, char **argv)
+{
+  MPI_Init(&argc, &argv);
+
+  int rank = 0;
+  int nRanks = 1;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &nRanks);
+
+  vtkDoubleArray *x = vtkDoubleArray::New();
+  x->SetName("x");
+  x->SetNumberOfTuples(gNx);
+
+  vtkIntArray *y = vtkIntArray::New();
+  y->SetName("y");
+  y->SetNumberOfTuples(gNx);
+
+  for (long i = 0; i < gNx; ++i)
+    {
+    *x->GetPointer(i) = xVal(rank*gNx + i);
+    *y->GetPointer(i) = yVal(rank*gNx + i);
+    }
+
+  vtkImageData *im = vtkImageData::New();
+  im->SetDimensions(gNx, 1, 1);
+  im->GetPointData()->AddArray(x);
+  im->GetPointData()->AddArray(y);
+  x->Delete();
+  y->Delete();
+
+  sensei::VTKDataAdaptor *dataAdaptor = sensei::VTKDataAdaptor::New();
+  dataAdaptor->SetDataObject("mesh", im);
+  im->Delete();
+
+  int result = 0;
+  for (int sparse = 0; sparse < 2; ++sparse)
+    {
+    sensei::JointHistogram *hist = sensei::JointHistogram::New();
+
+    hist->Initialize("mesh", vtkDataObject::POINT, {"x", "y"},
+      {gXBins, gYBins}, "");
+
+    hist->SetRanges({0.0, double(gXBins), 0.0, double(gYBins)});
+
+    if (sparse)
+      hist->SetDenseLimit(0);
+
+    if (!hist->Execute(dataAdaptor) ||
+      ((rank == 0) && validate(hist, nRanks)))
+      {
+      SENSEI_ERROR("The " << (sparse ? "sparse" : "dense")
+        << " joint histogram is wrong")
+      result = -1;
+      }
+
+    hist->Finalize();
+    hist->Delete();
+    }
+
+  dataAdaptor->ReleaseData();
+  dataAdaptor->Delete();
+
+  MPI_Bcast(&result, 1, MPI_INT, 0, MPI_COMM_WORLD);
+
+  MPI_Finalize();
+
+  return result;
+}
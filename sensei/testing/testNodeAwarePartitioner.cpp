@@ -0,0 +1,182 @@
+#include <iostream>
+#include <vector>
+#include <mpi.h>
+#include "Error.h"
+#include "MeshMetadata.h"
+#include "MPIUtils.h"
+#include "NodeAwarePartitioner.h"
+#include "partitionerTestUtils.h"
+
+// Checks that the node ids cached on a communicator match those computed
+// on a fresh one. Labels blocks with the compute node of their owner and
+// checks that the NodeAwarePartitioner keeps them on the node when the receivers are the
+// senders. Then places blocks from a simulated set of nodes onto simulated
+// receivers and checks that all of the data stays on the node when the
+// receivers can absorb it, that the load cap sends the excess elsewhere
+// when one node produces all of the data, and that blocks from a node
+// without receivers are placed by load alone.
+
+namespace
+{
+// the partitioner used in every test
+sensei::NodeAwarePartitionerPtr newPartitioner()
+{
+  return partitionerTestUtils::newPartitioner<sensei::NodeAwarePartitioner>(
+    "<partitioner type=\"node\" cost=\"cells\" slack=\"1.1\"/>");
+}
+
+int check(const sensei::NodeAwarePartitionerPtr &part,
+  const sensei::MeshMetadataPtr &out, int nRanks, double minOnNode,
+  double maxOnNode, double maxImbalance, const char *test)
+{
+  for (int i = 0; i < out->NumBlocks; ++i)
+    {
+    int owner = out->BlockOwner[i];
+    if ((owner < 0) || (owner >= nRanks))
+      {
+      SENSEI_ERROR("Block " << i << " has owner " << owner << " in " << test)
+      return -1;
+      }
+    }
+
+  double onNode = part->GetOnNodeFraction();
+  if ((onNode < minOnNode) || (onNode > maxOnNode))
+    {
+    SENSEI_ERROR("The on node fraction " << onNode << " of " << test
+      << " is not in [" << minOnNode << ", " << maxOnNode << "]")
+    return -1;
+    }
+
+  double imbalance = part->GetImbalance();
+  if (imbalance > maxImbalance)
+    {
+    SENSEI_ERROR("The imbalance " << imbalance << " of " << test
+      << " is larger than " << maxImbalance)
+    return -1;
+    }
+
+  return 0;
+}
+
+// the ids are computed once per communicator, later calls use the cached
+// ids. a duplicate does not inherit them
+int testNodeIdCache(MPI_Comm comm)
+{
+  std::vector<long> first;
+  std::vector<long> cached;
+  sensei::MPIUtils::GetNodeIds(comm, first);
+  sensei::MPIUtils::GetNodeIds(comm, cached);
+
+  MPI_Comm dupComm = MPI_COMM_NULL;
+  MPI_Comm_dup(comm, &dupComm);
+  std::vector<long> fresh;
+  sensei::MPIUtils::GetNodeIds(dupComm, fresh);
+  MPI_Comm_free(&dupComm);
+
+  if ((cached != first) || (fresh != first))
+    {
+    SENSEI_ERROR("The cached node ids differ from the computed ones")
+    return -1;
+    }
+
+  return 0;
+}
+
+// the senders are the receivers, every block can stay on its node
+int testSameRanks(MPI_Comm comm)
+{
+  int nRanks = 1;
+  MPI_Comm_size(comm, &nRanks);
+
+  sensei::MeshMetadataPtr in = partitionerTestUtils::newMetadata(
+    std::vector<long>(8*nRanks, 1000), nRanks);
+  if (in->LabelBlockNodes(comm))
+    {
+    SENSEI_ERROR("Failed to label the blocks with their node")
+    return -1;
+    }
+
+  std::vector<long> rankNode;
+  sensei::MPIUtils::GetNodeIds(comm, rankNode);
+
+  for (int i = 0; i < in->NumBlocks; ++i)
+    {
+    if (in->BlockNode[i] != rankNode[in->BlockOwner[i]])
+      {
+      SENSEI_ERROR("Block " << i << " is labeled with node "
+        << in->BlockNode[i] << " but its owner runs on node "
+        << rankNode[in->BlockOwner[i]])
+      return -1;
+      }
+    }
+
+  sensei::NodeAwarePartitionerPtr part = newPartitioner();
+  sensei::MeshMetadataPtr out;
+  if (!part || part->GetPartition(comm, in, out))
+    {
+    SENSEI_ERROR("Failed to partition the blocks")
+    return -1;
+    }
+
+  return check(part, out, nRanks, 1.0, 1.0, 1.0, "the same ranks test");
+}
+
+// 4 simulated nodes with 2 receivers each
+int testSimulated()
+{
+  std::vector<long> rankNode = {7, 7, 11, 11, 13, 13, 17, 17};
+  int nRanks = rankNode.size();
+
+  sensei::NodeAwarePartitionerPtr part = newPartitioner();
+  if (!part)
+    return -1;
+
+  // the blocks come from every node evenly
+  sensei::MeshMetadataPtr in = partitionerTestUtils::newMetadata(
+    std::vector<long>(64, 1000));
+  for (int i = 0; i < in->NumBlocks; ++i)
+    in->BlockNode.push_back(rankNode[2*(i % 4)]);
+
+  sensei::MeshMetadataPtr out;
+  if (part->GetPartition(rankNode, in, out) ||
+    check(part, out, nRanks, 1.0, 1.0, 1.0, "the even test"))
+    return -1;
+
+  // the blocks all come from one node. its receivers take 1.1 times the
+  // average and the rest go elsewhere
+  in->BlockNode.assign(in->NumBlocks, 11);
+  if (part->GetPartition(rankNode, in, out) ||
+    check(part, out, nRanks, 0.25, 0.28, 1.1, "the one node test"))
+    return -1;
+
+  // the blocks come from a node without receivers
+  in->BlockNode.assign(in->NumBlocks, 19);
+  if (part->GetPartition(rankNode, in, out) ||
+    check(part, out, nRanks, 0.0, 0.0, 1.0, "the no receivers test"))
+    return -1;
+
+  return 0;
+}
+}
+
+int main(int argc, char **argv)
+{
+  MPI_Init(&argc, &argv);
+
+  int result = 0;
+  // both are collective, every rank runs both
+  if (testNodeIdCache(MPI_COMM_WORLD))
+    result = -1;
+
+  if (testSameRanks(MPI_COMM_WORLD) || testSimulated())
+    result = -1;
+
+  int rank = 0;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  if ((rank == 0) && !result)
+    std::cerr << "Node aware partitioner checks passed" << std::endl;
+
+  MPI_Finalize();
+
+  return result;
+}
@@ -0,0 +1,323 @@
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include <mpi.h>
+#include <vtkImageData.h>
+#include <vtkMultiBlockDataSet.h>
+#include "Error.h"
+#include "VTKUtils.h"
+
+// Checks VTKUtils::ParallelFor and ParallelApply on 4 threads:
+// - with uneven work, the first item blocks until all of the other items
+//   have been processed, which only happens if the rest of the blocked
+//   thread's range is stolen. every item is processed exactly once and
+//   the per-thread results reduce to the serial result.
+// - a worker that fails stops the loop with an error and the reduction
+//   is not run. a worker that returns > 0 stops the loop without error.
+// - with 1 thread, the items are processed in order on the calling thread.
+// - ParallelApply visits each non-empty leaf of a multiblock once with
+//   its flat index, and a failing leaf is reported.
+// The failure cases report errors by design, the outcome is printed for
+// ctest to match.
+
+namespace
+{
+const unsigned int N_THREADS = 4;
+const unsigned int N_ITEMS = 64;
+
+// the work is uneven, the first item blocks until the others are done
+int testUneven()
+{
+  std::vector<std::atomic<int>> count(N_ITEMS);
+  for (unsigned int i = 0; i < N_ITEMS; ++i)
+    count[i] = 0;
+
+  std::atomic<unsigned int> nDone(0);
+  std::atomic<int> timedOut(0);
+  std::vector<long> sums(N_THREADS, 0);
+
+  sensei::VTKUtils::ThreadLoopFunction func =
+    [&](unsigned int thread, unsigned int item) -> int
+    {
+    // time out rather than hang if nothing is stolen
+    if (item == 0)
+      {
+      auto t0 = std::chrono::steady_clock::now();
+      while (nDone < N_ITEMS - 1)
+        {
+        if ((std::chrono::steady_clock::now() - t0) >
+          std::chrono::seconds(10))
+          {
+          timedOut = 1;
+          break;
+          }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+      }
+
+    count[item] += 1;
+    sums[thread] += item;
+    nDone += 1;
+    return 0;
+    };
+
+  long total = 0;
+  sensei::VTKUtils::ThreadReduceFunction reduce =
+    [&](unsigned int thread) -> int
+    {
+    total += sums[thread];
+    return 0;
+    };
+
+  if (sensei::VTKUtils::ParallelFor(N_THREADS, N_ITEMS, func, &reduce))
+    {
+    SENSEI_ERROR("ParallelFor failed with uneven work")
+    return -1;
+    }
+
+  for (unsigned int i = 0; i < N_ITEMS; ++i)
+    {
+    if (count[i] != 1)
+      {
+      SENSEI_ERROR("Item " << i << " was processed " << count[i] << " times")
+      return -1;
+      }
+    }
+
+  if (timedOut)
+    {
+    SENSEI_ERROR("The work of the blocked thread was not stolen")
+    return -1;
+    }
+
+  if (total != long(N_ITEMS*(N_ITEMS - 1)/2))
+    {
+    SENSEI_ERROR("The per-thread results reduce to " << total
+      << " not " << N_ITEMS*(N_ITEMS - 1)/2)
+    return -1;
+    }
+
+  return 0;
+}
+
+// a worker fails, or asks to stop
+int testStop()
+{
+  bool reduced = false;
+  sensei::VTKUtils::ThreadReduceFunction reduce =
+    [&](unsigned int) -> int
+    {
+    reduced = true;
+    return 0;
+    };
+
+  sensei::VTKUtils::ThreadLoopFunction fail =
+    [](unsigned int, unsigned int item) -> int
+    {
+    return item == 13 ? -1 : 0;
+    };
+
+  if (!sensei::VTKUtils::ParallelFor(N_THREADS, N_ITEMS, fail, &reduce) ||
+    reduced)
+    {
+    SENSEI_ERROR("A failing worker was not reported")
+    return -1;
+    }
+
+  sensei::VTKUtils::ThreadLoopFunction stop =
+    [](unsigned int, unsigned int item) -> int
+    {
+    return item == 13 ? 1 : 0;
+    };
+
+  if (sensei::VTKUtils::ParallelFor(N_THREADS, N_ITEMS, stop, &reduce) ||
+    !reduced)
+    {
+    SENSEI_ERROR("A worker that stopped the loop was reported as failed")
+    return -1;
+    }
+
+  return 0;
+}
+
+// with one thread the items are processed in order on the calling thread
+int testSerial()
+{
+  if (sensei::VTKUtils::GetNumberOfThreads() != 1)
+    {
+    SENSEI_ERROR("The number of threads is "
+      << sensei::VTKUtils::GetNumberOfThreads() << " not 1")
+    return -1;
+    }
+
+  std::thread::id caller = std::this_thread::get_id();
+  std::vector<unsigned int> order;
+  bool otherThread = false;
+
+  sensei::VTKUtils::ThreadLoopFunction func =
+    [&](unsigned int thread, unsigned int item) -> int
+    {
+    if ((thread != 0) || (std::this_thread::get_id() != caller))
+      otherThread = true;
+    order.push_back(item);
+    return 0;
+    };
+
+  // the reduction is still called for each of the requested threads
+  unsigned int nReduced = 0;
+  sensei::VTKUtils::ThreadReduceFunction reduce =
+    [&](unsigned int) -> int
+    {
+    nReduced += 1;
+    return 0;
+    };
+
+  if (sensei::VTKUtils::ParallelFor(N_THREADS, N_ITEMS, func, &reduce))
+    {
+    SENSEI_ERROR("The serial ParallelFor failed")
+    return -1;
+    }
+
+  bool inOrder = order.size() == N_ITEMS;
+  for (unsigned int i = 0; inOrder && (i < N_ITEMS); ++i)
+    inOrder = order[i] == i;
+
+  if (otherThread || !inOrder || (nReduced != N_THREADS))
+    {
+    SENSEI_ERROR("The serial ParallelFor did not process the items in"
+      " order on the calling thread")
+    return -1;
+    }
+
+  return 0;
+}
+
+// blocks of uneven size, with every third one empty
+vtkMultiBlockDataSet *newMesh(int nBlocks)
+{
+  vtkMultiBlockDataSet *mb = vtkMultiBlockDataSet::New();
+  mb->SetNumberOfBlocks(nBlocks);
+
+  for (int b = 0; b < nBlocks; ++b)
+    {
+    if (b % 3 == 2)
+      continue;
+
+    vtkImageData *im = vtkImageData::New();
+    im->SetExtent(0, b + 1, 0, 2, 0, 2);
+    mb->SetBlock(b, im);
+    im->Delete();
+    }
+
+  return mb;
+}
+
+// each non-empty leaf is visited once with its flat index
+int testApply()
+{
+  const int nBlocks = 12;
+  vtkMultiBlockDataSet *mb = newMesh(nBlocks);
+
+  std::vector<std::atomic<int>> visits(nBlocks + 1);
+  for (int i = 0; i <= nBlocks; ++i)
+    visits[i] = 0;
+
+  std::vector<long> nPts(N_THREADS, 0);
+
+  sensei::VTKUtils::ThreadDatasetFunction func =
+    [&](unsigned int thread, unsigned int flatIndex, vtkDataSet *ds) -> int
+    {
+    if ((flatIndex < 1) || (flatIndex > unsigned(nBlocks)))
+      return -1;
+    visits[flatIndex] += 1;
+    nPts[thread] += ds->GetNumberOfPoints();
+    return 0;
+    };
+
+  long total = 0;
+  sensei::VTKUtils::ThreadReduceFunction reduce =
+    [&](unsigned int thread) -> int
+    {
+    total += nPts[thread];
+    return 0;
+    };
+
+  int result = 0;
+  if (sensei::VTKUtils::ParallelApply(N_THREADS, mb, func, &reduce))
+    {
+    SENSEI_ERROR("ParallelApply failed")
+    result = -1;
+    }
+
+  long expected = 0;
+  for (int b = 0; !result && (b < nBlocks); ++b)
+    {
+    int nVisits = visits[b + 1];
+    if (nVisits != (b % 3 == 2 ? 0 : 1))
+      {
+      SENSEI_ERROR("Block " << b << " was visited " << nVisits << " times")
+      result = -1;
+      }
+
+    if (b % 3 != 2)
+      expected += 9*(b + 2);
+    }
+
+  if (!result && (total != expected))
+    {
+    SENSEI_ERROR("ParallelApply counted " << total << " points not "
+      << expected)
+    result = -1;
+    }
+
+  // a failing leaf is reported
+  sensei::VTKUtils::ThreadDatasetFunction fail =
+    [](unsigned int, unsigned int flatIndex, vtkDataSet *) -> int
+    {
+    return flatIndex == 5 ? -1 : 0;
+    };
+
+  if (!sensei::VTKUtils::ParallelApply(N_THREADS, mb, fail))
+    {
+    SENSEI_ERROR("A failing leaf was not reported by ParallelApply")
+    result = -1;
+    }
+
+  mb->Delete();
+
+  return result;
+}
+}
+
+int main(int argc, char **argv)
+{
+  MPI_Init(&argc, &argv);
+
+  int rank = 0;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+  int result = 0;
+
+  sensei::VTKUtils::SetNumberOfThreads(N_THREADS);
+
+  if (testUneven() || testStop() || testApply())
+    result = -1;
+
+  sensei::VTKUtils::SetNumberOfThreads(1);
+
+  if (testSerial())
+    result = -1;
+
+  int globalResult = 0;
+  MPI_Allreduce(&result, &globalResult, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+
+  if (rank == 0)
+    std::cerr << "ParallelApply checks "
+      << (globalResult ? "failed" : "passed") << std::endl;
+
+  MPI_Finalize();
+
+  return globalResult;
+}
@@ -0,0 +1,240 @@
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+#include <mpi.h>
+#include <vtkDoubleArray.h>
+#include <vtkImageData.h>
+#include <vtkPointData.h>
+#include "senseiConfig.h"
+#include "Error.h"
+#include "MeshMetadata.h"
+#include "Quantiles.h"
+#include "VTKDataAdaptor.h"
+
+// Computes quantiles of an array whose values, gathered over all ranks, are
+// 0 to N-1 and checks them against the exact quantiles within the error
+// bound of the sketch. The same is done for an array where every third
+// value is NaN, which must be skipped. Also checks that a rank that fails
+// to add the ghost cells still takes part in the reduction, otherwise the
+// other ranks would wait for it forever.
+
+namespace
+{
+const long N_PTS = 1000;
+
+// the value of point i of rank r of the "data" and "nan" arrays
+double value(long i, int r, bool nan)
+{
+  int nRanks = 1;
+  MPI_Comm_size(MPI_COMM_WORLD, &nRanks);
+
+  if (nan && (i % 3 == 0))
+    return std::numeric_limits<double>::quiet_NaN();
+
+  return i*nRanks + r;
+}
+
+// an image of 10^3 points per rank. rank r holds the values i*nRanks + r
+// in "data", and the same with every third value NaN in "nan"
+vtkImageData *newImage()
+{
+  int rank = 0;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+  vtkImageData *im = vtkImageData::New();
+  im->SetExtent(0, 9, 0, 9, 10*rank, 10*rank + 9);
+
+  for (int j = 0; j < 2; ++j)
+    {
+    vtkDoubleArray *da = vtkDoubleArray::New();
+    da->SetName(j ? "nan" : "data");
+    da->SetNumberOfTuples(N_PTS);
+    for (long i = 0; i < N_PTS; ++i)
+      da->SetValue(i, value(i, rank, j));
+    im->GetPointData()->AddArray(da);
+    da->Delete();
+    }
+
+  return im;
+}
+
+// reports ghost cells but fails to provide them on one rank
+class GhostFailDataAdaptor : public sensei::VTKDataAdaptor
+{
+public:
+  static GhostFailDataAdaptor *New();
+  senseiTypeMacro(GhostFailDataAdaptor, sensei::VTKDataAdaptor);
+
+  int GetMeshMetadata(unsigned int id, sensei::MeshMetadataPtr &md) override
+  {
+    if (this->sensei::VTKDataAdaptor::GetMeshMetadata(id, md))
+      return -1;
+    md->NumGhostCells = 1;
+    return 0;
+  }
+
+  int AddGhostCellsArray(vtkDataObject *, const std::string &) override
+  {
+    int rank = 0;
+    int nRanks = 1;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &nRanks);
+    return rank == nRanks - 1 ? -1 : 0;
+  }
+
+protected:
+  GhostFailDataAdaptor() {}
+  ~GhostFailDataAdaptor() {}
+};
+
+senseiNewMacro(GhostFailDataAdaptor);
+
+int testQuantiles(sensei::DataAdaptor *dataAdaptor, bool nan)
+{
+  int rank = 0;
+  int nRanks = 1;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &nRanks);
+
+  int k = 200;
+  std::vector<double> quantiles({0.0, 0.1, 0.25, 0.5, 0.75, 0.9, 1.0});
+
+  sensei::Quantiles *analysis = sensei::Quantiles::New();
+  analysis->Initialize("mesh", vtkDataObject::POINT, nan ? "nan" : "data",
+    quantiles, k, "");
+
+  int result = 0;
+  if (!analysis->Execute(dataAdaptor))
+    {
+    SENSEI_ERROR("Failed to compute the quantiles")
+    result = -1;
+    }
+
+  // the result is on rank 0
+  std::vector<double> q;
+  std::vector<double> values;
+  if (!result && (rank == 0) && analysis->GetQuantiles(q, values))
+    {
+    SENSEI_ERROR("No quantiles were computed")
+    result = -1;
+    }
+
+  if (!result && (rank == 0))
+    {
+    // all of the values that are not NaN, sorted
+    std::vector<double> all;
+    for (int r = 0; r < nRanks; ++r)
+      {
+      for (long i = 0; i < N_PTS; ++i)
+        {
+        double v = value(i, r, nan);
+        if (!std::isnan(v))
+          all.push_back(v);
+        }
+      }
+    std::sort(all.begin(), all.end());
+
+    // the min and max are exact, the others are within the rank error of
+    // the sketch, about 1.7/k
+    double n = all.size();
+    double eps = 2.0/k;
+    for (size_t i = 0; i < q.size(); ++i)
+      {
+      double r = std::upper_bound(all.begin(), all.end(), values[i])
+        - all.begin();
+      if (std::isnan(values[i]) ||
+        ((q[i] == 0.0) && (values[i] != all.front())) ||
+        ((q[i] == 1.0) && (values[i] != all.back())) ||
+        (std::fabs(r/n - q[i]) > eps))
+        {
+        SENSEI_ERROR("The " << q[i] << " quantile " << values[i]
+          << " of \"" << (nan ? "nan" : "data") << "\" is wrong for the"
+          " values " << all.front() << " to " << all.back())
+        result = -1;
+        }
+      }
+    }
+
+  analysis->Finalize();
+  analysis->Delete();
+
+  return result;
+}
+
+int testGhostFailure(sensei::DataAdaptor *dataAdaptor)
+{
+  int rank = 0;
+  int nRanks = 1;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &nRanks);
+
+  sensei::Quantiles *analysis = sensei::Quantiles::New();
+  analysis->Initialize("mesh", vtkDataObject::POINT, "data", 5, 200, "");
+
+  // the last rank fails, the others reduce the data of the rest
+  bool ok = analysis->Execute(dataAdaptor);
+
+  int result = 0;
+  if (ok != (rank != nRanks - 1))
+    {
+    SENSEI_ERROR("Execute " << (ok ? "succeeded" : "failed")
+      << " on rank " << rank)
+    result = -1;
+    }
+
+  analysis->Finalize();
+  analysis->Delete();
+
+  return result;
+}
+}
+
+int main(int argc, char **argv)
+{
+  MPI_Init(&argc, &argv);
+
+  int rank = 0;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+  vtkImageData *im = newImage();
+
+  sensei::VTKDataAdaptor *dataAdaptor = sensei::VTKDataAdaptor::New();
+  dataAdaptor->SetDataObject("mesh", im);
+
+  // every rank runs both, each is collective
+  int result = 0;
+  for (int nan = 0; nan < 2; ++nan)
+    {
+    if (testQuantiles(dataAdaptor, nan))
+      result = -1;
+    }
+
+  dataAdaptor->ReleaseData();
+  dataAdaptor->Delete();
+
+  GhostFailDataAdaptor *failAdaptor = GhostFailDataAdaptor::New();
+  failAdaptor->SetDataObject("mesh", im);
+  im->Delete();
+
+  if (testGhostFailure(failAdaptor))
+    result = -1;
+
+  failAdaptor->ReleaseData();
+  failAdaptor->Delete();
+
+  int globalResult = 0;
+  MPI_Allreduce(&result, &globalResult, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+
+  // the failure case reports errors by design, the outcome is printed
+  // for ctest to match
+  if (rank == 0)
+    std::cerr << "Quantiles checks "
+      << (globalResult ? "failed" : "passed") << std::endl;
+
+  MPI_Finalize();
+
+  return globalResult;
+}
@@ -0,0 +1,177 @@
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+#include <mpi.h>
+#include "Error.h"
+#include "MeshMetadata.h"
+#include "SpaceFillingCurvePartitioner.h"
+#include "partitionerTestUtils.h"
+
+// Orders an n x n x n arrangement of blocks, given in a random order,
+// along Hilbert and Morton curves. Checks that consecutive blocks along
+// the Hilbert curve are face neighbors, that the first 8 blocks along the
+// Morton curve fill an octant, and that the partition of the curve is
+// contiguous and balanced. The same is done for a 2D arrangement.
+
+namespace
+{
+// blocks of unit size, the i'th block in the list is at ijk[i]
+sensei::MeshMetadataPtr newMetadata(int n, int nz,
+  std::vector<std::array<int,3>> &ijk)
+{
+  for (int k = 0; k < nz; ++k)
+    for (int j = 0; j < n; ++j)
+      for (int i = 0; i < n; ++i)
+        ijk.push_back({{i, j, k}});
+
+  std::mt19937 gen(1234);
+  std::shuffle(ijk.begin(), ijk.end(), gen);
+
+  sensei::MeshMetadataPtr md =
+    partitionerTestUtils::newMetadata(std::vector<long>(ijk.size(), 1000));
+
+  for (int i = 0; i < md->NumBlocks; ++i)
+    {
+    const std::array<int,3> &b = ijk[i];
+    md->BlockBounds.push_back({{double(b[0]), b[0] + 1.0, double(b[1]),
+      b[1] + 1.0, double(b[2]), b[2] + 1.0}});
+    }
+
+  return md;
+}
+
+sensei::SpaceFillingCurvePartitionerPtr newPartitioner(const char *curve)
+{
+  std::string xml = std::string("<partitioner type=\"sfc\" curve=\"")
+    + curve + "\" cost=\"cells\"/>";
+
+  return partitionerTestUtils::newPartitioner<
+    sensei::SpaceFillingCurvePartitioner>(xml);
+}
+
+int testHilbert(int n, int nz)
+{
+  std::vector<std::array<int,3>> ijk;
+  sensei::MeshMetadataPtr md = newMetadata(n, nz, ijk);
+
+  sensei::SpaceFillingCurvePartitionerPtr part = newPartitioner("hilbert");
+
+  std::vector<int> order;
+  if (!part || part->GetCurveOrder(md, order))
+    {
+    SENSEI_ERROR("Failed to order the blocks")
+    return -1;
+    }
+
+  for (int i = 1; i < md->NumBlocks; ++i)
+    {
+    const std::array<int,3> &a = ijk[order[i-1]];
+    const std::array<int,3> &b = ijk[order[i]];
+
+    int dist = abs(a[0] - b[0]) + abs(a[1] - b[1]) + abs(a[2] - b[2]);
+    if (dist != 1)
+      {
+      SENSEI_ERROR("Blocks " << i - 1 << " and " << i << " along the "
+        << n << "x" << n << "x" << nz << " Hilbert curve are not neighbors")
+      return -1;
+      }
+    }
+
+  return 0;
+}
+
+int testMorton(int n)
+{
+  std::vector<std::array<int,3>> ijk;
+  sensei::MeshMetadataPtr md = newMetadata(n, n, ijk);
+
+  sensei::SpaceFillingCurvePartitionerPtr part = newPartitioner("morton");
+
+  std::vector<int> order;
+  if (!part || part->GetCurveOrder(md, order))
+    {
+    SENSEI_ERROR("Failed to order the blocks")
+    return -1;
+    }
+
+  for (int i = 0; i < 8; ++i)
+    {
+    const std::array<int,3> &a = ijk[order[i]];
+    if ((a[0] > 1) || (a[1] > 1) || (a[2] > 1))
+      {
+      SENSEI_ERROR("Block " << i << " along the Morton curve is not in "
+        "the first octant")
+      return -1;
+      }
+    }
+
+  return 0;
+}
+
+int testPartition(MPI_Comm comm, int n)
+{
+  int nRanks = 1;
+  MPI_Comm_size(comm, &nRanks);
+
+  std::vector<std::array<int,3>> ijk;
+  sensei::MeshMetadataPtr md = newMetadata(n, n, ijk);
+
+  sensei::SpaceFillingCurvePartitionerPtr part = newPartitioner("hilbert");
+
+  sensei::MeshMetadataPtr out;
+  std::vector<int> order;
+  if (!part || part->GetPartition(comm, md, out) ||
+    part->GetCurveOrder(md, order))
+    {
+    SENSEI_ERROR("Failed to partition the blocks")
+    return -1;
+    }
+
+  // the owners increase along the curve
+  for (int i = 1; i < md->NumBlocks; ++i)
+    {
+    if (out->BlockOwner[order[i]] < out->BlockOwner[order[i-1]])
+      {
+      SENSEI_ERROR("The segments of the curve are not contiguous")
+      return -1;
+      }
+    }
+
+  // the blocks are all the same, the counts differ by at most one
+  std::vector<int> count(nRanks, 0);
+  for (int i = 0; i < md->NumBlocks; ++i)
+    count[out->BlockOwner[i]] += 1;
+
+  int nMin = *std::min_element(count.begin(), count.end());
+  int nMax = *std::max_element(count.begin(), count.end());
+  if (nMax - nMin > 1)
+    {
+    SENSEI_ERROR("The ranks have between " << nMin << " and " << nMax
+      << " blocks")
+    return -1;
+    }
+
+  return 0;
+}
+}
+
+int main(int argc, char **argv)
+{
+  MPI_Init(&argc, &argv);
+
+  int result = 0;
+  if (testHilbert(4, 4) || testHilbert(8, 8) || testHilbert(16, 1) ||
+    testMorton(4) || testPartition(MPI_COMM_WORLD, 8))
+    result = -1;
+
+  int rank = 0;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  if ((rank == 0) && !result)
+    std::cerr << "Space filling curve partitioner checks passed" << std::endl;
+
+  MPI_Finalize();
+
+  return result;
+}
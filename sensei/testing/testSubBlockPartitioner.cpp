@@ -0,0 +1,242 @@
+#include <algorithm>
+#include <array>
+#include <iostream>
+#include <vector>
+#include <mpi.h>
+#include <vtkType.h>
+#include "Error.h"
+#include "MeshMetadata.h"
+#include "SubBlockPartitioner.h"
+#include "partitionerTestUtils.h"
+
+// Splits image blocks with the SubBlockPartitioner and checks that the
+// pieces of each block tile it along the slowest varying axis, sharing the
+// points at the cuts, that the piece sizes follow from their extents, and
+// that every rank is given a piece when there are fewer blocks than ranks.
+// Checks that the data of the pieces are consecutive slabs of the block's
+// data, that 2D blocks are split along j, that pieces are no thinner than
+// min_layers, and that unstructured meshes are left whole.
+
+namespace
+{
+// check that the pieces tile the blocks they were cut from along the axis,
+// and that the data of the pieces are consecutive slabs of the block's data
+int checkPieces(const sensei::MeshMetadataPtr &in,
+  const sensei::MeshMetadataPtr &out, int axis, int minPieces,
+  int minLayers, const char *test)
+{
+  int nOut = out->NumBlocks;
+  if ((nOut < minPieces) || (int(out->BlockSource.size()) != nOut))
+    {
+    SENSEI_ERROR("Made " << nOut << " pieces with " << out->BlockSource.size()
+      << " sources in " << test << ", at least " << minPieces << " needed")
+    return -1;
+    }
+
+  std::vector<int> nextLayer(in->NumBlocks);
+  std::vector<size_t> nextCell(in->NumBlocks, 0);
+  for (int i = 0; i < in->NumBlocks; ++i)
+    nextLayer[i] = in->BlockExtents[i][2*axis];
+
+  long nCells = 0;
+  for (int j = 0; j < nOut; ++j)
+    {
+    int i = out->BlockSource[j];
+    const std::array<int,6> &ext = out->BlockExtents[j];
+    const std::array<int,6> &bext = in->BlockExtents[i];
+
+    // the pieces of a block are in order and the faster axes are whole
+    bool whole = true;
+    for (int d = 0; d < 3; ++d)
+      {
+      if ((d != axis) && ((ext[2*d] != bext[2*d]) || (ext[2*d+1] != bext[2*d+1])))
+        whole = false;
+      }
+
+    if ((out->BlockIds[j] != j) || !whole || (ext[2*axis] != nextLayer[i]) ||
+      (ext[2*axis+1] - ext[2*axis] < minLayers))
+      {
+      SENSEI_ERROR("Piece " << j << " of block " << i << " in " << test
+        << " does not tile the block")
+      return -1;
+      }
+    nextLayer[i] = ext[2*axis+1];
+
+    long nPts = 1;
+    long nc = 1;
+    for (int d = 0; d < 3; ++d)
+      {
+      nPts *= ext[2*d+1] - ext[2*d] + 1;
+      nc *= std::max(ext[2*d+1] - ext[2*d], 1);
+      }
+
+    if ((out->BlockNumPoints[j] != nPts) || (out->BlockNumCells[j] != nc))
+      {
+      SENSEI_ERROR("Piece " << j << " in " << test << " has "
+        << out->BlockNumPoints[j] << " points and " << out->BlockNumCells[j]
+        << " cells, " << nPts << " and " << nc << " expected")
+      return -1;
+      }
+    nCells += nc;
+
+    size_t start = 0;
+    size_t count = 0;
+    if (sensei::SubBlockPartitioner::GetSelection(bext.data(), ext.data(),
+      true, start, count) || (start != nextCell[i]) || (long(count) != nc))
+      {
+      SENSEI_ERROR("The cells of piece " << j << " in " << test
+        << " are not the next slab of block " << i)
+      return -1;
+      }
+    nextCell[i] += count;
+    }
+
+  for (int i = 0; i < in->NumBlocks; ++i)
+    {
+    if (nextLayer[i] != in->BlockExtents[i][2*axis+1])
+      {
+      SENSEI_ERROR("Block " << i << " in " << test << " is not covered")
+      return -1;
+      }
+    }
+
+  if (nCells != in->NumBlocks*in->BlockNumCells[0])
+    {
+    SENSEI_ERROR("The pieces in " << test << " have " << nCells << " cells")
+    return -1;
+    }
+
+  return 0;
+}
+
+// the selections of pieces of a 16 x 8 x 8 block
+int testSelection()
+{
+  std::array<int,6> ext = {{0, 16, 0, 8, 0, 8}};
+  std::array<int,6> slab = {{0, 16, 0, 8, 4, 8}};
+  std::array<int,6> column = {{0, 8, 0, 8, 0, 8}};
+
+  size_t pts[2] = {0};
+  size_t cells[2] = {0};
+  if (sensei::SubBlockPartitioner::GetSelection(ext.data(), slab.data(),
+      false, pts[0], pts[1]) ||
+    sensei::SubBlockPartitioner::GetSelection(ext.data(), slab.data(),
+      true, cells[0], cells[1]) ||
+    (pts[0] != 4*17*9) || (pts[1] != 5*17*9) ||
+    (cells[0] != 4*16*8) || (cells[1] != 4*16*8))
+    {
+    SENSEI_ERROR("Wrong selection of a slab, points " << pts[0] << ", "
+      << pts[1] << " cells " << cells[0] << ", " << cells[1])
+    return -1;
+    }
+
+  // only slabs are contiguous
+  if (!sensei::SubBlockPartitioner::GetSelection(ext.data(), column.data(),
+    true, cells[0], cells[1]))
+    {
+    SENSEI_ERROR("A column of the block was selected")
+    return -1;
+    }
+
+  return 0;
+}
+
+// fewer blocks than ranks, every rank gets a piece
+int testFanOut(MPI_Comm comm)
+{
+  int nRanks = 1;
+  MPI_Comm_size(comm, &nRanks);
+
+  sensei::SubBlockPartitionerPtr part =
+    partitionerTestUtils::newPartitioner<sensei::SubBlockPartitioner>(
+    "<partitioner type=\"split\" blocks_per_rank=\"2\" cost=\"cells\"/>");
+  if (!part)
+    return -1;
+
+  sensei::MeshMetadataPtr in =
+    partitionerTestUtils::newImageMetadata(1, 16, 8, 4*nRanks);
+
+  sensei::MeshMetadataPtr out;
+  if (part->GetPartition(comm, in, out) ||
+    checkPieces(in, out, 2, 2*nRanks, 1, "the fan out test"))
+    return -1;
+
+  std::vector<int> nPieces(nRanks, 0);
+  for (int j = 0; j < out->NumBlocks; ++j)
+    {
+    int owner = out->BlockOwner[j];
+    if ((owner < 0) || (owner >= nRanks))
+      {
+      SENSEI_ERROR("Piece " << j << " has owner " << owner)
+      return -1;
+      }
+    nPieces[owner] += 1;
+    }
+
+  for (int r = 0; r < nRanks; ++r)
+    {
+    if (nPieces[r] == 0)
+      {
+      SENSEI_ERROR("Rank " << r << " was not given a piece")
+      return -1;
+      }
+    }
+
+  return 0;
+}
+
+// 2D blocks are split along j and pieces are no thinner than min_layers
+int testSplit()
+{
+  sensei::SubBlockPartitionerPtr part =
+    partitionerTestUtils::newPartitioner<sensei::SubBlockPartitioner>(
+    "<partitioner type=\"split\" min_layers=\"4\"/>");
+  if (!part)
+    return -1;
+
+  sensei::MeshMetadataPtr in =
+    partitionerTestUtils::newImageMetadata(3, 32, 10, 0);
+  for (int i = 0; i < 3; ++i)
+    in->BlockExtents[i] = {0, 32, 10*i, 10*(i + 1), 0, 0};
+
+  sensei::MeshMetadataPtr out;
+  if (part->Split(in, 7, out) || checkPieces(in, out, 1, 6, 4, "the 2D test"))
+    return -1;
+
+  // at most 2 pieces of 10 layers each can be made
+  if (part->Split(in, 64, out) || (out->NumBlocks != 6))
+    {
+    SENSEI_ERROR("Made " << out->NumBlocks << " pieces of 4 or more layers")
+    return -1;
+    }
+
+  // unstructured blocks are left whole
+  in->BlockType = VTK_UNSTRUCTURED_GRID;
+  if (part->Split(in, 7, out) || (out->NumBlocks != 3) ||
+    !out->BlockSource.empty())
+    {
+    SENSEI_ERROR("Unstructured blocks were split")
+    return -1;
+    }
+
+  return 0;
+}
+}
+
+int main(int argc, char **argv)
+{
+  MPI_Init(&argc, &argv);
+
+  int result = 0;
+  if (testSelection() || testFanOut(MPI_COMM_WORLD) || testSplit())
+    result = -1;
+
+  int rank = 0;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  if ((rank == 0) && !result)
+    std::cerr << "Sub-block partitioner checks passed" << std::endl;
+
+  MPI_Finalize();
+
+  return result;
+}
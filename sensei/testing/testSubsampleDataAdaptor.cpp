@@ -0,0 +1,240 @@
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <mpi.h>
+#include <vtkCellArray.h>
+#include <vtkCompositeDataIterator.h>
+#include <vtkCompositeDataSet.h>
+#include <vtkDoubleArray.h>
+#include <vtkImageData.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkSmartPointer.h>
+#include "Error.h"
+#include "SubsampleDataAdaptor.h"
+#include "VTKDataAdaptor.h"
+
+// Subsamples an image by stride and particles at random and by importance,
+// and checks that the values of the subsampled arrays are those of the
+// points that were kept. The arrays hold the index of the point in the
+// full mesh.
+
+namespace
+{
+const int gNx = 9;
+const long gNp = 20000;
+
+// get the single block of the subsampled mesh
+vtkDataSet *getBlock(sensei::DataAdaptor *da, const std::string &meshName,
+  vtkSmartPointer<vtkCompositeDataSet> &mesh)
+{
+  vtkCompositeDataSet *cd = nullptr;
+  if (da->GetMesh(meshName, false, cd) ||
+    da->AddArray(cd, meshName, vtkDataObject::POINT, "id"))
+    return nullptr;
+
+  mesh.TakeReference(cd);
+
+  vtkCompositeDataIterator *it = cd->NewIterator();
+  it->InitTraversal();
+  vtkDataSet *ds = it->IsDoneWithTraversal() ? nullptr :
+    dynamic_cast<vtkDataSet*>(it->GetCurrentDataObject());
+  it->Delete();
+
+  return ds;
+}
+
+int validateImage(sensei::DataAdaptor *da)
+{
+  vtkSmartPointer<vtkCompositeDataSet> mesh;
+  vtkImageData *im = dynamic_cast<vtkImageData*>(getBlock(da, "image", mesh));
+  if (!im)
+    {
+    SENSEI_ERROR("The strided mesh is not an image")
+    return -1;
+    }
+
+  int dims[3];
+  im->GetDimensions(dims);
+  int n = (gNx + 1)/2;
+  if ((dims[0] != n) || (dims[1] != n) || (dims[2] != n))
+    {
+    SENSEI_ERROR("The strided image is " << dims[0] << "x" << dims[1]
+      << "x" << dims[2] << " not " << n << "x" << n << "x" << n)
+    return -1;
+    }
+
+  vtkDataArray *ids = im->GetPointData()->GetArray("id");
+  for (int k = 0, q = 0; k < n; ++k)
+    {
+    for (int j = 0; j < n; ++j)
+      {
+      for (int i = 0; i < n; ++i, ++q)
+        {
+        long id = 2*i + gNx*(2*j + gNx*2*k);
+        if (ids->GetTuple1(q) != id)
+          {
+          SENSEI_ERROR("Point " << q << " of the strided image has id "
+            << ids->GetTuple1(q) << " not " << id)
+          return -1;
+          }
+        }
+      }
+    }
+
+  return 0;
+}
+
+int validateParticles(sensei::DataAdaptor *da, double fraction,
+  bool important, long &nKept)
+{
+  vtkSmartPointer<vtkCompositeDataSet> mesh;
+  vtkPolyData *pd = dynamic_cast<vtkPolyData*>(getBlock(da, "particles", mesh));
+  if (!pd)
+    {
+    SENSEI_ERROR("The subsampled particles are not polydata")
+    return -1;
+    }
+
+  nKept = pd->GetNumberOfPoints();
+
+  // the count is binomial, allow for 5 standard deviations
+  double expected = fraction*gNp;
+  if (fabs(nKept - expected) > 5.0*sqrt(expected))
+    {
+    SENSEI_ERROR("Kept " << nKept << " particles expected about " << expected)
+    return -1;
+    }
+
+  if (pd->GetNumberOfCells() != nKept)
+    {
+    SENSEI_ERROR("The subsampled particles have " << pd->GetNumberOfCells()
+      << " vertices and " << nKept << " points")
+    return -1;
+    }
+
+  vtkDataArray *ids = pd->GetPointData()->GetArray("id");
+  for (long i = 0; i < nKept; ++i)
+    {
+    double x[3];
+    pd->GetPoint(i, x);
+
+    long id = ids->GetTuple1(i);
+    if ((x[0] != id) || (important && (id % 2)))
+      {
+      SENSEI_ERROR("Particle " << i << " at " << x[0] << " has id " << id)
+      return -1;
+      }
+    }
+
+  return 0;
+}
+}
+
+int main(int argc, char **argv)
+{
+  MPI_Init(&argc, &argv);
+
+  // an image and a set of particles, each point holding its index
+  vtkImageData *im = vtkImageData::New();
+  im->SetDimensions(gNx, gNx, gNx);
+
+  long nPts = gNx*gNx*gNx;
+  vtkDoubleArray *imIds = vtkDoubleArray::New();
+  imIds->SetName("id");
+  imIds->SetNumberOfTuples(nPts);
+  for (long i = 0; i < nPts; ++i)
+    imIds->SetValue(i, i);
+  im->GetPointData()->AddArray(imIds);
+  imIds->Delete();
+
+  vtkPoints *pts = vtkPoints::New();
+  pts->SetDataTypeToDouble();
+  pts->SetNumberOfPoints(gNp);
+
+  vtkCellArray *verts = vtkCellArray::New();
+
+  vtkDoubleArray *pIds = vtkDoubleArray::New();
+  pIds->SetName("id");
+  pIds->SetNumberOfTuples(gNp);
+
+  // only the even particles carry weight
+  vtkDoubleArray *weight = vtkDoubleArray::New();
+  weight->SetName("weight");
+  weight->SetNumberOfTuples(gNp);
+
+  for (vtkIdType i = 0; i < gNp; ++i)
+    {
+    pts->SetPoint(i, i, 0.0, 0.0);
+    verts->InsertNextCell(1, &i);
+    pIds->SetValue(i, i);
+    weight->SetValue(i, (i % 2) ? 0.0 : 1.0);
+    }
+
+  vtkPolyData *pd = vtkPolyData::New();
+  pd->SetPoints(pts);
+  pd->SetVerts(verts);
+  pd->GetPointData()->AddArray(pIds);
+  pd->GetPointData()->AddArray(weight);
+  pts->Delete();
+  verts->Delete();
+  pIds->Delete();
+  weight->Delete();
+
+  sensei::VTKDataAdaptor *dataAdaptor = sensei::VTKDataAdaptor::New();
+  dataAdaptor->SetDataObject("image", im);
+  dataAdaptor->SetDataObject("particles", pd);
+  im->Delete();
+  pd->Delete();
+
+  sensei::SubsampleDataAdaptor *subsampler = sensei::SubsampleDataAdaptor::New();
+  subsampler->SetDataAdaptor(dataAdaptor);
+
+  int result = 0;
+
+  // every other point along each axis
+  subsampler->SetStride("image", {{2, 2, 2}});
+  if (validateImage(subsampler))
+    {
+    SENSEI_ERROR("Strided subsampling failed")
+    result = -1;
+    }
+
+  // the same particles are chosen each step
+  subsampler->SetRandom("particles", 0.25);
+  long nKept[2] = {0, 0};
+  for (int step = 0; step < 2; ++step)
+    {
+    if (validateParticles(subsampler, 0.25, false, nKept[step]))
+      {
+      SENSEI_ERROR("Random subsampling failed")
+      result = -1;
+      }
+    subsampler->ClearCache();
+    }
+
+  if (nKept[0] != nKept[1])
+    {
+    SENSEI_ERROR("Random subsampling kept " << nKept[0] << " then "
+      << nKept[1] << " particles")
+    result = -1;
+    }
+
+  // only particles with weight are chosen, each with twice the probability
+  subsampler->SetImportance("particles", 0.25, vtkDataObject::POINT, "weight");
+  if (validateParticles(subsampler, 0.25, true, nKept[0]))
+    {
+    SENSEI_ERROR("Importance subsampling failed")
+    result = -1;
+    }
+
+  subsampler->Delete();
+  dataAdaptor->ReleaseData();
+  dataAdaptor->Delete();
+
+  MPI_Finalize();
+
+  return result;
+}
@@ -0,0 +1,289 @@
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <mpi.h>
+#include <vtkDataArray.h>
+#include <vtkDoubleArray.h>
+#include <vtkImageData.h>
+#include <vtkMultiBlockDataSet.h>
+#include <vtkPointData.h>
+#include <vtkSmartPointer.h>
+#include "senseiConfig.h"
+#include "Error.h"
+#include "TemporalStatistics.h"
+#include "VTKDataAdaptor.h"
+
+// Feeds known values through TemporalStatistics over several steps and
+// checks the mean, variance, min, max, and exponential moving average it
+// writes against those computed directly from all of the steps. Also
+// checks that it is thread safe only when its writer is.
+
+namespace
+{
+// the value of component c of point i at step t
+double value(long i, int c, int t)
+{
+  int rank = 0;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  return (c + 1)*std::sin(0.1*i + 0.7*t) + 0.25*t*t - rank;
+}
+
+// an image of n^3 cells per rank stacked along z with a scalar and a two
+// component point array
+vtkImageData *newImage(int n)
+{
+  int rank = 0;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+  vtkImageData *im = vtkImageData::New();
+  im->SetExtent(0, n, 0, n, rank*n, (rank + 1)*n);
+
+  const char *names[] = {"a", "v"};
+  for (int j = 0; j < 2; ++j)
+    {
+    vtkDoubleArray *da = vtkDoubleArray::New();
+    da->SetName(names[j]);
+    da->SetNumberOfComponents(j + 1);
+    da->SetNumberOfTuples(im->GetNumberOfPoints());
+    im->GetPointData()->AddArray(da);
+    da->Delete();
+    }
+
+  return im;
+}
+
+// set the values of step t
+void setStep(vtkImageData *im, int t)
+{
+  const char *names[] = {"a", "v"};
+  for (int j = 0; j < 2; ++j)
+    {
+    vtkDataArray *da = im->GetPointData()->GetArray(names[j]);
+    long nTups = da->GetNumberOfTuples();
+    for (long i = 0; i < nTups; ++i)
+      for (int c = 0; c <= j; ++c)
+        da->SetComponent(i, c, value(i, c, t));
+    }
+}
+
+// keeps the statistics of the local block
+class StatsWriter : public sensei::AnalysisAdaptor
+{
+public:
+  static StatsWriter *New();
+  senseiTypeMacro(StatsWriter, sensei::AnalysisAdaptor);
+
+  bool Execute(sensei::DataAdaptor *data) override
+  {
+    int rank = 0;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+    vtkDataObject *mesh = nullptr;
+    if (data->GetMesh("mesh_stats", false, mesh) ||
+      data->AddArrays(mesh, "mesh_stats", vtkDataObject::POINT, this->Names))
+      {
+      SENSEI_ERROR("Failed to get the statistics")
+      return false;
+      }
+
+    vtkMultiBlockDataSet *mb = dynamic_cast<vtkMultiBlockDataSet*>(mesh);
+    vtkDataSet *ds = mb ?
+      dynamic_cast<vtkDataSet*>(mb->GetBlock(rank)) : nullptr;
+    if (!ds)
+      {
+      SENSEI_ERROR("The statistics have no block " << rank)
+      mesh->Delete();
+      return false;
+      }
+
+    this->Arrays.clear();
+    for (const std::string &name : this->Names)
+      {
+      vtkDataArray *da = ds->GetPointData()->GetArray(name.c_str());
+      if (!da)
+        {
+        SENSEI_ERROR("The statistics have no array \"" << name << "\"")
+        mesh->Delete();
+        return false;
+        }
+      this->Arrays.push_back(da);
+      }
+
+    mesh->Delete();
+
+    this->NumWrites += 1;
+    return true;
+  }
+
+  int GetThreadSafe() override { return this->ThreadSafe; }
+
+  int Finalize() override { return 0; }
+
+  std::vector<std::string> Names;
+  std::vector<vtkSmartPointer<vtkDataArray>> Arrays;
+  int NumWrites;
+  int ThreadSafe;
+
+protected:
+  StatsWriter() : NumWrites(0), ThreadSafe(0) {}
+  ~StatsWriter() {}
+};
+
+senseiNewMacro(StatsWriter);
+
+// compare the statistics of array j with those computed directly
+int checkStatistics(StatsWriter *writer, int j, long nTups, int nSteps,
+  double alpha)
+{
+  const char *names[] = {"a", "v"};
+  int nComps = j + 1;
+
+  int result = 0;
+  for (long i = 0; i < nTups; ++i)
+    {
+    for (int c = 0; c < nComps; ++c)
+      {
+      double sum = 0.0;
+      double mn = value(i, c, 0);
+      double mx = mn;
+      double ema = mn;
+      for (int t = 0; t < nSteps; ++t)
+        {
+        double x = value(i, c, t);
+        sum += x;
+        mn = std::min(mn, x);
+        mx = std::max(mx, x);
+        if (t)
+          ema = alpha*x + (1.0 - alpha)*ema;
+        }
+
+      double mean = sum/nSteps;
+
+      double var = 0.0;
+      for (int t = 0; t < nSteps; ++t)
+        {
+        double d = value(i, c, t) - mean;
+        var += d*d;
+        }
+      var /= nSteps - 1;
+
+      double expected[] = {mean, var, mn, mx, ema};
+      for (int k = 0; k < 5; ++k)
+        {
+        vtkDataArray *da = writer->Arrays[5*j + k];
+        double v = da->GetComponent(i, c);
+        if (std::fabs(v - expected[k]) > 1e-10*(1.0 + std::fabs(expected[k])))
+          {
+          if (!result)
+            SENSEI_ERROR(<< da->GetName() << " of " << names[j] << " is " << v
+              << " at " << i << "," << c << " but should be " << expected[k])
+          result = -1;
+          }
+        }
+      }
+    }
+
+  return result;
+}
+}
+
+int main(int argc, char **argv)
+{
+  MPI_Init(&argc, &argv);
+
+  int rank = 0;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+  int result = 0;
+
+  int nSteps = 7;
+  double alpha = 0.25;
+  std::vector<std::string> arrays({"a", "v"});
+
+  StatsWriter *writer = StatsWriter::New();
+  for (const std::string &array : arrays)
+    {
+    const char *stats[] = {"_mean", "_variance", "_min", "_max", "_ema"};
+    for (int k = 0; k < 5; ++k)
+      writer->Names.push_back(array + stats[k]);
+    }
+
+  sensei::TemporalStatistics *analysis = sensei::TemporalStatistics::New();
+  analysis->Initialize("mesh", vtkDataObject::POINT, arrays, alpha, 0);
+
+  // thread safe only when the writer is
+  if (!analysis->GetThreadSafe())
+    {
+    SENSEI_ERROR("TemporalStatistics without a writer is not thread safe")
+    result = -1;
+    }
+
+  analysis->SetWriter(writer);
+
+  if (analysis->GetThreadSafe())
+    {
+    SENSEI_ERROR("TemporalStatistics with a serial writer is thread safe")
+    result = -1;
+    }
+
+  writer->ThreadSafe = 1;
+
+  if (!analysis->GetThreadSafe())
+    {
+    SENSEI_ERROR("TemporalStatistics with a thread safe writer is not")
+    result = -1;
+    }
+
+  vtkImageData *im = newImage(8);
+
+  sensei::VTKDataAdaptor *dataAdaptor = sensei::VTKDataAdaptor::New();
+  dataAdaptor->SetDataObject("mesh", im);
+
+  for (int t = 0; t < nSteps; ++t)
+    {
+    setStep(im, t);
+    dataAdaptor->SetDataTimeStep(t);
+    dataAdaptor->SetDataTime(0.1*t);
+
+    if (!analysis->Execute(dataAdaptor))
+      {
+      SENSEI_ERROR("Failed to update the statistics at step " << t)
+      result = -1;
+      }
+    }
+
+  // the statistics are written once, in Finalize
+  if (writer->NumWrites || analysis->Finalize() || (writer->NumWrites != 1))
+    {
+    SENSEI_ERROR("The statistics were written " << writer->NumWrites
+      << " times")
+    result = -1;
+    }
+  else
+    {
+    for (int j = 0; j < 2; ++j)
+      {
+      if (checkStatistics(writer, j, im->GetNumberOfPoints(), nSteps, alpha))
+        result = -1;
+      }
+    }
+
+  analysis->Delete();
+  writer->Delete();
+
+  dataAdaptor->ReleaseData();
+  dataAdaptor->Delete();
+  im->Delete();
+
+  int globalResult = 0;
+  MPI_Allreduce(&result, &globalResult, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+
+  if ((rank == 0) && !globalResult)
+    std::cerr << "TemporalStatistics checks passed" << std::endl;
+
+  MPI_Finalize();
+
+  return globalResult;
+}
@@ -0,0 +1,124 @@
+#include <iostream>
+#include <vector>
+#include <mpi.h>
+#include "Error.h"
+#include "TimeBudgetScheduler.h"
+
+// Drives the TimeBudgetScheduler with fixed wall and execution times and
+// checks its decisions step by step. Three analyses, a high and a low
+// priority one and a low priority one with a minimum cadence of 3, share
+// a budget of 1/8 of the wall time. Checks that analyses of unknown cost
+// run, that the budget cuts off the low priority analyses, that higher
+// priority analyses are considered first, that the cost estimate is the
+// exponential moving average of the times of the slowest rank, and that
+// the minimum cadence forces a run when the budget is exhausted.
+
+namespace
+{
+enum { HIGH = 0, LOW = 1, CADENCED = 2 };
+
+int checkRun(const std::vector<int> &run, const std::vector<int> &expected,
+  int step)
+{
+  if (run != expected)
+    {
+    SENSEI_ERROR("At step " << step << " the scheduler ran "
+      << run[HIGH] << " " << run[LOW] << " " << run[CADENCED]
+      << " while " << expected[HIGH] << " " << expected[LOW] << " "
+      << expected[CADENCED] << " was expected")
+    return -1;
+    }
+  return 0;
+}
+
+int checkCost(const sensei::TimeBudgetScheduler &sched, unsigned int i,
+  double expected, int step)
+{
+  double cost = sched.GetCost(i);
+  if (cost != expected)
+    {
+    SENSEI_ERROR("At step " << step << " the cost of analysis " << i
+      << " is " << cost << " while " << expected << " was expected")
+    return -1;
+    }
+  return 0;
+}
+}
+
+int main(int argc, char **argv)
+{
+  MPI_Init(&argc, &argv);
+
+  int rank = 0;
+  int nRanks = 1;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &nRanks);
+
+  // the times are powers of 2 so that the arithmetic is exact
+  sensei::TimeBudgetScheduler sched;
+  sched.SetBudget(0.125);
+  sched.AddAnalysis("high", 2, 0);
+  sched.AddAnalysis("low", 1, 0);
+  sched.AddAnalysis("cadenced", 0, 3);
+
+  int result = 0;
+  std::vector<int> run;
+
+  // step 0, at t=0. no cost is known, everything runs
+  sched.Schedule(MPI_COMM_WORLD, 0.0, run);
+  if (checkRun(run, {1, 1, 1}, 0))
+    result = -1;
+
+  sched.SetExecuteTime(HIGH, 2.0);
+  sched.SetExecuteTime(LOW, 2.0);
+  sched.SetExecuteTime(CADENCED, 2.0);
+
+  // step 1, at t=64. 8 s of budget less 6 s spent leaves 2 s, only the
+  // high priority analysis fits
+  run.clear();
+  sched.Schedule(MPI_COMM_WORLD, 64.0, run);
+  if (checkRun(run, {1, 0, 0}, 1) || checkCost(sched, HIGH, 2.0, 1) ||
+    checkCost(sched, LOW, 2.0, 1) || checkCost(sched, CADENCED, 2.0, 1))
+    result = -1;
+
+  // the last rank is the slowest and sets the cost
+  sched.SetExecuteTime(HIGH, rank == nRanks - 1 ? 4.0 : 0.5);
+
+  // step 2, at t=120. the cost of the high priority analysis is
+  // 0.5*4 + 0.5*2 = 3 s. 15 s of budget less 10 s spent leaves 5 s, enough
+  // for the high and low priority analyses but not the cadenced one
+  run.clear();
+  sched.Schedule(MPI_COMM_WORLD, 120.0, run);
+  if (checkRun(run, {1, 1, 0}, 2) || checkCost(sched, HIGH, 3.0, 2))
+    result = -1;
+
+  sched.SetExecuteTime(HIGH, 3.0);
+  sched.SetExecuteTime(LOW, 2.0);
+
+  // step 3, at t=128. 16 s of budget less 15 s spent leaves 1 s, nothing
+  // fits, but the cadenced analysis was skipped for 2 steps and must run
+  run.clear();
+  sched.Schedule(MPI_COMM_WORLD, 128.0, run);
+  if (checkRun(run, {0, 0, 1}, 3) || checkCost(sched, HIGH, 3.0, 3) ||
+    checkCost(sched, LOW, 2.0, 3))
+    result = -1;
+
+  sched.SetExecuteTime(CADENCED, 2.0);
+
+  // step 4, at t=256. plenty of budget, but analyses that are not
+  // eligible, for instance because their trigger did not fire, are skipped
+  run = {1, 0, 1};
+  sched.Schedule(MPI_COMM_WORLD, 256.0, run);
+  if (checkRun(run, {1, 0, 1}, 4))
+    result = -1;
+
+  int globalResult = 0;
+  MPI_Allreduce(&result, &globalResult, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+
+  if ((rank == 0) && !globalResult)
+    std::cerr << "Time budget scheduler checks passed" << std::endl;
+
+  MPI_Finalize();
+
+  return globalResult;
+}
@@ -0,0 +1,149 @@
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "Error.h"
+#include "TimeSeriesStore.h"
+
+// Appends records to a time series file in two sessions, leaves a partial
+// record at the end as an interrupted run would, and checks that reopening
+// the file drops it and that all of the complete records read back.
+
+namespace
+{
+const unsigned int gNumBins = 16;
+
+std::vector<double> range(long step)
+{ return {-double(step), double(step + 1)}; }
+
+std::vector<unsigned int> bins(long step)
+{
+  std::vector<unsigned int> b(gNumBins);
+  for (unsigned int i = 0; i < gNumBins; ++i)
+    b[i] = step*gNumBins + i;
+  return b;
+}
+
+int append(sensei::TimeSeriesStore &store, long step0, long step1)
+{
+  for (long step = step0; step < step1; ++step)
+    {
+    std::vector<double> r = range(step);
+    std::vector<unsigned int> b = bins(step);
+    if (store.Append(step, 0.5*step, step % 2, r.data(), 2, b.data(), gNumBins))
+      return -1;
+    }
+  return 0;
+}
+
+int validate(const std::string &fileName, long nSteps)
+{
+  FILE *f = fopen(fileName.c_str(), "rb");
+  if (!f)
+    {
+    SENSEI_ERROR("Failed to open \"" << fileName << "\"")
+    return -1;
+    }
+
+  std::vector<char> buf;
+  char tmp[4096];
+  size_t n = 0;
+  while ((n = fread(tmp, 1, sizeof(tmp), f)))
+    buf.insert(buf.end(), tmp, tmp + n);
+  fclose(f);
+
+  if ((buf.size() < 16) || strncmp(buf.data(), "SENSEITS", 8))
+    {
+    SENSEI_ERROR("Bad header")
+    return -1;
+    }
+
+  uint32_t textLen = 0;
+  memcpy(&textLen, buf.data() + 12, 4);
+
+  std::string text(buf.data() + 16, textLen);
+  if (text != "kind=histogram\nmesh=mesh\n")
+    {
+    SENSEI_ERROR("Bad metadata \"" << text << "\"")
+    return -1;
+    }
+
+  size_t pos = 16 + textLen;
+  for (long step = 0; step < nSteps; ++step)
+    {
+    uint32_t len = 0;
+    int64_t rstep = 0;
+    double rtime = 0.0;
+    uint32_t var = 0, nVals = 0, nCounts = 0;
+
+    const char *p = buf.data() + pos;
+    memcpy(&len, p, 4);
+    memcpy(&rstep, p + 4, 8);
+    memcpy(&rtime, p + 12, 8);
+    memcpy(&var, p + 20, 4);
+    memcpy(&nVals, p + 24, 4);
+    memcpy(&nCounts, p + 28, 4);
+
+    std::vector<double> r(nVals);
+    std::vector<uint64_t> b(nCounts);
+    memcpy(r.data(), p + 32, 8*nVals);
+    memcpy(b.data(), p + 32 + 8*nVals, 8*nCounts);
+
+    std::vector<double> er = range(step);
+    std::vector<unsigned int> eb = bins(step);
+
+    if ((rstep != step) || (rtime != 0.5*step) || (var != step % 2) ||
+      (r != er) || !std::equal(eb.begin(), eb.end(), b.begin()) ||
+      (nCounts != gNumBins) || (len != 28 + 8*(nVals + nCounts)))
+      {
+      SENSEI_ERROR("Record " << step << " is wrong")
+      return -1;
+      }
+
+    pos += 4 + len;
+    }
+
+  if (pos != buf.size())
+    {
+    SENSEI_ERROR("Found " << buf.size() - pos << " bytes after the last record")
+    return -1;
+    }
+
+  return 0;
+}
+}
+
+int main(int argc, char **argv)
+{
+  std::string fileName = argc > 1 ? argv[1] : "testTimeSeriesStore.sts";
+  remove(fileName.c_str());
+
+  sensei::TimeSeriesStore store;
+  store.SetSyncInterval(3);
+
+  // the first session
+  if (store.Open(fileName, "histogram", {{"mesh", "mesh"}}) ||
+    append(store, 0, 10) || store.Close())
+    return -1;
+
+  // an interrupted write
+  FILE *f = fopen(fileName.c_str(), "ab");
+  const char partial[11] = {100, 0, 0, 0, 1, 2, 3, 4, 5, 6, 7};
+  fwrite(partial, 1, sizeof(partial), f);
+  fclose(f);
+
+  // the second session continues the file
+  if (store.Open(fileName, "histogram", {{"mesh", "mesh"}}) ||
+    append(store, 10, 25) || store.Close())
+    return -1;
+
+  if (validate(fileName, 25))
+    return -1;
+
+  remove(fileName.c_str());
+
+  std::cerr << "Time series store passed" << std::endl;
+
+  return 0;
+}
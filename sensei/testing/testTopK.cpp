@@ -0,0 +1,104 @@
+#include "TopK.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <vector>
+#include <mpi.h>
+
+// Checks the TopK reduction against the exact result. Each rank draws
+// values for a number of sets, with many duplicates, and the k largest of
+// each set over all ranks are compared to those found by gathering and
+// sorting all of the values on rank 0.
+//
+// usage: testTopK [values per rank] [k] [num sets]
+
+int main(int argc, char **argv)
+{
+  MPI_Init(&argc, &argv);
+
+  long nVals = argc > 1 ? atol(argv[1]) : 100000;
+  int k = argc > 2 ? atoi(argv[2]) : 10;
+  int nSets = argc > 3 ? atoi(argv[3]) : 4;
+
+  MPI_Comm comm = MPI_COMM_WORLD;
+
+  int rank = 0;
+  int nRanks = 1;
+  MPI_Comm_rank(comm, &rank);
+  MPI_Comm_size(comm, &nRanks);
+
+  std::mt19937 gen(54321 + rank);
+  std::uniform_int_distribution<int> dist(0, 1000);
+
+  sensei::TopK topk(k, nSets);
+  std::vector<double> vals(nSets*nVals);
+  for (int s = 0; s < nSets; ++s)
+    {
+    for (long i = 0; i < nVals; ++i)
+      {
+      double val = dist(gen)*(s + 1);
+      vals[s*nVals + i] = val;
+      topk.Insert(s, val, rank, i);
+      }
+    }
+
+  topk.Reduce(comm, 0);
+
+  std::vector<double> allVals;
+  if (rank == 0)
+    allVals.resize(nRanks*nSets*nVals);
+
+  MPI_Gather(vals.data(), nSets*nVals, MPI_DOUBLE, allVals.data(),
+    nSets*nVals, MPI_DOUBLE, 0, comm);
+
+  int result = 0;
+  if (rank == 0)
+    {
+    std::vector<sensei::TopK::Candidate> cands;
+    for (int s = 0; s < nSets && !result; ++s)
+      {
+      std::vector<double> setVals;
+      for (int r = 0; r < nRanks; ++r)
+        setVals.insert(setVals.end(), allVals.begin() + (r*nSets + s)*nVals,
+          allVals.begin() + (r*nSets + s + 1)*nVals);
+
+      std::sort(setVals.begin(), setVals.end(), std::greater<double>());
+
+      topk.GetCandidates(s, cands);
+      if (cands.size() != size_t(k))
+        {
+        std::cerr << "Set " << s << " has " << cands.size()
+          << " candidates, expected " << k << std::endl;
+        result = -1;
+        break;
+        }
+
+      for (int i = 0; i < k; ++i)
+        {
+        const sensei::TopK::Candidate &c = cands[i];
+        if ((c.Value != setVals[i]) || (c.Block < 0) || (c.Block >= nRanks)
+          || (allVals[(c.Block*nSets + s)*nVals + c.Location[0]] != c.Value))
+          {
+          std::cerr << "Set " << s << " candidate " << i << " value "
+            << c.Value << " block " << c.Block << " location "
+            << c.Location[0] << " does not match " << setVals[i] << std::endl;
+          result = -1;
+          break;
+          }
+        }
+      }
+
+    if (!result)
+      std::cerr << "The top " << k << " of " << nSets << " sets on "
+        << nRanks << " ranks match" << std::endl;
+    }
+
+  MPI_Bcast(&result, 1, MPI_INT, 0, comm);
+
+  MPI_Finalize();
+
+  return result;
+}
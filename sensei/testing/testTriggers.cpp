@@ -0,0 +1,167 @@
+#include <cmath>
+#include <iostream>
+#include <vector>
+#include <mpi.h>
+#include <vtkDoubleArray.h>
+#include <vtkImageData.h>
+#include <vtkPointData.h>
+#include "ArrayRangeTrigger.h"
+#include "EntropyTrigger.h"
+#include "Error.h"
+#include "PredicateTrigger.h"
+#include "TriggerSet.h"
+#include "VTKDataAdaptor.h"
+
+// Evaluates range, entropy, and predicate triggers over a short sequence
+// of steps and checks which analyses they let run. Each rank holds an
+// image whose point data is set to a known pattern on each step.
+
+namespace
+{
+const int gNx = 8;
+const int gNSteps = 5;
+
+// fills the array with the values of the given step
+void setValues(vtkDoubleArray *da, int step, int rank, int nRanks)
+{
+  long n = da->GetNumberOfTuples();
+  for (long i = 0; i < n; ++i)
+    {
+    double val = 0.1;
+    if (step == 2)
+      val = 0.9;
+    else if (step == 3)
+      val = 0.05 + 0.1*(i % 4);
+    da->SetValue(i, val);
+    }
+
+  // a single value above the threshold on the last rank
+  if ((step == 1) && (rank == nRanks - 1))
+    da->SetValue(n/2, 0.9);
+}
+}
+
+int main(int argc, char **argv)
+{
+  MPI_Init(&argc, &argv);
+
+  MPI_Comm comm = MPI_COMM_WORLD;
+
+  int rank = 0;
+  int nRanks = 1;
+  MPI_Comm_rank(comm, &rank);
+  MPI_Comm_size(comm, &nRanks);
+
+  vtkImageData *im = vtkImageData::New();
+  im->SetDimensions(gNx, gNx, gNx);
+  im->SetOrigin(0.0, 0.0, gNx*rank);
+
+  vtkDoubleArray *data = vtkDoubleArray::New();
+  data->SetName("data");
+  data->SetNumberOfTuples(gNx*gNx*gNx);
+  im->GetPointData()->AddArray(data);
+
+  // analysis 0 runs when the maximum crosses 0.5, analysis 1 while it is
+  // above 0.5 or when rank 0 votes for it, analysis 2 when the entropy
+  // changes by half a bit, and analysis 3 has no triggers
+  sensei::TriggerSet triggers;
+
+  sensei::ArrayRangeTrigger *crossing = sensei::ArrayRangeTrigger::New();
+  crossing->SetArray("image", vtkDataObject::POINT, "data");
+  crossing->SetAbove(0.5);
+  triggers.AddTrigger(0, 1, "crossing", crossing);
+  crossing->Delete();
+
+  sensei::ArrayRangeTrigger *level = sensei::ArrayRangeTrigger::New();
+  level->SetArray("image", vtkDataObject::POINT, "data");
+  level->SetAbove(0.5);
+  level->SetLevel(1);
+  triggers.AddTrigger(1, 2, "level", level);
+  level->Delete();
+
+  int step = 0;
+  sensei::PredicateTrigger *pred = sensei::PredicateTrigger::New();
+  pred->SetPredicate([&step,rank](sensei::DataAdaptor *, int &vote) -> int
+    {
+    vote = (rank == 0) && (step == 3);
+    return 0;
+    });
+  triggers.AddTrigger(1, 2, "predicate", pred);
+  pred->Delete();
+
+  sensei::EntropyTrigger *entropy = sensei::EntropyTrigger::New();
+  entropy->SetArray("image", vtkDataObject::POINT, "data");
+  entropy->SetNumberOfBins(4);
+  entropy->SetRange(0.0, 1.0);
+  entropy->SetChange(0.5);
+  triggers.AddTrigger(2, 3, "entropy", entropy);
+  entropy->Register(nullptr);
+  entropy->Delete();
+
+  int expected[gNSteps][4] = {
+    {0, 0, 0, 1},
+    {1, 1, 0, 1},
+    {0, 1, 0, 1},
+    {0, 1, 1, 1},
+    {0, 0, 1, 1}};
+
+  double expectedEntropy[gNSteps] = {0.0, -1.0, 0.0, 1.0, 0.0};
+
+  int result = 0;
+  for (step = 0; step < gNSteps; ++step)
+    {
+    setValues(data, step, rank, nRanks);
+    data->Modified();
+
+    sensei::VTKDataAdaptor *dataAdaptor = sensei::VTKDataAdaptor::New();
+    dataAdaptor->SetCommunicator(comm);
+    dataAdaptor->SetDataObject("image", im);
+
+    std::vector<int> run;
+    if (triggers.Evaluate(comm, dataAdaptor, 4, run))
+      {
+      SENSEI_ERROR("Failed to evaluate the triggers at step " << step)
+      result = -1;
+      }
+
+    dataAdaptor->ReleaseData();
+    dataAdaptor->Delete();
+
+    for (int i = 0; (result == 0) && (i < 4); ++i)
+      {
+      if (run[i] != expected[step][i])
+        {
+        SENSEI_ERROR("At step " << step << " analysis " << i << " "
+          << (run[i] ? "ran" : "was skipped"))
+        result = -1;
+        }
+      }
+
+    // the entropy of step 1 depends on the number of ranks
+    double h = entropy->GetEntropy();
+    if ((result == 0) && (expectedEntropy[step] >= 0.0) &&
+      (fabs(h - expectedEntropy[step]) > 1e-12))
+      {
+      SENSEI_ERROR("At step " << step << " the entropy is " << h
+        << " not " << expectedEntropy[step])
+      result = -1;
+      }
+
+    if (result)
+      break;
+    }
+
+  entropy->Delete();
+  data->Delete();
+  im->Delete();
+
+  triggers.Finalize();
+  triggers.PrintSummary(comm);
+
+  if (rank == 0)
+    std::cerr << "Trigger test " << (result ? "failed" : "passed") << std::endl;
+
+  MPI_Finalize();
+
+  return result;
+}